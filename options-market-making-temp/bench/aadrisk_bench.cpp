@@ -0,0 +1,226 @@
+#include "benchutils.hpp"
+#include "core/config.hpp"
+#include "core/workers/aadrisk.hpp"
+#include "core/workers/calculator.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace omm::core;
+using namespace omm::core::models;
+using namespace omm::core::workers;
+
+namespace {
+
+// makeMarket's surface
+const SurfaceParams MARKET_PARAMS{Config::VIX, -0.02, 0.01, 0.18};
+
+// Strikes between the surface's 50-point grid strikes: on a grid strike a leg lies on a
+// knot of the piecewise-linear smile, where the vol has a left and a right slope and
+// central differences average the two
+const omm::bench::BookShape BETWEEN_GRID_STRIKES{VolSurface::GRID_STRIKE_STEP, 0.5 * VolSurface::GRID_STRIKE_STEP};
+
+// Book value through Calculator's batch pricer, futures at spot
+double calculatorValue(const Portfolio& portfolio, const Market& market, std::vector<double>& prices) {
+    double value = 0.0;
+    for (const auto& bucket : portfolio.optionBuckets) {
+        prices.resize(bucket.size());
+        OptionBatch batch{bucket.strikes.data(), bucket.expiries.data(), bucket.optionTypes.data(), bucket.size()};
+        Calculator::priceOptionBatch(batch, market, OptionBatchResult{prices.data(), nullptr, nullptr, nullptr, nullptr});
+        for (std::size_t i = 0; i < bucket.size(); ++i) value += bucket.weights[i] * prices[i];
+    }
+    for (double weight : portfolio.futureWeights) value += weight * market.spot;
+    return value;
+}
+
+// Sensitivities by central differences: the surface rebuilt with each parameter
+// bumped, the book repriced by Calculator
+class BumpAndReprice {
+public:
+    BumpAndReprice(const Portfolio& portfolio_, const Market& market_)
+        : portfolio(portfolio_), market(market_), bumped(market_) {
+        bumped.volSurface = std::make_shared<VolSurface>();
+    }
+    
+    SurfaceSensitivities run(const SurfaceParams& params) {
+        SurfaceSensitivities result;
+        auto reprice = [&](SurfaceParams p) {
+            bumped.volSurface->rebuild(market.volSurface->expiries, p.atmOneMonthVolEst, p.skew, p.convexity,
+                                       p.volMean, market.spot, market.interestRate);
+            return calculatorValue(portfolio, bumped, prices);
+        };
+        auto central = [&](double SurfaceParams::*field) {
+            SurfaceParams up = params, down = params;
+            up.*field += VOL_BUMP;
+            down.*field -= VOL_BUMP;
+            return (reprice(up) - reprice(down)) / (2.0 * VOL_BUMP);
+        };
+        result.surface = SurfaceParams{central(&SurfaceParams::atmOneMonthVolEst), central(&SurfaceParams::skew),
+                                       central(&SurfaceParams::convexity), central(&SurfaceParams::volMean)};
+        result.value = reprice(params);
+        marketMoves(result);
+        return result;
+    }
+    
+    SurfaceSensitivities run(const std::vector<SmileParams>& smiles) {
+        SurfaceSensitivities result;
+        std::vector<SmileParams> bumpedSmiles = smiles;
+        auto reprice = [&]() {
+            bumped.volSurface->rebuild(market.volSurface->expiries, bumpedSmiles.data(), market.spot, market.interestRate);
+            return calculatorValue(portfolio, bumped, prices);
+        };
+        auto central = [&](double& field) {
+            double base = field;
+            field = base + VOL_BUMP;
+            double up = reprice();
+            field = base - VOL_BUMP;
+            double down = reprice();
+            field = base;
+            return (up - down) / (2.0 * VOL_BUMP);
+        };
+        for (auto& smile : bumpedSmiles) {
+            result.smiles.push_back(SmileParams{central(smile.atmVol), central(smile.skew), central(smile.convexity)});
+        }
+        result.value = reprice();
+        marketMoves(result);
+        return result;
+    }
+
+private:
+    static constexpr double VOL_BUMP = 1e-5;
+    static constexpr double SPOT_BUMP = 1e-2;
+    static constexpr double RATE_BUMP = 1e-6;
+    
+    // Spot and rate against the unchanged surface, as AadRisk holds it
+    void marketMoves(SurfaceSensitivities& result) {
+        auto reprice = [&](double spot, double rate) {
+            bumped.spot = spot;
+            bumped.interestRate = rate;
+            double value = calculatorValue(portfolio, bumped, prices);
+            bumped.spot = market.spot;
+            bumped.interestRate = market.interestRate;
+            return value;
+        };
+        result.spot = (reprice(market.spot + SPOT_BUMP, market.interestRate) -
+                       reprice(market.spot - SPOT_BUMP, market.interestRate)) / (2.0 * SPOT_BUMP);
+        result.interestRate = (reprice(market.spot, market.interestRate + RATE_BUMP) -
+                               reprice(market.spot, market.interestRate - RATE_BUMP)) / (2.0 * RATE_BUMP);
+    }
+    
+    const Portfolio& portfolio;
+    const Market& market;
+    Market bumped;
+    std::vector<double> prices;
+};
+
+// Worst |aad - bump| over the sensitivities, relative to the largest of their kind
+double relError(double aad, double bump, double scale) {
+    return std::abs(aad - bump) / std::max(scale, 1e-12);
+}
+
+double maxRelError(const SurfaceSensitivities& aad, const SurfaceSensitivities& bump) {
+    double worst = std::max(relError(aad.spot, bump.spot, std::abs(bump.spot)),
+                            relError(aad.interestRate, bump.interestRate, std::abs(bump.interestRate)));
+    const SurfaceParams& a = aad.surface;
+    const SurfaceParams& b = bump.surface;
+    double surfaceScale = std::max({std::abs(b.atmOneMonthVolEst), std::abs(b.skew), std::abs(b.convexity), std::abs(b.volMean)});
+    for (auto [x, y] : {std::pair{a.atmOneMonthVolEst, b.atmOneMonthVolEst}, {a.skew, b.skew},
+                        {a.convexity, b.convexity}, {a.volMean, b.volMean}}) {
+        worst = std::max(worst, relError(x, y, surfaceScale));
+    }
+    double smileScale = 0.0;
+    for (const auto& s : bump.smiles) {
+        smileScale = std::max({smileScale, std::abs(s.atmVol), std::abs(s.skew), std::abs(s.convexity)});
+    }
+    for (std::size_t i = 0; i < bump.smiles.size(); ++i) {
+        worst = std::max({worst, relError(aad.smiles[i].atmVol, bump.smiles[i].atmVol, smileScale),
+                          relError(aad.smiles[i].skew, bump.smiles[i].skew, smileScale),
+                          relError(aad.smiles[i].convexity, bump.smiles[i].convexity, smileScale)});
+    }
+    return worst;
+}
+
+// makeMarket's surface as per-expiry smiles (knot ATM vols of its term structure;
+// getAtmVol interpolates between knots and reads slightly higher)
+std::vector<SmileParams> marketSmiles(const Market& market) {
+    const SurfaceParams& p = MARKET_PARAMS;
+    std::vector<SmileParams> smiles;
+    for (double expiry : market.volSurface->expiries) {
+        double weight = std::exp(-std::abs(expiry - 30.0) / 365.0);
+        double atmVol = std::sqrt(p.volMean * p.volMean + weight * (p.atmOneMonthVolEst * p.atmOneMonthVolEst - p.volMean * p.volMean));
+        smiles.push_back(SmileParams{atmVol, p.skew, p.convexity});
+    }
+    return smiles;
+}
+
+void setLegCounters(benchmark::State& state, const Portfolio& portfolio) {
+    state.counters["legs/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * portfolio.numOptions()), benchmark::Counter::kIsRate);
+}
+
+}  // namespace
+
+// One valuation of the book: Calculator's batch pricer against the market surface
+// (range(1) = 0), and AadRisk's valuation in doubles, surface built from its
+// parameters included (range(1) = 1)
+static void BM_BookValue(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    Portfolio portfolio = omm::bench::makeBook(*market, static_cast<std::size_t>(state.range(0)), BETWEEN_GRID_STRIKES);
+    std::vector<double> prices;
+    
+    for (auto _ : state) {
+        double value = state.range(1) == 0 ? calculatorValue(portfolio, *market, prices)
+                                           : AadRisk::portfolioValue(portfolio, *market, MARKET_PARAMS);
+        benchmark::DoNotOptimize(value);
+    }
+    setLegCounters(state, portfolio);
+}
+
+// Value and every sensitivity in one recording and one reverse sweep. range(1): 0 =
+// parametric surface (4 parameters plus the per-expiry smiles they build), 1 =
+// per-expiry smiles. relErr is against bump-and-reprice through Calculator (84 or 82
+// central differences); valueDiff against Calculator's value.
+static void BM_AadSensitivities(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    Portfolio portfolio = omm::bench::makeBook(*market, static_cast<std::size_t>(state.range(0)), BETWEEN_GRID_STRIKES);
+    std::vector<SmileParams> smiles = marketSmiles(*market);
+    bool parametric = state.range(1) == 0;
+    aad::Tape tape;
+    
+    SurfaceSensitivities result;
+    for (auto _ : state) {
+        result = parametric ? AadRisk::portfolioSensitivities(portfolio, *market, MARKET_PARAMS, tape)
+                            : AadRisk::portfolioSensitivities(portfolio, *market, smiles, tape);
+        benchmark::DoNotOptimize(&result);
+    }
+    setLegCounters(state, portfolio);
+    
+    BumpAndReprice bumps(portfolio, *market);
+    SurfaceSensitivities reference = parametric ? bumps.run(MARKET_PARAMS) : bumps.run(smiles);
+    std::vector<double> prices;
+    state.counters["nodes"] = static_cast<double>(tape.size());
+    state.counters["relErr"] = maxRelError(result, reference);
+    state.counters["valueDiff"] = std::abs(result.value - calculatorValue(portfolio, *market, prices));
+}
+
+// The same sensitivities by bump-and-reprice
+static void BM_BumpAndReprice(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    Portfolio portfolio = omm::bench::makeBook(*market, static_cast<std::size_t>(state.range(0)), BETWEEN_GRID_STRIKES);
+    std::vector<SmileParams> smiles = marketSmiles(*market);
+    BumpAndReprice bumps(portfolio, *market);
+    
+    for (auto _ : state) {
+        SurfaceSensitivities result = state.range(1) == 0 ? bumps.run(MARKET_PARAMS) : bumps.run(smiles);
+        benchmark::DoNotOptimize(&result);
+    }
+    setLegCounters(state, portfolio);
+}
+
+BENCHMARK(BM_BookValue)->ArgsProduct({{2000, 20000}, {0, 1}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AadSensitivities)->ArgsProduct({{2000, 20000}, {0, 1}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BumpAndReprice)->ArgsProduct({{2000}, {0, 1}})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,147 @@
+#include "core/config.hpp"
+#include "sim/agents.hpp"
+#include "sim/agentsimulation.hpp"
+#include "sim/latentstate.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cmath>
+
+using namespace omm::sim;
+using namespace omm::lob;
+
+namespace {
+
+constexpr std::uint64_t SEED = 20240917;
+constexpr std::uint32_t MARKET_TICK = AGENT_EVENT_TYPES;
+constexpr Timestamp UPDATE_INTERVAL = NS_PER_MILLISECOND;
+constexpr Timestamp HORIZON = NS_PER_SECOND;
+constexpr double TICK_SIZE = 0.005;  // index points; fine enough for 1ms moves to matter
+constexpr Price CENTER_PRICE = 256;
+
+using Simulation = AgentSimulation<AggressiveTaker, LatencyArbitrageur, LiquidityProvider>;
+
+// 4 expiries x 32 strikes x call/put around the spot
+InstrumentRegistry makeRegistry() {
+    constexpr std::size_t numStrikes = 32;
+    double spot = omm::core::Config::SPX_SPOT;
+    return InstrumentRegistry({7.0, 14.0, 28.0, 56.0}, spot - 50.0 * (numStrikes / 2), 50.0, numStrikes);
+}
+
+// Rough delta per instrument, enough to move option fair values with the spot
+std::vector<double> makeDeltas(const InstrumentRegistry& registry) {
+    std::vector<double> deltas(registry.size());
+    for (InstrumentId id = 0; id < registry.size(); ++id) {
+        InstrumentInfo info = registry.describe(id);
+        double moneyness = (omm::core::Config::SPX_SPOT - info.strike) / 400.0;
+        double callDelta = 0.5 + 0.5 * std::tanh(moneyness);
+        deltas[id] = info.optionType == omm::core::models::OptionType::CALL ? callDelta : callDelta - 1.0;
+    }
+    return deltas;
+}
+
+std::vector<InstrumentId> pickInstruments(std::size_t agent, std::size_t count, std::size_t numInstruments) {
+    std::vector<InstrumentId> picked;
+    for (std::size_t k = 0; k < count; ++k) {
+        picked.push_back(static_cast<InstrumentId>((agent * 7919 + k * 31) % numInstruments));
+    }
+    return picked;
+}
+
+// 70% takers, 10% latency arbitrageurs (fastest), 20% LPs with tight to loose risk limits
+void populate(Simulation& sim, std::size_t numAgents, std::size_t numInstruments) {
+    for (std::size_t a = 0; a < numAgents; ++a) {
+        std::size_t kind = a % 10;
+        if (kind < 7) {
+            AggressiveTaker taker;
+            taker.instruments = pickInstruments(a, 8, numInstruments);
+            sim.addAgent(taker, LatencyModel::exponential(200 * NS_PER_MICROSECOND, 300 * NS_PER_MICROSECOND));
+        } else if (kind == 7) {
+            LatencyArbitrageur arb;
+            arb.instruments = pickInstruments(a, 16, numInstruments);
+            sim.addAgent(arb, LatencyModel::uniform(5 * NS_PER_MICROSECOND, 10 * NS_PER_MICROSECOND));
+        } else {
+            LiquidityProvider lp;
+            lp.instruments = pickInstruments(a, 8, numInstruments);
+            lp.maxInventory = kind == 8 ? 10 : 50;
+            lp.halfSpread = kind == 8 ? 3 : 2;
+            sim.addAgent(lp, LatencyModel::uniform(50 * NS_PER_MICROSECOND, 100 * NS_PER_MICROSECOND));
+        }
+    }
+}
+
+}  // namespace
+
+// One simulated second of takers, arbitrageurs and LPs on 256 option books, with
+// market updates from LatentState every millisecond. agents/s counts agent callbacks
+// (wakes, market updates and fills) per wall-clock second.
+static void BM_AgentSimulation(benchmark::State& state) {
+    using Clock = std::chrono::steady_clock;
+    
+    auto numAgents = static_cast<std::size_t>(state.range(0));
+    InstrumentRegistry registry = makeRegistry();
+    std::vector<double> deltas = makeDeltas(registry);
+    double spot0 = omm::core::Config::SPX_SPOT;
+    
+    AgentStats stats;
+    double arbEdge = 0.0;
+    Quantity maxLpInventory = 0;
+    std::uint64_t events = 0;
+    double seconds = 0.0;
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        BookManager books(registry, BookSpec());
+        Scheduler scheduler(SEED);
+        Simulation sim(books, scheduler, SEED);
+        LatentState latent(omm::core::workers::MarketState{omm::core::models::Regime::CALM, spot0, omm::core::Config::VIX}, SEED);
+        populate(sim, numAgents, registry.size());
+        
+        auto updateFair = [&](double spot) {
+            for (InstrumentId id = 0; id < registry.size(); ++id) {
+                auto move = static_cast<Price>(std::lround(deltas[id] * (spot - spot0) / TICK_SIZE));
+                sim.setFairPrice(id, std::clamp<Price>(CENTER_PRICE + move, 32, 480));
+            }
+        };
+        auto handler = [&](const Event& event, Scheduler& s) {
+            if (event.type == MARKET_TICK) {
+                updateFair(latent.sampleAt(event.time).spot);
+                sim.publishMarketUpdate();
+                s.scheduleAfter(UPDATE_INTERVAL, MARKET_TICK, 0);
+            } else {
+                sim(event, s);
+            }
+        };
+        
+        updateFair(spot0);
+        sim.start();
+        scheduler.scheduleAt(UPDATE_INTERVAL, MARKET_TICK, 0);
+        state.ResumeTiming();
+        
+        auto begin = Clock::now();
+        events += scheduler.run(handler, HORIZON);
+        seconds += std::chrono::duration<double>(Clock::now() - begin).count();
+        
+        state.PauseTiming();
+        stats = sim.stats();
+        arbEdge = 0.0;
+        for (const auto& arb : sim.agents<LatencyArbitrageur>()) arbEdge += arb.edgeCaptured;
+        for (const auto& lp : sim.agents<LiquidityProvider>()) {
+            for (const auto& q : lp.quotes) maxLpInventory = std::max(maxLpInventory, std::abs(q.inventory));
+        }
+        state.ResumeTiming();
+    }
+    
+    double iterations = static_cast<double>(state.iterations());
+    state.counters["agents/s"] = benchmark::Counter(static_cast<double>(stats.activations) * iterations / seconds);
+    state.counters["events/s"] = benchmark::Counter(static_cast<double>(events) / seconds);
+    state.counters["orders"] = static_cast<double>(stats.ordersSent);
+    state.counters["rejected"] = static_cast<double>(stats.ordersRejected);
+    state.counters["fills"] = static_cast<double>(stats.fills);
+    state.counters["arbEdgeTicks"] = arbEdge;
+    state.counters["maxLpInventory"] = static_cast<double>(maxLpInventory);
+}
+
+BENCHMARK(BM_AgentSimulation)->Arg(1000)->Arg(4000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "core/config.hpp"
+#include "core/models/market.hpp"
+#include "core/models/portfolio.hpp"
+#include "core/models/position.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace omm::bench {
+
+// Deterministic market on the standard expiry grid (no random shocks)
+inline std::shared_ptr<omm::core::models::Market> makeMarket(double spot = omm::core::Config::SPX_SPOT) {
+    using namespace omm::core;
+    
+    auto expiries = Config::getExpiries();
+    std::vector<double> expiriesDouble(expiries.begin(), expiries.end());
+    
+    auto volSurface = std::make_shared<models::VolSurface>(
+        expiriesDouble,
+        Config::VIX,
+        -0.02,  // skew
+        0.01,   // convexity
+        0.18,   // volMean
+        spot,
+        Config::INTEREST_RATE
+    );
+    
+    return std::make_shared<models::Market>(
+        models::Asset(".NDX"),
+        0,
+        spot,
+        volSurface,
+        Config::INTEREST_RATE,
+        models::Regime::CALM
+    );
+}
+
+// Strikes of makeBook: rounded to a multiple of strikeRounding, then shifted by strikeOffset
+struct BookShape {
+    double strikeRounding = 5.0;
+    double strikeOffset = 0.0;
+    bool unitQuantities = false;  // every position 1 lot rather than -10..10
+};
+
+// Calls and puts within +-20% of spot on random listed expiries, one future per 100
+// legs, from a fixed seed. Book is omm::core::models::Portfolio or
+// std::vector<omm::core::models::Position>.
+template <typename Book = omm::core::models::Portfolio>
+Book makeBook(const omm::core::models::Market& market, std::size_t numLegs, const BookShape& shape = {}) {
+    using namespace omm::core::models;
+    
+    std::mt19937_64 rng(5);
+    const auto& expiries = market.volSurface->expiries;
+    std::uniform_int_distribution<std::size_t> expiryDist(0, expiries.size() - 1);
+    std::uniform_real_distribution<double> strikeDist(0.8 * market.spot, 1.2 * market.spot);
+    std::uniform_int_distribution<int> quantityDist(-10, 10);
+    auto quantity = [&] { return shape.unitQuantities ? 1 : quantityDist(rng); };
+    
+    Book book;
+    for (std::size_t i = 0; i < numLegs; ++i) {
+        OptionType type = (i % 2 == 0) ? OptionType::CALL : OptionType::PUT;
+        double strike = std::round(strikeDist(rng) / shape.strikeRounding) * shape.strikeRounding + shape.strikeOffset;
+        int lots = quantity();  // before the expiry, so the draw order is fixed on every compiler
+        double expiry = expiries[expiryDist(rng)];
+        if constexpr (std::is_same_v<Book, Portfolio>) {
+            book.addOption(Option(market.asset, strike, expiry, type, 100), lots);
+            if (i % 100 == 0) book.addFuture(Future(market.asset, "30", 50), quantity());
+        } else {
+            book.emplace_back(std::make_shared<Option>(market.asset, strike, expiry, type, 100), lots);
+            if (i % 100 == 0) book.emplace_back(std::make_shared<Future>(market.asset, "30", 50), quantity());
+        }
+    }
+    return book;
+}
+
+// Log-linear latency histogram in nanoseconds: 16 sub-buckets per power of two, so
+// quantiles are exact below 16ns and within 1/16 above
+class LatencyHistogram {
+public:
+    LatencyHistogram() : counts(64 * SUB_BUCKETS, 0) {}
+    
+    void record(std::uint64_t ns) {
+        ++counts[bucketOf(ns)];
+        ++total;
+        maxNs = std::max(maxNs, ns);
+    }
+    
+    void reset() {
+        std::fill(counts.begin(), counts.end(), 0);
+        total = 0;
+        maxNs = 0;
+    }
+    
+    // Upper bound of the bucket holding quantile q of the recorded samples
+    double quantile(double q) const {
+        if (total == 0) return 0.0;
+        auto rank = static_cast<std::uint64_t>(q * static_cast<double>(total - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b < counts.size(); ++b) {
+            seen += counts[b];
+            if (seen >= rank) return static_cast<double>(std::min(upperBound(b), maxNs));
+        }
+        return static_cast<double>(maxNs);
+    }
+    
+    std::uint64_t count() const { return total; }
+    double max() const { return static_cast<double>(maxNs); }
+
+private:
+    static constexpr std::size_t SUB_BITS = 4;
+    static constexpr std::size_t SUB_BUCKETS = 1 << SUB_BITS;
+    
+    static std::size_t bucketOf(std::uint64_t ns) {
+        if (ns < SUB_BUCKETS) return static_cast<std::size_t>(ns);
+        std::size_t exponent = 63 - static_cast<std::size_t>(__builtin_clzll(ns));
+        std::size_t sub = static_cast<std::size_t>(ns >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1);
+        return (exponent - SUB_BITS + 1) * SUB_BUCKETS + sub;
+    }
+    
+    static std::uint64_t upperBound(std::size_t bucket) {
+        if (bucket < SUB_BUCKETS) return bucket;
+        std::size_t exponent = bucket / SUB_BUCKETS + SUB_BITS - 1;
+        std::uint64_t sub = bucket % SUB_BUCKETS;
+        return ((SUB_BUCKETS + sub + 1) << (exponent - SUB_BITS)) - 1;
+    }
+    
+    std::vector<std::uint64_t> counts;
+    std::uint64_t total = 0;
+    std::uint64_t maxNs = 0;
+};
+
+}  // namespace omm::bench
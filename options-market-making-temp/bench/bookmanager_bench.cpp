@@ -0,0 +1,224 @@
+#include "benchutils.hpp"
+#include "core/config.hpp"
+#include "lob/bookmanager.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using namespace omm::core;
+using namespace omm::core::models;
+using namespace omm::lob;
+
+namespace {
+
+constexpr std::uint64_t SEED = 20240917;
+constexpr Price CENTER_PRICE = 256;  // middle of the default BookSpec range
+
+// Full chain: 26 expiries x 81 strikes x call/put, plus three futures
+const InstrumentRegistry& registry() {
+    static const InstrumentRegistry instance = InstrumentRegistry::fromVolSurface(
+        *omm::bench::makeMarket()->volSurface, Config::SPX_SPOT, {"30", "91", "182"});
+    return instance;
+}
+
+// Series name a string-keyed design would route on
+std::string seriesName(InstrumentId id) {
+    const auto& reg = registry();
+    InstrumentInfo info = reg.describe(id);
+    if (info.kind == InstrumentKind::FUTURE) {
+        return ".NDX F" + std::to_string(info.expiryIdx);
+    }
+    return ".NDX " + std::to_string(static_cast<int>(info.expiry)) + " " +
+           std::to_string(static_cast<int>(info.strike)) +
+           (info.optionType == OptionType::CALL ? " C" : " P");
+}
+
+std::vector<Option> makeOptions(std::size_t n) {
+    const auto& reg = registry();
+    std::mt19937_64 rng(SEED);
+    std::vector<Option> options;
+    options.reserve(n);
+    Asset asset(".NDX");
+    for (std::size_t i = 0; i < n; ++i) {
+        InstrumentInfo info = reg.describe(static_cast<InstrumentId>(rng() % reg.numOptions()));
+        options.emplace_back(asset, info.strike, info.expiry, info.optionType, 1);
+    }
+    return options;
+}
+
+// Events spread uniformly over every instrument: 60% limit adds within 10 ticks of the
+// center, 30% cancels of live orders and 10% IOC takers. A reference manager run
+// alongside keeps cancels pointed at resting orders.
+std::vector<OrderEvent> makeEvents(std::size_t n) {
+    const auto& reg = registry();
+    std::mt19937_64 rng(SEED);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::uniform_int_distribution<Price> offset(1, 10);
+    std::uniform_int_distribution<Quantity> lots(1, 10);
+    
+    BookManager reference(reg, BookSpec());
+    std::vector<Fill> fills;
+    std::vector<std::pair<InstrumentId, OrderId>> live;
+    std::vector<OrderEvent> events;
+    events.reserve(n);
+    
+    OrderId nextId = 1;
+    while (events.size() < n) {
+        double u = uniform(rng);
+        auto instrument = static_cast<InstrumentId>(rng() % reg.size());
+        OrderEvent event{instrument, OrderAction::ADD, OrderRequest{nextId, uniform(rng) < 0.5 ? Side::BUY : Side::SELL}};
+        event.order.quantity = lots(rng);
+        
+        if (u < 0.6 || live.empty()) {
+            Price distance = offset(rng);
+            event.order.price = event.order.side == Side::BUY ? CENTER_PRICE - distance : CENTER_PRICE + distance;
+        } else if (u < 0.9) {
+            std::size_t k = static_cast<std::size_t>(uniform(rng) * static_cast<double>(live.size()));
+            auto [liveInstrument, id] = live[k];
+            live[k] = live.back();
+            live.pop_back();
+            if (!reference.book(liveInstrument).contains(id)) continue;
+            event.instrument = liveInstrument;
+            event.action = OrderAction::CANCEL;
+            event.order.id = id;
+        } else {
+            event.order.timeInForce = TimeInForce::IOC;
+            event.order.price = event.order.side == Side::BUY ? CENTER_PRICE + 10 : CENTER_PRICE - 10;
+        }
+        
+        fills.clear();
+        if (event.action == OrderAction::ADD) ++nextId;
+        if (reference.route(event, fills).status == OrderStatus::RESTING) {
+            live.emplace_back(event.instrument, event.order.id);
+        }
+        events.push_back(event);
+    }
+    return events;
+}
+
+const std::vector<OrderEvent>& events() {
+    static const std::vector<OrderEvent> instance = makeEvents(1000000);
+    return instance;
+}
+
+}  // namespace
+
+// Option -> InstrumentId through the registry's day table and strike arithmetic
+static void BM_InstrumentLookup(benchmark::State& state) {
+    const auto& reg = registry();
+    auto options = makeOptions(4096);
+    
+    std::size_t misses = 0;
+    for (auto _ : state) {
+        for (const Option& option : options) {
+            InstrumentId id = reg.lookup(option);
+            misses += id == NO_INSTRUMENT;
+            benchmark::DoNotOptimize(id);
+        }
+    }
+    
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(options.size()));
+    state.counters["instruments"] = static_cast<double>(reg.size());
+    state.counters["misses"] = static_cast<double>(misses);
+}
+
+// The same lookup through a series-name hash map, building the key per option
+static void BM_InstrumentLookupStringMap(benchmark::State& state) {
+    const auto& reg = registry();
+    auto options = makeOptions(4096);
+    
+    std::unordered_map<std::string, InstrumentId> byName;
+    for (InstrumentId id = 0; id < reg.numOptions(); ++id) {
+        byName.emplace(seriesName(id), id);
+    }
+    
+    std::size_t misses = 0;
+    for (auto _ : state) {
+        for (const Option& option : options) {
+            std::string key = ".NDX " + std::to_string(static_cast<int>(option.expiry)) + " " +
+                              std::to_string(static_cast<int>(option.strike)) +
+                              (option.optionType == OptionType::CALL ? " C" : " P");
+            auto it = byName.find(key);
+            misses += it == byName.end();
+            benchmark::DoNotOptimize(it);
+        }
+    }
+    
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(options.size()));
+    state.counters["misses"] = static_cast<double>(misses);
+}
+
+// Events routed by InstrumentId into the contiguous books
+static void BM_BookManagerRoute(benchmark::State& state) {
+    const auto& reg = registry();
+    const auto& evts = events();
+    BookManager manager(reg, BookSpec());
+    std::vector<Fill> fills;
+    fills.reserve(256);
+    
+    std::size_t rejected = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        manager.clear();
+        rejected = 0;
+        state.ResumeTiming();
+        
+        for (const OrderEvent& event : evts) {
+            fills.clear();
+            rejected += manager.route(event, fills).status == OrderStatus::REJECTED;
+        }
+        benchmark::DoNotOptimize(&manager);
+    }
+    
+    double resting = static_cast<double>(manager.numOrders());
+    double memoryMB = static_cast<double>(manager.memoryBytes()) / (1 << 20);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(evts.size()));
+    state.counters["books"] = static_cast<double>(manager.numBooks());
+    state.counters["rejected"] = static_cast<double>(rejected);
+    state.counters["resting"] = resting;
+    state.counters["memoryMB"] = memoryMB;
+    state.counters["KBperBook"] = memoryMB * 1024.0 / static_cast<double>(manager.numBooks());
+}
+
+// The same events routed through a series-name hash map to the books
+static void BM_StringMapRoute(benchmark::State& state) {
+    const auto& reg = registry();
+    const auto& evts = events();
+    BookManager manager(reg, BookSpec());
+    std::vector<Fill> fills;
+    fills.reserve(256);
+    
+    std::vector<std::string> names;
+    std::unordered_map<std::string, OrderBook*> byName;
+    for (InstrumentId id = 0; id < reg.size(); ++id) {
+        names.push_back(seriesName(id));
+        byName.emplace(names.back(), &manager.book(id));
+    }
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        manager.clear();
+        state.ResumeTiming();
+        
+        for (const OrderEvent& event : evts) {
+            fills.clear();
+            OrderBook& book = *byName.find(names[event.instrument])->second;
+            if (event.action == OrderAction::ADD) {
+                book.add(event.order, fills);
+            } else {
+                book.cancel(event.order.id);
+            }
+        }
+        benchmark::DoNotOptimize(&manager);
+    }
+    
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(evts.size()));
+}
+
+BENCHMARK(BM_InstrumentLookup);
+BENCHMARK(BM_InstrumentLookupStringMap);
+BENCHMARK(BM_BookManagerRoute)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StringMapRoute)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,296 @@
+#include "benchutils.hpp"
+#include "analytics/table.hpp"
+#include "core/utils.hpp"
+#include "core/workers/calculator.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace omm::core;
+using namespace omm::core::models;
+using namespace omm::core::workers;
+
+namespace {
+
+constexpr double CHAIN_EXPIRY = 32.0;
+
+// Every position 1 lot, so the unweighted legacy path agrees
+const omm::bench::BookShape UNIT_BOOK{5.0, 0.0, true};
+
+// The strikes Table::getOptionChainTable prices for one expiry
+std::vector<double> chainStrikes(const Market& market, double expiry) {
+    double forward = Utils::getForwardPrice(market.spot, market.interestRate, expiry);
+    std::vector<double> strikes;
+    for (double ns : Utils::getNormStrikes(market.spot, market.interestRate, expiry,
+                                           market.volSurface->getAtmVol(expiry))) {
+        strikes.push_back(market.volSurface->getStrike(ns, forward, expiry));
+    }
+    return strikes;
+}
+
+// Output arrays for one side (calls or puts) of a chain
+struct ChainSide {
+    std::vector<double> prices, deltas, gammas, vegas, thetas;
+    
+    explicit ChainSide(size_t n) : prices(n), deltas(n), gammas(n), vegas(n), thetas(n) {}
+    
+    OptionBatchResult view() {
+        return OptionBatchResult{prices.data(), deltas.data(), gammas.data(), vegas.data(), thetas.data()};
+    }
+};
+
+// Per-strike path as used by the option chain table before batching
+void priceChainPerStrike(const std::shared_ptr<Market>& market, const std::vector<double>& strikes,
+                         double expiry, ChainSide& calls, ChainSide& puts) {
+    for (size_t i = 0; i < strikes.size(); ++i) {
+        auto optionCall = std::make_shared<Option>(market->asset, strikes[i], expiry, OptionType::CALL, 1);
+        auto optionPut = std::make_shared<Option>(market->asset, strikes[i], expiry, OptionType::PUT, 1);
+        
+        calls.prices[i] = Calculator::priceOption(*optionCall, *market);
+        Risk callRisk = Calculator::calculateRisk(*optionCall, *market);
+        puts.prices[i] = Calculator::priceOption(*optionPut, *market);
+        Risk putRisk = Calculator::calculateRisk(*optionPut, *market);
+        
+        calls.deltas[i] = callRisk.delta;
+        calls.gammas[i] = callRisk.gamma;
+        calls.vegas[i] = callRisk.vega;
+        calls.thetas[i] = callRisk.theta;
+        puts.deltas[i] = putRisk.delta;
+        puts.gammas[i] = putRisk.gamma;
+        puts.vegas[i] = putRisk.vega;
+        puts.thetas[i] = putRisk.theta;
+    }
+}
+
+double maxRelDiff(const std::vector<double>& a, const std::vector<double>& b) {
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        double scale = std::max(1.0, std::abs(a[i]));
+        worst = std::max(worst, std::abs(a[i] - b[i]) / scale);
+    }
+    return worst;
+}
+
+void setChainCounters(benchmark::State& state, size_t chainsPerIteration, size_t strikesPerChain) {
+    double chains = static_cast<double>(state.iterations() * chainsPerIteration);
+    state.counters["chains/s"] = benchmark::Counter(chains, benchmark::Counter::kIsRate);
+    state.counters["options/s"] = benchmark::Counter(chains * 2.0 * strikesPerChain, benchmark::Counter::kIsRate);
+}
+
+void setPositionCounters(benchmark::State& state, std::size_t positions) {
+    state.counters["positions/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * positions), benchmark::Counter::kIsRate);
+}
+
+double riskRelDiff(const Risk& a, const Risk& b) {
+    double worst = 0.0;
+    for (auto [x, y] : {std::pair{a.delta, b.delta}, {a.gamma, b.gamma}, {a.vega, b.vega}, {a.theta, b.theta}}) {
+        worst = std::max(worst, std::abs(x - y) / std::max(1.0, std::abs(y)));
+    }
+    return worst;
+}
+
+}  // namespace
+
+static void BM_OptionChainPerStrike(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto strikes = chainStrikes(*market, CHAIN_EXPIRY);
+    ChainSide calls(strikes.size()), puts(strikes.size());
+    
+    for (auto _ : state) {
+        priceChainPerStrike(market, strikes, CHAIN_EXPIRY, calls, puts);
+        benchmark::DoNotOptimize(calls.prices.data());
+        benchmark::DoNotOptimize(puts.prices.data());
+    }
+    setChainCounters(state, 1, strikes.size());
+}
+BENCHMARK(BM_OptionChainPerStrike);
+
+static void BM_OptionChainBatch(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto strikes = chainStrikes(*market, CHAIN_EXPIRY);
+    std::vector<double> expiries(strikes.size(), CHAIN_EXPIRY);
+    ChainSide calls(strikes.size()), puts(strikes.size());
+    OptionChainBatch chain{strikes.data(), expiries.data(), strikes.size()};
+    
+    for (auto _ : state) {
+        Calculator::priceOptionChain(chain, *market, calls.view(), puts.view());
+        benchmark::DoNotOptimize(calls.prices.data());
+        benchmark::DoNotOptimize(puts.prices.data());
+    }
+    setChainCounters(state, 1, strikes.size());
+    
+    // Agreement with the per-strike path (relative to max(1, |value|))
+    ChainSide refCalls(strikes.size()), refPuts(strikes.size());
+    priceChainPerStrike(market, strikes, CHAIN_EXPIRY, refCalls, refPuts);
+    double diff = 0.0;
+    diff = std::max(diff, maxRelDiff(calls.prices, refCalls.prices));
+    diff = std::max(diff, maxRelDiff(calls.deltas, refCalls.deltas));
+    diff = std::max(diff, maxRelDiff(calls.gammas, refCalls.gammas));
+    diff = std::max(diff, maxRelDiff(calls.vegas, refCalls.vegas));
+    diff = std::max(diff, maxRelDiff(calls.thetas, refCalls.thetas));
+    diff = std::max(diff, maxRelDiff(puts.prices, refPuts.prices));
+    diff = std::max(diff, maxRelDiff(puts.deltas, refPuts.deltas));
+    diff = std::max(diff, maxRelDiff(puts.gammas, refPuts.gammas));
+    diff = std::max(diff, maxRelDiff(puts.vegas, refPuts.vegas));
+    diff = std::max(diff, maxRelDiff(puts.thetas, refPuts.thetas));
+    state.counters["maxRelDiff"] = diff;
+}
+BENCHMARK(BM_OptionChainBatch);
+
+static void BM_OptionChainTable(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    
+    for (auto _ : state) {
+        auto rows = omm::analytics::Table::getOptionChainTable(market, CHAIN_EXPIRY);
+        benchmark::DoNotOptimize(rows.data());
+    }
+    setChainCounters(state, 1, chainStrikes(*market, CHAIN_EXPIRY).size());
+}
+BENCHMARK(BM_OptionChainTable);
+
+// Every expiry of the surface, as one batch sorted by expiry
+static void BM_SurfaceChainsBatch(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    std::vector<double> strikes, expiries;
+    for (double expiry : market->volSurface->expiries) {
+        for (double strike : chainStrikes(*market, expiry)) {
+            strikes.push_back(strike);
+            expiries.push_back(expiry);
+        }
+    }
+    ChainSide calls(strikes.size()), puts(strikes.size());
+    OptionChainBatch chain{strikes.data(), expiries.data(), strikes.size()};
+    
+    for (auto _ : state) {
+        Calculator::priceOptionChain(chain, *market, calls.view(), puts.view());
+        benchmark::DoNotOptimize(calls.prices.data());
+    }
+    size_t numExpiries = market->volSurface->expiries.size();
+    setChainCounters(state, numExpiries, strikes.size() / numExpiries);
+}
+BENCHMARK(BM_SurfaceChainsBatch);
+
+// Same, with vols read from a frozen surface (freezing is outside the timed loop)
+static void BM_SurfaceChainsBatchFrozen(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto frozen = market->volSurface->freeze();
+    std::vector<double> strikes, expiries;
+    for (double expiry : market->volSurface->expiries) {
+        for (double strike : chainStrikes(*market, expiry)) {
+            strikes.push_back(strike);
+            expiries.push_back(expiry);
+        }
+    }
+    ChainSide calls(strikes.size()), puts(strikes.size());
+    OptionChainBatch chain{strikes.data(), expiries.data(), strikes.size()};
+    
+    for (auto _ : state) {
+        Calculator::priceOptionChain(chain, *market, frozen, calls.view(), puts.view());
+        benchmark::DoNotOptimize(calls.prices.data());
+    }
+    size_t numExpiries = market->volSurface->expiries.size();
+    setChainCounters(state, numExpiries, strikes.size() / numExpiries);
+}
+BENCHMARK(BM_SurfaceChainsBatchFrozen);
+
+// Portfolio risk: vector of Security pointers, dynamic_cast and scalar Greeks per leg ...
+static void BM_PortfolioRiskPerPosition(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto book = omm::bench::makeBook<std::vector<Position>>(*market, static_cast<std::size_t>(state.range(0)), UNIT_BOOK);
+    std::vector<std::shared_ptr<Security>> securities;
+    for (const auto& position : book) securities.push_back(position.security);
+    
+    for (auto _ : state) {
+        Risk risk = Calculator::calculatePortfolioRisk(securities, *market);
+        benchmark::DoNotOptimize(&risk);
+    }
+    setPositionCounters(state, book.size());
+}
+BENCHMARK(BM_PortfolioRiskPerPosition)->Arg(10000)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+// ... against the columnar Portfolio priced by the batch kernel per expiry bucket
+static void BM_PortfolioRiskColumnar(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto book = omm::bench::makeBook<std::vector<Position>>(*market, static_cast<std::size_t>(state.range(0)), UNIT_BOOK);
+    Portfolio portfolio = Portfolio::fromPositions(book);
+    FrozenVolSurface frozen = market->volSurface->freeze();
+    
+    for (auto _ : state) {
+        PortfolioRisk risk = Calculator::calculatePortfolioRisk(portfolio, *market, frozen);
+        benchmark::DoNotOptimize(&risk);
+    }
+    setPositionCounters(state, book.size());
+    
+    std::vector<std::shared_ptr<Security>> securities;
+    for (const auto& position : book) securities.push_back(position.security);
+    Risk reference = Calculator::calculatePortfolioRisk(securities, *market);
+    state.counters["relDiff"] = riskRelDiff(Calculator::calculatePortfolioRisk(portfolio, *market).total, reference);
+    state.counters["relDiffFrozen"] = riskRelDiff(
+        Calculator::calculatePortfolioRisk(portfolio, *market, frozen).total, reference);
+    state.counters["buckets"] = static_cast<double>(portfolio.optionBuckets.size());
+}
+BENCHMARK(BM_PortfolioRiskColumnar)->Arg(10000)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+// Columnar book through the general batch pricer (per-leg norm strike, log and both
+// CDFs), weighted outside: what the per-expiry precomputation saves
+static void BM_PortfolioRiskBatchPricer(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto book = omm::bench::makeBook<std::vector<Position>>(*market, static_cast<std::size_t>(state.range(0)), UNIT_BOOK);
+    Portfolio portfolio = Portfolio::fromPositions(book);
+    FrozenVolSurface frozen = market->volSurface->freeze();
+    ChainSide scratch(portfolio.numOptions());
+    
+    for (auto _ : state) {
+        Risk total;
+        for (const auto& bucket : portfolio.optionBuckets) {
+            OptionBatch batch{bucket.strikes.data(), bucket.expiries.data(), bucket.optionTypes.data(), bucket.size()};
+            OptionBatchResult out{nullptr, scratch.deltas.data(), scratch.gammas.data(),
+                                  scratch.vegas.data(), scratch.thetas.data()};
+            Calculator::priceOptionBatch(batch, *market, frozen, out);
+            for (size_t i = 0; i < bucket.size(); ++i) {
+                total.delta += bucket.weights[i] * scratch.deltas[i];
+                total.gamma += bucket.weights[i] * scratch.gammas[i];
+                total.vega += bucket.weights[i] * scratch.vegas[i];
+                total.theta += bucket.weights[i] * scratch.thetas[i];
+            }
+        }
+        benchmark::DoNotOptimize(&total);
+    }
+    setPositionCounters(state, book.size());
+}
+BENCHMARK(BM_PortfolioRiskBatchPricer)->Arg(10000)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+// Full ladder: per-expiry risk plus vega / gamma by norm-strike bucket
+static void BM_PortfolioRiskLadder(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto book = omm::bench::makeBook<std::vector<Position>>(*market, static_cast<std::size_t>(state.range(0)), UNIT_BOOK);
+    Portfolio portfolio = Portfolio::fromPositions(book);
+    FrozenVolSurface frozen = market->volSurface->freeze();
+    
+    for (auto _ : state) {
+        RiskLadder ladder = Calculator::calculateRiskLadder(portfolio, *market, frozen);
+        benchmark::DoNotOptimize(&ladder);
+    }
+    setPositionCounters(state, book.size());
+    
+    // Ladder rows add up to the expiry totals
+    RiskLadder ladder = Calculator::calculateRiskLadder(portfolio, *market, frozen);
+    double worst = 0.0;
+    for (size_t e = 0; e < ladder.byExpiry.size(); ++e) {
+        double vega = 0.0, gamma = 0.0;
+        for (size_t k = 0; k < ladder.spec.numBuckets; ++k) {
+            vega += ladder.vegaAt(e, k);
+            gamma += ladder.gammaAt(e, k);
+        }
+        const Risk& risk = ladder.byExpiry[e].risk;
+        worst = std::max(worst, std::abs(vega - risk.vega) / std::max(1.0, std::abs(risk.vega)));
+        worst = std::max(worst, std::abs(gamma - risk.gamma) / std::max(1.0, std::abs(risk.gamma)));
+    }
+    state.counters["ladderRelDiff"] = worst;
+}
+BENCHMARK(BM_PortfolioRiskLadder)->Arg(10000)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,253 @@
+#include "benchutils.hpp"
+#include "analytics/chainexport.hpp"
+#include "analytics/outputbuffer.hpp"
+#include "analytics/table.hpp"
+#include "core/workers/simulator.hpp"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace omm::core;
+using namespace omm::core::models;
+using namespace omm::core::workers;
+using namespace omm::analytics;
+
+// Every heap allocation of the process, for the allocs/step counter
+namespace {
+std::atomic<std::size_t> allocCount{0};
+}  // namespace
+
+void* operator new(std::size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+constexpr std::size_t NUM_STEPS = 100;
+
+// Simulated markets and the chains of every expiry of each
+struct Run {
+    std::vector<std::shared_ptr<Market>> markets;
+    std::vector<std::vector<OptionChainRow>> chains;  // step-major, expiry-minor
+    std::size_t numRows = 0;
+};
+
+const Run& simulatedRun() {
+    static const Run run = [] {
+        Run result;
+        auto market = omm::bench::makeMarket();
+        for (std::size_t i = 0; i < NUM_STEPS; ++i) {
+            market = Simulator::simulateNextMarket(market);
+            result.markets.push_back(market);
+            for (double expiry : market->volSurface->expiries) {
+                result.chains.push_back(Table::getOptionChainTable(market, expiry));
+                result.numRows += result.chains.back().size();
+            }
+        }
+        return result;
+    }();
+    return run;
+}
+
+std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::size_t fileSize(const std::string& path) {
+    return static_cast<std::size_t>(std::filesystem::file_size(path));
+}
+
+std::string fileContents(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void setRates(benchmark::State& state, std::size_t rowsPerIteration, std::size_t bytes) {
+    state.counters["rows/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * rowsPerIteration), benchmark::Counter::kIsRate);
+    state.counters["MB/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * bytes) / 1e6, benchmark::Counter::kIsRate);
+}
+
+// Table::printOptionChainTable as it was: std::setw columns through an ostream
+void printIostream(std::ostream& out, const std::vector<OptionChainRow>& chain) {
+    out << std::fixed << std::setprecision(4);
+    out << std::string(200, '=') << "\n";
+    out << std::setw(12) << "Call Theta"
+        << std::setw(12) << "Call Vega"
+        << std::setw(12) << "Call Gamma"
+        << std::setw(12) << "Call Delta"
+        << std::setw(12) << "Call Price"
+        << std::setw(12) << "Norm Strike"
+        << std::setw(12) << "Strike"
+        << std::setw(12) << "Fwd Strike"
+        << std::setw(12) << "Impl Vol"
+        << std::setw(12) << "Put Price"
+        << std::setw(12) << "Put Delta"
+        << std::setw(12) << "Put Gamma"
+        << std::setw(12) << "Put Vega"
+        << std::setw(12) << "Put Theta\n";
+    out << std::string(200, '-') << "\n";
+    for (const auto& row : chain) {
+        out << std::setw(12) << row.callTheta
+            << std::setw(12) << row.callVega
+            << std::setw(12) << row.callGamma
+            << std::setw(12) << row.callDelta
+            << std::setw(12) << row.callPrice
+            << std::setw(12) << row.normStrike
+            << std::setw(12) << row.strike
+            << std::setw(12) << row.forwardStrike
+            << std::setw(12) << row.impliedVol
+            << std::setw(12) << row.putPrice
+            << std::setw(12) << row.putDelta
+            << std::setw(12) << row.putGamma
+            << std::setw(12) << row.putVega
+            << std::setw(12) << row.putTheta << "\n";
+    }
+    out << std::string(200, '=') << "\n";
+}
+
+void printTablesIostream(const Run& run, const std::string& path) {
+    std::ofstream out(path);
+    for (const auto& chain : run.chains) printIostream(out, chain);
+}
+
+void printTablesBuffered(const Run& run, const std::string& path) {
+    OutputBuffer out;
+    out.open(path);
+    for (const auto& chain : run.chains) Table::writeOptionChainTable(out, chain);
+    out.close();
+}
+
+}  // namespace
+
+// Baseline: the console tables of every chain of 100 steps (26 expiries of 81 strikes)
+// through iostreams and setw, into a file
+static void BM_TableIostream(benchmark::State& state) {
+    const Run& run = simulatedRun();
+    std::string path = tempPath("omm_tables_iostream.txt");
+    for (auto _ : state) {
+        printTablesIostream(run, path);
+    }
+    setRates(state, run.numRows, fileSize(path));
+}
+
+// The same tables through Table::writeOptionChainTable; identical is 1 when the file
+// matches the iostream one byte for byte
+static void BM_TableBuffered(benchmark::State& state) {
+    const Run& run = simulatedRun();
+    std::string path = tempPath("omm_tables_buffered.txt");
+    for (auto _ : state) {
+        printTablesBuffered(run, path);
+    }
+    setRates(state, run.numRows, fileSize(path));
+    std::string baselinePath = tempPath("omm_tables_iostream.txt");
+    printTablesIostream(run, baselinePath);
+    state.counters["identical"] = fileContents(path) == fileContents(baselinePath) ? 1.0 : 0.0;
+}
+
+// Baseline: pricing each step's surface with the allocating getOptionChainTable and
+// writing it as CSV through an ofstream at full precision
+static void BM_ExportIostream(benchmark::State& state) {
+    const Run& run = simulatedRun();
+    std::string path = tempPath("omm_chains_iostream.csv");
+    std::size_t allocs = 0;
+    for (auto _ : state) {
+        std::ofstream out(path);
+        out << std::setprecision(17) << "time,expiry,callTheta,callVega,callGamma,callDelta,callPrice,normStrike,"
+            << "strike,forwardStrike,impliedVol,putPrice,putDelta,putGamma,putVega,putTheta\n";
+        std::size_t count = allocCount.load();
+        double fields[OptionChainColumns::NUM_FIELDS];
+        for (const auto& market : run.markets) {
+            for (double expiry : market->volSurface->expiries) {
+                for (const OptionChainRow& row : Table::getOptionChainTable(market, expiry)) {
+                    std::memcpy(fields, &row, sizeof(row));
+                    out << market->time << ',' << expiry;
+                    for (double field : fields) out << ',' << field;
+                    out << '\n';
+                }
+            }
+        }
+        allocs = allocCount.load() - count;
+    }
+    setRates(state, run.numRows, fileSize(path));
+    state.counters["allocs/step"] = static_cast<double>(allocs) / NUM_STEPS;
+}
+
+// ChainExporter::exportSurface for every step into a file. range(0) = format
+// (0 = CSV, 1 = columnar), range(1) = CSV digits after the point (-1 = shortest
+// round trip). allocs/step counts the steps after the first.
+static void BM_ExportSurface(benchmark::State& state) {
+    const Run& run = simulatedRun();
+    auto format = state.range(0) == 0 ? ExportFormat::CSV : ExportFormat::COLUMNAR;
+    auto precision = static_cast<int>(state.range(1));
+    std::string path = tempPath(format == ExportFormat::CSV ? "omm_chains.csv" : "omm_chains.bin");
+    std::size_t allocs = 0;
+    std::uint64_t bytes = 0;
+    for (auto _ : state) {
+        ChainExporter exporter(format, precision);
+        exporter.open(path, run.markets.front()->asset.symbol);
+        exporter.exportSurface(*run.markets.front());
+        std::size_t count = allocCount.load();
+        for (std::size_t i = 1; i < run.markets.size(); ++i) {
+            exporter.exportSurface(*run.markets[i]);
+        }
+        allocs = allocCount.load() - count;
+        exporter.close();
+        bytes = exporter.bytesWritten();
+    }
+    setRates(state, run.numRows, static_cast<std::size_t>(bytes));
+    state.counters["allocs/step"] = static_cast<double>(allocs) / (NUM_STEPS - 1);
+}
+
+// CSV into a pipe read by another process, as a live feed would be consumed
+static void BM_ExportPipe(benchmark::State& state) {
+    const Run& run = simulatedRun();
+    std::uint64_t bytes = 0;
+    for (auto _ : state) {
+        std::FILE* pipe = popen("cat > /dev/null", "w");
+        if (!pipe) {
+            state.SkipWithError("popen failed");
+            return;
+        }
+        ChainExporter exporter;
+        exporter.attach(pipe, run.markets.front()->asset.symbol);
+        for (const auto& market : run.markets) {
+            exporter.exportSurface(*market);
+            exporter.flush();
+        }
+        exporter.close();
+        bytes = exporter.bytesWritten();
+        pclose(pipe);
+    }
+    setRates(state, run.numRows, static_cast<std::size_t>(bytes));
+}
+
+BENCHMARK(BM_TableIostream)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_TableBuffered)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ExportIostream)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ExportSurface)->Args({0, -1})->Args({0, 6})->Args({1, -1})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ExportPipe)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
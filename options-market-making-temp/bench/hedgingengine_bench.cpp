@@ -0,0 +1,166 @@
+#include "benchutils.hpp"
+#include "core/config.hpp"
+#include "core/utils.hpp"
+#include "core/workers/calculator.hpp"
+#include "engine/hedgingengine.hpp"
+#include "sim/latentstate.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+using namespace omm::core;
+using namespace omm::engine;
+using namespace omm::lob;
+
+namespace {
+
+constexpr std::uint64_t SEED = 20240917;
+constexpr std::size_t NUM_STEPS = 20000;       // 100ms apart
+constexpr std::size_t INITIAL_LEGS = 2000;
+constexpr double FUTURE_EXPIRY = 30.0;
+constexpr int LOT_SIZE = 10;
+
+struct OptionFill {
+    models::Option option;
+    int quantity;
+};
+
+// Spot path, an option fill stream and the future book's depth per step
+struct Scenario {
+    std::shared_ptr<models::Market> market = omm::bench::makeMarket();
+    models::FrozenVolSurface surface = market->volSurface->freeze();
+    InstrumentRegistry registry = InstrumentRegistry::fromVolSurface(*market->volSurface, market->spot, {"30"});
+    std::vector<OptionFill> initialLegs;
+    std::vector<double> spots;
+    std::vector<std::vector<OptionFill>> fills;  // per step
+    std::vector<Quantity> depth;                 // per step, lots per level of the future book
+    
+    Scenario() {
+        std::mt19937_64 rng(SEED);
+        std::uniform_int_distribution<std::size_t> series(0, registry.numOptions() - 1);
+        std::uniform_int_distribution<int> quantity(-20, 20);
+        auto randomFill = [&]() {
+            InstrumentInfo info = registry.describe(static_cast<InstrumentId>(series(rng)));
+            return OptionFill{models::Option(market->asset, info.strike, info.expiry, info.optionType, LOT_SIZE), quantity(rng)};
+        };
+        for (std::size_t i = 0; i < INITIAL_LEGS; ++i) {
+            initialLegs.push_back(randomFill());
+        }
+        
+        omm::sim::LatentState latent(workers::MarketState{models::Regime::CALM, market->spot, Config::VIX}, SEED);
+        std::poisson_distribution<int> numFills(0.5);
+        std::uniform_int_distribution<Quantity> lots(1, 20);
+        for (std::size_t step = 1; step <= NUM_STEPS; ++step) {
+            spots.push_back(latent.sampleAt(static_cast<omm::sim::Timestamp>(step) * 100 * omm::sim::NS_PER_MILLISECOND).spot);
+            fills.emplace_back();
+            for (int f = numFills(rng); f > 0; --f) fills.back().push_back(randomFill());
+            depth.push_back(lots(rng));
+        }
+    }
+    
+    std::vector<BookSpec> bookSpecs(const HedgeParams& params) const {
+        double fair = Utils::getForwardPrice(market->spot, market->interestRate, FUTURE_EXPIRY);
+        auto center = static_cast<Price>(std::lround(fair / params.tickSize));
+        std::vector<BookSpec> specs(registry.size(), BookSpec{0, 63, 4});
+        specs[registry.futureId(0)] = BookSpec{center - 4000, center + 4000, 256};
+        return specs;
+    }
+};
+
+const Scenario& scenario() {
+    static const Scenario instance;
+    return instance;
+}
+
+// Ten levels of depth either side of the future's fair, replacing the previous ones
+void refreshDepth(BookManager& books, InstrumentId future, Price fair, Quantity lots, std::vector<Fill>& fills) {
+    OrderBook& book = books.book(future);
+    book.clear();
+    OrderId id = 1;
+    for (Price level = 1; level <= 10; ++level) {
+        book.add(OrderRequest{id++, Side::BUY, OrderType::LIMIT, TimeInForce::GTC, fair - level, lots}, fills);
+        book.add(OrderRequest{id++, Side::SELL, OrderType::LIMIT, TimeInForce::GTC, fair + level, lots}, fills);
+    }
+}
+
+}  // namespace
+
+// Delta hedging over 20000 steps (100ms apart) of a 2000-leg book taking Poisson option
+// fills, hedged with a future through its book. range(0) = 1 keeps the Greeks
+// incrementally (fills add their Greeks, spot rolls delta by gamma); 0 recomputes
+// full-book risk with calculatePortfolioRisk every step. Only the risk and hedge
+// work is timed. deltaErr is the largest gap to the exact delta, checked every 100
+// steps; the incremental run resyncs every 6000 steps (10 simulated minutes).
+static void BM_HedgingStep(benchmark::State& state) {
+    using Clock = std::chrono::steady_clock;
+    
+    bool incremental = state.range(0) != 0;
+    const Scenario& s = scenario();
+    HedgeParams params;
+    params.deltaBand = 250.0;
+    params.futureLotSize = LOT_SIZE;
+    params.feePerLot = 0.5;
+    InstrumentId future = s.registry.futureId(0);
+    
+    double seconds = 0.0;
+    double maxError = 0.0;
+    HedgeStats stats;
+    std::vector<Fill> scratch;
+    for (auto _ : state) {
+        state.PauseTiming();
+        BookManager books(s.registry, s.bookSpecs(params));
+        models::Market market = *s.market;
+        models::Future hedgeFuture(market.asset, "30", LOT_SIZE);
+        models::Portfolio portfolio;
+        for (const OptionFill& leg : s.initialLegs) portfolio.addOption(leg.option, leg.quantity);
+        HedgingEngine hedger(books, future, FUTURE_EXPIRY, market.spot, market.interestRate, params);
+        hedger.resync(workers::Calculator::calculatePortfolioRisk(portfolio, market, s.surface).total);
+        maxError = 0.0;
+        state.ResumeTiming();
+        
+        for (std::size_t step = 0; step < NUM_STEPS; ++step) {
+            market.spot = s.spots[step];
+            double futureBefore = hedger.futurePosition();
+            refreshDepth(books, future, hedger.futureFairTicks(), s.depth[step], scratch);
+            
+            auto begin = Clock::now();
+            for (const OptionFill& fill : s.fills[step]) {
+                portfolio.addOption(fill.option, fill.quantity);
+                if (incremental) hedger.onOptionFill(workers::Calculator::calculateRisk(fill.option, market), fill.quantity, LOT_SIZE);
+            }
+            hedger.onSpot(market.spot);
+            if (!incremental) {
+                hedger.resync(workers::Calculator::calculatePortfolioRisk(portfolio, market, s.surface).total);
+            }
+            hedger.hedge();
+            seconds += std::chrono::duration<double>(Clock::now() - begin).count();
+            
+            auto hedged = static_cast<int>(std::lround(hedger.futurePosition() - futureBefore));
+            if (hedged != 0) portfolio.addFuture(hedgeFuture, hedged);
+            if (step % 100 == 99) {
+                double exact = workers::Calculator::calculatePortfolioRisk(portfolio, market, s.surface).total.delta;
+                maxError = std::max(maxError, std::abs(exact - hedger.risk().delta));
+            }
+            if (incremental && step % 6000 == 5999) {
+                hedger.resync(workers::Calculator::calculatePortfolioRisk(portfolio, market, s.surface).total);
+            }
+        }
+        stats = hedger.stats();
+        benchmark::DoNotOptimize(&hedger);
+    }
+    
+    double steps = static_cast<double>(state.iterations() * NUM_STEPS);
+    double lots = static_cast<double>(stats.lotsTraded);
+    double slippagePerLot = lots > 0.0 ? stats.slippage / lots : 0.0;
+    state.counters["steps/s"] = steps / seconds;
+    state.counters["hedges"] = static_cast<double>(stats.hedges);
+    state.counters["lots"] = lots;
+    state.counters["slippage/lot"] = slippagePerLot;
+    state.counters["cost"] = stats.cost();
+    state.counters["deltaErr"] = maxError;
+}
+
+BENCHMARK(BM_HedgingStep)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
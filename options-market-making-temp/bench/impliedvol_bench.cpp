@@ -0,0 +1,240 @@
+#include "benchutils.hpp"
+#include "core/workers/calculator.hpp"
+#include "core/workers/impliedvol.hpp"
+#include "lob/instrumentregistry.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace omm::core;
+using namespace omm::core::models;
+using namespace omm::core::workers;
+
+namespace {
+
+constexpr std::uint64_t SEED = 20240917;
+constexpr std::size_t NUM_STRESS = 100000;
+constexpr double BISECTION_LOW = 1e-4;
+constexpr double BISECTION_HIGH = 10.0;
+constexpr double BISECTION_TOLERANCE = 1e-12;  // on vol
+
+// Black price with the Calculator's forward and discounting, in double precision
+// throughout (erfc keeps deep out-of-the-money prices exact)
+double blackPrice(double vol, double strike, double expiry, OptionType optionType, const Market& market) {
+    double tte = expiry / 365.0;
+    double forward = market.spot * std::exp(market.interestRate * tte);
+    double df = std::exp(-market.interestRate * tte);
+    double stdDev = vol * std::sqrt(tte);
+    double d1 = std::log(forward / strike) / stdDev + 0.5 * stdDev;
+    double d2 = d1 - stdDev;
+    auto cdf = [](double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); };
+    if (optionType == OptionType::CALL) {
+        return df * (forward * cdf(d1) - strike * cdf(d2));
+    }
+    return df * (strike * cdf(-d2) - forward * cdf(-d1));
+}
+
+// Baseline: bisection on the Black price over [1e-4, 10]
+double bisectionVol(double price, double strike, double expiry, OptionType optionType, const Market& market) {
+    double lo = BISECTION_LOW;
+    double hi = BISECTION_HIGH;
+    while (hi - lo > BISECTION_TOLERANCE) {
+        double mid = 0.5 * (lo + hi);
+        if (blackPrice(mid, strike, expiry, optionType, market) < price) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return 0.5 * (lo + hi);
+}
+
+// Quotes with the vols that produced them
+struct Quotes {
+    std::vector<double> prices, strikes, expiries, vols;
+    std::vector<OptionType> optionTypes;
+    
+    void add(double price, double strike, double expiry, OptionType optionType, double vol) {
+        prices.push_back(price);
+        strikes.push_back(strike);
+        expiries.push_back(expiry);
+        optionTypes.push_back(optionType);
+        vols.push_back(vol);
+    }
+    
+    ImpliedVolBatch view() const {
+        return ImpliedVolBatch{prices.data(), strikes.data(), expiries.data(), optionTypes.data(), prices.size()};
+    }
+};
+
+// Full chain of the standard market (26 expiries x 81 strikes x call/put), priced
+// off its surface
+const Quotes& chainQuotes() {
+    static const Quotes quotes = [] {
+        auto market = omm::bench::makeMarket();
+        auto registry = omm::lob::InstrumentRegistry::fromVolSurface(*market->volSurface, market->spot);
+        Quotes q;
+        for (std::size_t id = 0; id < registry.numOptions(); ++id) {
+            auto info = registry.describe(static_cast<omm::lob::InstrumentId>(id));
+            Option option(market->asset, info.strike, info.expiry, info.optionType, 1);
+            double vol = Calculator::getOptionPricerInputs(option, *market).sigma;
+            q.add(blackPrice(vol, info.strike, info.expiry, info.optionType, *market), info.strike, info.expiry,
+                  info.optionType, vol);
+        }
+        return q;
+    }();
+    return quotes;
+}
+
+// Random quotes well beyond the chain: vols 2% to 300%, 1 day to 2 years, strikes
+// out to +-4 standard deviations; sorted by expiry as a chain would be
+const Quotes& stressQuotes() {
+    static const Quotes quotes = [] {
+        auto market = omm::bench::makeMarket();
+        std::mt19937_64 rng(SEED);
+        std::uniform_real_distribution<double> logVol(std::log(0.02), std::log(3.0));
+        std::uniform_real_distribution<double> expiryDays(1.0, 730.0);
+        std::uniform_real_distribution<double> deviations(-4.0, 4.0);
+        std::bernoulli_distribution call(0.5);
+        std::vector<double> expiries(NUM_STRESS);
+        for (double& expiry : expiries) expiry = std::round(expiryDays(rng));
+        std::sort(expiries.begin(), expiries.end());
+        Quotes q;
+        for (double expiry : expiries) {
+            double vol = std::exp(logVol(rng));
+            double tte = expiry / 365.0;
+            double forward = market->spot * std::exp(market->interestRate * tte);
+            double strike = forward * std::exp(deviations(rng) * vol * std::sqrt(tte));
+            OptionType optionType = call(rng) ? OptionType::CALL : OptionType::PUT;
+            q.add(blackPrice(vol, strike, expiry, optionType, *market), strike, expiry, optionType, vol);
+        }
+        return q;
+    }();
+    return quotes;
+}
+
+const Quotes& quoteSet(int64_t which) {
+    return which == 0 ? chainQuotes() : stressQuotes();
+}
+
+// Largest vol and relative reprice errors, and how many quotes did not solve
+void reportAccuracy(benchmark::State& state, const Quotes& quotes, const std::vector<double>& vols,
+                    const std::vector<ImpliedVolStatus>* statuses) {
+    auto market = omm::bench::makeMarket();
+    double maxVolError = 0.0;
+    double maxPriceError = 0.0;
+    std::size_t failed = 0;
+    for (std::size_t i = 0; i < quotes.prices.size(); ++i) {
+        if (statuses && (*statuses)[i] != ImpliedVolStatus::OK) {
+            ++failed;
+            continue;
+        }
+        double price = blackPrice(vols[i], quotes.strikes[i], quotes.expiries[i], quotes.optionTypes[i], *market);
+        maxVolError = std::max(maxVolError, std::abs(vols[i] - quotes.vols[i]));
+        maxPriceError = std::max(maxPriceError, std::abs(price - quotes.prices[i]) / quotes.prices[i]);
+    }
+    state.counters["volErr"] = maxVolError;
+    state.counters["priceRelErr"] = maxPriceError;
+    state.counters["failed"] = static_cast<double>(failed);
+}
+
+}  // namespace
+
+// Batch solver over a quote set: range(0) = 0 for the 4212-quote chain, 1 for 100k
+// random quotes in the wings
+static void BM_ImpliedVolBatch(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    const Quotes& quotes = quoteSet(state.range(0));
+    std::vector<double> vols(quotes.prices.size());
+    std::vector<ImpliedVolStatus> statuses(quotes.prices.size());
+    
+    for (auto _ : state) {
+        ImpliedVolSolver::impliedVolBatch(quotes.view(), *market, ImpliedVolResult{vols.data(), statuses.data()});
+        benchmark::DoNotOptimize(vols.data());
+    }
+    
+    state.counters["calls/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * quotes.prices.size()), benchmark::Counter::kIsRate);
+    reportAccuracy(state, quotes, vols, &statuses);
+}
+
+// Scalar entry point, one quote at a time
+static void BM_ImpliedVolScalar(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    const Quotes& quotes = quoteSet(state.range(0));
+    std::vector<double> vols(quotes.prices.size());
+    
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < quotes.prices.size(); ++i) {
+            vols[i] = ImpliedVolSolver::impliedVol(quotes.prices[i], quotes.strikes[i], quotes.expiries[i],
+                                                   quotes.optionTypes[i], *market);
+        }
+        benchmark::DoNotOptimize(vols.data());
+    }
+    
+    state.counters["calls/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * quotes.prices.size()), benchmark::Counter::kIsRate);
+    reportAccuracy(state, quotes, vols, nullptr);
+}
+
+// Baseline: bisection to 1e-12 in vol on the scalar Black price
+static void BM_ImpliedVolBisection(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    const Quotes& quotes = quoteSet(state.range(0));
+    std::vector<double> vols(quotes.prices.size());
+    
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < quotes.prices.size(); ++i) {
+            vols[i] = bisectionVol(quotes.prices[i], quotes.strikes[i], quotes.expiries[i], quotes.optionTypes[i],
+                                   *market);
+        }
+        benchmark::DoNotOptimize(vols.data());
+    }
+    
+    state.counters["calls/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * quotes.prices.size()), benchmark::Counter::kIsRate);
+    reportAccuracy(state, quotes, vols, nullptr);
+}
+
+// Prices no vol can produce, and bad inputs, are flagged rather than solved
+static void BM_ImpliedVolRejects(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    const Quotes& chain = chainQuotes();
+    Quotes quotes;
+    for (std::size_t i = 0; i < chain.prices.size(); ++i) {
+        double price = chain.prices[i];
+        switch (i % 4) {
+            case 0: price = -1.0; break;                           // below intrinsic
+            case 1: price = chain.strikes[i] + market->spot; break; // above both bounds
+            case 2: price = std::nan(""); break;
+            default: break;
+        }
+        quotes.add(price, chain.strikes[i], chain.expiries[i], chain.optionTypes[i], chain.vols[i]);
+    }
+    std::vector<double> vols(quotes.prices.size());
+    std::vector<ImpliedVolStatus> statuses(quotes.prices.size());
+    
+    for (auto _ : state) {
+        ImpliedVolSolver::impliedVolBatch(quotes.view(), *market, ImpliedVolResult{vols.data(), statuses.data()});
+        benchmark::DoNotOptimize(vols.data());
+    }
+    
+    auto count = [&](ImpliedVolStatus status) {
+        return static_cast<double>(std::count(statuses.begin(), statuses.end(), status));
+    };
+    state.counters["calls/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * quotes.prices.size()), benchmark::Counter::kIsRate);
+    state.counters["ok"] = count(ImpliedVolStatus::OK);
+    state.counters["belowIntrinsic"] = count(ImpliedVolStatus::BELOW_INTRINSIC);
+    state.counters["aboveMax"] = count(ImpliedVolStatus::ABOVE_MAXIMUM);
+    state.counters["invalid"] = count(ImpliedVolStatus::INVALID_INPUT);
+}
+
+BENCHMARK(BM_ImpliedVolBatch)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ImpliedVolScalar)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ImpliedVolBisection)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ImpliedVolRejects)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,191 @@
+#include "benchutils.hpp"
+#include "lob/orderbook.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <random>
+
+using namespace omm::lob;
+
+namespace {
+
+constexpr Price MIN_PRICE = 0;
+constexpr Price MAX_PRICE = 20000;
+constexpr Price MID_PRICE = 10000;
+constexpr std::size_t MAX_ORDERS = 1 << 17;
+constexpr std::uint64_t SEED = 20240917;
+
+enum class OpType : std::uint8_t { ADD, CANCEL, REPLACE };
+
+struct Op {
+    OpType type;
+    OrderRequest order;  // id, price and quantity are reused by cancel and replace
+};
+
+// Synthetic flow around a drifting mid: 60% limit adds within 20 ticks of the mid (a
+// tenth of them hidden), 10% market / IOC / FOK takers, 25% cancels and 5% replaces
+// of live orders. A reference book run alongside keeps cancels and replaces pointed
+// at orders that are still resting.
+std::vector<Op> makeFlow(std::size_t numOps) {
+    std::mt19937_64 rng(SEED);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::uniform_int_distribution<Price> offset(0, 20);
+    std::uniform_int_distribution<Quantity> lots(1, 10);
+    
+    OrderBook reference(MIN_PRICE, MAX_PRICE, MAX_ORDERS);
+    std::vector<Fill> fills;
+    std::vector<OrderId> live;
+    std::vector<Op> ops;
+    ops.reserve(numOps);
+    
+    Price mid = MID_PRICE;
+    OrderId nextId = 1;
+    while (ops.size() < numOps) {
+        if (uniform(rng) < 0.01) {
+            mid += uniform(rng) < 0.5 ? -1 : 1;
+        }
+        
+        double u = uniform(rng);
+        Op op{OpType::ADD, OrderRequest{nextId, uniform(rng) < 0.5 ? Side::BUY : Side::SELL}};
+        op.order.quantity = lots(rng);
+        
+        if (u < 0.6 || live.empty()) {
+            Price distance = offset(rng);
+            op.order.price = op.order.side == Side::BUY ? mid - 1 - distance : mid + 1 + distance;
+            op.order.hidden = uniform(rng) < 0.1;
+            if (live.size() + 1 >= MAX_ORDERS) continue;
+        } else if (u < 0.7) {
+            double kind = uniform(rng);
+            op.order.type = kind < 0.4 ? OrderType::MARKET : OrderType::LIMIT;
+            op.order.timeInForce = kind < 0.8 ? TimeInForce::IOC : TimeInForce::FOK;
+            op.order.price = op.order.side == Side::BUY ? mid + 2 : mid - 2;
+            op.order.quantity *= 3;
+        } else {
+            // Pick a live order; ids that filled since are dropped lazily
+            std::size_t k = static_cast<std::size_t>(uniform(rng) * static_cast<double>(live.size()));
+            OrderId id = live[k];
+            live[k] = live.back();
+            live.pop_back();
+            if (!reference.contains(id)) continue;
+            
+            op.order.id = id;
+            if (u < 0.95) {
+                op.type = OpType::CANCEL;
+            } else {
+                op.type = OpType::REPLACE;
+                live.push_back(id);
+                Price distance = offset(rng);
+                op.order.price = op.order.side == Side::BUY ? mid - 1 - distance : mid + 1 + distance;
+            }
+        }
+        
+        fills.clear();
+        if (op.type == OpType::ADD) {
+            ++nextId;
+            if (reference.add(op.order, fills).status == OrderStatus::RESTING) live.push_back(op.order.id);
+        } else if (op.type == OpType::CANCEL) {
+            reference.cancel(op.order.id);
+        } else {
+            reference.replace(op.order.id, op.order.price, op.order.quantity, fills);
+        }
+        ops.push_back(op);
+    }
+    return ops;
+}
+
+const std::vector<Op>& flow() {
+    static const std::vector<Op> ops = makeFlow(2000000);
+    return ops;
+}
+
+inline void apply(OrderBook& book, const Op& op, std::vector<Fill>& fills) {
+    fills.clear();
+    switch (op.type) {
+        case OpType::ADD:
+            book.add(op.order, fills);
+            break;
+        case OpType::CANCEL:
+            book.cancel(op.order.id);
+            break;
+        case OpType::REPLACE:
+            book.replace(op.order.id, op.order.price, op.order.quantity, fills);
+            break;
+    }
+}
+
+}  // namespace
+
+// Throughput of a full replay of the synthetic flow
+static void BM_OrderBookReplay(benchmark::State& state) {
+    const auto& ops = flow();
+    OrderBook book(MIN_PRICE, MAX_PRICE, MAX_ORDERS);
+    std::vector<Fill> fills;
+    fills.reserve(256);
+    std::size_t numFills = 0;
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        book.clear();
+        numFills = 0;
+        state.ResumeTiming();
+        
+        for (const Op& op : ops) {
+            apply(book, op, fills);
+            numFills += fills.size();
+        }
+        benchmark::DoNotOptimize(&book);
+    }
+    
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ops.size()));
+    state.counters["fills"] = static_cast<double>(numFills);
+    state.counters["resting"] = static_cast<double>(book.numOrders());
+    state.counters["bookMB"] = static_cast<double>(book.memoryBytes()) / (1 << 20);
+}
+
+// Per-operation latency distribution, each op timed on its own (clock overhead included)
+static void BM_OrderBookLatency(benchmark::State& state) {
+    using Clock = std::chrono::steady_clock;
+    
+    const auto& ops = flow();
+    OrderBook book(MIN_PRICE, MAX_PRICE, MAX_ORDERS);
+    std::vector<Fill> fills;
+    fills.reserve(256);
+    omm::bench::LatencyHistogram histogram;
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        book.clear();
+        histogram.reset();
+        state.ResumeTiming();
+        
+        for (const Op& op : ops) {
+            auto start = Clock::now();
+            apply(book, op, fills);
+            auto end = Clock::now();
+            histogram.record(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        }
+        benchmark::DoNotOptimize(&book);
+    }
+    
+    // Baseline: two back-to-back clock reads
+    omm::bench::LatencyHistogram clockOnly;
+    for (std::size_t i = 0; i < 100000; ++i) {
+        auto start = Clock::now();
+        auto end = Clock::now();
+        clockOnly.record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    }
+    
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ops.size()));
+    state.counters["p50_ns"] = histogram.quantile(0.50);
+    state.counters["p90_ns"] = histogram.quantile(0.90);
+    state.counters["p99_ns"] = histogram.quantile(0.99);
+    state.counters["p999_ns"] = histogram.quantile(0.999);
+    state.counters["max_ns"] = histogram.max();
+    state.counters["clock_p50_ns"] = clockOnly.quantile(0.50);
+}
+
+BENCHMARK(BM_OrderBookReplay)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_OrderBookLatency)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
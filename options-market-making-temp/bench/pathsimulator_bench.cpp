@@ -0,0 +1,192 @@
+#include "benchutils.hpp"
+#include "core/workers/pathsimulator.hpp"
+#include "core/workers/simulator.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+using namespace omm::core;
+using namespace omm::core::models;
+using namespace omm::core::workers;
+
+namespace {
+
+constexpr std::size_t NUM_STEPS = 63;
+constexpr std::uint64_t SEED = 20240917;
+constexpr std::size_t REPLAY_PATHS = 64;
+
+// Replays paths through the single-path dynamics with the engine's shocks
+void checkAgainstSimulator(const std::shared_ptr<Market>& market, const MarketPaths& paths,
+                           benchmark::State& state) {
+    double regimeMismatches = 0.0, maxSpotRelDiff = 0.0, maxVolAbsDiff = 0.0;
+    for (std::size_t path = 0; path < std::min(REPLAY_PATHS, paths.numPaths); ++path) {
+        auto shocks = PathSimulator::generateShocks(paths.seed, path, paths.numSteps);
+        MarketState replay{market->regime, market->spot, market->volSurface->atmOneMonthVolEst};
+        for (std::size_t t = 1; t <= paths.numSteps; ++t) {
+            replay = Simulator::simulateNextState(replay, shocks[t - 1]);
+            regimeMismatches += replay.regime != paths.regime(t, path) ? 1.0 : 0.0;
+            maxSpotRelDiff = std::max(maxSpotRelDiff, std::abs(paths.spot(t, path) / replay.spot - 1.0));
+            maxVolAbsDiff = std::max(maxVolAbsDiff, std::abs(paths.atmOneMonthVol(t, path) - replay.atmOneMonthVol));
+        }
+    }
+    
+    // Full surfaces: simulateNextMarket with the same shocks against a materialized market
+    auto shocks = PathSimulator::generateShocks(paths.seed, 0, paths.numSteps);
+    auto replayMarket = market;
+    for (const auto& shock : shocks) {
+        replayMarket = Simulator::simulateNextMarket(replayMarket, shock);
+    }
+    auto materialized = PathSimulator::materializeMarket(paths, paths.numSteps, 0);
+    double maxSurfaceDiff = 0.0;
+    for (double expiry : replayMarket->volSurface->expiries) {
+        for (double ns = -3.0; ns <= 3.0; ns += 0.5) {
+            maxSurfaceDiff = std::max(maxSurfaceDiff, std::abs(
+                replayMarket->volSurface->getVolNormStrike(ns, expiry) -
+                materialized->volSurface->getVolNormStrike(ns, expiry)));
+        }
+    }
+    
+    state.counters["regimeMismatches"] = regimeMismatches;
+    state.counters["maxSpotRelDiff"] = maxSpotRelDiff;
+    state.counters["maxVolAbsDiff"] = maxVolAbsDiff;
+    state.counters["maxSurfaceDiff"] = maxSurfaceDiff;
+}
+
+// Single-path baseline: one Market and VolSurface allocated per step
+void BM_SimulateNextMarket(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    
+    for (auto _ : state) {
+        auto current = market;
+        for (std::size_t t = 0; t < NUM_STEPS; ++t) {
+            current = Simulator::simulateNextMarket(current);
+        }
+        benchmark::DoNotOptimize(current->spot);
+    }
+    state.counters["pathSteps/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * NUM_STEPS), benchmark::Counter::kIsRate);
+}
+
+// Same steps with the market and its surface updated in place
+void BM_AdvanceMarket(benchmark::State& state) {
+    auto initial = omm::bench::makeMarket();
+    auto shocks = PathSimulator::generateShocks(SEED, 0, NUM_STEPS);
+    
+    Market current;
+    for (auto _ : state) {
+        state.PauseTiming();
+        current = *initial;
+        current.volSurface = std::make_shared<VolSurface>(*initial->volSurface);
+        state.ResumeTiming();
+        for (const auto& shock : shocks) {
+            Simulator::advanceMarket(current, shock);
+        }
+        benchmark::DoNotOptimize(&current);
+    }
+    state.counters["pathSteps/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * NUM_STEPS), benchmark::Counter::kIsRate);
+    
+    // Against full reconstruction every step
+    auto replay = initial;
+    for (const auto& shock : shocks) {
+        replay = Simulator::simulateNextMarket(replay, shock);
+    }
+    double maxSurfaceDiff = 0.0;
+    for (size_t i = 0; i < replay->volSurface->smiles.size(); ++i) {
+        const auto& full = replay->volSurface->smiles[i];
+        const auto& incremental = current.volSurface->smiles[i];
+        for (size_t j = 0; j < full.volPoints.size(); ++j) {
+            maxSurfaceDiff = std::max(maxSurfaceDiff, std::abs(full.volPoints[j] - incremental.volPoints[j]));
+            maxSurfaceDiff = std::max(maxSurfaceDiff, std::abs(full.normStrikes[j] - incremental.normStrikes[j]));
+        }
+    }
+    state.counters["maxSurfaceDiff"] = maxSurfaceDiff;
+    state.counters["spotRelDiff"] = std::abs(current.spot / replay->spot - 1.0);
+}
+
+// Scalar state only, still one path at a time
+void BM_SimulateNextState(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto shocks = PathSimulator::generateShocks(SEED, 0, NUM_STEPS);
+    
+    for (auto _ : state) {
+        MarketState current{market->regime, market->spot, market->volSurface->atmOneMonthVolEst};
+        for (const auto& shock : shocks) {
+            current = Simulator::simulateNextState(current, shock);
+        }
+        benchmark::DoNotOptimize(current.spot);
+    }
+    state.counters["pathSteps/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * NUM_STEPS), benchmark::Counter::kIsRate);
+}
+
+void BM_PathSimulator(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    std::size_t numPaths = static_cast<std::size_t>(state.range(0));
+    
+    MarketPaths paths;
+    for (auto _ : state) {
+        paths = PathSimulator::simulatePaths(*market, numPaths, NUM_STEPS, SEED);
+        benchmark::DoNotOptimize(paths.spots.data());
+    }
+    state.counters["pathSteps/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * numPaths * NUM_STEPS), benchmark::Counter::kIsRate);
+    checkAgainstSimulator(market, paths, state);
+}
+
+// Scaling over threads; every run is compared bit for bit with the sequential one
+void BM_PathSimulatorThreads(benchmark::State& state) {
+    constexpr std::size_t numPaths = 50000;
+    auto market = omm::bench::makeMarket();
+    ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+    
+    MarketPaths paths;
+    for (auto _ : state) {
+        paths = PathSimulator::simulatePaths(*market, numPaths, NUM_STEPS, SEED, pool);
+        benchmark::DoNotOptimize(paths.spots.data());
+    }
+    state.counters["pathSteps/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * numPaths * NUM_STEPS), benchmark::Counter::kIsRate);
+    
+    auto sequential = PathSimulator::simulatePaths(*market, numPaths, NUM_STEPS, SEED);
+    bool identical =
+        std::memcmp(paths.spots.data(), sequential.spots.data(), paths.spots.size() * sizeof(double)) == 0 &&
+        std::memcmp(paths.atmOneMonthVols.data(), sequential.atmOneMonthVols.data(),
+                    paths.atmOneMonthVols.size() * sizeof(double)) == 0 &&
+        paths.regimes == sequential.regimes;
+    state.counters["bitIdentical"] = identical ? 1.0 : 0.0;
+}
+
+void threadCounts(benchmark::internal::Benchmark* bench) {
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        bench->Arg(threads);
+    }
+    bench->Arg(maxThreads);
+}
+
+void BM_MaterializeMarket(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto paths = PathSimulator::simulatePaths(*market, 1024, NUM_STEPS, SEED);
+    
+    std::size_t path = 0;
+    for (auto _ : state) {
+        auto materialized = PathSimulator::materializeMarket(paths, NUM_STEPS, path);
+        benchmark::DoNotOptimize(materialized.get());
+        path = (path + 1) % paths.numPaths;
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_SimulateNextMarket);
+BENCHMARK(BM_AdvanceMarket);
+BENCHMARK(BM_SimulateNextState);
+BENCHMARK(BM_PathSimulator)->Arg(1024)->Arg(10000)->Arg(50000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PathSimulatorThreads)->Apply(threadCounts)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MaterializeMarket);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,185 @@
+#include "benchutils.hpp"
+#include "core/workers/calculator.hpp"
+#include "core/workers/pathsimulator.hpp"
+#include "core/workers/simulator.hpp"
+#include "engine/pnlengine.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace omm::core;
+using namespace omm::core::models;
+using namespace omm::core::workers;
+using omm::engine::PnlEngine;
+
+namespace {
+
+constexpr std::size_t DAYS_PER_YEAR = 365;  // steps are calendar days (Config::TIME_STEP)
+
+// Random legs within +-20% of spot, one call and one put in turn
+class LegSource {
+public:
+    Option next(const Market& market, double expiry) {
+        std::uniform_real_distribution<double> strikeDist(0.8 * market.spot, 1.2 * market.spot);
+        OptionType type = (count++ % 2 == 0) ? OptionType::CALL : OptionType::PUT;
+        return Option(market.asset, std::round(strikeDist(rng) / 5.0) * 5.0, expiry, type, 100);
+    }
+    
+    int quantity() {
+        std::uniform_int_distribution<int> quantityDist(1, 10);
+        return (count % 4 < 2 ? 1 : -1) * quantityDist(rng);
+    }
+    
+    double expiry(const Market& market) {
+        const auto& expiries = market.volSurface->expiries;
+        std::uniform_int_distribution<std::size_t> expiryDist(0, expiries.size() - 1);
+        return expiries[expiryDist(rng)];
+    }
+
+private:
+    std::mt19937_64 rng{5};
+    std::size_t count = 0;
+};
+
+// The book without the engine: a Position per leg holding its own Option, re-aged and
+// priced one at a time through Calculator::priceOption and calculateRisk every day,
+// on markets from the allocating simulateNextMarket
+struct PerPositionBook {
+    std::vector<Position> legs;
+    std::vector<double> expiryTimes;
+    std::vector<double> prices;
+    double cash = 0.0;
+    
+    void open(const Option& option, int quantity, const Market& market) {
+        auto leg = std::make_shared<Option>(option);
+        double price = Calculator::priceOption(*leg, market);
+        legs.emplace_back(leg, quantity);
+        expiryTimes.push_back(market.time + option.expiry);
+        prices.push_back(price);
+        cash -= quantity * option.lotSize * price;
+    }
+    
+    // P&L of the day; expired legs are settled at intrinsic and dropped
+    double step(const Market& market, Risk& risk) {
+        double pnl = 0.0;
+        risk = Risk();
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < legs.size(); ++i) {
+            auto& option = static_cast<Option&>(*legs[i].security);
+            double weight = static_cast<double>(legs[i].quantity) * option.lotSize;
+            option.expiry = expiryTimes[i] - market.time;
+            double price;
+            if (option.expiry <= 0.0) {
+                double payoff = option.optionType == OptionType::CALL ? market.spot - option.strike
+                                                                      : option.strike - market.spot;
+                price = std::max(payoff, 0.0);
+                cash += weight * price;
+            } else {
+                price = Calculator::priceOption(option, market);
+                Risk legRisk = Calculator::calculateRisk(option, market);
+                risk.delta += weight * legRisk.delta;
+                risk.gamma += weight * legRisk.gamma;
+                risk.vega += weight * legRisk.vega;
+                risk.theta += weight * legRisk.theta;
+            }
+            pnl += weight * (price - prices[i]);
+            if (option.expiry > 0.0) {
+                legs[kept] = legs[i];
+                expiryTimes[kept] = expiryTimes[i];
+                prices[kept] = price;
+                ++kept;
+            }
+        }
+        legs.resize(kept);
+        expiryTimes.resize(kept);
+        prices.resize(kept);
+        return pnl;
+    }
+};
+
+}  // namespace
+
+// Baseline: one year of a 1000-leg book rolled into the longest expiry as legs expire,
+// one Position at a time
+static void BM_PnlPerPosition(benchmark::State& state) {
+    auto numLegs = static_cast<std::size_t>(state.range(0));
+    auto shocks = PathSimulator::generateShocks(42, 0, DAYS_PER_YEAR);
+    
+    std::size_t legDays = 0;
+    for (auto _ : state) {
+        auto market = omm::bench::makeMarket();
+        LegSource source;
+        PerPositionBook book;
+        for (std::size_t i = 0; i < numLegs; ++i) {
+            book.open(source.next(*market, source.expiry(*market)), source.quantity(), *market);
+        }
+        double total = 0.0;
+        Risk risk;
+        for (const MarketShock& shock : shocks) {
+            market = Simulator::simulateNextMarket(market, shock);
+            legDays += book.legs.size();
+            total += book.step(*market, risk);
+            while (book.legs.size() < numLegs) {
+                book.open(source.next(*market, market->volSurface->expiries.back()), source.quantity(), *market);
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.counters["legDays/s"] = benchmark::Counter(static_cast<double>(legDays), benchmark::Counter::kIsRate);
+}
+
+// Years of the same rolled book through PnlEngine, delta hedged daily with a future
+// traded 1 point through spot. range(0) = legs, range(1) = years. unexplainedShare is
+// sum |unexplained| / sum |total| over the days; reconcileErr the largest gap between
+// a day's P&L and the change of the book's value.
+static void BM_PnlEngine(benchmark::State& state) {
+    auto numLegs = static_cast<std::size_t>(state.range(0));
+    std::size_t numDays = DAYS_PER_YEAR * static_cast<std::size_t>(state.range(1));
+    auto shocks = PathSimulator::generateShocks(42, 0, numDays);
+    
+    std::size_t legDays = 0;
+    double unexplained = 0.0;
+    double total = 0.0;
+    double reconcileErr = 0.0;
+    std::size_t trades = 0;
+    for (auto _ : state) {
+        PnlEngine engine(omm::bench::makeMarket());
+        LegSource source;
+        for (std::size_t i = 0; i < numLegs; ++i) {
+            engine.trade(source.next(engine.market(), source.expiry(engine.market())), source.quantity());
+        }
+        Future hedge(engine.market().asset, "30", 50);
+        unexplained = total = reconcileErr = 0.0;
+        double lastValue = engine.value();
+        for (const MarketShock& shock : shocks) {
+            legDays += engine.numLiveOptions();
+            const auto& day = engine.step(shock);
+            unexplained += std::abs(day.pnl.unexplained);
+            total += std::abs(day.pnl.total);
+            reconcileErr = std::max(reconcileErr, std::abs(day.value - lastValue - day.pnl.total));
+            lastValue = day.value;
+            
+            const Market& market = engine.market();
+            while (engine.numLiveOptions() < numLegs) {
+                engine.trade(source.next(market, market.volSurface->expiries.back()), source.quantity());
+            }
+            auto lots = static_cast<int>(std::lround(-engine.risk().delta / hedge.lotSize));
+            if (lots != 0) engine.trade(hedge, lots, market.spot + (lots > 0 ? 1.0 : -1.0));
+        }
+        trades = engine.archive().size();
+        benchmark::DoNotOptimize(engine.value());
+    }
+    state.counters["legDays/s"] = benchmark::Counter(static_cast<double>(legDays), benchmark::Counter::kIsRate);
+    state.counters["trades"] = static_cast<double>(trades);
+    state.counters["unexplainedShare"] = unexplained / total;
+    state.counters["reconcileErr"] = reconcileErr;
+}
+
+BENCHMARK(BM_PnlPerPosition)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PnlEngine)->ArgsProduct({{1000, 5000}, {1, 3}})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
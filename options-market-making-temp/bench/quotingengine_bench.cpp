@@ -0,0 +1,283 @@
+#include "benchutils.hpp"
+#include "core/config.hpp"
+#include "engine/quotingengine.hpp"
+#include "sim/agents.hpp"
+#include "sim/agentsimulation.hpp"
+#include "sim/latentstate.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+
+using namespace omm::core;
+using namespace omm::engine;
+using namespace omm::lob;
+
+namespace {
+
+constexpr std::uint64_t SEED = 20240917;
+constexpr std::size_t NUM_UPDATES = 2000;
+
+// Full chain of the standard market (26 expiries x 81 strikes x call/put) with its
+// books and a quoting engine
+struct QuotingSetup {
+    std::shared_ptr<models::Market> market = omm::bench::makeMarket();
+    models::FrozenVolSurface surface = market->volSurface->freeze();
+    InstrumentRegistry registry = InstrumentRegistry::fromVolSurface(*market->volSurface, market->spot);
+    QuotingParams params;
+    std::unique_ptr<BookManager> books;
+    std::unique_ptr<QuotingEngine> engine;
+    
+    explicit QuotingSetup(double requoteTicks) {
+        params.requoteTicks = requoteTicks;
+        books = std::make_unique<BookManager>(registry, QuotingEngine::bookSpecs(registry, *market, surface, params));
+        engine = std::make_unique<QuotingEngine>(registry, *books, *market, surface, params);
+        engine->start();
+    }
+};
+
+// Spot from the latent state, sampled every interval
+std::vector<double> spotPath(omm::sim::Timestamp interval) {
+    omm::sim::LatentState latent(workers::MarketState{models::Regime::CALM, Config::SPX_SPOT, Config::VIX}, SEED);
+    std::vector<double> spots;
+    for (std::size_t i = 1; i <= NUM_UPDATES; ++i) {
+        spots.push_back(latent.sampleAt(static_cast<omm::sim::Timestamp>(i) * interval).spot);
+    }
+    return spots;
+}
+
+// Surfaces along a random walk of the ATM vol (5bp steps), frozen up front
+std::vector<models::FrozenVolSurface> volPath(std::size_t count) {
+    auto expiries = Config::getExpiries();
+    std::vector<double> expiriesDouble(expiries.begin(), expiries.end());
+    models::VolSurface surface = *omm::bench::makeMarket()->volSurface;
+    std::vector<models::FrozenVolSurface> frozen;
+    std::mt19937_64 rng(SEED);
+    std::bernoulli_distribution up(0.5);
+    double atmVol = Config::VIX;
+    for (std::size_t i = 0; i < count; ++i) {
+        atmVol += up(rng) ? 0.0005 : -0.0005;
+        surface.rebuild(expiriesDouble, atmVol, -0.02, 0.01, 0.18, Config::SPX_SPOT, Config::INTEREST_RATE);
+        frozen.push_back(surface.freeze());
+    }
+    return frozen;
+}
+
+// Quotes resting in the books at a price other than the engine's bid or ask, or not
+// at the top of a book only the engine quotes into
+std::uint64_t topMismatches(const QuotingEngine& engine, const BookManager& books) {
+    std::uint64_t mismatches = 0;
+    for (InstrumentId series = 0; series < engine.numSeries(); ++series) {
+        const OrderBook& book = books.book(series);
+        if (book.bestBid() != engine.bidPrice(series) || book.bestAsk() != engine.askPrice(series)) ++mismatches;
+    }
+    return mismatches;
+}
+
+// Times update(k) along a path of numUpdates market states, walked forwards and back
+// so consecutive updates stay one step apart
+template <typename Update>
+void timeUpdates(benchmark::State& state, QuotingSetup& setup, std::size_t numUpdates, Update update) {
+    using Clock = std::chrono::steady_clock;
+    omm::bench::LatencyHistogram histogram;
+    
+    bool forwards = true;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < numUpdates; ++i) {
+            std::size_t k = forwards ? i : numUpdates - 1 - i;
+            auto start = Clock::now();
+            update(k);
+            auto end = Clock::now();
+            histogram.record(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        }
+        benchmark::DoNotOptimize(setup.engine.get());
+        forwards = !forwards;
+    }
+    
+    const QuotingStats& totals = setup.engine->totals();
+    double updates = static_cast<double>(histogram.count());
+    double repriced = static_cast<double>(totals.seriesRepriced) / updates;
+    double quotes = static_cast<double>(totals.quotesSent) / updates;
+    state.SetItemsProcessed(static_cast<int64_t>(histogram.count()));
+    state.counters["p50_us"] = histogram.quantile(0.50) * 1e-3;
+    state.counters["p99_us"] = histogram.quantile(0.99) * 1e-3;
+    state.counters["max_us"] = histogram.max() * 1e-3;
+    state.counters["repriced/update"] = repriced;
+    state.counters["quotes/update"] = quotes;
+    state.counters["topMismatches"] = static_cast<double>(topMismatches(*setup.engine, *setup.books));
+}
+
+using AgentSim = omm::sim::AgentSimulation<omm::sim::AggressiveTaker, omm::sim::LatencyArbitrageur, omm::sim::LiquidityProvider>;
+
+// 70% takers, 10% latency arbitrageurs, 20% LPs, each on a few of the options
+void populate(AgentSim& sim, std::size_t numAgents, std::size_t numOptions) {
+    using namespace omm::sim;
+    for (std::size_t a = 0; a < numAgents; ++a) {
+        std::vector<InstrumentId> instruments;
+        for (std::size_t k = 0; k < 8; ++k) {
+            instruments.push_back(static_cast<InstrumentId>((a * 7919 + k * 31) % numOptions));
+        }
+        std::size_t kind = a % 10;
+        if (kind < 7) {
+            AggressiveTaker taker;
+            taker.instruments = instruments;
+            sim.addAgent(taker, LatencyModel::exponential(200 * NS_PER_MICROSECOND, 300 * NS_PER_MICROSECOND));
+        } else if (kind == 7) {
+            LatencyArbitrageur arb;
+            arb.instruments = instruments;
+            sim.addAgent(arb, LatencyModel::uniform(5 * NS_PER_MICROSECOND, 10 * NS_PER_MICROSECOND));
+        } else {
+            LiquidityProvider lp;
+            lp.instruments = instruments;
+            sim.addAgent(lp, LatencyModel::uniform(50 * NS_PER_MICROSECOND, 100 * NS_PER_MICROSECOND));
+        }
+    }
+}
+
+// Invariants of the engine and the books it shares with the agents
+struct SharedBookChecks {
+    std::uint64_t crossedBooks = 0;     // best bid at or above best ask
+    std::uint64_t quoteMismatches = 0;  // engine quote not resting at its price
+    double inventoryErr = 0.0;          // inventory Greeks vs the position-weighted sum, relative
+    
+    void check(const QuotingEngine& engine, const BookManager& books) {
+        models::Risk sum;
+        models::Risk scale;
+        for (InstrumentId series = 0; series < engine.numSeries(); ++series) {
+            const OrderBook& book = books.book(series);
+            if (book.bestBid() != NO_PRICE && book.bestAsk() != NO_PRICE && book.bestBid() >= book.bestAsk()) {
+                ++crossedBooks;
+            }
+            for (Side side : {Side::BUY, Side::SELL}) {
+                Price price = side == Side::BUY ? engine.bidPrice(series) : engine.askPrice(series);
+                if (price == NO_PRICE) continue;
+                Price best = side == Side::BUY ? book.bestBid() : book.bestAsk();
+                bool behindTop = side == Side::BUY ? best < price : best > price;
+                if (!book.contains(QuotingEngine::quoteId(series, side)) || behindTop || book.totalQuantity(side, price) == 0) {
+                    ++quoteMismatches;
+                }
+            }
+            auto position = static_cast<double>(engine.position(series));
+            models::Risk unit = engine.risk(series);
+            sum.delta += position * unit.delta;
+            sum.vega += position * unit.vega;
+            scale.delta += std::abs(position * unit.delta);
+            scale.vega += std::abs(position * unit.vega);
+        }
+        const models::Risk& inventory = engine.inventory();
+        inventoryErr = std::max({inventoryErr,
+                                 std::abs(inventory.delta - sum.delta) / (1.0 + scale.delta),
+                                 std::abs(inventory.vega - sum.vega) / (1.0 + scale.vega)});
+    }
+};
+
+}  // namespace
+
+// Tick-to-quote: spot update in, every changed quote resting in its book out.
+// range(0) = update interval in ms, range(1) = 1 for incremental requotes, 0 to
+// reprice all 4212 series on every update.
+static void BM_QuotingSpotUpdate(benchmark::State& state) {
+    auto spots = spotPath(state.range(0) * omm::sim::NS_PER_MILLISECOND);
+    QuotingSetup setup(state.range(1) ? 1.0 : 0.0);
+    timeUpdates(state, setup, spots.size(), [&](std::size_t k) { setup.engine->onSpot(spots[k]); });
+}
+
+// New surface on every update (ATM vol moves 5bp), same spot
+static void BM_QuotingVolUpdate(benchmark::State& state) {
+    auto surfaces = volPath(64);
+    QuotingSetup setup(state.range(0) ? 1.0 : 0.0);
+    timeUpdates(state, setup, surfaces.size(), [&](std::size_t k) { setup.engine->onVolSurface(surfaces[k]); });
+}
+
+// One simulated second of the engine quoting 256 options (4 expiries x 32 strikes)
+// into books shared with range(0) agents pricing against its theos. Fills are wired
+// both ways: agents taking quotes reach applyFill, and requotes crossing agents reach
+// deliverMakerFill. The invariants are checked after every event: crossedBooks,
+// quoteMismatches and netPosition (lots over all participants, nonzero if a fill
+// reached only one side) should be 0, inventoryErr ~1e-12.
+static void BM_QuotingWithAgents(benchmark::State& state) {
+    using namespace omm::sim;
+    constexpr std::uint32_t MARKET_TICK = AGENT_EVENT_TYPES;
+    
+    auto market = omm::bench::makeMarket();
+    models::FrozenVolSurface surface = market->volSurface->freeze();
+    InstrumentRegistry registry({4.0, 11.0, 25.0, 53.0}, market->spot - 800.0, 50.0, 32);
+    QuotingParams params;
+    params.halfSpread = 1;  // inside the LPs, so takers reach the engine first
+    // About a tick of skew for a hundred lots of an ATM option
+    params.deltaSkew = 1e-3;
+    params.vegaSkew = 1e-9;
+    
+    SharedBookChecks checks;
+    Quantity netPosition = 0;
+    std::uint64_t engineFills = 0;
+    std::uint64_t externalFills = 0;
+    double maxInventoryDelta = 0.0;
+    
+    for (auto _ : state) {
+        BookManager books(registry, QuotingEngine::bookSpecs(registry, *market, surface, params));
+        QuotingEngine engine(registry, books, *market, surface, params);
+        Scheduler scheduler(SEED);
+        AgentSim sim(books, scheduler, SEED);
+        LatentState latent(workers::MarketState{models::Regime::CALM, market->spot, Config::VIX}, SEED);
+        populate(sim, static_cast<std::size_t>(state.range(0)), registry.numOptions());
+        
+        sim.setExternalFillHandler([&](InstrumentId instrument, const Fill& fill) { engine.applyFill(instrument, fill); });
+        engine.setCounterpartyFillHandler([&](InstrumentId instrument, const Fill& fill) { sim.deliverMakerFill(instrument, fill); });
+        
+        auto updateFair = [&] {
+            for (InstrumentId series = 0; series < engine.numSeries(); ++series) {
+                sim.setFairPrice(series, static_cast<Price>(std::lround(engine.theoValue(series) / params.tickSize)));
+            }
+        };
+        auto handler = [&](const Event& event, Scheduler& s) {
+            if (event.type == MARKET_TICK) {
+                engine.onSpot(latent.sampleAt(event.time).spot);
+                updateFair();
+                sim.publishMarketUpdate();
+                s.scheduleAfter(NS_PER_MILLISECOND, MARKET_TICK, 0);
+            } else {
+                sim(event, s);
+            }
+            checks.check(engine, books);
+            maxInventoryDelta = std::max(maxInventoryDelta, std::abs(engine.inventory().delta));
+        };
+        
+        engine.start();
+        updateFair();
+        sim.start();
+        scheduler.scheduleAt(NS_PER_MILLISECOND, MARKET_TICK, 0);
+        scheduler.run(handler, NS_PER_SECOND);
+        
+        netPosition = 0;
+        for (InstrumentId series = 0; series < engine.numSeries(); ++series) netPosition += engine.position(series);
+        for (const auto& taker : sim.agents<AggressiveTaker>()) netPosition += taker.position;
+        for (const auto& arb : sim.agents<LatencyArbitrageur>()) {
+            for (Quantity position : arb.positions) netPosition += position;
+        }
+        for (const auto& lp : sim.agents<LiquidityProvider>()) {
+            for (const auto& q : lp.quotes) netPosition += q.inventory;
+        }
+        engineFills = engine.totals().fills;
+        externalFills = sim.stats().externalFills;
+    }
+    
+    state.counters["engineFills"] = static_cast<double>(engineFills);
+    state.counters["externalFills"] = static_cast<double>(externalFills);
+    state.counters["maxInventoryDelta"] = maxInventoryDelta;
+    state.counters["crossedBooks"] = static_cast<double>(checks.crossedBooks);
+    state.counters["quoteMismatches"] = static_cast<double>(checks.quoteMismatches);
+    state.counters["inventoryErr"] = checks.inventoryErr;
+    state.counters["netPosition"] = static_cast<double>(netPosition);
+}
+
+BENCHMARK(BM_QuotingSpotUpdate)
+    ->Args({1, 1})->Args({1, 0})->Args({10, 1})->Args({10, 0})->Args({100, 1})->Args({100, 0})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_QuotingVolUpdate)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_QuotingWithAgents)->Arg(200)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,135 @@
+#include "benchutils.hpp"
+#include "core/threadpool.hpp"
+#include "core/workers/calculator.hpp"
+#include "core/workers/scenarioengine.hpp"
+#include "core/workers/simulator.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace omm::core;
+using namespace omm::core::models;
+using namespace omm::core::workers;
+
+namespace {
+
+constexpr std::size_t NUM_LEGS = 10000;
+
+// The book's value one position at a time, as before the scenario engine
+double perPositionValue(const std::vector<Position>& book, const Market& market) {
+    double value = 0.0;
+    for (const auto& position : book) {
+        if (auto* option = dynamic_cast<const Option*>(position.security.get())) {
+            value += position.quantity * option->lotSize * Calculator::priceOption(*option, market);
+        } else if (auto* future = dynamic_cast<const Future*>(position.security.get())) {
+            value += position.quantity * future->lotSize * market.spot;
+        }
+    }
+    return value;
+}
+
+// One cell the old way: a new VolSurface for the scenario and every position priced
+double perPositionPnl(const std::vector<Position>& book, const Market& market, double baseValue, Regime regime,
+                      double spotShock, double volShock) {
+    const auto& params = Simulator::getRegimeParams(regime);
+    Market shocked = market;
+    shocked.volSurface = std::make_shared<VolSurface>(
+        market.volSurface->expiries, market.volSurface->atmOneMonthVolEst + volShock, params.skew,
+        params.convexity, params.volMean, market.spot, market.interestRate);
+    shocked.spot = market.spot * (1.0 + spotShock);
+    return perPositionValue(book, shocked) - baseValue;
+}
+
+void setCellCounters(benchmark::State& state, std::size_t cells) {
+    state.counters["cells/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * cells), benchmark::Counter::kIsRate);
+}
+
+void threadCounts(benchmark::internal::Benchmark* bench) {
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        bench->Arg(threads);
+    }
+    bench->Arg(maxThreads);
+}
+
+}  // namespace
+
+// Baseline on a 5 x 3 grid: a surface per cell and Calculator::priceOption per position
+static void BM_ScenarioGridPerPosition(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto book = omm::bench::makeBook<std::vector<Position>>(*market, NUM_LEGS);
+    auto spec = ScenarioGridSpec::uniform(0.1, 5, 0.05, 3);
+    double baseValue = perPositionValue(book, *market);
+    
+    std::vector<double> pnl;
+    for (auto _ : state) {
+        pnl.clear();
+        for (double volShock : spec.volShocks) {
+            for (double spotShock : spec.spotShocks) {
+                pnl.push_back(perPositionPnl(book, *market, baseValue, market->regime, spotShock, volShock));
+            }
+        }
+        benchmark::DoNotOptimize(pnl.data());
+    }
+    setCellCounters(state, spec.spotShocks.size() * spec.volShocks.size());
+    
+    // Against the engine on the same grid
+    ScenarioResult result = ScenarioEngine::runGrid(Portfolio::fromPositions(book), *market, spec);
+    double maxDiff = 0.0;
+    for (std::size_t cell = 0; cell < pnl.size(); ++cell) maxDiff = std::max(maxDiff, std::abs(pnl[cell] - result.pnl[cell]));
+    state.counters["maxDiff"] = maxDiff;
+}
+
+// 21 x 11 grid (spot +-10%, vol +-5 points) under the market's regime over threads;
+// every run is compared bit for bit with the sequential one
+static void BM_ScenarioGrid(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    Portfolio portfolio = Portfolio::fromPositions(omm::bench::makeBook<std::vector<Position>>(*market, NUM_LEGS));
+    auto spec = ScenarioGridSpec::uniform(0.1, 21, 0.05, 11);
+    ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+    
+    ScenarioResult result;
+    for (auto _ : state) {
+        result = ScenarioEngine::runGrid(portfolio, *market, spec, market->regime, pool);
+        benchmark::DoNotOptimize(result.pnl.data());
+    }
+    setCellCounters(state, result.pnl.size());
+    state.counters["legRevals/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * result.pnl.size() * portfolio.numOptions()), benchmark::Counter::kIsRate);
+    
+    ScenarioResult sequential = ScenarioEngine::runGrid(portfolio, *market, spec);
+    bool identical = std::memcmp(result.pnl.data(), sequential.pnl.data(), result.pnl.size() * sizeof(double)) == 0;
+    state.counters["bitIdentical"] = identical ? 1.0 : 0.0;
+    state.counters["worstPnl"] = result.worst.front().pnl;
+    state.counters["worstSpot"] = result.worst.front().spotShock;
+    state.counters["worstVol"] = result.worst.front().volShock;
+}
+
+// The same grid under every regime's surface parameters in one pass
+static void BM_ScenarioRegimes(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    Portfolio portfolio = Portfolio::fromPositions(omm::bench::makeBook<std::vector<Position>>(*market, NUM_LEGS));
+    auto spec = ScenarioGridSpec::uniform(0.1, 21, 0.05, 11);
+    ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+    
+    std::vector<ScenarioResult> results;
+    for (auto _ : state) {
+        results = ScenarioEngine::runRegimes(portfolio, *market, spec, pool);
+        benchmark::DoNotOptimize(results.data());
+    }
+    setCellCounters(state, results.size() * results.front().pnl.size());
+    state.counters["worstCalm"] = results[0].worst.front().pnl;
+    state.counters["worstStress"] = results[1].worst.front().pnl;
+    state.counters["worstEvent"] = results[2].worst.front().pnl;
+}
+
+BENCHMARK(BM_ScenarioGridPerPosition)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ScenarioGrid)->Apply(threadCounts)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ScenarioRegimes)->Apply(threadCounts)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
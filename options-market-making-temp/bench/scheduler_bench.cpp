@@ -0,0 +1,158 @@
+#include "core/config.hpp"
+#include "sim/latentstate.hpp"
+#include "sim/scheduler.hpp"
+#include <benchmark/benchmark.h>
+#include <queue>
+#include <random>
+
+using namespace omm::sim;
+
+namespace {
+
+constexpr std::uint64_t SEED = 20240917;
+constexpr std::size_t NUM_INCREMENTS = 1 << 16;
+
+// Exponential inter-event gaps (mean 1us) for the hold model
+std::vector<Timestamp> makeIncrements() {
+    std::mt19937_64 rng(SEED);
+    std::exponential_distribution<double> gap(1.0 / static_cast<double>(NS_PER_MICROSECOND));
+    std::vector<Timestamp> increments(NUM_INCREMENTS);
+    for (auto& inc : increments) {
+        inc = 1 + static_cast<Timestamp>(gap(rng));
+    }
+    return increments;
+}
+
+struct Later {
+    bool operator()(const Event& a, const Event& b) const {
+        return a.time > b.time || (a.time == b.time && a.seq > b.seq);
+    }
+};
+
+// Classic hold model: take the earliest event, schedule one a random gap later
+template <typename Queue, typename Top, typename Hold>
+void holdModel(benchmark::State& state, Queue& queue, Top top, Hold hold) {
+    auto increments = makeIncrements();
+    auto size = static_cast<std::size_t>(state.range(0));
+    std::uint64_t seq = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        queue.push(Event{increments[i % NUM_INCREMENTS] * static_cast<Timestamp>(i % 64), seq++, 0, 0, 0});
+    }
+    
+    std::size_t k = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < 1024; ++i) {
+            Event event = top(queue);
+            event.time += increments[k++ & (NUM_INCREMENTS - 1)];
+            event.seq = seq++;
+            hold(queue, event);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+}  // namespace
+
+// pop + push, as a generic handler that schedules later
+static void BM_EventQueueHold(benchmark::State& state) {
+    EventQueue queue;
+    holdModel(state, queue,
+              [](EventQueue& q) { return q.top(); },
+              [](EventQueue& q, const Event& e) { q.pop(); q.push(e); });
+}
+
+// One sift per event, as Scheduler::run when the handler schedules a follow-up
+static void BM_EventQueueReplaceTop(benchmark::State& state) {
+    EventQueue queue;
+    holdModel(state, queue,
+              [](EventQueue& q) { return q.top(); },
+              [](EventQueue& q, const Event& e) { q.replaceTop(e); });
+}
+
+// Binary heap baseline
+static void BM_PriorityQueueHold(benchmark::State& state) {
+    using BinaryHeap = std::priority_queue<Event, std::vector<Event>, Later>;
+    BinaryHeap queue;
+    holdModel(state, queue,
+              [](BinaryHeap& q) { return q.top(); },
+              [](BinaryHeap& q, const Event& e) { q.pop(); q.push(e); });
+}
+
+// Participants exchanging messages through the scheduler: one event in, one message
+// out. Latency models are all constant (range(1) = 0), all uniform (1), all
+// exponential (2) or a mix of the three by participant (3).
+static void BM_SchedulerPingPong(benchmark::State& state) {
+    auto numParticipants = static_cast<ParticipantId>(state.range(0));
+    auto kind = static_cast<ParticipantId>(state.range(1));
+    Scheduler scheduler(SEED);
+    for (ParticipantId p = 0; p < numParticipants; ++p) {
+        switch (kind == 3 ? p % 3 : kind) {
+            case 0: scheduler.setLatency(p, LatencyModel::constant(5 * NS_PER_MICROSECOND)); break;
+            case 1: scheduler.setLatency(p, LatencyModel::uniform(2 * NS_PER_MICROSECOND, 10 * NS_PER_MICROSECOND)); break;
+            default: scheduler.setLatency(p, LatencyModel::exponential(20 * NS_PER_MICROSECOND, 50 * NS_PER_MICROSECOND)); break;
+        }
+    }
+    scheduler.reserve(numParticipants + 1);
+    
+    std::uint64_t checksum = 0;
+    auto handler = [&](const Event& event, Scheduler& s) {
+        checksum += event.payload;
+        ParticipantId next = event.target + 1 == numParticipants ? 0 : event.target + 1;
+        s.send(event.target, event.type, next, event.payload + 1);
+    };
+    
+    constexpr std::size_t EVENTS_PER_RUN = 1 << 20;
+    std::size_t events = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        scheduler.reset();
+        for (ParticipantId p = 0; p < numParticipants; ++p) {
+            scheduler.scheduleAt(static_cast<Timestamp>(p), 0, p, 0);
+        }
+        state.ResumeTiming();
+        
+        // Stop once enough events were delivered
+        std::size_t delivered = 0;
+        auto counted = [&](const Event& event, Scheduler& s) {
+            handler(event, s);
+            if (++delivered == EVENTS_PER_RUN) s.stop();
+        };
+        events += scheduler.run(counted);
+    }
+    benchmark::DoNotOptimize(checksum);
+    
+    double simSeconds = static_cast<double>(scheduler.now()) / static_cast<double>(NS_PER_SECOND);
+    state.SetItemsProcessed(static_cast<int64_t>(events));
+    state.counters["simSeconds"] = simSeconds;
+}
+
+// Latent regime / spot / vol sampled at every event of a Poisson stream (mean gap
+// state.range(0) us) over one simulated trading year
+static void BM_LatentStateSampling(benchmark::State& state) {
+    Timestamp meanGap = state.range(0) * NS_PER_MICROSECOND;
+    auto increments = makeIncrements();
+    omm::core::workers::MarketState initial{omm::core::models::Regime::CALM, omm::core::Config::SPX_SPOT, omm::core::Config::VIX};
+    
+    constexpr std::size_t SAMPLES_PER_RUN = 1 << 20;
+    double spot = 0.0;
+    for (auto _ : state) {
+        LatentState latent(initial, SEED);
+        Timestamp t = 0;
+        for (std::size_t i = 0; i < SAMPLES_PER_RUN; ++i) {
+            t += increments[i & (NUM_INCREMENTS - 1)] * meanGap / NS_PER_MICROSECOND;
+            spot += latent.sampleAt(t).spot;
+        }
+    }
+    benchmark::DoNotOptimize(spot);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(SAMPLES_PER_RUN));
+}
+
+BENCHMARK(BM_EventQueueHold)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_EventQueueReplaceTop)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_PriorityQueueHold)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_SchedulerPingPong)
+    ->Args({64, 0})->Args({64, 1})->Args({64, 2})->Args({64, 3})->Args({4096, 3})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LatentStateSampling)->Arg(1)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
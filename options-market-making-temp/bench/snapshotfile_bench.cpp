@@ -0,0 +1,219 @@
+#include "benchutils.hpp"
+#include "analytics/snapshotfile.hpp"
+#include "analytics/table.hpp"
+#include "core/workers/calculator.hpp"
+#include "core/workers/simulator.hpp"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace omm::core;
+using namespace omm::core::models;
+using namespace omm::core::workers;
+using namespace omm::analytics;
+
+namespace {
+
+constexpr std::size_t NUM_SNAPSHOTS = 1000;
+constexpr std::size_t CALL_PRICE = offsetof(OptionChainRow, callPrice) / sizeof(double);
+constexpr std::size_t STRIKE = offsetof(OptionChainRow, strike) / sizeof(double);
+
+// Simulated markets, each with the option chain of its first expiry
+struct Run {
+    std::vector<std::shared_ptr<Market>> markets;
+    std::vector<std::vector<OptionChainRow>> chains;
+};
+
+const Run& simulatedRun() {
+    static const Run run = [] {
+        Run result;
+        auto market = omm::bench::makeMarket();
+        for (std::size_t i = 0; i < NUM_SNAPSHOTS; ++i) {
+            market = Simulator::simulateNextMarket(market);
+            result.markets.push_back(market);
+            result.chains.push_back(Table::getOptionChainTable(market, market->volSurface->expiries.front()));
+        }
+        return result;
+    }();
+    return run;
+}
+
+std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void writeSnapshots(const Run& run, const std::string& path) {
+    SnapshotWriter writer;
+    writer.open(path, run.markets.front()->asset.symbol);
+    for (std::size_t i = 0; i < run.markets.size(); ++i) {
+        writer.append(*run.markets[i]);
+        writer.appendChain(run.markets[i]->volSurface->expiries.front(), run.chains[i]);
+    }
+    writer.close();
+}
+
+// The same content as text: a knot file with the snapshot's fields repeated on each
+// knot, and a chain file with the snapshot's time and the row's expiry on each row
+void writeCsv(const Run& run, const std::string& knotPath, const std::string& chainPath) {
+    std::ofstream knots(knotPath);
+    std::ofstream chain(chainPath);
+    knots << std::setprecision(17) << "time,regime,spot,rate,atmVol,expiry,normStrike,vol\n";
+    chain << std::setprecision(17) << "time,expiry,callTheta,callVega,callGamma,callDelta,callPrice,normStrike,"
+          << "strike,forwardStrike,impliedVol,putPrice,putDelta,putGamma,putVega,putTheta\n";
+    for (std::size_t i = 0; i < run.markets.size(); ++i) {
+        const Market& market = *run.markets[i];
+        const auto& surface = *market.volSurface;
+        for (std::size_t j = 0; j < surface.expiries.size(); ++j) {
+            const Smile& smile = surface.smiles[j];
+            for (std::size_t k = 0; k < smile.normStrikes.size(); ++k) {
+                knots << market.time << ',' << static_cast<int>(market.regime) << ',' << market.spot << ','
+                      << market.interestRate << ',' << surface.atmOneMonthVolEst << ',' << surface.expiries[j]
+                      << ',' << smile.normStrikes[k] << ',' << smile.volPoints[k] << '\n';
+            }
+        }
+        double fields[OptionChainColumns::NUM_FIELDS];
+        for (const OptionChainRow& row : run.chains[i]) {
+            std::memcpy(fields, &row, sizeof(row));
+            chain << market.time << ',' << surface.expiries.front();
+            for (double field : fields) chain << ',' << field;
+            chain << '\n';
+        }
+    }
+}
+
+// Parse every field of a CSV file; returns the sum of its last column
+double readCsv(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    double sum = 0.0;
+    while (std::getline(in, line)) {
+        const char* at = line.c_str();
+        char* end = nullptr;
+        double value = 0.0;
+        while (*at) {
+            value = std::strtod(at, &end);
+            if (end == at) break;
+            at = *end == ',' ? end + 1 : end;
+        }
+        sum += value;
+    }
+    return sum;
+}
+
+std::size_t fileSize(const std::string& path) {
+    return static_cast<std::size_t>(std::filesystem::file_size(path));
+}
+
+void setRates(benchmark::State& state, std::size_t bytes) {
+    state.counters["snapshots/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * NUM_SNAPSHOTS), benchmark::Counter::kIsRate);
+    state.counters["MB/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * bytes) / 1e6, benchmark::Counter::kIsRate);
+    state.counters["fileMB"] = static_cast<double>(bytes) / 1e6;
+}
+
+}  // namespace
+
+// Streaming 1000 snapshots (26 smiles of 81 knots each, plus an 81-row chain)
+static void BM_SnapshotWrite(benchmark::State& state) {
+    const Run& run = simulatedRun();
+    std::string path = tempPath("omm_snapshots.bin");
+    for (auto _ : state) {
+        writeSnapshots(run, path);
+    }
+    setRates(state, fileSize(path));
+}
+
+// Mapping the file and summing every knot vol and chain price through the views
+static void BM_SnapshotRead(benchmark::State& state) {
+    const Run& run = simulatedRun();
+    std::string path = tempPath("omm_snapshots.bin");
+    writeSnapshots(run, path);
+    for (auto _ : state) {
+        SnapshotReader reader;
+        reader.open(path);
+        double sum = 0.0;
+        for (std::size_t i = 0; i < reader.numSnapshots(); ++i) {
+            SnapshotView view = reader.snapshot(i);
+            for (std::size_t j = 0; j < view.numExpiries; ++j) {
+                SmileView smile = view.smile(j);
+                for (std::size_t k = 0; k < smile.size; ++k) sum += smile.volPoints[k];
+            }
+            for (std::size_t r = 0; r < view.chain.size; ++r) sum += view.chain.fields[CALL_PRICE][r];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    setRates(state, fileSize(path));
+}
+
+// Restoring every snapshot into one Market and repricing its chain straight off the
+// mapped strike column; mismatches counts prices that differ from the stored ones in
+// any bit
+static void BM_SnapshotReplay(benchmark::State& state) {
+    const Run& run = simulatedRun();
+    std::string path = tempPath("omm_snapshots.bin");
+    writeSnapshots(run, path);
+    SnapshotReader reader;
+    reader.open(path);
+    
+    Market market;
+    std::vector<double> callPrices;
+    std::size_t mismatches = 0;
+    for (auto _ : state) {
+        mismatches = 0;
+        for (std::size_t i = 0; i < reader.numSnapshots(); ++i) {
+            reader.restore(i, market);
+            SnapshotView view = reader.snapshot(i);
+            std::size_t n = view.chain.size;
+            callPrices.resize(n);
+            Calculator::priceOptionChain(OptionChainBatch{view.chain.fields[STRIKE], view.chain.expiries, n}, market,
+                                         OptionBatchResult{callPrices.data(), nullptr, nullptr, nullptr, nullptr},
+                                         OptionBatchResult{nullptr, nullptr, nullptr, nullptr, nullptr});
+            mismatches += static_cast<std::size_t>(
+                std::memcmp(callPrices.data(), view.chain.fields[CALL_PRICE], n * sizeof(double)) != 0);
+        }
+        benchmark::DoNotOptimize(market.spot);
+    }
+    setRates(state, reader.fileSize());
+    state.counters["mismatches"] = static_cast<double>(mismatches);
+}
+
+// Baseline: the same content as CSV through iostreams at full precision
+static void BM_CsvWrite(benchmark::State& state) {
+    const Run& run = simulatedRun();
+    std::string knotPath = tempPath("omm_knots.csv");
+    std::string chainPath = tempPath("omm_chains.csv");
+    for (auto _ : state) {
+        writeCsv(run, knotPath, chainPath);
+    }
+    setRates(state, fileSize(knotPath) + fileSize(chainPath));
+}
+
+// Baseline: parsing every field of the CSV files back with strtod
+static void BM_CsvRead(benchmark::State& state) {
+    const Run& run = simulatedRun();
+    std::string knotPath = tempPath("omm_knots.csv");
+    std::string chainPath = tempPath("omm_chains.csv");
+    writeCsv(run, knotPath, chainPath);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(readCsv(knotPath) + readCsv(chainPath));
+    }
+    setRates(state, fileSize(knotPath) + fileSize(chainPath));
+}
+
+BENCHMARK(BM_SnapshotWrite)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_SnapshotRead)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_SnapshotReplay)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_CsvWrite)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_CsvRead)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
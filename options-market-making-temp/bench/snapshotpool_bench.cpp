@@ -0,0 +1,156 @@
+#include "benchutils.hpp"
+#include "core/models/snapshotpool.hpp"
+#include "core/workers/pathsimulator.hpp"
+#include "core/workers/simulator.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+using namespace omm::core;
+using namespace omm::core::models;
+using namespace omm::core::workers;
+
+// Every heap allocation of the process, for the allocs/step and bytes/step counters
+namespace {
+std::atomic<std::size_t> allocCount{0};
+std::atomic<std::size_t> allocBytes{0};
+}  // namespace
+
+void* operator new(std::size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+constexpr std::size_t NUM_STEPS = 252;  // one year of daily steps
+constexpr std::size_t HISTORY = 8;      // snapshots kept alive, as a quoting loop would
+constexpr std::uint64_t SEED = 20240917;
+
+// Simulates a year of days keeping the last HISTORY markets, one allocation window
+struct Run {
+    std::shared_ptr<Market> history[HISTORY];
+    
+    template <typename Step>
+    std::shared_ptr<Market> simulate(const std::shared_ptr<Market>& initial,
+                                     const std::vector<workers::MarketShock>& shocks, Step step) {
+        auto current = initial;
+        for (std::size_t t = 0; t < shocks.size(); ++t) {
+            current = step(current, shocks[t]);
+            history[t % HISTORY] = current;
+        }
+        return current;
+    }
+};
+
+// Allocations per simulated day over one more run after warm-up
+template <typename Step>
+void countAllocations(benchmark::State& state, const std::shared_ptr<Market>& initial,
+                      const std::vector<workers::MarketShock>& shocks, Run& run, Step step) {
+    std::size_t count = allocCount.load();
+    std::size_t bytes = allocBytes.load();
+    auto last = run.simulate(initial, shocks, step);
+    benchmark::DoNotOptimize(&last);
+    std::size_t allocs = allocCount.load() - count;
+    std::size_t allocated = allocBytes.load() - bytes;
+    state.counters["allocs/step"] = static_cast<double>(allocs) / shocks.size();
+    state.counters["bytes/step"] = static_cast<double>(allocated) / shocks.size();
+}
+
+}  // namespace
+
+// Baseline: a new Market, VolSurface and smiles per day (arbitrage checks off)
+static void BM_SimulateNextMarketHistory(benchmark::State& state) {
+    ArbitrageChecker::setMode(ArbitrageCheckMode::OFF);
+    auto initial = omm::bench::makeMarket();
+    auto shocks = PathSimulator::generateShocks(SEED, 0, NUM_STEPS);
+    auto step = [](const std::shared_ptr<Market>& market, const MarketShock& shock) {
+        return Simulator::simulateNextMarket(market, shock);
+    };
+    
+    Run run;
+    for (auto _ : state) {
+        auto last = run.simulate(initial, shocks, step);
+        benchmark::DoNotOptimize(&last);
+    }
+    state.counters["steps/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * NUM_STEPS), benchmark::Counter::kIsRate);
+    countAllocations(state, initial, shocks, run, step);
+    ArbitrageChecker::setMode(ArbitrageCheckMode::FULL);
+}
+BENCHMARK(BM_SimulateNextMarketHistory)->Unit(benchmark::kMicrosecond);
+
+// Same history from pooled snapshots
+static void BM_PooledSimulateNextMarket(benchmark::State& state) {
+    auto initial = omm::bench::makeMarket();
+    auto shocks = PathSimulator::generateShocks(SEED, 0, NUM_STEPS);
+    SnapshotPool pool;
+    auto step = [&pool](const std::shared_ptr<Market>& market, const MarketShock& shock) {
+        return Simulator::simulateNextMarket(market, shock, pool);
+    };
+    
+    Run run;
+    for (auto _ : state) {
+        auto last = run.simulate(initial, shocks, step);
+        benchmark::DoNotOptimize(&last);
+    }
+    state.counters["steps/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * NUM_STEPS), benchmark::Counter::kIsRate);
+    countAllocations(state, initial, shocks, run, step);
+    state.counters["slots"] = static_cast<double>(pool.stats().slots);
+    
+    // Against advanceMarket on a private copy with the same shocks
+    Market replay = *initial;
+    replay.volSurface = std::make_shared<VolSurface>(*initial->volSurface);
+    for (const auto& shock : shocks) Simulator::advanceMarket(replay, shock);
+    auto last = run.simulate(initial, shocks, step);
+    double maxDiff = std::abs(last->spot - replay.spot);
+    for (std::size_t i = 0; i < replay.volSurface->smiles.size(); ++i) {
+        const auto& a = replay.volSurface->smiles[i];
+        const auto& b = last->volSurface->smiles[i];
+        for (std::size_t j = 0; j < a.volPoints.size(); ++j) {
+            maxDiff = std::max(maxDiff, std::abs(a.volPoints[j] - b.volPoints[j]));
+        }
+    }
+    state.counters["maxDiff"] = maxDiff;
+}
+BENCHMARK(BM_PooledSimulateNextMarket)->Unit(benchmark::kMicrosecond);
+
+// In-place stepping of a single market, for reference
+static void BM_AdvanceMarketAllocations(benchmark::State& state) {
+    auto initial = omm::bench::makeMarket();
+    auto shocks = PathSimulator::generateShocks(SEED, 0, NUM_STEPS);
+    Market current = *initial;
+    current.volSurface = std::make_shared<VolSurface>(*initial->volSurface);
+    
+    for (auto _ : state) {
+        for (const auto& shock : shocks) Simulator::advanceMarket(current, shock);
+        benchmark::DoNotOptimize(&current);
+    }
+    state.counters["steps/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * NUM_STEPS), benchmark::Counter::kIsRate);
+    
+    std::size_t count = allocCount.load();
+    std::size_t bytes = allocBytes.load();
+    for (const auto& shock : shocks) Simulator::advanceMarket(current, shock);
+    std::size_t allocs = allocCount.load() - count;
+    std::size_t allocated = allocBytes.load() - bytes;
+    state.counters["allocs/step"] = static_cast<double>(allocs) / NUM_STEPS;
+    state.counters["bytes/step"] = static_cast<double>(allocated) / NUM_STEPS;
+}
+BENCHMARK(BM_AdvanceMarketAllocations)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
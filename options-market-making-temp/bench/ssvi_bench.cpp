@@ -0,0 +1,167 @@
+#include "benchutils.hpp"
+#include "core/utils.hpp"
+#include "core/models/arbitrage.hpp"
+#include "core/models/frozenvolsurface.hpp"
+#include "core/models/ssvi.hpp"
+#include "core/models/volsurface.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace omm::core;
+using namespace omm::core::models;
+
+namespace {
+
+constexpr std::size_t NUM_QUERIES = 1 << 16;
+constexpr int GRID_STEP_DIST = VolSurface::GRID_STEP_DIST;
+constexpr double GRID_STRIKE_STEP = VolSurface::GRID_STRIKE_STEP;
+
+struct VolQuery {
+    double strike;
+    double forward;
+    double expiry;
+};
+
+// SSVI with the standard market's ATM term structure
+SsviSurface makeSsvi(const VolSurface& surface, const SsviParams& params) {
+    std::vector<double> thetas;
+    for (double expiry : surface.expiries) {
+        double atmVol = surface.getAtmVol(expiry);
+        thetas.push_back(atmVol * atmVol * expiry / 365.0);
+    }
+    return SsviSurface(surface.expiries, thetas, params);
+}
+
+// Chain strikes on listed expiries, the lookups a quoting or risk pass makes
+std::vector<VolQuery> makeQueries(const Market& market) {
+    std::mt19937_64 rng(11);
+    const auto& expiries = market.volSurface->expiries;
+    std::uniform_int_distribution<std::size_t> expiryIdx(0, expiries.size() - 1);
+    std::uniform_int_distribution<int> strikeStep(-GRID_STEP_DIST, GRID_STEP_DIST);
+    std::vector<VolQuery> queries(NUM_QUERIES);
+    for (auto& q : queries) {
+        q.expiry = expiries[expiryIdx(rng)];
+        q.strike = market.spot + strikeStep(rng) * GRID_STRIKE_STEP;
+        q.forward = Utils::getForwardPrice(market.spot, market.interestRate, q.expiry);
+    }
+    return queries;
+}
+
+// Smiles and vectors of a surface, as allocated
+std::size_t surfaceBytes(const VolSurface& surface) {
+    std::size_t bytes = sizeof(surface) + surface.expiries.capacity() * sizeof(double) +
+                        surface.smiles.capacity() * sizeof(Smile);
+    for (const Smile& smile : surface.smiles) {
+        bytes += (smile.normStrikes.capacity() + smile.volPoints.capacity()) * sizeof(double);
+    }
+    if (surface.ssvi) bytes += surface.ssvi->memoryBytes() - sizeof(SsviSurface);
+    return bytes;
+}
+
+// The SSVI surface sampled on the usual strike grid, for ArbitrageChecker
+VolSurface sampleOnGrid(const SsviSurface& ssvi, const Market& market) {
+    VolSurface sampled;
+    sampled.expiries = ssvi.expiries();
+    for (std::size_t idx = 0; idx < ssvi.expiries().size(); ++idx) {
+        double expiry = ssvi.expiries()[idx];
+        double forward = Utils::getForwardPrice(market.spot, market.interestRate, expiry);
+        for (int z = -GRID_STEP_DIST; z <= GRID_STEP_DIST; ++z) {
+            double ns = Utils::getNormStrike(market.spot + z * GRID_STRIKE_STEP, forward, expiry, ssvi.getAtmVol(expiry));
+            sampled.addVolPoint(static_cast<int>(idx), ns, ssvi.getVolNormStrike(ns, expiry));
+        }
+    }
+    return sampled;
+}
+
+template <typename Surface>
+void runLookups(benchmark::State& state, const Surface& surface, const std::vector<VolQuery>& queries) {
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (const auto& q : queries) {
+            sum += surface.getVol(q.strike, q.forward, q.expiry);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * queries.size()));
+}
+
+}  // namespace
+
+// getVol over chain strikes on listed expiries. range(0): 0 = piecewise-linear
+// VolSurface, 1 = SSVI-backed VolSurface, 2 / 3 = the same frozen. bytes is the
+// VolSurface's footprint.
+static void BM_SurfaceLookup(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto queries = makeQueries(*market);
+    VolSurface ssviSurface(makeSsvi(*market->volSurface, SsviParams{}));
+    bool ssvi = state.range(0) % 2 == 1;
+    const VolSurface& surface = ssvi ? ssviSurface : *market->volSurface;
+    
+    if (state.range(0) < 2) {
+        runLookups(state, surface, queries);
+    } else {
+        FrozenVolSurface frozen = surface.freeze();
+        runLookups(state, frozen, queries);
+    }
+    state.counters["bytes"] = static_cast<double>(surfaceBytes(surface));
+}
+
+// Closed-form vol, dvol/dk and d2vol/dk2 against central differences of getVol
+static void BM_SsviDerivatives(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto queries = makeQueries(*market);
+    SsviSurface ssvi = makeSsvi(*market->volSurface, SsviParams{});
+    
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (const auto& q : queries) {
+            SmileDerivatives d = ssvi.getVolDerivatives(std::log(q.strike / q.forward), q.expiry);
+            sum += d.vol + d.dVolDk + d.d2VolDk2;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    
+    constexpr double h = 1e-5;
+    double maxSlopeError = 0.0;
+    double maxCurvatureError = 0.0;
+    for (const auto& q : queries) {
+        double k = std::log(q.strike / q.forward);
+        SmileDerivatives d = ssvi.getVolDerivatives(k, q.expiry);
+        double up = ssvi.getVol(k + h, q.expiry);
+        double down = ssvi.getVol(k - h, q.expiry);
+        maxSlopeError = std::max(maxSlopeError, std::abs(d.dVolDk - (up - down) / (2.0 * h)));
+        maxCurvatureError = std::max(maxCurvatureError, std::abs(d.d2VolDk2 - (up - 2.0 * d.vol + down) / (h * h)));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * queries.size()));
+    state.counters["slopeErr"] = maxSlopeError;
+    state.counters["curvatureErr"] = maxCurvatureError;
+}
+
+// ArbitrageChecker on SSVI sampled on the strike grid. range(0) = requested eta
+// (x10): 10 is inside the no-arbitrage bound, 40 outside it and clamped.
+static void BM_SsviArbitrage(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    SsviParams params;
+    params.rho = -0.9;
+    params.eta = static_cast<double>(state.range(0)) / 10.0;
+    SsviSurface ssvi = makeSsvi(*market->volSurface, params);
+    VolSurface sampled = sampleOnGrid(ssvi, *market);
+    
+    ArbitrageReport report;
+    for (auto _ : state) {
+        report = sampled.checkArbitrage();
+        benchmark::DoNotOptimize(&report);
+    }
+    state.counters["eta"] = ssvi.params().eta;
+    state.counters["butterfly"] = static_cast<double>(report.butterflyCount);
+    state.counters["calendar"] = static_cast<double>(report.calendarCount);
+}
+
+BENCHMARK(BM_SurfaceLookup)->DenseRange(0, 3)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SsviDerivatives)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SsviArbitrage)->Arg(10)->Arg(40)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
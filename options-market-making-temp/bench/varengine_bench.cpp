@@ -0,0 +1,139 @@
+#include "benchutils.hpp"
+#include "core/tdigest.hpp"
+#include "core/threadpool.hpp"
+#include "core/workers/varengine.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace omm::core;
+using namespace omm::core::models;
+using namespace omm::core::workers;
+
+namespace {
+
+constexpr std::size_t NUM_LEGS = 1000;
+constexpr std::size_t NUM_PATHS = 4096;
+
+// Fat-tailed P&L-like sample: Student t with 3 degrees of freedom
+std::vector<double> makeSample(std::size_t n) {
+    std::mt19937_64 rng(17);
+    std::student_t_distribution<double> dist(3.0);
+    std::vector<double> sample(n);
+    for (double& x : sample) x = 1e6 * dist(rng);
+    return sample;
+}
+
+// Exact lower-tail quantile and mean of a sorted sample, value i at rank i + 1/2 as in
+// the digest
+double exactQuantile(const std::vector<double>& sorted, double q) {
+    double rank = std::clamp(q * static_cast<double>(sorted.size()) - 0.5, 0.0, static_cast<double>(sorted.size() - 1));
+    auto idx = std::min(static_cast<std::size_t>(rank), sorted.size() - 2);
+    double frac = rank - static_cast<double>(idx);
+    return sorted[idx] + frac * (sorted[idx + 1] - sorted[idx]);
+}
+
+double exactTailMean(const std::vector<double>& sorted, double q) {
+    auto n = std::max<std::size_t>(1, static_cast<std::size_t>(q * static_cast<double>(sorted.size())));
+    double sum = 0.0;
+    for (std::size_t i = 0; i < n; ++i) sum += sorted[i];
+    return sum / static_cast<double>(n);
+}
+
+void threadCounts(benchmark::internal::Benchmark* bench) {
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        bench->Arg(threads);
+    }
+    bench->Arg(maxThreads);
+}
+
+}  // namespace
+
+// Streaming inserts into a t-digest. range(0) = values. Errors of the 0.1%, 1% and
+// 2.5% quantiles and tail means are against the sorted sample: relative to the exact
+// value, and for quantiles also in rank (fraction of the sample). bytes is the
+// digest's footprint, against 8 bytes per value to keep the sample.
+static void BM_TDigestAdd(benchmark::State& state) {
+    auto sample = makeSample(static_cast<std::size_t>(state.range(0)));
+    TDigest digest;
+    for (auto _ : state) {
+        digest = TDigest();
+        for (double x : sample) digest.add(x);
+        benchmark::DoNotOptimize(digest.quantile(0.01));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * sample.size()));
+    
+    std::sort(sample.begin(), sample.end());
+    double quantileErr = 0.0;
+    double rankErr = 0.0;
+    double tailMeanErr = 0.0;
+    for (double q : {0.001, 0.01, 0.025}) {
+        double estimate = digest.quantile(q);
+        double exactQ = exactQuantile(sample, q);
+        double exactTail = exactTailMean(sample, q);
+        double rank = static_cast<double>(std::lower_bound(sample.begin(), sample.end(), estimate) - sample.begin());
+        quantileErr = std::max(quantileErr, std::abs(estimate - exactQ) / std::abs(exactQ));
+        rankErr = std::max(rankErr, std::abs(rank / static_cast<double>(sample.size()) - q));
+        tailMeanErr = std::max(tailMeanErr, std::abs(digest.tailMean(q) - exactTail) / std::abs(exactTail));
+    }
+    state.counters["quantileErr"] = quantileErr;
+    state.counters["rankErr"] = rankErr;
+    state.counters["tailMeanErr"] = tailMeanErr;
+    state.counters["centroids"] = static_cast<double>(digest.numCentroids());
+    state.counters["bytes"] = static_cast<double>(digest.memoryBytes());
+}
+
+// 1-day and 10-day VaR / ES of a 1000-leg book over 4096 paths starting in the
+// market's regime, revalued over threads
+static void BM_VarEngine(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    Portfolio portfolio = omm::bench::makeBook(*market, NUM_LEGS);
+    VarSpec spec;
+    spec.numPaths = NUM_PATHS;
+    ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+    
+    VarResult result;
+    for (auto _ : state) {
+        result = VarEngine::run(portfolio, *market, spec, pool);
+        benchmark::DoNotOptimize(&result);
+    }
+    std::size_t revaluations = spec.numPaths * spec.horizons.size();
+    state.counters["revals/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * revaluations), benchmark::Counter::kIsRate);
+    state.counters["var99_1d"] = result.horizons[0].measures[0].var;
+    state.counters["es99_1d"] = result.horizons[0].measures[0].es;
+    state.counters["var99_10d"] = result.horizons[1].measures[0].var;
+    state.counters["es99_10d"] = result.horizons[1].measures[0].es;
+}
+
+// 10-day 99% VaR / ES for paths starting in each regime, on the same draws
+static void BM_VarEngineRegimes(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    Portfolio portfolio = omm::bench::makeBook(*market, NUM_LEGS);
+    VarSpec spec;
+    spec.numPaths = NUM_PATHS;
+    ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+    
+    std::vector<VarResult> results;
+    for (auto _ : state) {
+        results = VarEngine::runRegimes(portfolio, *market, spec, pool);
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.counters["var99Calm"] = results[0].horizons[1].measures[0].var;
+    state.counters["var99Stress"] = results[1].horizons[1].measures[0].var;
+    state.counters["var99Event"] = results[2].horizons[1].measures[0].var;
+    state.counters["es99Calm"] = results[0].horizons[1].measures[0].es;
+    state.counters["es99Stress"] = results[1].horizons[1].measures[0].es;
+    state.counters["es99Event"] = results[2].horizons[1].measures[0].es;
+}
+
+BENCHMARK(BM_TDigestAdd)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_VarEngine)->Apply(threadCounts)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_VarEngineRegimes)->Arg(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,156 @@
+#include "core/vecmath.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using omm::core::SimdLevel;
+using omm::core::VecMath;
+
+namespace {
+
+constexpr std::size_t ARRAY_SIZE = 4096;
+constexpr std::size_t ACCURACY_SAMPLES = 1000000;
+
+using VecFn = void (*)(const double*, double*, std::size_t);
+using StdFn = double (*)(double);
+
+double stdNormCdf(double x) { return 0.5 * (1.0 + std::erf(x / std::sqrt(2.0))); }
+double stdNormPdf(double x) { return std::exp(-0.5 * x * x) / 2.50662827463100050241; }
+double stdExp(double x) { return std::exp(x); }
+double stdLog(double x) { return std::log(x); }
+double stdSqrt(double x) { return std::sqrt(x); }
+double stdErf(double x) { return std::erf(x); }
+
+// sin(pi x) / cos(pi x) in long double after the exact half-turn reduction, since
+// std::sin(M_PI * x) itself is off by the rounding of pi * x
+long double turnsAngle(double x, int& quadrant) {
+    double q = std::nearbyint(2.0 * x);
+    double r = x - 0.5 * q;
+    quadrant = static_cast<int>(std::fmod(q, 4.0) + 4.0) % 4;
+    return 3.14159265358979323846264338327950288L * r;
+}
+
+double refSinPi(double x) {
+    int quadrant;
+    long double t = turnsAngle(x, quadrant);
+    long double v = (quadrant % 2 == 0) ? std::sin(t) : std::cos(t);
+    return static_cast<double>(quadrant >= 2 ? -v : v);
+}
+
+double refCosPi(double x) {
+    int quadrant;
+    long double t = turnsAngle(x, quadrant);
+    long double v = (quadrant % 2 == 0) ? std::cos(t) : std::sin(t);
+    return static_cast<double>((quadrant == 1 || quadrant == 2) ? -v : v);
+}
+
+struct MathCase {
+    const char* name;
+    VecFn vec;
+    StdFn ref;
+    double lo;
+    double hi;
+    bool logUniform;  // sample log-uniformly (log, sqrt)
+};
+
+const MathCase CASES[] = {
+    {"exp", &VecMath::exp, &stdExp, -745.0, 709.7, false},
+    {"log", &VecMath::log, &stdLog, 1e-300, 1e300, true},
+    {"sqrt", &VecMath::sqrt, &stdSqrt, 1e-300, 1e300, true},
+    {"erf", &VecMath::erf, &stdErf, -7.0, 7.0, false},
+    {"normCdf", &VecMath::normCdf, &stdNormCdf, -10.0, 10.0, false},
+    {"normPdf", &VecMath::normPdf, &stdNormPdf, -10.0, 10.0, false},
+    {"sinPi", &VecMath::sinPi, &refSinPi, -1e6, 1e6, false},
+    {"cosPi", &VecMath::cosPi, &refCosPi, -1e6, 1e6, false},
+};
+
+std::vector<double> sampleInputs(const MathCase& mathCase, std::size_t n, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<double> x(n);
+    if (mathCase.logUniform) {
+        std::uniform_real_distribution<double> dist(std::log(mathCase.lo), std::log(mathCase.hi));
+        for (auto& v : x) v = std::exp(dist(rng));
+    } else {
+        std::uniform_real_distribution<double> dist(mathCase.lo, mathCase.hi);
+        for (auto& v : x) v = dist(rng);
+    }
+    return x;
+}
+
+std::int64_t orderedBits(double x) {
+    std::int64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits < 0 ? INT64_MIN - bits : bits;
+}
+
+double ulpDistance(double a, double b) {
+    if (a == b) return 0.0;
+    if (std::isnan(a) || std::isnan(b)) return INFINITY;
+    return std::abs(static_cast<double>(orderedBits(a) - orderedBits(b)));
+}
+
+// Max ULP and absolute error of the current level against libm
+void measureAccuracy(const MathCase& mathCase, benchmark::State& state) {
+    auto x = sampleInputs(mathCase, ACCURACY_SAMPLES, 7);
+    std::vector<double> out(x.size());
+    mathCase.vec(x.data(), out.data(), x.size());
+    
+    double maxUlp = 0.0, maxAbs = 0.0;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        double ref = mathCase.ref(x[i]);
+        maxUlp = std::max(maxUlp, ulpDistance(out[i], ref));
+        maxAbs = std::max(maxAbs, std::abs(out[i] - ref));
+    }
+    state.counters["maxUlp"] = maxUlp;
+    state.counters["maxAbsErr"] = maxAbs;
+}
+
+void BM_VecMath(benchmark::State& state, const MathCase& mathCase, SimdLevel level) {
+    SimdLevel active = VecMath::setSimdLevel(level);
+    if (active != level) {
+        state.SkipWithError("SIMD level not supported by this CPU");
+        return;
+    }
+    auto x = sampleInputs(mathCase, ARRAY_SIZE, 1);
+    std::vector<double> out(x.size());
+    
+    for (auto _ : state) {
+        mathCase.vec(x.data(), out.data(), x.size());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(x.size()));
+    measureAccuracy(mathCase, state);
+}
+
+void BM_Libm(benchmark::State& state, const MathCase& mathCase) {
+    auto x = sampleInputs(mathCase, ARRAY_SIZE, 1);
+    std::vector<double> out(x.size());
+    
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < x.size(); ++i) out[i] = mathCase.ref(x[i]);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(x.size()));
+}
+
+int registerBenchmarks() {
+    const SimdLevel levels[] = {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512};
+    for (const auto& mathCase : CASES) {
+        benchmark::RegisterBenchmark((std::string("BM_Libm/") + mathCase.name).c_str(), BM_Libm, mathCase);
+        for (SimdLevel level : levels) {
+            std::string name = std::string("BM_VecMath/") + mathCase.name + "/" + VecMath::simdLevelName(level);
+            benchmark::RegisterBenchmark(name.c_str(), BM_VecMath, mathCase, level);
+        }
+    }
+    return 0;
+}
+
+const int registered = registerBenchmarks();
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,168 @@
+#include "benchutils.hpp"
+#include "core/config.hpp"
+#include "core/utils.hpp"
+#include "core/workers/volcalibrator.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace omm::core;
+using namespace omm::core::models;
+using namespace omm::core::workers;
+
+namespace {
+
+constexpr std::uint64_t SEED = 20240917;
+constexpr std::size_t NUM_TICKS = 256;
+constexpr int STRIKE_STEP_DIST = 40;
+constexpr double STRIKE_STEP = 50.0;
+constexpr double QUOTE_NOISE = 0.0005;  // vol, standard deviation
+
+// Implied-vol quotes of the full chain (26 expiries x 81 strikes) per tick, from
+// surfaces along a random walk of ATM vol, skew and convexity, with quote noise
+struct QuoteTicks {
+    std::shared_ptr<Market> market = omm::bench::makeMarket();
+    std::vector<double> strikes, expiries, weights;
+    std::vector<std::vector<double>> vols;  // per tick
+    std::vector<std::vector<double>> atmVols;  // per tick, per expiry
+    
+    explicit QuoteTicks(double calendarBump) {
+        auto configExpiries = Config::getExpiries();
+        std::vector<double> surfaceExpiries(configExpiries.begin(), configExpiries.end());
+        for (double expiry : surfaceExpiries) {
+            for (int z = -STRIKE_STEP_DIST; z <= STRIKE_STEP_DIST; ++z) {
+                strikes.push_back(market->spot + z * STRIKE_STEP);
+                expiries.push_back(expiry);
+                weights.push_back(1.0);
+            }
+        }
+        
+        std::mt19937_64 rng(SEED);
+        std::normal_distribution<double> noise(0.0, QUOTE_NOISE);
+        std::bernoulli_distribution up(0.5);
+        double atmVol = Config::VIX;
+        double skew = -0.02;
+        double convexity = 0.01;
+        VolSurface surface = *market->volSurface;
+        for (std::size_t tick = 0; tick < NUM_TICKS; ++tick) {
+            atmVol += up(rng) ? 0.0005 : -0.0005;
+            skew += up(rng) ? 0.0002 : -0.0002;
+            convexity = std::max(0.0, convexity + (up(rng) ? 0.0001 : -0.0001));
+            surface.rebuild(surfaceExpiries, atmVol, skew, convexity, 0.18, market->spot, market->interestRate);
+            
+            std::vector<double> tickVols;
+            for (std::size_t i = 0; i < strikes.size(); ++i) {
+                double forward = Utils::getForwardPrice(market->spot, market->interestRate, expiries[i]);
+                double vol = surface.getVol(strikes[i], forward, expiries[i]) + noise(rng);
+                // Every fifth expiry quoted too low: calendar arbitrage against the one before
+                bool bumped = calendarBump > 0.0 && (i / (2 * STRIKE_STEP_DIST + 1)) % 5 == 4;
+                tickVols.push_back(bumped ? vol * (1.0 - calendarBump) : vol);
+            }
+            vols.push_back(std::move(tickVols));
+            std::vector<double> tickAtm;
+            for (double expiry : surfaceExpiries) tickAtm.push_back(surface.getAtmVol(expiry));
+            atmVols.push_back(std::move(tickAtm));
+        }
+    }
+    
+    VolQuoteBatch view(std::size_t tick) const {
+        return VolQuoteBatch{strikes.data(), expiries.data(), vols[tick].data(), weights.data(), strikes.size()};
+    }
+};
+
+const QuoteTicks& cleanTicks() {
+    static const QuoteTicks ticks(0.0);
+    return ticks;
+}
+
+const QuoteTicks& bumpedTicks() {
+    static const QuoteTicks ticks(0.3);
+    return ticks;
+}
+
+}  // namespace
+
+// Recalibration on every tick: 2106 quotes in, the rebuilt surface out.
+// range(0) = 1 warm-starts each fit from the previous tick's, 0 starts from the ATM
+// quote and a flat smile. atmErr is the largest gap between fitted and true ATM vols.
+static void BM_VolCalibrationTick(benchmark::State& state) {
+    using Clock = std::chrono::steady_clock;
+    
+    bool warm = state.range(0) != 0;
+    const QuoteTicks& ticks = cleanTicks();
+    VolCalibrator calibrator;
+    calibrator.warmStart(*ticks.market->volSurface);
+    VolSurface surface = *ticks.market->volSurface;
+    omm::bench::LatencyHistogram histogram;
+    CalibrationStats totals;
+    double maxAtmError = 0.0;
+    std::size_t tick = 0;
+    
+    for (auto _ : state) {
+        if (!warm) calibrator.reset();
+        auto start = Clock::now();
+        CalibrationStats stats = calibrator.calibrate(ticks.view(tick), *ticks.market);
+        calibrator.toSurface(surface, ticks.market->spot, ticks.market->interestRate);
+        auto end = Clock::now();
+        histogram.record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        benchmark::DoNotOptimize(&surface);
+        
+        totals.smiles += stats.smiles;
+        totals.iterations += stats.iterations;
+        totals.constrained += stats.constrained;
+        totals.rmse = std::max(totals.rmse, stats.rmse);
+        for (std::size_t idx = 0; idx < calibrator.smiles().size(); ++idx) {
+            maxAtmError = std::max(maxAtmError, std::abs(calibrator.smiles()[idx].atmVol - ticks.atmVols[tick][idx]));
+        }
+        tick = (tick + 1) % NUM_TICKS;
+    }
+    
+    ArbitrageReport report = surface.checkArbitrage();
+    state.SetItemsProcessed(static_cast<int64_t>(histogram.count()));
+    state.counters["p50_us"] = histogram.quantile(0.50) * 1e-3;
+    state.counters["p99_us"] = histogram.quantile(0.99) * 1e-3;
+    state.counters["max_us"] = histogram.max() * 1e-3;
+    state.counters["iters/smile"] = static_cast<double>(totals.iterations) / static_cast<double>(totals.smiles);
+    state.counters["rmse"] = totals.rmse;
+    state.counters["atmErr"] = maxAtmError;
+    state.counters["arbitrage"] = static_cast<double>(report.violations.size());
+}
+
+// Quotes with calendar arbitrage (every fifth expiry 30% low). range(0) = 1 fits
+// with the no-arbitrage penalties, 0 without (constraintWeight 0, no vol floor);
+// arbitrage counts the violations in the resulting surface.
+static void BM_VolCalibrationArbitrage(benchmark::State& state) {
+    bool constrained = state.range(0) != 0;
+    const QuoteTicks& ticks = bumpedTicks();
+    CalibrationParams params;
+    if (!constrained) {
+        params.constraintWeight = 0.0;
+        params.minVol = 1e-4;
+    }
+    VolCalibrator calibrator(params);
+    VolSurface surface = *ticks.market->volSurface;
+    CalibrationStats stats;
+    std::size_t tick = 0;
+    
+    for (auto _ : state) {
+        stats = calibrator.calibrate(ticks.view(tick), *ticks.market);
+        calibrator.toSurface(surface, ticks.market->spot, ticks.market->interestRate);
+        benchmark::DoNotOptimize(&surface);
+        tick = (tick + 1) % NUM_TICKS;
+    }
+    
+    ArbitrageReport report = surface.checkArbitrage();
+    state.counters["calendar"] = static_cast<double>(report.calendarCount);
+    state.counters["butterfly"] = static_cast<double>(report.butterflyCount);
+    state.counters["constrained"] = static_cast<double>(stats.constrained);
+    state.counters["rmse"] = stats.rmse;
+}
+
+BENCHMARK(BM_VolCalibrationTick)->Arg(1)->Arg(0)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_VolCalibrationArbitrage)->Arg(1)->Arg(0)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,292 @@
+#include "benchutils.hpp"
+#include "core/utils.hpp"
+#include "core/models/arbitrage.hpp"
+#include "core/models/frozenvolsurface.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace omm::core;
+using namespace omm::core::models;
+
+namespace {
+
+struct VolQuery {
+    double strike;
+    double forward;
+    double expiry;
+};
+
+// Strikes within +-20% of spot on random expiries inside and just outside the grid
+std::vector<VolQuery> makeQueries(const Market& market, std::size_t n) {
+    std::mt19937_64 rng(11);
+    const auto& expiries = market.volSurface->expiries;
+    std::uniform_real_distribution<double> expiryDist(expiries.front() - 2.0, expiries.back() + 2.0);
+    std::uniform_real_distribution<double> strikeDist(0.8 * market.spot, 1.2 * market.spot);
+    
+    std::vector<VolQuery> queries(n);
+    for (auto& q : queries) {
+        q.expiry = expiryDist(rng);
+        q.strike = strikeDist(rng);
+        q.forward = Utils::getForwardPrice(market.spot, market.interestRate, q.expiry);
+    }
+    return queries;
+}
+
+// Largest |frozen - surface| over random queries plus every knot of every smile
+double maxAbsDiff(const VolSurface& surface, const FrozenVolSurface& frozen, const std::vector<VolQuery>& queries) {
+    double worst = 0.0;
+    for (const auto& q : queries) {
+        worst = std::max(worst, std::abs(frozen.getVol(q.strike, q.forward, q.expiry) -
+                                         surface.getVol(q.strike, q.forward, q.expiry)));
+    }
+    for (size_t i = 0; i < surface.expiries.size(); ++i) {
+        for (double ns : surface.smiles[i].normStrikes) {
+            for (double expiry : {surface.expiries[i], surface.expiries[i] + 0.5}) {
+                worst = std::max(worst, std::abs(frozen.getVolNormStrike(ns, expiry) -
+                                                 surface.getVolNormStrike(ns, expiry)));
+            }
+        }
+    }
+    return worst;
+}
+
+// Surface parameters of the next simulation step from makeMarket()
+struct SurfaceParams {
+    std::vector<double> expiries;
+    double atmOneMonthVol = 0.21;
+    double skew = -0.05;
+    double convexity = 0.02;
+    double volMean = 0.28;
+    double spot = Config::SPX_SPOT * 1.003;
+};
+
+SurfaceParams nextStepParams(const VolSurface& surface) {
+    SurfaceParams params;
+    for (double e : surface.expiries) params.expiries.push_back(e - Config::TIME_STEP);
+    params.expiries.front() = params.expiries.back() + 7.0;  // expired front month moves to the back
+    std::rotate(params.expiries.begin(), params.expiries.begin() + 1, params.expiries.end());
+    return params;
+}
+
+// Largest difference of knots and vols between two surfaces with the same expiries
+double maxKnotDiff(const VolSurface& a, const VolSurface& b) {
+    double worst = 0.0;
+    for (size_t i = 0; i < a.smiles.size(); ++i) {
+        for (size_t j = 0; j < a.smiles[i].normStrikes.size(); ++j) {
+            worst = std::max(worst, std::abs(a.smiles[i].normStrikes[j] - b.smiles[i].normStrikes[j]));
+            worst = std::max(worst, std::abs(a.smiles[i].volPoints[j] - b.smiles[i].volPoints[j]));
+        }
+    }
+    return worst;
+}
+
+// Violation counts of the previous checks: nested-loop strike matching plus a binary
+// search per common strike (the earlier smile is read at its own knot)
+struct LegacyCounts {
+    std::size_t calendar = 0;
+    std::size_t butterfly = 0;
+};
+
+LegacyCounts legacyArbitrageCheck(const VolSurface& surface) {
+    LegacyCounts counts;
+    for (size_t i = 0; i + 1 < surface.expiries.size(); ++i) {
+        const Smile& smileEarlier = surface.smiles[i];
+        const Smile& smileLater = surface.smiles[i + 1];
+        for (size_t k = 0; k < smileEarlier.normStrikes.size(); ++k) {
+            double ns = smileEarlier.normStrikes[k];
+            double nsRounded = std::round(ns * 100.0) / 100.0;
+            bool common = false;
+            for (double nsLater : smileLater.normStrikes) {
+                if (std::abs(nsRounded - std::round(nsLater * 100.0) / 100.0) < 1e-6) {
+                    common = true;
+                    break;
+                }
+            }
+            if (!common) continue;
+            double volEarlier = smileEarlier.volPoints[k];
+            double volLater = smileLater.getVol(ns);
+            double varEarlier = volEarlier * volEarlier * surface.expiries[i] / 365.0;
+            double varLater = volLater * volLater * surface.expiries[i + 1] / 365.0;
+            counts.calendar += varLater < varEarlier - 1e-8;
+        }
+    }
+    for (size_t idx = 0; idx < surface.expiries.size(); ++idx) {
+        const auto& v = surface.smiles[idx].volPoints;
+        double T = surface.expiries[idx] / 365.0;
+        for (size_t i = 1; i + 1 < v.size(); ++i) {
+            double varDiff = v[i + 1] * v[i + 1] * T - 2.0 * v[i] * v[i] * T + v[i - 1] * v[i - 1] * T;
+            counts.butterfly += varDiff < -1e-8;
+        }
+    }
+    return counts;
+}
+
+// Surfaces to check: the market's, a steep-skew one with calendar violations in the
+// wings and a concave one with butterfly violations
+std::vector<VolSurface> makeCheckSurfaces() {
+    auto market = omm::bench::makeMarket();
+    SurfaceParams p = nextStepParams(*market->volSurface);
+    ArbitrageChecker::setMode(ArbitrageCheckMode::OFF);
+    std::vector<VolSurface> surfaces;
+    surfaces.push_back(*market->volSurface);
+    surfaces.emplace_back(p.expiries, p.atmOneMonthVol, p.skew, -0.01, p.volMean, p.spot, Config::INTEREST_RATE);
+    surfaces.emplace_back(p.expiries, p.atmOneMonthVol, -0.3, 0.001, p.volMean, p.spot, Config::INTEREST_RATE);
+    ArbitrageChecker::setMode(ArbitrageCheckMode::FULL);
+    return surfaces;
+}
+
+}  // namespace
+
+static void BM_VolSurfaceGetVol(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto queries = makeQueries(*market, 4096);
+    const VolSurface& surface = *market->volSurface;
+    
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (const auto& q : queries) sum += surface.getVol(q.strike, q.forward, q.expiry);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.size()));
+}
+BENCHMARK(BM_VolSurfaceGetVol);
+
+static void BM_FrozenVolSurfaceGetVol(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto queries = makeQueries(*market, 4096);
+    FrozenVolSurface frozen = market->volSurface->freeze();
+    
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (const auto& q : queries) sum += frozen.getVol(q.strike, q.forward, q.expiry);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.size()));
+    state.counters["maxAbsDiff"] = maxAbsDiff(*market->volSurface, frozen, makeQueries(*market, 100000));
+}
+BENCHMARK(BM_FrozenVolSurfaceGetVol);
+
+// Lookup only: norm strike given, no log / sqrt
+static void BM_VolSurfaceGetVolNormStrike(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto queries = makeQueries(*market, 4096);
+    const VolSurface& surface = *market->volSurface;
+    
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (const auto& q : queries) sum += surface.getVolNormStrike((q.strike - q.forward) / 2500.0, q.expiry);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.size()));
+}
+BENCHMARK(BM_VolSurfaceGetVolNormStrike);
+
+static void BM_FrozenVolSurfaceGetVolNormStrike(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    auto queries = makeQueries(*market, 4096);
+    FrozenVolSurface frozen = market->volSurface->freeze();
+    
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (const auto& q : queries) sum += frozen.getVolNormStrike((q.strike - q.forward) / 2500.0, q.expiry);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.size()));
+}
+BENCHMARK(BM_FrozenVolSurfaceGetVolNormStrike);
+
+static void BM_VolSurfaceFreeze(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    
+    for (auto _ : state) {
+        FrozenVolSurface frozen = market->volSurface->freeze();
+        benchmark::DoNotOptimize(&frozen);
+    }
+}
+BENCHMARK(BM_VolSurfaceFreeze);
+
+// Per-step surface cost: full construction (arbitrage checks included) ...
+static void BM_VolSurfaceConstruct(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    SurfaceParams p = nextStepParams(*market->volSurface);
+    
+    for (auto _ : state) {
+        VolSurface surface(p.expiries, p.atmOneMonthVol, p.skew, p.convexity, p.volMean, p.spot, Config::INTEREST_RATE);
+        benchmark::DoNotOptimize(surface.smiles.data());
+    }
+}
+BENCHMARK(BM_VolSurfaceConstruct);
+
+static void BM_VolSurfaceConstructUnchecked(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    SurfaceParams p = nextStepParams(*market->volSurface);
+    ArbitrageChecker::setMode(ArbitrageCheckMode::OFF);
+    
+    for (auto _ : state) {
+        VolSurface surface(p.expiries, p.atmOneMonthVol, p.skew, p.convexity, p.volMean, p.spot, Config::INTEREST_RATE);
+        benchmark::DoNotOptimize(surface.smiles.data());
+    }
+    ArbitrageChecker::setMode(ArbitrageCheckMode::FULL);
+}
+BENCHMARK(BM_VolSurfaceConstructUnchecked);
+
+// ... against the in-place rebuild of an existing surface
+static void BM_VolSurfaceRebuild(benchmark::State& state) {
+    auto market = omm::bench::makeMarket();
+    SurfaceParams p = nextStepParams(*market->volSurface);
+    VolSurface surface = *market->volSurface;
+    
+    for (auto _ : state) {
+        surface.rebuild(p.expiries, p.atmOneMonthVol, p.skew, p.convexity, p.volMean, p.spot, Config::INTEREST_RATE);
+        benchmark::DoNotOptimize(surface.smiles.data());
+    }
+    
+    VolSurface full(p.expiries, p.atmOneMonthVol, p.skew, p.convexity, p.volMean, p.spot, Config::INTEREST_RATE);
+    state.counters["maxAbsDiff"] = maxKnotDiff(surface, full);
+}
+BENCHMARK(BM_VolSurfaceRebuild);
+
+// Calendar + butterfly checks of all test surfaces: previous nested loops ...
+static void BM_ArbitrageCheckLegacy(benchmark::State& state) {
+    auto surfaces = makeCheckSurfaces();
+    
+    for (auto _ : state) {
+        for (const auto& surface : surfaces) {
+            LegacyCounts counts = legacyArbitrageCheck(surface);
+            benchmark::DoNotOptimize(&counts);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(surfaces.size()));
+}
+BENCHMARK(BM_ArbitrageCheckLegacy);
+
+// ... against the merge-based checker, which also reports every violation
+static void BM_ArbitrageCheck(benchmark::State& state) {
+    auto surfaces = makeCheckSurfaces();
+    
+    for (auto _ : state) {
+        for (const auto& surface : surfaces) {
+            ArbitrageReport report = ArbitrageChecker::check(surface);
+            benchmark::DoNotOptimize(&report);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(surfaces.size()));
+    
+    double calendar = 0.0, butterfly = 0.0, mismatches = 0.0;
+    for (const auto& surface : surfaces) {
+        ArbitrageReport report = ArbitrageChecker::check(surface);
+        LegacyCounts counts = legacyArbitrageCheck(surface);
+        calendar += report.calendarCount;
+        butterfly += report.butterflyCount;
+        mismatches += (report.calendarCount != counts.calendar) + (report.butterflyCount != counts.butterfly);
+    }
+    state.counters["calendar"] = calendar;
+    state.counters["butterfly"] = butterfly;
+    state.counters["mismatches"] = mismatches;
+}
+BENCHMARK(BM_ArbitrageCheck);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "analytics/outputbuffer.hpp"
+#include "analytics/snapshotfile.hpp"
+#include "analytics/table.hpp"
+#include "core/models/market.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace omm::analytics {
+
+enum class ExportFormat {
+    CSV,       // one text row per strike: time, expiry and the OptionChainRow fields
+    COLUMNAR   // a snapshot file (see SnapshotFileFormat), readable with SnapshotReader
+};
+
+// Streams the option chains of every expiry of a market, one call per simulation
+// step, to a file or an open stream such as a pipe. Chains are priced into scratch
+// kept between steps and formatted straight into the output buffer, so a step
+// allocates nothing once the first has sized the buffers.
+class ChainExporter {
+public:
+    // precision is the digits after the point of CSV fields; negative writes the
+    // shortest form that reads back to the same double
+    explicit ChainExporter(ExportFormat format_ = ExportFormat::CSV, int precision_ = -1);
+    
+    ChainExporter(const ChainExporter&) = delete;
+    ChainExporter& operator=(const ChainExporter&) = delete;
+    
+    // Create or truncate path; CSV output starts with a header line
+    bool open(const std::string& path, const std::string& assetSymbol);
+    
+    // Write to a stream the caller keeps open, e.g. stdout or a popen pipe
+    bool attach(std::FILE* stream, const std::string& assetSymbol);
+    
+    // Chains of every expiry of the market's surface
+    bool exportSurface(const core::models::Market& market);
+    
+    // Push what is buffered through to the stream; close() also flushes
+    bool flush();
+    bool close();
+    
+    std::size_t stepsWritten() const { return steps; }
+    std::uint64_t rowsWritten() const { return rows; }
+    std::uint64_t bytesWritten() const;
+    
+    // Chain of the last expiry exported
+    const std::vector<OptionChainRow>& lastChain() const { return chain; }
+
+private:
+    void writeHeader();
+    void writeCsvRows(int time, double expiry);
+    
+    ExportFormat format;
+    int precision;
+    OutputBuffer text;
+    SnapshotWriter columns;
+    OptionChainWorkspace workspace;
+    std::vector<OptionChainRow> chain;
+    std::size_t steps = 0;
+    std::uint64_t rows = 0;
+};
+
+}  // namespace omm::analytics
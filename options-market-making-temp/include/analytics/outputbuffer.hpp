@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace omm::analytics {
+
+// Fixed-size text buffer in front of a stdio stream (a file, stdout or a popen pipe).
+// Numbers are formatted straight into it with std::to_chars, so no locale, stream
+// state or temporary strings are involved; the stream sees one fwrite per buffer. After
+// a failed write every call returns false.
+class OutputBuffer {
+public:
+    // Room always kept for one formatted number; capacities below it are raised to it
+    static constexpr std::size_t MAX_NUMBER = 512;
+    
+    explicit OutputBuffer(std::size_t capacity_ = 1 << 20);
+    ~OutputBuffer();
+    
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+    
+    // Create or truncate path; the buffer owns and closes the file
+    bool open(const std::string& path);
+    
+    // Write to a stream the caller keeps open, e.g. stdout
+    bool attach(std::FILE* stream_);
+    
+    void put(char c) {
+        if (end - pos < 1) drain();
+        buffer[pos++] = c;
+    }
+    void put(std::string_view text);
+    void put(char c, std::size_t count);
+    
+    void putInt(long long value);
+    
+    // precision digits after the point; negative writes the shortest form that reads
+    // back to the same double
+    void putDouble(double value, int precision = -1);
+    
+    // Right-aligned in width columns, as std::setw with std::fixed would print it
+    void putPadded(std::string_view text, int width);
+    void putPadded(double value, int width, int precision);
+    
+    // Write the buffer and flush the stream; close() also flushes
+    bool flush();
+    bool close();
+    
+    bool isOpen() const { return stream != nullptr; }
+    bool ok() const { return !failed; }
+    std::uint64_t bytesWritten() const { return streamBytes + pos; }
+
+private:
+    // Write out the buffered text (without flushing the stream)
+    bool drain();
+    char* reserve() {
+        if (end - pos < MAX_NUMBER) drain();
+        return buffer.data() + pos;
+    }
+    
+    std::vector<char> buffer;
+    std::size_t pos = 0;
+    std::size_t end;
+    std::FILE* stream = nullptr;
+    bool ownsStream = false;
+    bool failed = false;
+    std::uint64_t streamBytes = 0;
+};
+
+}  // namespace omm::analytics
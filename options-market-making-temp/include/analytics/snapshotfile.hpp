@@ -0,0 +1,204 @@
+#pragma once
+
+#include "analytics/table.hpp"
+#include "core/models/market.hpp"
+#include "core/models/ssvi.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace omm::analytics {
+
+// Columnar binary file of market snapshots and option-chain rows.
+//
+// A 64-byte file header (magic, format version, byte order, asset symbol) is followed
+// by chunks of up to chunkSnapshots snapshots. A chunk is a 40-byte header (counts and
+// payload size) and its columns, each 8-byte aligned:
+//     per snapshot: time, regime, spot, interest rate, one-month ATM vol, surface kind,
+//                   SSVI rho / eta / gamma, end of its expiries, end of its chain rows
+//     per expiry:   expiry, ATM total variance (SSVI surfaces), end of its knots
+//     per knot:     norm strike, vol
+//     per row:      expiry and the OptionChainRow fields
+// Ends are cumulative within the chunk. There is no index or footer: the reader walks
+// the chunk headers, so a file cut short by a crash still reads up to its last whole
+// chunk.
+struct SnapshotFileFormat {
+    static constexpr char MAGIC[8] = {'O', 'M', 'M', 'S', 'N', 'A', 'P', '\0'};
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static constexpr std::uint32_t CHUNK_MAGIC = 0x4b4e4843;  // "CHNK"
+    static constexpr std::size_t HEADER_BYTES = 64;
+    static constexpr std::size_t CHUNK_HEADER_BYTES = 40;
+    static constexpr std::size_t MAX_SYMBOL = 32;
+};
+
+// Streams snapshots to a file, one chunk of columns in memory at a time. After a
+// failed write every call returns false; the chunks written before it stay readable.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::size_t chunkSnapshots_ = 64);
+    ~SnapshotWriter();
+    
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+    
+    // Create or truncate path; the symbol is cut to SnapshotFileFormat::MAX_SYMBOL bytes
+    bool open(const std::string& path, const std::string& assetSymbol);
+    
+    // Write to a stream the caller keeps open (stdout, a pipe); close() flushes it
+    bool attach(std::FILE* stream, const std::string& assetSymbol);
+    
+    // Market state and surface knots (or SSVI parameters) of a new snapshot
+    bool append(const core::models::Market& market);
+    
+    // Chain rows of one expiry, added to the last snapshot
+    bool appendChain(double expiry, const std::vector<OptionChainRow>& rows);
+    
+    // Write the pending chunk and flush the stream; close() also flushes
+    bool flush();
+    bool close();
+    
+    std::size_t numSnapshots() const { return snapshotsWritten + times.size(); }
+    std::uint64_t bytesWritten() const { return fileBytes; }
+
+private:
+    bool start(std::FILE* stream, bool owned, const std::string& assetSymbol);
+    bool writeBytes(const void* data, std::size_t size);
+    template <typename T> bool writeColumn(const std::vector<T>& column);
+    
+    std::size_t chunkSnapshots;
+    std::FILE* file = nullptr;
+    bool ownsFile = false;
+    bool failed = false;
+    std::size_t snapshotsWritten = 0;
+    std::uint64_t fileBytes = 0;
+    
+    // Columns of the pending chunk
+    std::vector<std::int32_t> times;
+    std::vector<std::uint8_t> regimes;
+    std::vector<double> spots;
+    std::vector<double> interestRates;
+    std::vector<double> atmOneMonthVols;
+    std::vector<std::uint8_t> surfaceKinds;
+    std::vector<double> ssviRhos;
+    std::vector<double> ssviEtas;
+    std::vector<double> ssviGammas;
+    std::vector<std::uint32_t> expiryEnds;
+    std::vector<std::uint32_t> rowEnds;
+    std::vector<double> expiries;
+    std::vector<double> atmTotalVariances;
+    std::vector<std::uint32_t> knotEnds;
+    std::vector<double> normStrikes;
+    std::vector<double> volPoints;
+    std::vector<double> rowExpiries;
+    std::vector<std::vector<double>> rowFields;  // one column per OptionChainRow field
+};
+
+// Option-chain rows of one snapshot as columns, in OptionChainRow field order
+struct OptionChainColumns {
+    static constexpr std::size_t NUM_FIELDS = sizeof(OptionChainRow) / sizeof(double);
+    
+    std::size_t size = 0;
+    const double* expiries = nullptr;
+    const double* fields[NUM_FIELDS] = {};
+    
+    OptionChainRow row(std::size_t i) const;
+};
+
+struct SmileView {
+    std::size_t size;
+    const double* normStrikes;
+    const double* volPoints;
+};
+
+// One snapshot, pointing into the reader's mapping (valid while the reader is open)
+struct SnapshotView {
+    int time;
+    double spot;
+    core::models::Regime regime;
+    double interestRate;
+    double atmOneMonthVol;
+    bool isSsvi;
+    core::models::SsviParams ssviParams;
+    std::size_t numExpiries;
+    const double* expiries;
+    const double* atmTotalVariances;
+    OptionChainColumns chain;
+    
+    // Knot ends of the snapshot's expiries (cumulative within its chunk) and the
+    // chunk's knot columns
+    const std::uint32_t* knotEnds;
+    std::size_t firstKnot;
+    const double* normStrikes;
+    const double* volPoints;
+    
+    SmileView smile(std::size_t expiryIdx) const;
+};
+
+// Memory-mapped reader. Views point into the mapping, so reading a snapshot copies
+// nothing; restore() copies one into a Market for re-pricing.
+class SnapshotReader {
+public:
+    SnapshotReader() = default;
+    ~SnapshotReader();
+    
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+    
+    // False if the file cannot be mapped, is not a snapshot file, or has another
+    // version or byte order. Reading stops before the first chunk that is cut short or
+    // whose counts and ends do not agree.
+    bool open(const std::string& path);
+    void close();
+    
+    std::size_t numSnapshots() const { return snapshotCount; }
+    std::uint32_t version() const { return fileVersion; }
+    const std::string& assetSymbol() const { return symbol; }
+    std::size_t fileSize() const { return size; }
+    
+    SnapshotView snapshot(std::size_t idx) const;
+    
+    // Snapshot idx into market, reusing its surface's storage (a surface is created if
+    // it has none). Prices off the restored market match the original bit for bit.
+    void restore(std::size_t idx, core::models::Market& market) const;
+    std::shared_ptr<core::models::Market> market(std::size_t idx) const;
+
+private:
+    // Column pointers of one chunk
+    struct Chunk {
+        std::size_t firstSnapshot;
+        std::size_t numSnapshots;
+        const std::int32_t* times;
+        const std::uint8_t* regimes;
+        const double* spots;
+        const double* interestRates;
+        const double* atmOneMonthVols;
+        const std::uint8_t* surfaceKinds;
+        const double* ssviRhos;
+        const double* ssviEtas;
+        const double* ssviGammas;
+        const std::uint32_t* expiryEnds;
+        const std::uint32_t* rowEnds;
+        const double* expiries;
+        const double* atmTotalVariances;
+        const std::uint32_t* knotEnds;
+        const double* normStrikes;
+        const double* volPoints;
+        const double* rowExpiries;
+        const double* rowFields[OptionChainColumns::NUM_FIELDS];
+    };
+    
+    const unsigned char* data = nullptr;
+    std::size_t size = 0;
+    bool mapped = false;
+    std::vector<unsigned char> buffer;  // file contents where mmap is unavailable
+    std::uint32_t fileVersion = 0;
+    std::string symbol;
+    std::vector<Chunk> chunks;
+    std::size_t snapshotCount = 0;
+};
+
+}  // namespace omm::analytics
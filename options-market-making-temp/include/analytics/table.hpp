@@ -1,5 +1,6 @@
 #pragma once
 
+#include "analytics/outputbuffer.hpp"
 #include "core/models/market.hpp"
 #include "core/models/option.hpp"
 #include <map>
@@ -25,6 +26,14 @@ struct OptionChainRow {
     double putTheta;
 };
 
+// Scratch of getOptionChainTable, kept by callers that build chains repeatedly
+struct OptionChainWorkspace {
+    std::vector<double> normStrikes;
+    std::vector<double> strikes;
+    std::vector<double> expiries;
+    std::vector<double> results;
+};
+
 class Table {
 public:
     // Generate option chain table for a given expiry
@@ -33,8 +42,20 @@ public:
         double expiry
     );
     
+    // Same rows into rows (cleared first); allocates nothing once the workspace and
+    // rows have grown to a chain's size
+    static void getOptionChainTable(
+        const omm::core::models::Market& market,
+        double expiry,
+        OptionChainWorkspace& workspace,
+        std::vector<OptionChainRow>& rows
+    );
+    
     // Print option chain table to console
     static void printOptionChainTable(const std::vector<OptionChainRow>& chain);
+    
+    // The console table into out
+    static void writeOptionChainTable(OutputBuffer& out, const std::vector<OptionChainRow>& chain);
 };
 
 }  // namespace omm::analytics
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace omm::core::aad {
+
+using NodeIndex = std::uint32_t;
+
+// Index of values that are constants rather than nodes of a tape
+constexpr NodeIndex CONSTANT = ~NodeIndex(0);
+
+// Reverse-mode tape. Each node stores the partial derivatives of its value with
+// respect to the nodes it was computed from; propagate() then walks the tape
+// backwards once and leaves d output / d node in every node's adjoint. Nodes may
+// have any number of parents, so a whole sub-computation with known partials (a
+// Black price, a weighted sum) can be a single node. clear() keeps the storage,
+// so a tape reused across valuations stops allocating.
+class Tape {
+public:
+    // Input whose adjoint is wanted
+    NodeIndex variable() { return record(nullptr, nullptr, 0); }
+    
+    NodeIndex record(NodeIndex a, double da) { return record(&a, &da, 1); }
+    
+    NodeIndex record(NodeIndex a, double da, NodeIndex b, double db) {
+        NodeIndex nodes[2] = {a, b};
+        double partials[2] = {da, db};
+        return record(nodes, partials, 2);
+    }
+    
+    // Parents that are CONSTANT are skipped
+    NodeIndex record(const NodeIndex* nodes, const double* partials, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (nodes[i] == CONSTANT) continue;
+            parents.push_back(nodes[i]);
+            parentPartials.push_back(partials[i]);
+        }
+        offsets.push_back(static_cast<std::uint32_t>(parents.size()));
+        return static_cast<NodeIndex>(offsets.size() - 2);
+    }
+    
+    // Adjoints of every node for d output / d node
+    void propagate(NodeIndex output) {
+        adjoints.assign(size(), 0.0);
+        adjoints[output] = 1.0;
+        for (std::size_t node = output + 1; node-- > 0;) {
+            double adjoint = adjoints[node];
+            if (adjoint == 0.0) continue;
+            for (std::uint32_t k = offsets[node]; k < offsets[node + 1]; ++k) {
+                adjoints[parents[k]] += adjoint * parentPartials[k];
+            }
+        }
+    }
+    
+    double adjoint(NodeIndex node) const { return node == CONSTANT ? 0.0 : adjoints[node]; }
+    
+    void clear() {
+        offsets.assign(1, 0);
+        parents.clear();
+        parentPartials.clear();
+    }
+    
+    void reserve(std::size_t nodes, std::size_t edges) {
+        offsets.reserve(nodes + 1);
+        parents.reserve(edges);
+        parentPartials.reserve(edges);
+        adjoints.reserve(nodes);
+    }
+    
+    std::size_t size() const { return offsets.size() - 1; }
+
+private:
+    std::vector<std::uint32_t> offsets = {0};  // node i's parents are [offsets[i], offsets[i + 1])
+    std::vector<NodeIndex> parents;
+    std::vector<double> parentPartials;
+    std::vector<double> adjoints;
+};
+
+// A double that records how it was computed on a tape. Operations between
+// constants stay plain arithmetic; anything involving a recorded value adds one
+// node to that value's tape.
+class Real {
+public:
+    Real(double value_ = 0.0) : value(value_) {}
+    Real(double value_, NodeIndex node_, Tape* tape_) : value(value_), node(node_), tape(tape_) {}
+    
+    // New input on tape
+    static Real variable(double value, Tape& tape) { return Real(value, tape.variable(), &tape); }
+    
+    // Value with known partials to parents (CONSTANT parents are skipped); the tape is
+    // the first recorded parent's
+    template <std::size_t N>
+    static Real record(double value, const Real (&parents)[N], const double (&partials)[N]) {
+        Tape* tape = nullptr;
+        NodeIndex nodes[N];
+        for (std::size_t i = 0; i < N; ++i) {
+            nodes[i] = parents[i].node;
+            if (!tape) tape = parents[i].tape;
+        }
+        if (!tape) return Real(value);
+        return Real(value, tape->record(nodes, partials, N), tape);
+    }
+    
+    double value;
+    NodeIndex node = CONSTANT;
+    Tape* tape = nullptr;
+    
+    bool isConstant() const { return node == CONSTANT; }
+};
+
+inline Real unary(const Real& x, double value, double dx) {
+    if (x.isConstant()) return Real(value);
+    return Real(value, x.tape->record(x.node, dx), x.tape);
+}
+
+inline Real binary(const Real& a, const Real& b, double value, double da, double db) {
+    if (a.isConstant()) return unary(b, value, db);
+    if (b.isConstant()) return unary(a, value, da);
+    return Real(value, a.tape->record(a.node, da, b.node, db), a.tape);
+}
+
+inline Real operator+(const Real& a, const Real& b) { return binary(a, b, a.value + b.value, 1.0, 1.0); }
+inline Real operator-(const Real& a, const Real& b) { return binary(a, b, a.value - b.value, 1.0, -1.0); }
+inline Real operator*(const Real& a, const Real& b) { return binary(a, b, a.value * b.value, b.value, a.value); }
+inline Real operator/(const Real& a, const Real& b) {
+    double inv = 1.0 / b.value;
+    double value = a.value * inv;
+    return binary(a, b, value, inv, -value * inv);
+}
+inline Real operator-(const Real& x) { return unary(x, -x.value, -1.0); }
+
+inline Real exp(const Real& x) {
+    double value = std::exp(x.value);
+    return unary(x, value, value);
+}
+inline Real log(const Real& x) { return unary(x, std::log(x.value), 1.0 / x.value); }
+inline Real sqrt(const Real& x) {
+    double value = std::sqrt(x.value);
+    return unary(x, value, 0.5 / value);
+}
+
+inline double valueOf(double x) { return x; }
+inline double valueOf(const Real& x) { return x.value; }
+
+}  // namespace omm::core::aad
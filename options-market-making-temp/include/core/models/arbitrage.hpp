@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace omm::core::models {
+
+class VolSurface;
+
+enum class ArbitrageType {
+    CALENDAR,
+    BUTTERFLY
+};
+
+struct ArbitrageViolation {
+    ArbitrageType type;
+    std::size_t expiryIdx;  // Calendar: earlier expiry of the pair; butterfly: the smile
+    double expiry;
+    double laterExpiry;     // Calendar only (equal to expiry for butterflies)
+    double normStrike;
+    double varianceGap;     // Calendar: earlier - later total variance; butterfly: -(w+ - 2w + w-)
+};
+
+struct ArbitrageReport {
+    std::vector<ArbitrageViolation> violations;
+    std::size_t calendarCount = 0;
+    std::size_t butterflyCount = 0;
+    
+    bool empty() const { return violations.empty(); }
+};
+
+// When VolSurface's constructor checks for arbitrage
+enum class ArbitrageCheckMode {
+    FULL,      // every surface (default)
+    SAMPLED,   // every sampleInterval-th surface constructed
+    DEFERRED,  // none; VolSurface::ensureArbitrageChecked runs it when a surface is used
+    OFF        // never, ensureArbitrageChecked included
+};
+
+// Calendar and butterfly checks in one linear pass per smile.
+//
+// Calendar: the norm strikes of adjacent smiles (rounded to 2 decimals, as before) are
+// merged with two cursors instead of compared pairwise, and the later smile is
+// interpolated at each common strike with a cursor that only moves forward.
+// Butterfly: a vectorizable pass over total variance w = vol^2 T counts concave
+// points; details are only collected for smiles that have any.
+class ArbitrageChecker {
+public:
+    static constexpr double TOLERANCE = 1e-8;  // on total variance
+    
+    static ArbitrageReport check(const VolSurface& surface);
+    static void checkCalendar(const VolSurface& surface, ArbitrageReport& report);
+    static void checkButterfly(const VolSurface& surface, ArbitrageReport& report);
+    
+    // Process-wide construction policy; safe to change while surfaces are being built
+    static void setMode(ArbitrageCheckMode mode, std::size_t sampleInterval = 100);
+    static ArbitrageCheckMode mode();
+    
+    // Whether the surface being constructed now should be checked under the policy
+    static bool shouldCheckOnConstruction();
+
+private:
+    static std::atomic<ArbitrageCheckMode> currentMode;
+    static std::atomic<std::size_t> sampleInterval;
+    static std::atomic<std::size_t> constructed;
+};
+
+}  // namespace omm::core::models
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ssvi.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace omm::core::models {
+
+class VolSurface;
+
+// Immutable, cache-resident copy of a VolSurface for O(1) lookups.
+//
+// Every smile's knots live back to back in flat arrays with precomputed slopes, the ATM
+// vol of each expiry is cached, and expiries and knots are located through uniform
+// bucket tables instead of binary searches. Lookups follow VolSurface's interpolation
+// (flat extrapolation, linear in norm strike, then linear in expiry) and agree with it
+// to a few ULPs. A NaN norm strike or expiry takes the low end's flat extrapolation.
+// A surface backed by SSVI is copied as its model and looked up in closed form.
+class FrozenVolSurface {
+public:
+    FrozenVolSurface() = default;
+    explicit FrozenVolSurface(const VolSurface& surface);
+    
+    double getNormStrike(double strike, double forward, double expiry) const;
+    double getVolNormStrike(double normStrike, double expiry) const;
+    double getVol(double strike, double forward, double expiry) const;
+    double getAtmVol(double expiry) const;
+    
+    // getVolNormStrike for n norm strikes of one expiry, locating the expiry once
+    void getVolsNormStrike(const double* normStrikes, double expiry, double* vols, std::size_t n) const;
+    
+    std::size_t numExpiries() const { return expiries.size(); }
+
+private:
+    // Bracketing index of a sorted array through a uniform bucket table
+    struct UniformIndex {
+        double origin = 0.0;
+        double invWidth = 0.0;
+        std::uint32_t bucketOffset = 0;
+        std::uint32_t numBuckets = 0;
+    };
+    
+    struct SmileRange {
+        std::uint32_t knotOffset = 0;
+        std::uint32_t numKnots = 0;
+        UniformIndex index;
+    };
+    
+    // Lower expiry of the bracket and the interpolation weight towards the upper one
+    struct ExpiryBracket {
+        std::size_t idx;
+        double weight;
+    };
+    
+    static UniformIndex buildIndex(const double* values, std::size_t count, std::vector<std::uint32_t>& buckets);
+    std::size_t findInterval(const UniformIndex& index, const double* values, std::size_t count, double x) const;
+    
+    ExpiryBracket locateExpiry(double expiry) const;
+    double smileVol(std::size_t smileIdx, double normStrike) const;
+    double atmVol(const ExpiryBracket& bracket) const;
+    double volNormStrike(const ExpiryBracket& bracket, double normStrike) const;
+    
+    std::vector<double> expiries;
+    std::vector<double> invExpirySpans;  // 1 / (expiries[i + 1] - expiries[i])
+    UniformIndex expiryIndex;
+    std::vector<double> atmVols;         // smile vol at norm strike 0, per expiry
+    std::vector<SmileRange> smiles;
+    std::vector<double> knotNormStrikes;  // all smiles back to back
+    std::vector<double> knotVols;
+    std::vector<double> knotSlopes;       // towards the next knot of the same smile
+    std::vector<std::uint32_t> buckets;  // bucket tables of expiryIndex and every smile
+    std::optional<SsviSurface> ssvi;
+};
+
+}  // namespace omm::core::models
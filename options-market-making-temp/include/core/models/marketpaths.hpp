@@ -0,0 +1,54 @@
+#pragma once
+
+#include "asset.hpp"
+#include "regime.hpp"
+#include "volsurface.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace omm::core::models {
+
+// Simulated regime / spot / ATM vol of numPaths paths over numSteps time steps.
+//
+// Values are stored step-major in structure-of-arrays form: the numPaths values of
+// one step are contiguous, and step 0 holds the initial market. Path i is path
+// firstPath + i of the seed's random stream. Only the initial
+// surface is kept; PathSimulator::materializeMarket rebuilds later ones on request.
+class MarketPaths {
+public:
+    std::size_t numPaths = 0;
+    std::size_t numSteps = 0;
+    std::uint64_t seed = 0;
+    std::size_t firstPath = 0;  // index in the seed's stream of path 0
+    
+    // Shared by every path
+    Asset asset;
+    int startTime = 0;
+    double interestRate = 0.0;
+    std::shared_ptr<VolSurface> initialVolSurface;
+    std::vector<std::vector<double>> expiries;  // surface expiries of each step
+    
+    std::vector<Regime> regimes;
+    std::vector<double> spots;
+    std::vector<double> atmOneMonthVols;
+    
+    MarketPaths() = default;
+    MarketPaths(std::size_t numPaths_, std::size_t numSteps_, std::uint64_t seed_)
+        : numPaths(numPaths_), numSteps(numSteps_), seed(seed_),
+          regimes((numSteps_ + 1) * numPaths_), spots((numSteps_ + 1) * numPaths_),
+          atmOneMonthVols((numSteps_ + 1) * numPaths_) {}
+    
+    std::size_t index(std::size_t step, std::size_t path) const { return step * numPaths + path; }
+    
+    Regime regime(std::size_t step, std::size_t path) const { return regimes[index(step, path)]; }
+    double spot(std::size_t step, std::size_t path) const { return spots[index(step, path)]; }
+    double atmOneMonthVol(std::size_t step, std::size_t path) const { return atmOneMonthVols[index(step, path)]; }
+    
+    // All paths at one step
+    const double* stepSpots(std::size_t step) const { return spots.data() + index(step, 0); }
+    const double* stepAtmOneMonthVols(std::size_t step) const { return atmOneMonthVols.data() + index(step, 0); }
+};
+
+}  // namespace omm::core::models
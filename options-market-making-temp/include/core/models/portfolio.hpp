@@ -0,0 +1,75 @@
+#pragma once
+
+#include "future.hpp"
+#include "option.hpp"
+#include "optiontype.hpp"
+#include "position.hpp"
+#include "risk.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace omm::core::models {
+
+// Option legs of one expiry in structure-of-arrays form
+struct OptionBucket {
+    double expiry = 0.0;
+    std::vector<double> strikes;
+    std::vector<double> expiries;  // all equal to expiry; the batch pricer reads one per leg
+    std::vector<OptionType> optionTypes;
+    std::vector<double> weights;   // quantity * lotSize
+    std::vector<double> logStrikes;  // log(K) is fixed, log(K / F) = log(K) - log(F) per tick
+    
+    std::size_t size() const { return strikes.size(); }
+};
+
+struct ExpiryRisk {
+    double expiry;
+    Risk risk;
+};
+
+struct PortfolioRisk {
+    Risk total;                      // options and futures
+    std::vector<ExpiryRisk> byExpiry;  // options only, in Portfolio::optionBuckets order
+};
+
+// Uniform norm-strike buckets of a RiskLadder; legs outside [min, max) fall into the
+// first or last bucket. A reversed range is swapped and an empty one widened to
+// [min - 0.5, min + 0.5]; RiskLadder::spec holds the range used.
+struct RiskLadderSpec {
+    double minNormStrike = -3.0;
+    double maxNormStrike = 3.0;
+    std::size_t numBuckets = 12;
+};
+
+// Greeks by expiry bucket and by (expiry, norm-strike bucket)
+struct RiskLadder {
+    RiskLadderSpec spec;
+    Risk total;                      // options and futures
+    std::vector<ExpiryRisk> byExpiry;  // options only, in Portfolio::optionBuckets order
+    std::vector<double> vega;        // [expiry row * spec.numBuckets + norm-strike bucket]
+    std::vector<double> gamma;
+    
+    double vegaAt(std::size_t expiryIdx, std::size_t bucket) const { return vega[expiryIdx * spec.numBuckets + bucket]; }
+    double gammaAt(std::size_t expiryIdx, std::size_t bucket) const { return gamma[expiryIdx * spec.numBuckets + bucket]; }
+};
+
+// Columnar book. Options sit in per-expiry buckets sorted by expiry and futures only
+// carry their delta weight, so pricing needs no virtual calls or casts.
+class Portfolio {
+public:
+    std::vector<OptionBucket> optionBuckets;  // sorted by expiry
+    std::vector<double> futureWeights;        // quantity * lotSize
+    
+    void addOption(const Option& option, int quantity);
+    void addFuture(const Future& future, int quantity);
+    
+    // Dispatches on the security type once, here; other securities are ignored
+    void addPosition(const Position& position);
+    
+    std::size_t numOptions() const;
+    std::size_t numFutures() const { return futureWeights.size(); }
+    
+    static Portfolio fromPositions(const std::vector<Position>& positions);
+};
+
+}  // namespace omm::core::models
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace omm::core::models {
+
+// Append-only trade log in columns, one row per trade: the Python PosArchive
+// (position, price, time). The position is an instrument row of its owner (see
+// engine::PositionTable) and a signed quantity, so rows are plain data and a row
+// index is a stable trade id.
+struct PosArchive {
+    std::vector<std::uint32_t> instruments;
+    std::vector<int> quantities;  // positive when bought
+    std::vector<double> prices;   // per unit of the underlying
+    std::vector<int> times;       // Market::time of the trade
+    
+    void append(std::uint32_t instrument, int quantity, double price, int time) {
+        instruments.push_back(instrument);
+        quantities.push_back(quantity);
+        prices.push_back(price);
+        times.push_back(time);
+    }
+    
+    void reserve(std::size_t rows) {
+        instruments.reserve(rows);
+        quantities.reserve(rows);
+        prices.reserve(rows);
+        times.reserve(rows);
+    }
+    
+    std::size_t size() const { return instruments.size(); }
+};
+
+}  // namespace omm::core::models
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "market.hpp"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace omm::core::models {
+
+// Recycled storage for Market snapshots and their vol surfaces.
+//
+// acquire() hands out a shared_ptr<Market> whose volSurface points into the same
+// pooled slot. Both shared_ptr control blocks are placed in buffers inside the slot,
+// and the slot goes back on the free list once both are gone. A slot keeps its smile
+// vectors between uses, so refilling it (VolSurface::rebuild) does not allocate once
+// the pool has as many slots as snapshots are alive at a time.
+//
+// The pool must outlive every snapshot it handed out.
+class SnapshotPool {
+public:
+    struct Stats {
+        std::size_t slots = 0;      // allocated so far
+        std::size_t inUse = 0;
+        std::size_t peakInUse = 0;
+        std::size_t acquired = 0;   // acquire() calls
+    };
+    
+    explicit SnapshotPool(std::size_t initialSlots = 0);
+    ~SnapshotPool();
+    
+    SnapshotPool(const SnapshotPool&) = delete;
+    SnapshotPool& operator=(const SnapshotPool&) = delete;
+    
+    // Market with a pooled surface. Its fields hold whatever the slot held last and
+    // are meant to be overwritten (see Simulator::simulateNextMarket).
+    std::shared_ptr<Market> acquire();
+    
+    Stats stats() const;
+
+private:
+    struct Slot;
+    struct MarketDeleter;
+    template <typename T> class SlotAllocator;
+    
+    Slot* popSlot();
+    void releaseSlot(Slot* slot);
+    
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::vector<Slot*> freeSlots;
+    Stats counters;
+};
+
+}  // namespace omm::core::models
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace omm::core::models {
+
+// Surface-wide SSVI shape: correlation rho and the power-law curvature
+// phi(theta) = eta / (theta^gamma (1 + theta)^(1 - gamma))
+struct SsviParams {
+    double rho = -0.7;
+    double eta = 1.0;
+    double gamma = 0.5;
+};
+
+// Vol and its derivatives in log-moneyness k = log(K / F) at one point of the surface
+struct SmileDerivatives {
+    double vol;
+    double dVolDk;
+    double d2VolDk2;
+};
+
+// Gatheral-Jacquier SSVI surface: total variance
+//     w(k, T) = theta / 2 * (1 + rho phi k + sqrt((phi k + rho)^2 + 1 - rho^2))
+// with theta = theta(T) the ATM total variance and phi = phi(theta). Storage is one
+// theta per expiry plus three shape parameters.
+//
+// The constructor enforces the conditions under which the surface is free of static
+// arbitrage: |rho| < 1, 0 <= gamma <= 1/2 and eta (1 + |rho|) <= 2 (no butterfly
+// arbitrage), and theta non-decreasing in expiry (no calendar arbitrage); inputs
+// outside them are clamped, as are expiries below a millionth of a day so that
+// theta / T stays finite. Between expiries theta is linear in time, before the
+// first it grows from 0 and after the last the ATM vol stays flat, which keeps theta
+// non-decreasing everywhere.
+class SsviSurface {
+public:
+    static constexpr double MAX_ABS_RHO = 0.999;
+    
+    SsviSurface() = default;
+    
+    // atmTotalVariances[i] = ATM vol^2 * T (years) at expiries[i] (days), expiries sorted
+    SsviSurface(
+        const std::vector<double>& expiries_,
+        const std::vector<double>& atmTotalVariances_,
+        const SsviParams& params_ = {}
+    );
+    
+    double atmTotalVariance(double expiry) const;
+    double totalVariance(double logMoneyness, double expiry) const;
+    double getVol(double logMoneyness, double expiry) const;
+    double getAtmVol(double expiry) const;
+    SmileDerivatives getVolDerivatives(double logMoneyness, double expiry) const;
+    
+    // Same norm strike as VolSurface, log(K / F) / (atmVol sqrt(T)) = k / sqrt(theta)
+    double getVolNormStrike(double normStrike, double expiry) const;
+    
+    const std::vector<double>& expiries() const { return knotExpiries; }
+    const std::vector<double>& atmTotalVariances() const { return thetas; }
+    const SsviParams& params() const { return shape; }
+    
+    // Heap and object bytes of the model
+    std::size_t memoryBytes() const;
+
+private:
+    // ATM total variance and curvature at one expiry
+    struct Slice {
+        double theta;
+        double phi;
+        double tte;
+    };
+    
+    Slice slice(double expiry) const;
+    double phi(double theta) const;
+    double totalVariance(const Slice& s, double logMoneyness) const;
+    
+    std::vector<double> knotExpiries;
+    std::vector<double> thetas;
+    std::vector<double> phis;  // phi(theta) at each expiry, so that quotes at an expiry skip the pow
+    SsviParams shape;
+};
+
+}  // namespace omm::core::models
@@ -1,5 +1,10 @@
 #pragma once
 
+#include "arbitrage.hpp"
+#include "frozenvolsurface.hpp"
+#include "ssvi.hpp"
+#include <cstddef>
+#include <optional>
 #include <vector>
 #include <map>
 
@@ -17,12 +22,37 @@ public:
     double getVol(double normStrike) const;
 };
 
+// Parametric smile of one expiry: vol = atmVol + skew * ns + convexity * ns^2
+struct SmileParams {
+    double atmVol;
+    double skew;
+    double convexity;
+};
+
 class VolSurface {
 public:
+    // Strike grid of every smile: spot + z * GRID_STRIKE_STEP for |z| <= GRID_STEP_DIST,
+    // the defaults of Utils::getNormStrikes and InstrumentRegistry::fromVolSurface. Code
+    // that rebuilds the knots (AadRisk) must use the same grid.
+    static constexpr int GRID_STEP_DIST = 40;
+    static constexpr double GRID_STRIKE_STEP = 50.0;
+    static constexpr std::size_t GRID_SIZE = 2 * GRID_STEP_DIST + 1;
+    
+    // Vol of every lookup on a surface without expiries
+    static constexpr double DEFAULT_VOL = 0.15;
+    
     std::vector<double> expiries;
     std::vector<Smile> smiles;
     double atmOneMonthVolEst;
     
+    // Analytic model instead of smiles: when set, smiles are empty and lookups are
+    // closed form. The rebuilds go back to smiles.
+    std::optional<SsviSurface> ssvi;
+    
+    // Filled when the surface was checked (see ArbitrageCheckMode); rebuild clears it
+    ArbitrageReport arbitrageReport;
+    bool arbitrageChecked = false;
+    
     VolSurface() = default;
     
     VolSurface(
@@ -35,6 +65,33 @@ public:
         double interestRate
     );
     
+    // Backed by an SSVI model; free of static arbitrage by construction, so no check runs
+    explicit VolSurface(const SsviSurface& model);
+    
+    // Rebuild in place with new parameters, giving the smiles the constructor would.
+    // The strike grid's log-moneyness is computed once and mapped affinely onto each
+    // expiry, smile storage is reused, and the arbitrage checks are skipped (call
+    // ensureArbitrageChecked if needed). expiries_ may be this surface's own expiries.
+    // Agrees with a freshly constructed surface to about 1e-14.
+    void rebuild(
+        const std::vector<double>& expiries_,
+        double atmOneMonthVolEst_,
+        double skew,
+        double convexity,
+        double volMean,
+        double spot,
+        double interestRate
+    );
+    
+    // Same, with each expiry's smile given directly (params[i] for expiries_[i])
+    // instead of the ATM term structure
+    void rebuild(
+        const std::vector<double>& expiries_,
+        const SmileParams* params,
+        double spot,
+        double interestRate
+    );
+    
     void addVolPoint(int idx, double normStrike, double vol);
     double getNormStrike(double strike, double forward, double expiry) const;
     double getStrike(double normStrike, double forward, double expiry) const;
@@ -42,8 +99,22 @@ public:
     double getVol(double strike, double forward, double expiry) const;
     double getAtmVol(double expiry) const;
     
+    // Immutable O(1)-lookup copy of this surface (see FrozenVolSurface)
+    FrozenVolSurface freeze() const;
+    
+    // Every violation, regardless of the check mode
+    ArbitrageReport checkArbitrage() const;
+    
+    // Run the check (and warn) unless it already ran or the mode is OFF
+    const ArbitrageReport& ensureArbitrageChecked();
+    
     bool hasButterflyArbitrage() const;
     bool hasCalendarArbitrage() const;
+
+private:
+    void recordArbitrage();
+    void resetForRebuild(const std::vector<double>& expiries_);
+    void fillSmile(std::size_t idx, const double* logMoneyness, double carry, const SmileParams& params);
 };
 
 }  // namespace omm::core::models
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace omm::core {
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random numbers: as
+// easy as 1, 2, 3"). Every (key, counter) pair maps to four independent 32-bit words,
+// so a stream can be addressed directly, e.g. by (seed, path, step), without carrying
+// generator state between draws or threads.
+class Philox4x32 {
+public:
+    struct Counter {
+        std::uint32_t words[4];
+    };
+    
+    struct Key {
+        std::uint32_t words[2];
+    };
+    
+    static Key makeKey(std::uint64_t seed) {
+        return Key{{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)}};
+    }
+    
+    static Counter generate(Counter ctr, Key key) {
+        for (int round = 0; round < ROUNDS; ++round) {
+            if (round > 0) {
+                key.words[0] += WEYL0;
+                key.words[1] += WEYL1;
+            }
+            std::uint64_t p0 = static_cast<std::uint64_t>(MULT0) * ctr.words[0];
+            std::uint64_t p1 = static_cast<std::uint64_t>(MULT1) * ctr.words[2];
+            ctr = Counter{{
+                static_cast<std::uint32_t>(p1 >> 32) ^ ctr.words[1] ^ key.words[0],
+                static_cast<std::uint32_t>(p1),
+                static_cast<std::uint32_t>(p0 >> 32) ^ ctr.words[3] ^ key.words[1],
+                static_cast<std::uint32_t>(p0),
+            }};
+        }
+        return ctr;
+    }
+    
+    // Same over n counters held as four word arrays, transformed in place; the loop over
+    // lanes vectorizes
+    static void generate(std::uint32_t* w0, std::uint32_t* w1, std::uint32_t* w2, std::uint32_t* w3,
+                         std::size_t n, Key key) {
+        for (int round = 0; round < ROUNDS; ++round) {
+            if (round > 0) {
+                key.words[0] += WEYL0;
+                key.words[1] += WEYL1;
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                std::uint64_t p0 = static_cast<std::uint64_t>(MULT0) * w0[i];
+                std::uint64_t p1 = static_cast<std::uint64_t>(MULT1) * w2[i];
+                std::uint32_t next0 = static_cast<std::uint32_t>(p1 >> 32) ^ w1[i] ^ key.words[0];
+                std::uint32_t next2 = static_cast<std::uint32_t>(p0 >> 32) ^ w3[i] ^ key.words[1];
+                w1[i] = static_cast<std::uint32_t>(p1);
+                w3[i] = static_cast<std::uint32_t>(p0);
+                w0[i] = next0;
+                w2[i] = next2;
+            }
+        }
+    }
+    
+    // Top 53 bits of two words to a double in [0, 1)
+    static double toUniform(std::uint32_t hi, std::uint32_t lo) {
+        std::uint64_t bits = (static_cast<std::uint64_t>(hi) << 32) | lo;
+        return static_cast<double>(bits >> 11) * 0x1.0p-53;
+    }
+
+private:
+    static constexpr int ROUNDS = 10;
+    static constexpr std::uint32_t MULT0 = 0xD2511F53;
+    static constexpr std::uint32_t MULT1 = 0xCD9E8D57;
+    static constexpr std::uint32_t WEYL0 = 0x9E3779B9;
+    static constexpr std::uint32_t WEYL1 = 0xBB67AE85;
+};
+
+}  // namespace omm::core
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace omm::core {
+
+// Merging t-digest (Dunning): a streaming quantile sketch of bounded size.
+//
+// Values are buffered and periodically merged into centroids (mean, weight). A
+// centroid spans at most one unit of the k2 scale function
+//     k(q) = compression / (4 log(n / compression) + 24) * log(q / (1 - q)),
+// so its weight is proportional to q (1 - q): the extreme values stay singletons and
+// the tails, where VaR and ES are read, keep the same relative resolution however
+// deep they go. Storage is O(compression) however many values are added. Quantiles
+// interpolate linearly between centroid centres, with the exact min and max at the
+// ends; tailMean sums the centroids below the quantile exactly.
+class TDigest {
+public:
+    explicit TDigest(double compression_ = 200.0);
+    
+    void add(double x, double weight = 1.0);
+    void merge(const TDigest& other);
+    
+    // Value at quantile q in [0, 1]
+    double quantile(double q) const;
+    
+    // Mean of the values below quantile q (expected shortfall of a P&L sample)
+    double tailMean(double q) const;
+    
+    double count() const { return totalWeight + bufferWeight; }
+    double min() const { return minValue; }
+    double max() const { return maxValue; }
+    double mean() const;
+    
+    // Centroids after merging the buffer
+    std::size_t numCentroids() const;
+    
+    // Heap and object bytes; fixed by the compression
+    std::size_t memoryBytes() const;
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+    
+    // Merge buffered values into the centroids; queries call it (hence mutable state)
+    void flush() const;
+    
+    // Quantile curve at rank t in [0, count()], and its integral over [0, t]
+    double valueAtRank(double t) const;
+    double integralToRank(double t) const;
+    
+    double compression;
+    std::size_t bufferCapacity;
+    mutable std::vector<Centroid> centroids;
+    mutable std::vector<Centroid> buffer;
+    mutable std::vector<Centroid> scratch;
+    mutable double totalWeight = 0.0;
+    mutable double bufferWeight = 0.0;
+    double sum = 0.0;
+    double minValue;
+    double maxValue;
+};
+
+}  // namespace omm::core
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace omm::core {
+
+// Fixed set of worker threads running parallelFor jobs with work stealing.
+//
+// A job's indices are dealt out in contiguous runs, one per thread, into per-thread
+// deques. Each thread takes from the back of its own deque and, once that is empty,
+// steals from the front of the others, so uneven tasks still balance out.
+class ThreadPool {
+public:
+    // numThreads includes the calling thread; 0 means one per hardware thread
+    explicit ThreadPool(std::size_t numThreads = 0);
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    std::size_t size() const { return queues.size(); }
+    
+    // Run task(i) for every i in [0, count) and wait. The calling thread takes part;
+    // the first exception thrown by a task is rethrown here once all tasks are done.
+    // Not reentrant: tasks must not call parallelFor on the same pool.
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& task);
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::size_t> indices;
+    };
+    
+    void workerLoop(std::size_t self);
+    void runTasks(std::size_t self, const std::function<void(std::size_t)>& task);
+    bool popTask(std::size_t self, std::size_t& index);
+    
+    std::vector<std::unique_ptr<WorkQueue>> queues;  // one per thread, caller at 0
+    std::vector<std::thread> workers;
+    
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(std::size_t)>* currentTask = nullptr;
+    std::size_t generation = 0;
+    std::size_t activeWorkers = 0;
+    bool stopping = false;
+    
+    std::atomic<std::size_t> remaining{0};
+    std::exception_ptr error;
+};
+
+}  // namespace omm::core
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/models/volsurface.hpp"
 #include <vector>
 #include <cmath>
 
@@ -19,8 +20,19 @@ public:
         double interestRate, 
         double expiry, 
         double atmVol,
-        int maxStrikeStepDist = 40, 
-        double strikeStep = 50.0
+        int maxStrikeStepDist = models::VolSurface::GRID_STEP_DIST,
+        double strikeStep = models::VolSurface::GRID_STRIKE_STEP
+    );
+    
+    // Same, into normStrikes (cleared first) to reuse its storage
+    static void getNormStrikes(
+        double spot,
+        double interestRate,
+        double expiry,
+        double atmVol,
+        std::vector<double>& normStrikes,
+        int maxStrikeStepDist = models::VolSurface::GRID_STEP_DIST,
+        double strikeStep = models::VolSurface::GRID_STRIKE_STEP
     );
     
     // Calculate forward price using risk-free rate
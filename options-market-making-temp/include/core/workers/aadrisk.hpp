@@ -0,0 +1,75 @@
+#pragma once
+
+#include "core/aad.hpp"
+#include "core/models/market.hpp"
+#include "core/models/portfolio.hpp"
+#include "core/models/volsurface.hpp"
+#include <vector>
+
+namespace omm::core::workers {
+
+// Inputs of VolSurface's parametric constructor and rebuild
+struct SurfaceParams {
+    double atmOneMonthVolEst = 0.0;
+    double skew = 0.0;
+    double convexity = 0.0;
+    double volMean = 0.0;
+};
+
+// Book value and its derivatives; the surface is held fixed in norm strike under
+// spot and rate moves (as Calculator prices against an unchanged VolSurface)
+struct SurfaceSensitivities {
+    double value = 0.0;
+    double spot = 0.0;
+    double interestRate = 0.0;
+    SurfaceParams surface;                           // parametric surfaces only
+    std::vector<omm::core::models::SmileParams> smiles;  // per expiry of market.volSurface
+};
+
+// Surface-parameter risk of a book by adjoint differentiation.
+//
+// The book is valued on an aad::Tape exactly as Calculator would price it against
+// the VolSurface the parameters build: knots of every smile, getAtmVol and the
+// norm-strike lookup with VolSurface's linear interpolation and flat extrapolation,
+// then Black-Scholes per leg. Each Black price is a single tape node with analytic
+// partials, and the book total is one node over all legs. One reverse sweep then
+// gives the derivatives to spot, rate, every expiry's (atmVol, skew, convexity) and,
+// for a parametric surface, its four parameters. Futures count one delta per unit,
+// as in calculatePortfolioRisk.
+//
+// market.volSurface supplies the expiries; its smiles are not read. The knots are
+// laid on the strike grid of market.spot and market.interestRate.
+class AadRisk {
+public:
+    static SurfaceSensitivities portfolioSensitivities(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market,
+        const SurfaceParams& params,
+        aad::Tape& tape
+    );
+    
+    // smiles[i] for market.volSurface->expiries[i], as VolSurface::rebuild takes them.
+    // With any other number of smiles every result is NaN (and smiles empty).
+    static SurfaceSensitivities portfolioSensitivities(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market,
+        const std::vector<omm::core::models::SmileParams>& smiles,
+        aad::Tape& tape
+    );
+    
+    // Same valuation in plain doubles
+    static double portfolioValue(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market,
+        const SurfaceParams& params
+    );
+    
+    // NaN unless there is one smile per expiry
+    static double portfolioValue(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market,
+        const std::vector<omm::core::models::SmileParams>& smiles
+    );
+};
+
+}  // namespace omm::core::workers
@@ -3,7 +3,9 @@
 #include "core/models/market.hpp"
 #include "core/models/option.hpp"
 #include "core/models/future.hpp"
+#include "core/models/portfolio.hpp"
 #include "core/models/risk.hpp"
+#include <cstddef>
 #include <vector>
 #include <memory>
 
@@ -18,6 +20,32 @@ struct OptionPricerInputs {
     double df;
 };
 
+// Structure-of-arrays view over a batch of options (non-owning)
+struct OptionBatch {
+    const double* strikes;
+    const double* expiries;
+    const omm::core::models::OptionType* optionTypes;
+    std::size_t size;
+};
+
+// Structure-of-arrays view over an option chain: one call and one put per (strike, expiry)
+struct OptionChainBatch {
+    const double* strikes;
+    const double* expiries;
+    std::size_t size;
+};
+
+// Structure-of-arrays batch pricing output (non-owning, sized by the caller).
+// A null array is skipped.
+struct OptionBatchResult {
+    double* prices;
+    double* deltas;
+    double* gammas;
+    double* vegas;
+    double* thetas;
+    double* vols = nullptr;  // implied vol each option was priced at
+};
+
 class Calculator {
 public:
     // Price a future contract
@@ -32,12 +60,79 @@ public:
     // Calculate Greeks for an option
     static omm::core::models::Risk calculateRisk(const omm::core::models::Option& option, const omm::core::models::Market& market);
     
+    // Price a batch of options and fill their Greeks in one pass (no heap allocation).
+    // Inputs sorted by expiry share the forward, discount factor and ATM vol lookup.
+    static void priceOptionBatch(
+        const OptionBatch& batch,
+        const omm::core::models::Market& market,
+        const OptionBatchResult& result
+    );
+    
+    // Same, reading vols from a frozen copy of the market's surface
+    static void priceOptionBatch(
+        const OptionBatch& batch,
+        const omm::core::models::Market& market,
+        const omm::core::models::FrozenVolSurface& volSurface,
+        const OptionBatchResult& result
+    );
+    
+    // Price the calls and puts of a chain in one pass (no heap allocation)
+    static void priceOptionChain(
+        const OptionChainBatch& chain,
+        const omm::core::models::Market& market,
+        const OptionBatchResult& calls,
+        const OptionBatchResult& puts
+    );
+    
+    static void priceOptionChain(
+        const OptionChainBatch& chain,
+        const omm::core::models::Market& market,
+        const omm::core::models::FrozenVolSurface& volSurface,
+        const OptionBatchResult& calls,
+        const OptionBatchResult& puts
+    );
+    
     // Calculate portfolio-level Greeks
     static omm::core::models::Risk calculatePortfolioRisk(
         const std::vector<std::shared_ptr<omm::core::models::Security>>& positions,
         const omm::core::models::Market& market
     );
     
+    // Same Greeks for positions, weighted by quantity * lotSize (via Portfolio)
+    static omm::core::models::Risk calculatePortfolioRisk(
+        const std::vector<omm::core::models::Position>& positions,
+        const omm::core::models::Market& market
+    );
+    
+    // Greeks of a columnar portfolio in blocks through VecMath, each leg weighted by
+    // quantity * lotSize, in total and per expiry bucket. Forward, discount factor,
+    // sqrt(tte) and ATM vol are computed once per expiry; per leg there is one vol
+    // lookup, one exp and one erf. No heap allocation besides the per-expiry result.
+    static omm::core::models::PortfolioRisk calculatePortfolioRisk(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market
+    );
+    
+    static omm::core::models::PortfolioRisk calculatePortfolioRisk(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market,
+        const omm::core::models::FrozenVolSurface& volSurface
+    );
+    
+    // Same pass, also bucketing vega and gamma by (expiry, norm strike) per spec
+    static omm::core::models::RiskLadder calculateRiskLadder(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market,
+        const omm::core::models::RiskLadderSpec& spec = {}
+    );
+    
+    static omm::core::models::RiskLadder calculateRiskLadder(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market,
+        const omm::core::models::FrozenVolSurface& volSurface,
+        const omm::core::models::RiskLadderSpec& spec = {}
+    );
+
 private:
     static double getForwardStrike(const omm::core::models::Market& market, double strike, double expiry);
 };
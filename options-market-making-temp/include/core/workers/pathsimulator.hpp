@@ -0,0 +1,57 @@
+#pragma once
+
+#include "core/models/market.hpp"
+#include "core/threadpool.hpp"
+#include "core/models/marketpaths.hpp"
+#include "core/workers/simulator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace omm::core::workers {
+
+// Path-batched Monte Carlo version of Simulator::simulateNextMarket.
+//
+// Paths are evolved in blocks: per step, the regime draws and Box-Muller normals of a
+// whole block come out of one vectorized pass (VecMath log/sqrt/sinPi/cosPi/exp), and
+// only regime, spot and ATM vol are kept. Draws come from Philox4x32 keyed by seed
+// with counter (step, draw, path), so a path depends on nothing but (seed, path):
+// results are bit-identical whatever numPaths, block layout or thread count is used.
+// firstPath selects paths [firstPath, firstPath + numPaths) of that stream, so a large
+// run can be simulated in batches on one seed.
+class PathSimulator {
+public:
+    // Simulate numPaths paths of numSteps steps starting from market
+    static omm::core::models::MarketPaths simulatePaths(
+        const omm::core::models::Market& market,
+        std::size_t numPaths,
+        std::size_t numSteps,
+        std::uint64_t seed,
+        std::size_t firstPath = 0
+    );
+    
+    // Same, with path blocks spread over the pool's threads
+    static omm::core::models::MarketPaths simulatePaths(
+        const omm::core::models::Market& market,
+        std::size_t numPaths,
+        std::size_t numSteps,
+        std::uint64_t seed,
+        ThreadPool& pool,
+        std::size_t firstPath = 0
+    );
+    
+    // Shocks of steps 1..numSteps of one path, drawn one at a time with libm Box-Muller.
+    // Replaying them through Simulator::simulateNextState reproduces the path's regimes
+    // exactly and its spot / vol to rounding.
+    static std::vector<MarketShock> generateShocks(std::uint64_t seed, std::size_t path, std::size_t numSteps);
+    
+    // Full market (surface included) of one path at one step
+    static std::shared_ptr<omm::core::models::Market> materializeMarket(
+        const omm::core::models::MarketPaths& paths,
+        std::size_t step,
+        std::size_t path
+    );
+};
+
+}  // namespace omm::core::workers
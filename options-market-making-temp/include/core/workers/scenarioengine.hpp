@@ -0,0 +1,87 @@
+#pragma once
+
+#include "core/models/market.hpp"
+#include "core/models/portfolio.hpp"
+#include "core/models/regime.hpp"
+#include "core/threadpool.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace omm::core::workers {
+
+// Spot x vol shock grid. Spot shocks are relative (spot * (1 + shock)); vol shocks are
+// absolute moves of the one-month ATM vol the surface is built from.
+struct ScenarioGridSpec {
+    std::vector<double> spotShocks;
+    std::vector<double> volShocks;
+    std::size_t numWorst = 5;  // worst cells kept in the result
+    
+    // numSpot shocks evenly spaced in [-maxSpotShock, maxSpotShock], likewise for vol
+    static ScenarioGridSpec uniform(double maxSpotShock, std::size_t numSpot, double maxVolShock, std::size_t numVol);
+};
+
+struct ScenarioCell {
+    std::size_t spotIdx;
+    std::size_t volIdx;
+    double spotShock;
+    double volShock;
+    double pnl;
+};
+
+// P&L of every grid cell against the book's value on the unshocked market
+struct ScenarioResult {
+    omm::core::models::Regime regime;
+    double baseValue = 0.0;
+    std::size_t numSpotShocks = 0;
+    std::size_t numVolShocks = 0;
+    std::vector<double> pnl;          // [volIdx * numSpotShocks + spotIdx]
+    std::vector<ScenarioCell> worst;  // lowest P&L first
+    
+    double pnlAt(std::size_t spotIdx, std::size_t volIdx) const { return pnl[volIdx * numSpotShocks + spotIdx]; }
+};
+
+// Full revaluation of a Portfolio over a ScenarioGridSpec.
+//
+// A scenario's surface is built as Simulator builds one for a regime: the regime's
+// skew, convexity and vol mean around the market's one-month ATM vol plus the vol
+// shock, on the market's expiries and spot. Each vol shock's surface is built and
+// frozen once and shared by every spot shock of its row; the surface is held in norm
+// strike as spot moves, as Calculator prices against an unchanged VolSurface. Every
+// cell then prices all option buckets through Calculator::priceOptionBatch; futures
+// move with spot. The zero-shock cell of a regime other than the market's own carries
+// the P&L of the change of surface shape.
+class ScenarioEngine {
+public:
+    // Grid under the market's regime
+    static ScenarioResult runGrid(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market,
+        const ScenarioGridSpec& spec
+    );
+    
+    static ScenarioResult runGrid(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market,
+        const ScenarioGridSpec& spec,
+        omm::core::models::Regime regime
+    );
+    
+    // Same, with surface builds and then grid cells spread over the pool's threads
+    static ScenarioResult runGrid(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market,
+        const ScenarioGridSpec& spec,
+        omm::core::models::Regime regime,
+        ThreadPool& pool
+    );
+    
+    // One grid per regime, in Regime order (CALM, STRESS, EVENT)
+    static std::vector<ScenarioResult> runRegimes(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market,
+        const ScenarioGridSpec& spec,
+        ThreadPool& pool
+    );
+};
+
+}  // namespace omm::core::workers
@@ -1,25 +1,85 @@
 #pragma once
 
 #include "core/models/market.hpp"
+#include "core/models/regimeparams.hpp"
+#include "core/models/snapshotpool.hpp"
 #include <memory>
 #include <vector>
 
 namespace omm::core::workers {
 
+// Random inputs of one simulation step
+struct MarketShock {
+    double regimeDraw;  // Uniform in [0, 1) for the regime transition
+    double z1;          // Independent standard normals, correlated through the regime's rho
+    double z2;
+};
+
+// Scalar state moved by one simulation step (everything but the surface shape)
+struct MarketState {
+    omm::core::models::Regime regime;
+    double spot;
+    double atmOneMonthVol;
+};
+
 class Simulator {
 public:
     // Initialize market with initial conditions
     static std::shared_ptr<omm::core::models::Market> initializeMarket();
     
+    // Dynamics parameters of a regime
+    static const omm::core::models::RegimeParams& getRegimeParams(omm::core::models::Regime regime);
+    
     // Get next regime based on transition probabilities
     static omm::core::models::Regime getNextRegime(omm::core::models::Regime regime);
     
+    // Same, from a uniform draw u in [0, 1)
+    static omm::core::models::Regime getNextRegime(omm::core::models::Regime regime, double u);
+    
+    // Regime switch, spot GBM step and ATM vol OU step for the given shock
+    static MarketState simulateNextState(const MarketState& state, const MarketShock& shock);
+    
+    // Spot GBM and ATM vol OU step over dt years in the state's regime, with z1 and z2
+    // correlated as in simulateNextState (which is a regime switch followed by this)
+    static MarketState diffuseState(const MarketState& state, double dt, double z1, double z2);
+    
+    // Expiries one time step later: expired ones are dropped and replaced at the back in 7-day steps
+    static std::vector<double> rollExpiries(const std::vector<double>& expiries);
+    static void rollExpiriesInPlace(std::vector<double>& expiries);
+    
     // Simulate the next market state
     static std::shared_ptr<omm::core::models::Market> simulateNextMarket(
         const std::shared_ptr<omm::core::models::Market>& market,
         double atmOneMonthVol = -1.0,
         const std::vector<double>& expiries = {}
     );
+    
+    // Same, with the step's random inputs given
+    static std::shared_ptr<omm::core::models::Market> simulateNextMarket(
+        const std::shared_ptr<omm::core::models::Market>& market,
+        const MarketShock& shock,
+        double atmOneMonthVol = -1.0,
+        const std::vector<double>& expiries = {}
+    );
+    
+    // Move market one step forward in place, with the same dynamics as simulateNextMarket.
+    // The vol surface is rebuilt incrementally (VolSurface::rebuild, no arbitrage checks);
+    // a surface still shared with another market is copied first.
+    static void advanceMarket(omm::core::models::Market& market);
+    static void advanceMarket(omm::core::models::Market& market, const MarketShock& shock);
+    
+    // Next market as a new snapshot in pooled storage, for callers that keep a history
+    // of markets. Same dynamics and surface as advanceMarket (no arbitrage checks); once
+    // the pool holds as many slots as snapshots are alive, a step allocates nothing.
+    static std::shared_ptr<omm::core::models::Market> simulateNextMarket(
+        const std::shared_ptr<omm::core::models::Market>& market,
+        omm::core::models::SnapshotPool& pool
+    );
+    static std::shared_ptr<omm::core::models::Market> simulateNextMarket(
+        const std::shared_ptr<omm::core::models::Market>& market,
+        const MarketShock& shock,
+        omm::core::models::SnapshotPool& pool
+    );
 };
 
 }  // namespace omm::core::workers
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "core/models/market.hpp"
+#include "core/models/portfolio.hpp"
+#include "core/models/regime.hpp"
+#include "core/tdigest.hpp"
+#include "core/threadpool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace omm::core::workers {
+
+struct VarSpec {
+    std::vector<int> horizons = {1, 10};             // days, multiples of Config::TIME_STEP
+    std::vector<double> confidences = {0.99, 0.975};
+    std::size_t numPaths = 10000;
+    std::uint64_t seed = 42;
+    double compression = 200.0;                      // of each P&L digest
+};
+
+// VaR and ES as positive losses: VaR is minus the (1 - confidence) quantile of P&L,
+// ES minus the mean P&L below it
+struct RiskMeasure {
+    double confidence;
+    double var;
+    double es;
+};
+
+struct HorizonRisk {
+    int horizon;
+    double meanPnl;
+    std::vector<RiskMeasure> measures;  // per VarSpec::confidences
+    TDigest pnl;                        // the P&L distribution, for other quantiles
+};
+
+struct VarResult {
+    omm::core::models::Regime regime;  // regime the paths start in
+    double baseValue = 0.0;
+    std::size_t numPaths = 0;
+    std::vector<HorizonRisk> horizons;  // per VarSpec::horizons
+};
+
+// Monte Carlo VaR / ES of a Portfolio over simulated market paths.
+//
+// Paths come from PathSimulator (regime switching, spot GBM, ATM vol OU) in batches
+// of a fixed size, each batch the next paths of the one seed's stream, so memory does
+// not grow with numPaths and runs on different seeds share no paths. At each horizon
+// the book is revalued in full on the path's market, as Simulator::advanceMarket would
+// leave it: the regime's surface rebuilt around the path's spot and one-month ATM vol
+// on the rolled expiries, options aged by the horizon and futures at the path's spot.
+// Options that expire within the horizon are paid intrinsic at the path's spot on the
+// step they expire at; the payoff carries no interest to the horizon.
+// P&L against the book's value today goes into one t-digest per horizon.
+class VarEngine {
+public:
+    // Paths starting in the market's regime
+    static VarResult run(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market,
+        const VarSpec& spec
+    );
+    
+    // Same, with the paths of each batch revalued over the pool's threads; results
+    // do not depend on the number of threads
+    static VarResult run(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market,
+        const VarSpec& spec,
+        ThreadPool& pool
+    );
+    
+    // One result per starting regime, in Regime order (CALM, STRESS, EVENT), on the
+    // same random draws
+    static std::vector<VarResult> runRegimes(
+        const omm::core::models::Portfolio& portfolio,
+        const omm::core::models::Market& market,
+        const VarSpec& spec,
+        ThreadPool& pool
+    );
+};
+
+}  // namespace omm::core::workers
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "core/models/market.hpp"
+#include "core/models/volsurface.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace omm::core::workers {
+
+// Structure-of-arrays view over implied-vol quotes, sorted by expiry (non-owning);
+// a null weights array weighs every quote 1
+struct VolQuoteBatch {
+    const double* strikes;
+    const double* expiries;
+    const double* vols;
+    const double* weights;
+    std::size_t size;
+};
+
+struct CalibrationParams {
+    int maxIterations = 20;           // per smile
+    double tolerance = 1e-10;         // relative decrease of the cost that ends a fit
+    double initialDamping = 1e-3;     // Levenberg-Marquardt lambda, relative to diag(J^T J)
+    double minVol = 0.01;             // floor on the smile over the check strikes
+    double constraintWeight = 1e4;    // penalty weight of calendar and floor violations
+    double checkRange = 4.0;          // check strikes span [-checkRange, checkRange] in ns
+};
+
+struct CalibrationStats {
+    std::uint64_t smiles = 0;
+    std::uint64_t iterations = 0;     // Levenberg-Marquardt steps, accepted or not
+    std::uint64_t warmStarts = 0;     // smiles started from the previous fit
+    std::uint64_t constrained = 0;    // smiles with a calendar or floor penalty active at the end
+    double rmse = 0.0;                // weighted, in vol
+    double maxError = 0.0;            // largest |model - quote| vol
+};
+
+// Fits the surface's parametric smile, vol = atmVol + skew * ns + convexity * ns^2
+// with ns = log(K / F) / (atmVol * sqrt(T)), to implied-vol quotes, one expiry at a
+// time in expiry order.
+//
+// Each fit is a weighted least-squares problem in (atmVol, skew, convexity), solved
+// by Levenberg-Marquardt on the 3x3 normal equations (Eigen, fixed size). No-arbitrage
+// conditions are kept as penalty residuals on a fixed set of norm strikes: total
+// variance at least the previous expiry's (calendar) and vol above minVol, and
+// convexity is projected onto >= 0; with a positive convex smile, total variance is
+// convex in ns (butterfly). Fits start from the previous calibration of the same
+// expiry when there is one: three steps for a free smile, more where the calendar
+// bound is close to binding. After the fit, any violation the penalties left is
+// removed by lifting the smile's level. No heap allocation once the expiries have
+// been seen.
+class VolCalibrator {
+public:
+    explicit VolCalibrator(const CalibrationParams& params_ = {});
+    
+    // Fit every expiry of the batch; expiries not in the batch are dropped
+    CalibrationStats calibrate(const VolQuoteBatch& quotes, const omm::core::models::Market& market);
+    
+    // Start the next calibration from an existing surface: a quadratic per smile,
+    // through its knots, or through an SSVI slice at the check strikes. Returns the
+    // smiles seeded (smiles with fewer than 3 knots are skipped).
+    std::size_t warmStart(const omm::core::models::VolSurface& surface);
+    
+    // Rebuild surface in place from the fitted smiles, on its usual strike grid
+    void toSurface(omm::core::models::VolSurface& surface, double spot, double interestRate) const;
+    
+    const std::vector<double>& expiries() const { return fittedExpiries; }
+    const std::vector<omm::core::models::SmileParams>& smiles() const { return fittedSmiles; }
+    
+    // Start calibrations from scratch (ATM quote, flat smile) rather than warm
+    void reset();
+
+private:
+    CalibrationParams params;
+    std::vector<double> fittedExpiries;
+    std::vector<omm::core::models::SmileParams> fittedSmiles;
+    std::vector<double> previousExpiries;
+    std::vector<omm::core::models::SmileParams> previousSmiles;
+    std::vector<double> logMoneyness;  // per quote, scratch
+};
+
+}  // namespace omm::core::workers
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "core/models/risk.hpp"
+#include "lob/bookmanager.hpp"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace omm::engine {
+
+struct HedgeParams {
+    double deltaBand = 50.0;       // |delta| left unhedged
+    double gammaBandScale = 0.0;   // widen the band by the delta of a move of this fraction of spot
+    double rehedgeTo = 0.0;        // 0 hedges back to flat, 1 back to the band edge
+    int futureLotSize = 1;         // delta per future lot
+    lob::Quantity maxLots = 1000;  // per hedge order
+    double tickSize = 0.25;        // future book tick
+    lob::Price maxSlippage = 8;    // ticks through fair for the hedge's IOC limit
+    double feePerLot = 0.0;
+};
+
+struct HedgeStats {
+    std::uint64_t checks = 0;
+    std::uint64_t hedges = 0;        // hedge orders sent
+    std::uint64_t lotsTraded = 0;
+    std::uint64_t lotsMissed = 0;    // asked for but not filled within maxSlippage
+    double slippage = 0.0;           // sum of (fill - fair) * signed lots * lot size; > 0 is a cost
+    double fees = 0.0;
+    
+    double cost() const { return slippage + fees; }
+};
+
+// Delta hedging of an options book with one future.
+//
+// Portfolio Greeks are kept as a running Risk: option fills add their unit Greeks,
+// future fills add their delta, and a spot move rolls delta forward by gamma. Nothing
+// re-sums the book, so a check costs O(1) and can run on every simulation step;
+// resync() replaces the running Greeks by a full calculatePortfolioRisk now and then
+// (vega and theta do not roll with spot, and neither does gamma).
+//
+// Futures count one delta per unit of lot size, as in calculatePortfolioRisk. When
+// |delta| leaves the band, hedge() sends an IOC on the future's book, limited to
+// maxSlippage ticks through fair (the forward), and books what filled; slippage
+// is measured against fair at the time of the hedge. Each hedge fill is also passed
+// to the counterparty fill handler, so the owner of the resting order it hit (e.g. an
+// agent of AgentSimulation, through deliverMakerFill) books its side.
+class HedgingEngine {
+public:
+    static constexpr lob::OrderId HEDGE_ID_TAG = lob::OrderId(1) << 61;
+    
+    HedgingEngine(
+        lob::BookManager& books_,
+        lob::InstrumentId future_,
+        double futureExpiry_,  // days
+        double spot_,
+        double interestRate_,
+        const HedgeParams& params_ = {}
+    );
+    
+    // quantity in lots of lotSize options, positive when bought
+    void onOptionFill(const core::models::Risk& unitRisk, double quantity, int lotSize = 1);
+    
+    // Futures traded outside hedge()
+    void onFutureFill(double lots);
+    
+    void onSpot(double spot);
+    
+    // Greeks of the whole book, futures included
+    void resync(const core::models::Risk& risk);
+    
+    // Signed lots to trade now; 0 inside the band
+    lob::Quantity requiredLots() const;
+    
+    // Check the band and hedge through the book if needed; returns the lots filled
+    lob::Quantity hedge();
+    
+    // Book a hedge executed elsewhere (e.g. at a simulator's close), against fair
+    void executed(lob::Quantity lots, double price);
+    
+    // Called with each fill of a hedge order; it must not call back into the engine
+    void setCounterpartyFillHandler(lob::FillHandler handler) { counterpartyFillHandler = std::move(handler); }
+    
+    const core::models::Risk& risk() const { return runningRisk; }
+    double bandWidth() const;
+    double futureFair() const;
+    lob::Price futureFairTicks() const;
+    double futurePosition() const { return futureLots; }
+    double spot() const { return currentSpot; }
+    const HedgeStats& stats() const { return hedgeStats; }
+
+private:
+    lob::BookManager& books;
+    lob::InstrumentId future;
+    double futureTte;
+    double interestRate;
+    HedgeParams params;
+    
+    double currentSpot;
+    double futureLots = 0.0;
+    core::models::Risk runningRisk;
+    lob::OrderId nextOrderId;
+    std::vector<lob::Fill> fills;
+    lob::FillHandler counterpartyFillHandler;
+    HedgeStats hedgeStats;
+};
+
+}  // namespace omm::engine
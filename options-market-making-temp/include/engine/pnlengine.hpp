@@ -0,0 +1,154 @@
+#pragma once
+
+#include "core/models/future.hpp"
+#include "core/models/market.hpp"
+#include "core/models/option.hpp"
+#include "core/models/optiontype.hpp"
+#include "core/models/posarchive.hpp"
+#include "core/models/position.hpp"
+#include "core/models/risk.hpp"
+#include "core/models/snapshotpool.hpp"
+#include "core/workers/simulator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace omm::engine {
+
+// Instruments traded so far and the net quantity held in each, one row per
+// instrument in first-trade order. Rows are only appended; an expired option keeps
+// its row with quantity 0.
+struct PositionTable {
+    std::vector<double> strikes;                         // 0 for futures
+    std::vector<double> expiryTimes;                     // Market::time of expiry; options only
+    std::vector<core::models::OptionType> optionTypes;
+    std::vector<int> lotSizes;
+    std::vector<std::uint8_t> isFuture;
+    std::vector<int> quantities;                         // net, positive when long
+    
+    std::size_t size() const { return strikes.size(); }
+};
+
+// One day's P&L split by Greek. The Greeks are those held over the day, vega times
+// the change of each leg's own vol (sticky strike) and theta per year times dt.
+struct PnlAttribution {
+    double total = 0.0;        // change of the marked book, cash included
+    double delta = 0.0;        // delta * dS
+    double gamma = 0.0;        // gamma * dS^2 / 2
+    double vega = 0.0;
+    double theta = 0.0;
+    double trading = 0.0;      // (mark - price) * weight of the trades done since the last step
+    double unexplained = 0.0;  // total minus the above
+};
+
+struct DailyPnl {
+    int time;
+    double spot;
+    core::models::Regime regime;
+    double value;             // book marked at the new market, cash included
+    core::models::Risk risk;  // Greeks held over the day
+    PnlAttribution pnl;
+};
+
+// Path-dependent P&L of a book traded along a simulated market.
+//
+// step() moves the market through Simulator::simulateNextMarket, on pooled snapshots,
+// and books the day's P&L.
+// Trades append to a PosArchive and net into a PositionTable; option legs held are
+// also kept in structure-of-arrays form sorted by expiry, with the price, Greeks and
+// vol of their last mark, so a step is one Calculator::priceOptionBatch pass. Options
+// expire into cash at intrinsic value, recorded as a closing trade. Futures are delta
+// one at spot, as in calculatePortfolioRisk, and do not expire.
+class PnlEngine {
+public:
+    explicit PnlEngine(std::shared_ptr<core::models::Market> market_);
+    
+    PnlEngine(const PnlEngine&) = delete;
+    PnlEngine& operator=(const PnlEngine&) = delete;
+    
+    // Trade quantity at price per unit of the underlying; a negative price trades at
+    // the current mark. Option expiries are in days from now. Returns the instrument's
+    // PositionTable row.
+    std::uint32_t trade(const core::models::Option& option, int quantity, double price = -1.0);
+    std::uint32_t trade(const core::models::Future& future, int quantity, double price = -1.0);
+    
+    // Dispatches on the security type once, as Portfolio::addPosition; other securities
+    // are ignored
+    void trade(const core::models::Position& position, double price = -1.0);
+    
+    // Move the market one step, settle expired options and book the day's P&L
+    const DailyPnl& step();
+    const DailyPnl& step(const core::workers::MarketShock& shock);
+    
+    // Greeks of the book at the current market, futures included
+    core::models::Risk risk() const;
+    
+    // Book marked at the current market, cash included
+    double value() const;
+    
+    // Sum of the daily attributions so far
+    PnlAttribution cumulative() const;
+    
+    const core::models::Market& market() const { return *currentMarket; }
+    const PositionTable& positions() const { return table; }
+    const core::models::PosArchive& archive() const { return trades; }
+    const std::vector<DailyPnl>& history() const { return days; }
+    std::size_t numLiveOptions() const { return legs.size(); }
+
+private:
+    // Option legs held, sorted by expiry time
+    struct Legs {
+        std::vector<std::uint32_t> rows;  // PositionTable row
+        std::vector<double> expiryTimes;
+        std::vector<double> strikes;
+        std::vector<core::models::OptionType> optionTypes;
+        std::vector<double> weights;      // quantity * lotSize
+        std::vector<double> expiries;     // days to expiry at the current market
+        std::vector<double> prices;
+        std::vector<double> deltas;
+        std::vector<double> gammas;
+        std::vector<double> vegas;
+        std::vector<double> thetas;
+        std::vector<double> vols;
+        
+        std::size_t size() const { return rows.size(); }
+        void insert(std::size_t at, std::uint32_t row, double expiryTime, double strike,
+                    core::models::OptionType optionType);
+        void erase(std::size_t at);
+        void eraseFront(std::size_t count);
+    };
+    
+    // Marks of the legs at the next market, swapped in after attribution
+    struct Marks {
+        std::vector<double> prices;
+        std::vector<double> deltas;
+        std::vector<double> gammas;
+        std::vector<double> vegas;
+        std::vector<double> thetas;
+        std::vector<double> vols;
+        
+        void resize(std::size_t size);
+    };
+    
+    using InstrumentKey = std::tuple<std::uint8_t, double, double, int, int>;  // isFuture, strike, expiry, type, lot
+    
+    std::uint32_t instrumentRow(const InstrumentKey& key);
+    const DailyPnl& bookStep(std::shared_ptr<core::models::Market> next);
+    
+    core::models::SnapshotPool pool;  // declared first: outlives every snapshot
+    std::shared_ptr<core::models::Market> currentMarket;
+    PositionTable table;
+    core::models::PosArchive trades;
+    std::map<InstrumentKey, std::uint32_t> instrumentRows;
+    Legs legs;
+    Marks nextMarks;
+    double futureWeight = 0.0;  // quantity * lotSize over all futures
+    double cash = 0.0;
+    double pendingTrading = 0.0;
+    std::vector<DailyPnl> days;
+};
+
+}  // namespace omm::engine
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "core/models/frozenvolsurface.hpp"
+#include "core/models/market.hpp"
+#include "core/models/risk.hpp"
+#include "lob/bookmanager.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace omm::engine {
+
+struct QuotingParams {
+    double tickSize = 0.05;        // price units per book tick
+    double requoteTicks = 1.0;     // reprice a series once its theo may have moved this far (0: always)
+    lob::Price halfSpread = 2;     // ticks either side of the skewed theo
+    lob::Quantity quoteSize = 10;
+    // Price shift per unit of inventory Greek times the series' Greek; both lean the
+    // quotes towards trades that flatten the inventory
+    double deltaSkew = 0.0;
+    double vegaSkew = 0.0;
+};
+
+// Counters of one update, or totals since construction
+struct QuotingStats {
+    std::uint64_t seriesChecked = 0;
+    std::uint64_t seriesRepriced = 0;
+    std::uint64_t quotesSent = 0;   // adds, replaces and cancels
+    std::uint64_t fills = 0;
+};
+
+// Streams a two-sided quote on every option of a registry into its books.
+//
+// Per series the engine keeps the theo and Greeks of its last repricing, and the spot
+// and vol they were computed at. A spot or vol update first estimates each theo by a
+// second-order expansion from that reference (delta, gamma and vega, with vols from a
+// batched smile lookup), and only the series whose estimate moved by requoteTicks or
+// more are repriced exactly, through Calculator::priceOptionBatch. Quotes are sent
+// only when a tick price changed. Fills adjust the inventory Risk, which skews every
+// quote. Ids of the engine's orders have QUOTE_ID_TAG set.
+//
+// Other participants share the books, so fills reach the engine from both sides: a
+// fill of a resting quote comes in through applyFill, and a requote that crosses a
+// resting order is booked here and passed to the counterparty fill handler, which
+// tells the owner of that order (e.g. AgentSimulation::deliverMakerFill).
+class QuotingEngine {
+public:
+    static constexpr lob::OrderId QUOTE_ID_TAG = lob::OrderId(1) << 62;
+    
+    QuotingEngine(
+        const lob::InstrumentRegistry& registry,
+        lob::BookManager& books_,
+        const core::models::Market& market_,
+        const core::models::FrozenVolSurface& surface_,
+        const QuotingParams& params_ = {}
+    );
+    
+    // Books centered on each option's current theo, bandTicks either side (futures
+    // get futureSpec), for a BookManager this engine will quote into
+    static std::vector<lob::BookSpec> bookSpecs(
+        const lob::InstrumentRegistry& registry,
+        const core::models::Market& market,
+        const core::models::FrozenVolSurface& surface,
+        const QuotingParams& params,
+        lob::Price bandTicks = 500,
+        const lob::BookSpec& futureSpec = {}
+    );
+    
+    // Price every series and place all quotes
+    QuotingStats start();
+    
+    // Incremental requote after a spot move, or after a new surface at the current spot
+    QuotingStats onSpot(double spot);
+    QuotingStats onVolSurface(const core::models::FrozenVolSurface& surface_);
+    
+    // Book a fill of a resting quote (ignored unless fill.makerId is one) and requote
+    // with the new skew. Fills of the engine's own aggressive requotes are applied
+    // internally and go to the counterparty fill handler.
+    QuotingStats applyFill(lob::InstrumentId instrument, const lob::Fill& fill);
+    
+    // Called with each fill of a requote against someone else's resting order; it must
+    // not call back into the engine
+    void setCounterpartyFillHandler(lob::FillHandler handler) { counterpartyFillHandler = std::move(handler); }
+    
+    static bool isQuote(lob::OrderId id) { return (id & QUOTE_ID_TAG) != 0; }
+    
+    // Id of the engine's order on one side of a series
+    static lob::OrderId quoteId(std::size_t series, lob::Side side) {
+        return QUOTE_ID_TAG | (static_cast<lob::OrderId>(series) << 1) | (side == lob::Side::SELL ? 1 : 0);
+    }
+    
+    std::size_t numSeries() const { return theo.size(); }
+    double spot() const { return market.spot; }
+    double theoValue(lob::InstrumentId series) const { return theo[series]; }
+    core::models::Risk risk(lob::InstrumentId series) const;
+    lob::Quantity position(lob::InstrumentId series) const { return positions[series]; }
+    const core::models::Risk& inventory() const { return inventoryRisk; }
+    
+    // NO_PRICE when the side is not quoted
+    lob::Price bidPrice(lob::InstrumentId series) const { return bids[series]; }
+    lob::Price askPrice(lob::InstrumentId series) const { return asks[series]; }
+    
+    const QuotingStats& totals() const { return totalStats; }
+
+private:
+    // Estimate theos at the current market; mark the series to reprice
+    void collectMoved(bool all);
+    void reprice();
+    void requote(std::size_t series);
+    void sendQuote(std::size_t series, lob::Side side, lob::Price price);
+    void bookFill(std::size_t series, lob::Side side, lob::Quantity quantity);
+    void handleFills(lob::InstrumentId instrument);
+    QuotingStats finish();
+    
+    lob::BookManager& books;
+    core::models::Market market;
+    core::models::FrozenVolSurface surface;
+    QuotingParams params;
+    std::size_t numStrikes;
+    
+    // Per expiry
+    std::vector<double> expiries;
+    std::vector<double> ttes;
+    std::vector<double> sqrtTtes;
+    
+    // Per (expiry, strike) node; calls and puts share the vol
+    std::vector<double> strikes;
+    std::vector<double> logStrikes;
+    std::vector<double> vols;       // at the current market
+    std::vector<double> normStrikes;  // scratch for the smile lookup
+    
+    // Per series, at the last repricing
+    std::vector<double> theo;
+    std::vector<double> deltas;
+    std::vector<double> gammas;
+    std::vector<double> vegas;
+    std::vector<double> thetas;
+    std::vector<double> refSpots;
+    std::vector<double> refVols;
+    
+    // Per series quote and position
+    std::vector<lob::Price> bids;
+    std::vector<lob::Price> asks;
+    std::vector<lob::Quantity> positions;
+    core::models::Risk inventoryRisk;
+    
+    // Series to reprice, in id order, and their batch inputs and outputs
+    std::vector<std::uint32_t> moved;
+    std::vector<double> batchStrikes;
+    std::vector<double> batchExpiries;
+    std::vector<core::models::OptionType> batchTypes;
+    std::vector<double> batchPrices;
+    std::vector<double> batchDeltas;
+    std::vector<double> batchGammas;
+    std::vector<double> batchVegas;
+    std::vector<double> batchThetas;
+    
+    std::vector<lob::Fill> fills;
+    lob::FillHandler counterpartyFillHandler;
+    QuotingStats updateStats;
+    QuotingStats totalStats;
+};
+
+}  // namespace omm::engine
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "lob/instrumentregistry.hpp"
+#include "lob/order.hpp"
+#include "lob/orderbook.hpp"
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace omm::lob {
+
+// Tick range and resting-order capacity of one instrument's book
+struct BookSpec {
+    Price minPrice = 0;
+    Price maxPrice = 511;
+    std::size_t maxOrders = 128;
+};
+
+enum class OrderAction : std::uint8_t {
+    ADD,
+    CANCEL,   // order.id
+    REPLACE   // order.id, order.price, order.quantity
+};
+
+// Receives a fill for the participant on the other side of it, when the books are
+// shared by components that do not see each other's fills
+using FillHandler = std::function<void(InstrumentId, const Fill&)>;
+
+struct OrderEvent {
+    InstrumentId instrument;
+    OrderAction action;
+    OrderRequest order;
+};
+
+// One OrderBook per registry instrument, stored in a vector indexed by InstrumentId so
+// routing an event is a bounds check and an array index.
+class BookManager {
+public:
+    BookManager(const InstrumentRegistry& registry, const BookSpec& spec);
+    
+    // specs[id] for every instrument id of the registry
+    BookManager(const InstrumentRegistry& registry, const std::vector<BookSpec>& specs);
+    
+    // UNKNOWN_INSTRUMENT rejection for ids outside the registry
+    OrderResult route(const OrderEvent& event, std::vector<Fill>& fills);
+    
+    OrderResult add(InstrumentId instrument, const OrderRequest& order, std::vector<Fill>& fills);
+    OrderResult cancel(InstrumentId instrument, OrderId id);
+    OrderResult replace(InstrumentId instrument, OrderId id, Price price, Quantity quantity, std::vector<Fill>& fills);
+    
+    OrderBook& book(InstrumentId instrument) { return books[instrument]; }
+    const OrderBook& book(InstrumentId instrument) const { return books[instrument]; }
+    std::size_t numBooks() const { return books.size(); }
+    
+    // Resting orders over all books
+    std::size_t numOrders() const;
+    
+    std::size_t memoryBytes() const;
+    
+    void clear();
+
+private:
+    std::vector<OrderBook> books;
+};
+
+}  // namespace omm::lob
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "core/models/future.hpp"
+#include "core/models/option.hpp"
+#include "core/models/optiontype.hpp"
+#include "core/models/volsurface.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace omm::lob {
+
+using InstrumentId = std::uint32_t;
+
+constexpr InstrumentId NO_INSTRUMENT = UINT32_MAX;
+
+enum class InstrumentKind : std::uint8_t {
+    OPTION,
+    FUTURE
+};
+
+struct InstrumentInfo {
+    InstrumentKind kind;
+    std::size_t expiryIdx;  // option expiry row, or position in the futures list
+    std::size_t strikeIdx;  // options only
+    double expiry;          // days, options only
+    double strike;          // options only
+    core::models::OptionType optionType;
+};
+
+// Dense instrument ids for an option chain and its futures.
+//
+// Options are laid out expiry-major over the strike grid, call and put side by side:
+//   id = (expiryIdx * numStrikes + strikeIdx) * 2 + (PUT ? 1 : 0)
+// followed by the futures. Resolving an Option is a table lookup on its expiry day
+// and a multiply on its strike, so ids are found without string or map lookups.
+class InstrumentRegistry {
+public:
+    InstrumentRegistry() = default;
+    
+    // expiries in days (ascending), strikes minStrike + i * strikeStep for i < numStrikes
+    InstrumentRegistry(
+        const std::vector<double>& expiries_,
+        double minStrike_,
+        double strikeStep_,
+        std::size_t numStrikes_,
+        const std::vector<std::string>& futureExpiries_ = {}
+    );
+    
+    // The grid VolSurface builds its smiles on: spot + z * strikeStep, |z| <= maxStrikeStepDist
+    static InstrumentRegistry fromVolSurface(
+        const core::models::VolSurface& surface,
+        double spot,
+        const std::vector<std::string>& futureExpiries = {},
+        int maxStrikeStepDist = core::models::VolSurface::GRID_STEP_DIST,
+        double strikeStep = core::models::VolSurface::GRID_STRIKE_STEP
+    );
+    
+    InstrumentId optionId(std::size_t expiryIdx, std::size_t strikeIdx, core::models::OptionType optionType) const {
+        return static_cast<InstrumentId>((expiryIdx * numStrikes + strikeIdx) * 2 +
+                                         (optionType == core::models::OptionType::PUT ? 1 : 0));
+    }
+    InstrumentId futureId(std::size_t futureIdx) const {
+        return static_cast<InstrumentId>(numOptions() + futureIdx);
+    }
+    
+    // NO_INSTRUMENT when the expiry or strike is off the grid
+    InstrumentId lookup(const core::models::Option& option) const;
+    InstrumentId lookup(double expiry, double strike, core::models::OptionType optionType) const;
+    
+    // Compares expiry strings: resolve futures once, then route by id
+    InstrumentId lookup(const core::models::Future& future) const;
+    
+    InstrumentInfo describe(InstrumentId id) const;
+    
+    std::size_t size() const { return numOptions() + futureExpiries.size(); }
+    std::size_t numOptions() const { return expiries.size() * numStrikes * 2; }
+    std::size_t numFutures() const { return futureExpiries.size(); }
+    std::size_t numExpiries() const { return expiries.size(); }
+    std::size_t strikesPerExpiry() const { return numStrikes; }
+    double strikeAt(std::size_t strikeIdx) const { return minStrike + static_cast<double>(strikeIdx) * strikeStep; }
+    double expiryAt(std::size_t expiryIdx) const { return expiries[expiryIdx]; }
+
+private:
+    std::vector<double> expiries;
+    std::vector<std::uint32_t> expiryByDay;  // expiry index by whole day, UINT32_MAX if none
+    double minStrike = 0.0;
+    double strikeStep = 1.0;
+    double invStrikeStep = 1.0;
+    std::size_t numStrikes = 0;
+    std::vector<std::string> futureExpiries;
+};
+
+}  // namespace omm::lob
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace omm::lob {
+
+using OrderId = std::uint64_t;
+using Price = std::int64_t;     // in ticks
+using Quantity = std::int64_t;  // in lots
+
+constexpr Price NO_PRICE = std::numeric_limits<Price>::min();
+
+enum class Side : std::uint8_t {
+    BUY,
+    SELL
+};
+
+enum class OrderType : std::uint8_t {
+    LIMIT,
+    MARKET  // executes against the book up to its quantity, never rests
+};
+
+enum class TimeInForce : std::uint8_t {
+    GTC,  // rests until filled or cancelled
+    IOC,  // fills what it can, the rest is cancelled
+    FOK   // fills completely or not at all
+};
+
+struct OrderRequest {
+    OrderId id;
+    Side side;
+    OrderType type = OrderType::LIMIT;
+    TimeInForce timeInForce = TimeInForce::GTC;
+    Price price = 0;         // ignored for market orders
+    Quantity quantity = 0;
+    bool hidden = false;     // rests without showing in the depth; queued behind displayed
+                             // orders of its price level
+};
+
+struct Fill {
+    OrderId makerId;
+    OrderId takerId;
+    Price price;
+    Quantity quantity;
+    Side takerSide;
+};
+
+enum class OrderStatus : std::uint8_t {
+    RESTING,    // (rest of the) order is in the book
+    FILLED,
+    CANCELLED,  // cancelled, or the IOC / market remainder that could not fill
+    REJECTED
+};
+
+enum class RejectReason : std::uint8_t {
+    NONE,
+    DUPLICATE_ID,
+    UNKNOWN_ORDER,
+    UNKNOWN_INSTRUMENT,
+    INVALID_PRICE,
+    INVALID_QUANTITY,
+    BOOK_FULL,
+    FOK_NOT_FILLABLE
+};
+
+struct OrderResult {
+    OrderStatus status;
+    RejectReason reason = RejectReason::NONE;
+    Quantity filled = 0;
+    Quantity remaining = 0;  // still resting
+};
+
+}  // namespace omm::lob
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "lob/order.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace omm::lob {
+
+// Price-time priority limit order book for one instrument.
+//
+// Prices are ticks in a fixed [minPrice, maxPrice] range with one PriceLevel per tick
+// and side, so a level is found by subtraction. Each level holds two FIFO queues
+// (displayed, then hidden) threaded through pooled order nodes by index, and a bit
+// per level marks non-empty levels so the next best price is a find-first-set away.
+// Order ids map to nodes through an open-addressing table. All storage is sized at
+// construction: nothing allocates afterwards except the caller's fill vector.
+class OrderBook {
+public:
+    OrderBook(Price minPrice, Price maxPrice, std::size_t maxOrders);
+    
+    // Match the order against the opposite side, then rest what is left if it is a
+    // GTC limit order. Fills are appended to fills in execution order.
+    OrderResult add(const OrderRequest& order, std::vector<Fill>& fills);
+    
+    OrderResult cancel(OrderId id);
+    
+    // New price and quantity for a resting order. A quantity decrease at the same
+    // price keeps time priority; anything else requeues (and may match) as new.
+    OrderResult replace(OrderId id, Price price, Quantity quantity, std::vector<Fill>& fills);
+    
+    Price bestBid() const;  // NO_PRICE when the side is empty
+    Price bestAsk() const;
+    
+    // Displayed quantity at a price (hidden orders excluded)
+    Quantity visibleQuantity(Side side, Price price) const;
+    Quantity totalQuantity(Side side, Price price) const;
+    
+    bool contains(OrderId id) const;
+    std::size_t numOrders() const { return liveOrders; }
+    std::size_t capacity() const { return nodes.size(); }
+    Price minPrice() const { return lowPrice; }
+    Price maxPrice() const { return lowPrice + static_cast<Price>(numLevels) - 1; }
+    
+    // Bytes held by the book's fixed storage
+    std::size_t memoryBytes() const;
+    
+    // Remove every order, keeping the storage
+    void clear();
+
+private:
+    static constexpr std::uint32_t NIL = UINT32_MAX;
+    
+    struct OrderNode {
+        OrderId id;
+        Quantity remaining;
+        std::uint32_t level;
+        std::uint32_t prev;
+        std::uint32_t next;
+        Side side;
+        bool hidden;
+    };
+    
+    struct Queue {
+        std::uint32_t head = NIL;
+        std::uint32_t tail = NIL;
+    };
+    
+    struct PriceLevel {
+        Queue displayed;
+        Queue hiddenQueue;
+        Quantity visibleQuantity = 0;
+        Quantity hiddenQuantity = 0;
+    };
+    
+    struct BookSide {
+        std::vector<PriceLevel> levels;
+        std::vector<std::uint64_t> occupied;  // one bit per level
+        std::size_t best = NIL;               // level index, NIL when empty
+    };
+    
+    struct IndexEntry {
+        OrderId id;
+        std::uint32_t node = NIL;  // NIL marks a free slot
+    };
+    
+    Quantity match(const OrderRequest& order, Quantity quantity, std::vector<Fill>& fills);
+    Quantity matchQueue(Queue& queue, const OrderRequest& order, Quantity quantity, Price price,
+                        std::vector<Fill>& fills);
+    bool canFill(const OrderRequest& order) const;
+    bool crosses(const OrderRequest& order, std::size_t level) const;
+    void rest(const OrderRequest& order, Quantity quantity);
+    void remove(std::uint32_t node);  // unlink from its level, drop from the index, free
+    
+    BookSide& sideOf(Side side) { return side == Side::BUY ? bids : asks; }
+    const BookSide& sideOf(Side side) const { return side == Side::BUY ? bids : asks; }
+    void markLevel(Side side, std::size_t level);
+    void clearLevel(Side side, std::size_t level);
+    std::size_t nextOccupied(const BookSide& book, std::size_t from) const;  // >= from
+    std::size_t prevOccupied(const BookSide& book, std::size_t from) const;  // <= from
+    
+    std::size_t slotOf(OrderId id) const;
+    std::uint32_t findOrder(OrderId id) const;
+    void insertOrder(OrderId id, std::uint32_t node);
+    void eraseOrder(OrderId id);
+    
+    Price lowPrice;
+    std::size_t numLevels;
+    BookSide bids;
+    BookSide asks;
+    
+    std::vector<OrderNode> nodes;
+    std::uint32_t freeList = NIL;  // through OrderNode::next
+    std::size_t liveOrders = 0;
+    
+    std::vector<IndexEntry> index;  // power-of-two size, linear probing
+    std::size_t indexMask = 0;
+    unsigned indexShift = 0;        // multiplicative hash keeps the top bits
+};
+
+}  // namespace omm::lob
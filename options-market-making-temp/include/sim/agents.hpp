@@ -0,0 +1,221 @@
+#pragma once
+
+#include "lob/bookmanager.hpp"
+#include "sim/eventqueue.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace omm::sim {
+
+// Market participants for AgentSimulation. Each one takes away one kind of edge; all
+// price against the simulation's fair values (ticks) and trade their own instruments.
+
+// Crosses the spread at Poisson times: IOC orders on a random instrument and side,
+// paying up to maxPayUp ticks through fair
+struct AggressiveTaker {
+    std::vector<lob::InstrumentId> instruments;
+    Timestamp meanInterval = 10 * NS_PER_MILLISECOND;
+    lob::Quantity maxQuantity = 5;
+    lob::Price maxPayUp = 3;
+    
+    lob::Quantity position = 0;  // net lots over all instruments
+    lob::Quantity traded = 0;
+    
+    template <typename Env>
+    void onStart(Env& env, ParticipantId self) {
+        scheduleNext(env, self);
+    }
+    
+    template <typename Env>
+    void onWake(Env& env, ParticipantId self) {
+        if (!instruments.empty()) {
+            auto pick = static_cast<std::size_t>(env.uniform(self) * static_cast<double>(instruments.size()));
+            lob::InstrumentId instrument = instruments[pick];
+            double u = env.uniform(self);
+            lob::Side side = u < 0.5 ? lob::Side::BUY : lob::Side::SELL;
+            auto quantity = 1 + static_cast<lob::Quantity>(2.0 * (u < 0.5 ? u : u - 0.5) * static_cast<double>(maxQuantity));
+            
+            lob::OrderRequest order{0, side, lob::OrderType::LIMIT, lob::TimeInForce::IOC};
+            order.price = env.fairPrice(instrument) + (side == lob::Side::BUY ? maxPayUp : -maxPayUp);
+            order.quantity = std::min(quantity, maxQuantity);
+            env.submit(self, instrument, order);
+        }
+        scheduleNext(env, self);
+    }
+    
+    template <typename Env>
+    void onMarketUpdate(Env&, ParticipantId) {}
+    
+    template <typename Env>
+    void onFill(Env&, ParticipantId, lob::InstrumentId, const lob::Fill& fill, bool) {
+        traded += fill.quantity;
+        position += fill.takerSide == lob::Side::BUY ? fill.quantity : -fill.quantity;
+    }
+
+private:
+    template <typename Env>
+    void scheduleNext(Env& env, ParticipantId self) {
+        double wait = -std::log(1.0 - env.uniform(self)) * static_cast<double>(meanInterval);
+        env.wakeAfter(self, 1 + static_cast<Timestamp>(wait));
+    }
+};
+
+// After each market update, hits resting quotes that the new fair value left at least
+// minEdge ticks stale, before their owners can requote
+struct LatencyArbitrageur {
+    std::vector<lob::InstrumentId> instruments;
+    lob::Price minEdge = 1;
+    lob::Quantity maxQuantity = 10;
+    lob::Quantity maxPosition = 100;  // per instrument, either side
+    
+    std::vector<lob::Quantity> positions;  // parallel to instruments
+    lob::Quantity traded = 0;
+    double edgeCaptured = 0.0;  // ticks x lots against fair at the fill
+    
+    template <typename Env>
+    void onStart(Env&, ParticipantId) {
+        positions.assign(instruments.size(), 0);
+    }
+    
+    template <typename Env>
+    void onWake(Env&, ParticipantId) {}
+    
+    template <typename Env>
+    void onMarketUpdate(Env& env, ParticipantId self) {
+        for (std::size_t i = 0; i < instruments.size(); ++i) {
+            lob::InstrumentId instrument = instruments[i];
+            const lob::OrderBook& book = env.book(instrument);
+            lob::Price fair = env.fairPrice(instrument);
+            
+            lob::Price ask = book.bestAsk();
+            if (ask != lob::NO_PRICE && ask <= fair - minEdge && positions[i] < maxPosition) {
+                lob::Quantity quantity = std::min({book.visibleQuantity(lob::Side::SELL, ask), maxQuantity, maxPosition - positions[i]});
+                if (quantity > 0) {
+                    env.submit(self, instrument, lob::OrderRequest{0, lob::Side::BUY, lob::OrderType::LIMIT, lob::TimeInForce::IOC, ask, quantity});
+                }
+            }
+            lob::Price bid = book.bestBid();
+            if (bid != lob::NO_PRICE && bid >= fair + minEdge && positions[i] > -maxPosition) {
+                lob::Quantity quantity = std::min({book.visibleQuantity(lob::Side::BUY, bid), maxQuantity, maxPosition + positions[i]});
+                if (quantity > 0) {
+                    env.submit(self, instrument, lob::OrderRequest{0, lob::Side::SELL, lob::OrderType::LIMIT, lob::TimeInForce::IOC, bid, quantity});
+                }
+            }
+        }
+    }
+    
+    template <typename Env>
+    void onFill(Env& env, ParticipantId, lob::InstrumentId instrument, const lob::Fill& fill, bool) {
+        auto it = std::find(instruments.begin(), instruments.end(), instrument);
+        lob::Quantity signedQuantity = fill.takerSide == lob::Side::BUY ? fill.quantity : -fill.quantity;
+        if (it != instruments.end()) {
+            positions[static_cast<std::size_t>(it - instruments.begin())] += signedQuantity;
+        }
+        traded += fill.quantity;
+        edgeCaptured += static_cast<double>((env.fairPrice(instrument) - fill.price) * signedQuantity);
+    }
+};
+
+// Quotes a two-sided market around fair on each of its instruments and requotes on
+// every market update. The quotes are skewed against inventory, and a side is pulled
+// once the inventory on that instrument reaches maxInventory.
+struct LiquidityProvider {
+    struct Quote {
+        lob::OrderId bidId = 0;  // 0 when no bid rests
+        lob::OrderId askId = 0;
+        lob::Price bidPrice = 0;
+        lob::Price askPrice = 0;
+        lob::Quantity bidLeft = 0;
+        lob::Quantity askLeft = 0;
+        lob::Quantity inventory = 0;
+    };
+    
+    std::vector<lob::InstrumentId> instruments;
+    lob::Price halfSpread = 2;
+    lob::Quantity quoteSize = 5;
+    lob::Quantity maxInventory = 20;
+    double skewPerLot = 0.25;  // ticks of quote shift per lot of inventory
+    
+    std::vector<Quote> quotes;  // parallel to instruments
+    lob::Quantity traded = 0;
+    
+    template <typename Env>
+    void onStart(Env& env, ParticipantId self) {
+        quotes.assign(instruments.size(), Quote());
+        for (std::size_t i = 0; i < instruments.size(); ++i) {
+            requote(env, self, i);
+        }
+    }
+    
+    template <typename Env>
+    void onWake(Env&, ParticipantId) {}
+    
+    template <typename Env>
+    void onMarketUpdate(Env& env, ParticipantId self) {
+        for (std::size_t i = 0; i < instruments.size(); ++i) {
+            requote(env, self, i);
+        }
+    }
+    
+    template <typename Env>
+    void onFill(Env& env, ParticipantId self, lob::InstrumentId instrument, const lob::Fill& fill, bool aggressor) {
+        auto it = std::find(instruments.begin(), instruments.end(), instrument);
+        if (it == instruments.end()) return;
+        auto i = static_cast<std::size_t>(it - instruments.begin());
+        Quote& q = quotes[i];
+        traded += fill.quantity;
+        
+        // A quote that crossed on arrival is the taker; a resting one is on the other side
+        bool bought = (fill.takerSide == lob::Side::BUY) == aggressor;
+        q.inventory += bought ? fill.quantity : -fill.quantity;
+        lob::OrderId& id = bought ? q.bidId : q.askId;
+        lob::Quantity& left = bought ? q.bidLeft : q.askLeft;
+        left -= fill.quantity;
+        if (left <= 0) {
+            // A replace in flight may have resized the order: make sure it is gone
+            if (env.book(instrument).contains(id)) env.cancel(self, instrument, id);
+            id = 0;
+            left = 0;
+        }
+        requote(env, self, i);
+    }
+
+private:
+    template <typename Env>
+    void requote(Env& env, ParticipantId self, std::size_t i) {
+        lob::InstrumentId instrument = instruments[i];
+        Quote& q = quotes[i];
+        lob::Price fair = env.fairPrice(instrument);
+        auto skew = static_cast<lob::Price>(std::lround(skewPerLot * static_cast<double>(q.inventory)));
+        
+        updateSide(env, self, instrument, lob::Side::BUY, q.inventory < maxInventory,
+                   fair - halfSpread - skew, q.bidId, q.bidPrice, q.bidLeft);
+        updateSide(env, self, instrument, lob::Side::SELL, q.inventory > -maxInventory,
+                   fair + halfSpread - skew, q.askId, q.askPrice, q.askLeft);
+    }
+    
+    template <typename Env>
+    void updateSide(Env& env, ParticipantId self, lob::InstrumentId instrument, lob::Side side, bool wanted,
+                    lob::Price target, lob::OrderId& id, lob::Price& price, lob::Quantity& left) {
+        if (!wanted) {
+            if (id != 0) {
+                env.cancel(self, instrument, id);
+                id = 0;
+                left = 0;
+            }
+            return;
+        }
+        if (id == 0) {
+            id = env.submit(self, instrument, lob::OrderRequest{0, side, lob::OrderType::LIMIT, lob::TimeInForce::GTC, target, quoteSize});
+            price = target;
+            left = quoteSize;
+        } else if (price != target) {
+            env.replace(self, instrument, id, target, left);
+            price = target;
+        }
+    }
+};
+
+}  // namespace omm::sim
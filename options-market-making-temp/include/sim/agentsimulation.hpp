@@ -0,0 +1,281 @@
+#pragma once
+
+#include "core/random.hpp"
+#include "lob/bookmanager.hpp"
+#include "sim/scheduler.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace omm::sim {
+
+// Event types used by AgentSimulation; drivers use types from AGENT_EVENT_TYPES up
+constexpr std::uint32_t AGENT_WAKE = 0;
+constexpr std::uint32_t ORDER_ARRIVAL = 1;
+constexpr std::uint32_t AGENT_EVENT_TYPES = 2;
+
+// Participant of orders sent to the exchange
+constexpr ParticipantId EXCHANGE = 0xFFFFFFFE;
+
+struct AgentStats {
+    std::uint64_t activations = 0;  // agent callbacks (wake, market update, fill)
+    std::uint64_t ordersSent = 0;
+    std::uint64_t ordersRejected = 0;
+    std::uint64_t fills = 0;
+    std::uint64_t externalFills = 0;  // maker fills of orders no agent sent
+    std::uint64_t marketUpdates = 0;
+};
+
+// Agents trading on a BookManager through the Scheduler.
+//
+// Agent types are template arguments and every type is stored in its own vector, so a
+// callback is a direct (inlinable) call on the concrete type: a market update runs one
+// tight loop per agent type, and an event for one agent dispatches on its type index.
+// An agent type provides
+//   template <typename Env> void onStart(Env&, ParticipantId self);
+//   template <typename Env> void onWake(Env&, ParticipantId self);
+//   template <typename Env> void onMarketUpdate(Env&, ParticipantId self);
+//   template <typename Env> void onFill(Env&, ParticipantId self, lob::InstrumentId,
+//                                       const lob::Fill&, bool aggressor);
+// and acts through submit / cancel / replace / wakeAfter. Orders reach the exchange
+// after a draw from the agent's LatencyModel, in the order they were sent, so agents
+// seeing the same market update race on latency. Fills are reported at match time.
+//
+// Other components may trade in the same books (a quoting engine). A fill whose maker
+// order no agent sent goes to the external fill handler; a fill of an agent's resting
+// order matched outside the simulation comes back in through deliverMakerFill.
+template <typename... Agents>
+class AgentSimulation {
+public:
+    AgentSimulation(lob::BookManager& books_, Scheduler& scheduler_, std::uint64_t seed)
+        : books(books_),
+          scheduler(scheduler_),
+          fair(books_.numBooks(), 0),
+          key(core::Philox4x32::makeKey(seed)) {}
+    
+    template <typename Agent>
+    ParticipantId addAgent(const Agent& agent, const LatencyModel& latency) {
+        constexpr std::size_t group = groupIndex<Agent>();
+        auto id = static_cast<ParticipantId>(slots.size());
+        auto& agents = std::get<group>(groups);
+        slots.push_back(AgentSlot{static_cast<std::uint32_t>(group), static_cast<std::uint32_t>(agents.size())});
+        agents.push_back(agent);
+        groupIds[group].push_back(id);
+        scheduler.setLatency(id, latency);
+        return id;
+    }
+    
+    // Calls every agent's onStart at the scheduler's current time
+    void start() {
+        forEachAgent([this](auto& agent, ParticipantId id) { agent.onStart(*this, id); });
+    }
+    
+    // Fair values (ticks) the agents price against, by instrument
+    void setFairPrice(lob::InstrumentId instrument, lob::Price price) { fair[instrument] = price; }
+    lob::Price fairPrice(lob::InstrumentId instrument) const { return fair[instrument]; }
+    
+    // Tell every agent the fair values changed, now
+    void publishMarketUpdate() {
+        ++agentStats.marketUpdates;
+        forEachAgent([this](auto& agent, ParticipantId id) { agent.onMarketUpdate(*this, id); });
+    }
+    
+    void setExternalFillHandler(lob::FillHandler handler) { externalFillHandler = std::move(handler); }
+    
+    // Report a fill of a resting order to the agent that sent it, as a maker fill.
+    // False (and nothing happens) when no agent owns fill.makerId.
+    bool deliverMakerFill(lob::InstrumentId instrument, const lob::Fill& fill) {
+        ParticipantId maker = ownerOf(fill.makerId);
+        if (!isAgent(maker)) return false;
+        ++agentStats.fills;
+        ++agentStats.activations;
+        visit(maker, [&](auto& agent) { agent.onFill(*this, maker, instrument, fill, false); });
+        return true;
+    }
+    
+    // Scheduler handler for AGENT_WAKE and ORDER_ARRIVAL events
+    void operator()(const Event& event, Scheduler&) {
+        if (event.type == AGENT_WAKE) {
+            ++agentStats.activations;
+            visit(event.target, [this, &event](auto& agent) { agent.onWake(*this, event.target); });
+        } else if (event.type == ORDER_ARRIVAL) {
+            arrive(static_cast<std::size_t>(event.payload));
+        }
+    }
+    
+    // --- Agent interface ---
+    
+    Timestamp now() const { return scheduler.now(); }
+    std::size_t numInstruments() const { return books.numBooks(); }
+    const lob::OrderBook& book(lob::InstrumentId instrument) const { return books.book(instrument); }
+    
+    // Uniform in [0, 1) from the agent's own Philox stream
+    double uniform(ParticipantId agent) {
+        std::uint64_t n = slots[agent].draws++;
+        core::Philox4x32::Counter out = core::Philox4x32::generate(core::Philox4x32::Counter{{
+            static_cast<std::uint32_t>(n),
+            static_cast<std::uint32_t>(n >> 32),
+            agent,
+            1,
+        }}, key);
+        return core::Philox4x32::toUniform(out.words[0], out.words[1]);
+    }
+    
+    // The id is assigned here (owner in the top bits) and returned to the agent
+    lob::OrderId submit(ParticipantId agent, lob::InstrumentId instrument, lob::OrderRequest order) {
+        order.id = (static_cast<lob::OrderId>(agent) << OWNER_SHIFT) | (++slots[agent].numOrders & SEQ_MASK);
+        send(agent, lob::OrderEvent{instrument, lob::OrderAction::ADD, order});
+        return order.id;
+    }
+    
+    void cancel(ParticipantId agent, lob::InstrumentId instrument, lob::OrderId id) {
+        lob::OrderRequest order{id, lob::Side::BUY};
+        send(agent, lob::OrderEvent{instrument, lob::OrderAction::CANCEL, order});
+    }
+    
+    void replace(ParticipantId agent, lob::InstrumentId instrument, lob::OrderId id, lob::Price price, lob::Quantity quantity) {
+        lob::OrderRequest order{id, lob::Side::BUY};
+        order.price = price;
+        order.quantity = quantity;
+        send(agent, lob::OrderEvent{instrument, lob::OrderAction::REPLACE, order});
+    }
+    
+    void wakeAfter(ParticipantId agent, Timestamp delay) {
+        scheduler.scheduleAfter(delay, AGENT_WAKE, agent);
+    }
+    
+    static ParticipantId ownerOf(lob::OrderId id) { return static_cast<ParticipantId>(id >> OWNER_SHIFT); }
+    bool isAgent(ParticipantId id) const { return id < slots.size(); }
+    
+    // --- Inspection ---
+    
+    template <typename Agent>
+    std::vector<Agent>& agents() { return std::get<groupIndex<Agent>()>(groups); }
+    
+    template <typename Agent>
+    const std::vector<ParticipantId>& agentIds() const { return groupIds[groupIndex<Agent>()]; }
+    
+    std::size_t numAgents() const { return slots.size(); }
+    const AgentStats& stats() const { return agentStats; }
+
+private:
+    static constexpr unsigned OWNER_SHIFT = 40;
+    static constexpr lob::OrderId SEQ_MASK = (lob::OrderId(1) << OWNER_SHIFT) - 1;
+    
+    struct AgentSlot {
+        std::uint32_t group;
+        std::uint32_t index;
+        std::uint64_t draws = 0;
+        std::uint64_t numOrders = 0;
+        Timestamp lastArrival = 0;  // keeps the agent's messages in order
+    };
+    
+    // An order in flight to the exchange; freed on arrival
+    struct InFlight {
+        lob::OrderEvent event;
+        ParticipantId agent;
+    };
+    
+    template <typename Agent, std::size_t I = 0>
+    static constexpr std::size_t groupIndex() {
+        static_assert(I < sizeof...(Agents), "agent type is not part of this AgentSimulation");
+        if constexpr (std::is_same_v<Agent, std::tuple_element_t<I, std::tuple<Agents...>>>) {
+            return I;
+        } else {
+            return groupIndex<Agent, I + 1>();
+        }
+    }
+    
+    // No-op for ids that are not agents
+    template <std::size_t I = 0, typename F>
+    void visit(ParticipantId id, F&& f) {
+        if constexpr (I == 0) {
+            if (!isAgent(id)) return;
+        }
+        if constexpr (I < sizeof...(Agents)) {
+            const AgentSlot& slot = slots[id];
+            if (slot.group == I) {
+                f(std::get<I>(groups)[slot.index]);
+            } else {
+                visit<I + 1>(id, f);
+            }
+        }
+    }
+    
+    template <std::size_t I = 0, typename F>
+    void forEachAgent(F&& f) {
+        if constexpr (I < sizeof...(Agents)) {
+            auto& agents = std::get<I>(groups);
+            const auto& ids = groupIds[I];
+            for (std::size_t i = 0; i < agents.size(); ++i) {
+                f(agents[i], ids[i]);
+            }
+            agentStats.activations += agents.size();
+            forEachAgent<I + 1>(f);
+        }
+    }
+    
+    void send(ParticipantId agent, const lob::OrderEvent& event) {
+        std::size_t slot;
+        if (!freeInFlight.empty()) {
+            slot = freeInFlight.back();
+            freeInFlight.pop_back();
+            inFlight[slot] = InFlight{event, agent};
+        } else {
+            slot = inFlight.size();
+            inFlight.push_back(InFlight{event, agent});
+        }
+        
+        AgentSlot& a = slots[agent];
+        Timestamp arrival = std::max(scheduler.now() + scheduler.drawLatency(agent), a.lastArrival);
+        a.lastArrival = arrival;
+        scheduler.scheduleAt(arrival, ORDER_ARRIVAL, EXCHANGE, slot);
+        ++agentStats.ordersSent;
+    }
+    
+    void arrive(std::size_t slot) {
+        InFlight order = inFlight[slot];
+        freeInFlight.push_back(slot);
+        
+        fills.clear();
+        lob::OrderResult result = books.route(order.event, fills);
+        agentStats.ordersRejected += result.status == lob::OrderStatus::REJECTED;
+        agentStats.fills += fills.size();
+        
+        lob::InstrumentId instrument = order.event.instrument;
+        for (const lob::Fill& fill : fills) {
+            ParticipantId maker = ownerOf(fill.makerId);
+            if (isAgent(maker)) {
+                ++agentStats.activations;
+                visit(maker, [&](auto& agent) { agent.onFill(*this, maker, instrument, fill, false); });
+            } else {
+                ++agentStats.externalFills;
+                if (externalFillHandler) externalFillHandler(instrument, fill);
+            }
+            ++agentStats.activations;
+            visit(order.agent, [&](auto& agent) { agent.onFill(*this, order.agent, instrument, fill, true); });
+        }
+    }
+    
+    lob::BookManager& books;
+    Scheduler& scheduler;
+    std::vector<lob::Price> fair;
+    core::Philox4x32::Key key;
+    
+    std::tuple<std::vector<Agents>...> groups;
+    std::array<std::vector<ParticipantId>, sizeof...(Agents)> groupIds;
+    std::vector<AgentSlot> slots;
+    
+    std::vector<InFlight> inFlight;
+    std::vector<std::size_t> freeInFlight;
+    std::vector<lob::Fill> fills;  // scratch for one arrival
+    lob::FillHandler externalFillHandler;
+    AgentStats agentStats;
+};
+
+}  // namespace omm::sim
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace omm::sim {
+
+using Timestamp = std::int64_t;  // nanoseconds since the simulation start
+
+constexpr Timestamp NS_PER_MICROSECOND = 1000;
+constexpr Timestamp NS_PER_MILLISECOND = 1000 * NS_PER_MICROSECOND;
+constexpr Timestamp NS_PER_SECOND = 1000 * NS_PER_MILLISECOND;
+constexpr Timestamp NS_PER_DAY = 86400 * NS_PER_SECOND;
+constexpr Timestamp END_OF_TIME = std::numeric_limits<Timestamp>::max();
+
+using ParticipantId = std::uint32_t;
+
+struct Event {
+    Timestamp time;
+    std::uint64_t seq;         // scheduling order: events at the same time pop first-in first-out
+    std::uint32_t type;        // meaning is up to the handler
+    ParticipantId target;      // participant the event is delivered to
+    std::uint64_t payload;     // e.g. an order or instrument index
+};
+
+// 4-ary min-heap of events on (time, seq).
+//
+// A node's four children are adjacent, so a sift-down step compares one or two cache
+// lines instead of following pointers, and the tree is half as deep as a binary heap.
+// Sifts move a hole instead of swapping.
+class EventQueue {
+public:
+    bool empty() const { return heap.empty(); }
+    std::size_t size() const { return heap.size(); }
+    const Event& top() const { return heap.front(); }
+    
+    void reserve(std::size_t n) { heap.reserve(n); }
+    void clear() { heap.clear(); }
+    
+    void push(const Event& event) {
+        std::size_t hole = heap.size();
+        heap.push_back(event);
+        while (hole > 0) {
+            std::size_t parent = (hole - 1) / ARITY;
+            if (!before(event, heap[parent])) break;
+            heap[hole] = heap[parent];
+            hole = parent;
+        }
+        heap[hole] = event;
+    }
+    
+    Event pop() {
+        Event result = heap.front();
+        Event last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            siftDown(last);
+        }
+        return result;
+    }
+    
+    // Pop and push in one sift: the event must not be earlier than the current top
+    // (true for anything scheduled while handling the top event)
+    void replaceTop(const Event& event) {
+        siftDown(event);
+    }
+
+private:
+    // Fill the vacant root with event and move it down to its place
+    void siftDown(const Event& event) {
+        std::size_t n = heap.size();
+        OrderKey eventKey = keyOf(event);
+        std::size_t hole = 0;
+        for (;;) {
+            std::size_t first = hole * ARITY + 1;
+            if (first >= n) break;
+            std::size_t end = first + ARITY < n ? first + ARITY : n;
+            
+            // Select the earliest child without branching on the (unpredictable) keys
+            std::size_t best = first;
+            OrderKey bestKey = keyOf(heap[first]);
+            for (std::size_t child = first + 1; child < end; ++child) {
+                OrderKey childKey = keyOf(heap[child]);
+                bool earlier = childKey < bestKey;
+                best = earlier ? child : best;
+                bestKey = earlier ? childKey : bestKey;
+            }
+            if (!(bestKey < eventKey)) break;
+            heap[hole] = heap[best];
+            hole = best;
+        }
+        heap[hole] = event;
+    }
+    static constexpr std::size_t ARITY = 4;
+
+#if defined(__SIZEOF_INT128__)
+    // (time, seq) as one unsigned 128-bit number, compared without branches
+    using OrderKey = unsigned __int128;
+    
+    static OrderKey keyOf(const Event& e) {
+        auto time = static_cast<std::uint64_t>(e.time) ^ (std::uint64_t(1) << 63);
+        return (static_cast<OrderKey>(time) << 64) | e.seq;
+    }
+#else
+    struct OrderKey {
+        Timestamp time;
+        std::uint64_t seq;
+        
+        bool operator<(const OrderKey& other) const {
+            return time < other.time || (time == other.time && seq < other.seq);
+        }
+    };
+    
+    static OrderKey keyOf(const Event& e) { return OrderKey{e.time, e.seq}; }
+#endif
+    
+    static bool before(const Event& a, const Event& b) { return keyOf(a) < keyOf(b); }
+    
+    std::vector<Event> heap;
+};
+
+}  // namespace omm::sim
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "sim/eventqueue.hpp"
+#include <cmath>
+#include <cstdint>
+
+namespace omm::sim {
+
+enum class LatencyKind : std::uint8_t {
+    CONSTANT,     // base
+    UNIFORM,      // base + U[0, spread)
+    EXPONENTIAL   // base + Exp(mean spread): a fixed wire delay plus queueing
+};
+
+// One-way delay of a participant's messages
+struct LatencyModel {
+    LatencyKind kind = LatencyKind::CONSTANT;
+    Timestamp base = 0;
+    Timestamp spread = 0;
+    
+    static LatencyModel constant(Timestamp base) { return LatencyModel{LatencyKind::CONSTANT, base, 0}; }
+    static LatencyModel uniform(Timestamp base, Timestamp spread) { return LatencyModel{LatencyKind::UNIFORM, base, spread}; }
+    static LatencyModel exponential(Timestamp base, Timestamp mean) { return LatencyModel{LatencyKind::EXPONENTIAL, base, mean}; }
+    
+    // Delay for a uniform draw u in [0, 1)
+    Timestamp sample(double u) const {
+        switch (kind) {
+            case LatencyKind::UNIFORM:
+                return base + static_cast<Timestamp>(u * static_cast<double>(spread));
+            case LatencyKind::EXPONENTIAL:
+                return base + static_cast<Timestamp>(-std::log(1.0 - u) * static_cast<double>(spread));
+            case LatencyKind::CONSTANT:
+                break;
+        }
+        return base;
+    }
+};
+
+}  // namespace omm::sim
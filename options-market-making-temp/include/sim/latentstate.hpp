@@ -0,0 +1,41 @@
+#pragma once
+
+#include "core/random.hpp"
+#include "core/workers/simulator.hpp"
+#include "sim/eventqueue.hpp"
+#include <cstdint>
+
+namespace omm::sim {
+
+// Regime, spot and ATM vol of the simulator, sampled at event times.
+//
+// The regime is the daily Markov chain of Simulator: it switches at the start of each
+// day (time a multiple of NS_PER_DAY; for the first, partial or not, at the first
+// sample after start) and holds within the day. Spot and vol move between samples by
+// Simulator::diffuseState over the elapsed time under the day's regime. One sample per
+// day therefore steps like simulateNextState, switch then diffuse, and finer sampling
+// refines the same GBM / OU dynamics. Draws come from Philox4x32 keyed by the seed and addressed by sample
+// number and day, so a path depends only on the seed and the sample times.
+class LatentState {
+public:
+    LatentState(const core::workers::MarketState& initial, std::uint64_t seed, Timestamp start = 0);
+    
+    // State at time (not before the last sample)
+    const core::workers::MarketState& sampleAt(Timestamp time);
+    
+    const core::workers::MarketState& state() const { return current; }
+    Timestamp time() const { return lastTime; }
+
+private:
+    void diffuse(Timestamp elapsed);
+    void switchRegime(std::int64_t day);
+    
+    core::workers::MarketState current;
+    Timestamp lastTime;
+    Timestamp nextDayBoundary;
+    bool dayStarted = false;  // regime of the current day drawn
+    core::Philox4x32::Key key;
+    std::uint64_t numDiffusions = 0;
+};
+
+}  // namespace omm::sim
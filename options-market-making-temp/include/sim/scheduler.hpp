@@ -0,0 +1,103 @@
+#pragma once
+
+#include "core/random.hpp"
+#include "sim/eventqueue.hpp"
+#include "sim/latency.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace omm::sim {
+
+// Discrete-event simulation kernel.
+//
+// Events are kept in an EventQueue and delivered in (time, scheduling order) to a
+// handler given to run(), which is called directly (no virtual dispatch) and schedules
+// follow-up events on the scheduler. Messages sent by a participant arrive after a draw
+// from that participant's LatencyModel. Draws come from Philox4x32 keyed by the seed
+// and addressed by (participant, draw number), so each participant's delays do not
+// depend on how its events interleave with everyone else's.
+class Scheduler {
+public:
+    explicit Scheduler(std::uint64_t seed = 0);
+    
+    Timestamp now() const { return currentTime; }
+    
+    // Times before now() are clamped to now()
+    void scheduleAt(Timestamp time, std::uint32_t type, ParticipantId target, std::uint64_t payload = 0) {
+        Event event{time < currentTime ? currentTime : time, nextSeq++, type, target, payload};
+        if (topVacant) {
+            queue.replaceTop(event);
+            topVacant = false;
+        } else {
+            queue.push(event);
+        }
+    }
+    void scheduleAfter(Timestamp delay, std::uint32_t type, ParticipantId target, std::uint64_t payload = 0) {
+        scheduleAt(currentTime + delay, type, target, payload);
+    }
+    
+    // Delivered to target after a latency draw of the sender
+    void send(ParticipantId from, std::uint32_t type, ParticipantId target, std::uint64_t payload = 0) {
+        scheduleAt(currentTime + drawLatency(from), type, target, payload);
+    }
+    
+    // Participants without a model have zero latency
+    void setLatency(ParticipantId participant, const LatencyModel& model);
+    const LatencyModel& latency(ParticipantId participant) const;
+    Timestamp drawLatency(ParticipantId participant);
+    
+    // Deliver events up to and including time until, calling handler(event, *this) for
+    // each, then move the clock to until. Returns the number of events delivered.
+    template <typename Handler>
+    std::size_t run(Handler& handler, Timestamp until = END_OF_TIME) {
+        std::size_t count = 0;
+        stopRequested = false;
+        while (!queue.empty() && queue.top().time <= until && !stopRequested) {
+            // The top stays in the heap while it is handled: the first event the
+            // handler schedules takes its place with one sift instead of pop + push
+            Event event = queue.top();
+            topVacant = true;
+            currentTime = event.time;
+            handler(static_cast<const Event&>(event), *this);
+            if (topVacant) {
+                queue.pop();
+                topVacant = false;
+            }
+            ++count;
+        }
+        if (!stopRequested && until != END_OF_TIME && currentTime < until) {
+            currentTime = until;
+        }
+        processedCount += count;
+        return count;
+    }
+    
+    // Make run() return after the current event
+    void stop() { stopRequested = true; }
+    
+    std::size_t pending() const { return queue.size() - (topVacant ? 1 : 0); }
+    std::uint64_t processed() const { return processedCount; }
+    void reserve(std::size_t events) { queue.reserve(events); }
+    
+    // Drop pending events and restart the clock and latency draws at zero
+    void reset();
+
+private:
+    struct Participant {
+        LatencyModel model;
+        std::uint64_t draws = 0;
+    };
+    
+    EventQueue queue;
+    Timestamp currentTime = 0;
+    std::uint64_t nextSeq = 0;
+    std::uint64_t processedCount = 0;
+    bool stopRequested = false;
+    bool topVacant = false;  // the queue's top was delivered and awaits replacement
+    
+    core::Philox4x32::Key key;
+    std::vector<Participant> participants;
+};
+
+}  // namespace omm::sim
@@ -0,0 +1,87 @@
+#include "analytics/chainexport.hpp"
+#include <cstring>
+
+namespace omm::analytics {
+
+namespace {
+
+constexpr const char* CSV_HEADER =
+    "time,expiry,callTheta,callVega,callGamma,callDelta,callPrice,normStrike,strike,forwardStrike,"
+    "impliedVol,putPrice,putDelta,putGamma,putVega,putTheta\n";
+
+}  // namespace
+
+ChainExporter::ChainExporter(ExportFormat format_, int precision_)
+    : format(format_),
+      precision(precision_),
+      text(format_ == ExportFormat::CSV ? std::size_t(1) << 20 : OutputBuffer::MAX_NUMBER) {}
+
+bool ChainExporter::open(const std::string& path, const std::string& assetSymbol) {
+    close();
+    steps = 0;
+    rows = 0;
+    if (format == ExportFormat::COLUMNAR) return columns.open(path, assetSymbol);
+    if (!text.open(path)) return false;
+    writeHeader();
+    return true;
+}
+
+bool ChainExporter::attach(std::FILE* stream, const std::string& assetSymbol) {
+    close();
+    steps = 0;
+    rows = 0;
+    if (format == ExportFormat::COLUMNAR) return columns.attach(stream, assetSymbol);
+    if (!text.attach(stream)) return false;
+    writeHeader();
+    return true;
+}
+
+void ChainExporter::writeHeader() {
+    text.put(CSV_HEADER);
+}
+
+bool ChainExporter::exportSurface(const core::models::Market& market) {
+    if (format == ExportFormat::COLUMNAR && !columns.append(market)) return false;
+    if (format == ExportFormat::CSV && (!text.isOpen() || !text.ok())) return false;
+    
+    for (double expiry : market.volSurface->expiries) {
+        Table::getOptionChainTable(market, expiry, workspace, chain);
+        if (format == ExportFormat::COLUMNAR) {
+            if (!columns.appendChain(expiry, chain)) return false;
+        } else {
+            writeCsvRows(market.time, expiry);
+        }
+        rows += chain.size();
+    }
+    ++steps;
+    return format == ExportFormat::COLUMNAR || text.ok();
+}
+
+void ChainExporter::writeCsvRows(int time, double expiry) {
+    double fields[OptionChainColumns::NUM_FIELDS];
+    for (const OptionChainRow& row : chain) {
+        std::memcpy(fields, &row, sizeof(row));
+        text.putInt(time);
+        text.put(',');
+        text.putDouble(expiry);
+        for (double field : fields) {
+            text.put(',');
+            text.putDouble(field, precision);
+        }
+        text.put('\n');
+    }
+}
+
+bool ChainExporter::flush() {
+    return format == ExportFormat::COLUMNAR ? columns.flush() : text.flush();
+}
+
+bool ChainExporter::close() {
+    return format == ExportFormat::COLUMNAR ? columns.close() : text.close();
+}
+
+std::uint64_t ChainExporter::bytesWritten() const {
+    return format == ExportFormat::COLUMNAR ? columns.bytesWritten() : text.bytesWritten();
+}
+
+}  // namespace omm::analytics
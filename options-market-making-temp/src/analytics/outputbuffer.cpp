@@ -0,0 +1,113 @@
+#include "analytics/outputbuffer.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace omm::analytics {
+
+OutputBuffer::OutputBuffer(std::size_t capacity_)
+    : buffer(std::max(capacity_, MAX_NUMBER)),
+      end(buffer.size()) {}
+
+OutputBuffer::~OutputBuffer() {
+    close();
+}
+
+bool OutputBuffer::open(const std::string& path) {
+    close();
+    failed = false;
+    streamBytes = 0;
+    stream = std::fopen(path.c_str(), "wb");
+    if (!stream) {
+        failed = true;
+        return false;
+    }
+    // The buffer already batches the writes
+    std::setvbuf(stream, nullptr, _IONBF, 0);
+    ownsStream = true;
+    return true;
+}
+
+bool OutputBuffer::attach(std::FILE* stream_) {
+    close();
+    failed = !stream_;
+    streamBytes = 0;
+    stream = stream_;
+    ownsStream = false;
+    return !failed;
+}
+
+void OutputBuffer::put(std::string_view text) {
+    while (!text.empty()) {
+        if (pos == end && !drain()) return;
+        std::size_t count = std::min(text.size(), end - pos);
+        std::memcpy(buffer.data() + pos, text.data(), count);
+        pos += count;
+        text.remove_prefix(count);
+    }
+}
+
+void OutputBuffer::put(char c, std::size_t count) {
+    while (count > 0) {
+        if (pos == end && !drain()) return;
+        std::size_t run = std::min(count, end - pos);
+        std::memset(buffer.data() + pos, c, run);
+        pos += run;
+        count -= run;
+    }
+}
+
+void OutputBuffer::putInt(long long value) {
+    char* at = reserve();
+    pos = static_cast<std::size_t>(std::to_chars(at, at + MAX_NUMBER, value).ptr - buffer.data());
+}
+
+void OutputBuffer::putDouble(double value, int precision) {
+    char* at = reserve();
+    auto result = precision < 0 ? std::to_chars(at, at + MAX_NUMBER, value)
+                                : std::to_chars(at, at + MAX_NUMBER, value, std::chars_format::fixed, precision);
+    pos = static_cast<std::size_t>(result.ptr - buffer.data());
+}
+
+void OutputBuffer::putPadded(std::string_view text, int width) {
+    if (static_cast<int>(text.size()) < width) put(' ', static_cast<std::size_t>(width) - text.size());
+    put(text);
+}
+
+void OutputBuffer::putPadded(double value, int width, int precision) {
+    char digits[MAX_NUMBER];
+    auto result = std::to_chars(digits, digits + MAX_NUMBER, value, std::chars_format::fixed, precision);
+    putPadded(std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)), width);
+}
+
+bool OutputBuffer::drain() {
+    if (!stream || failed) {
+        // Nowhere to write: drop the text so callers can keep formatting
+        pos = 0;
+        return false;
+    }
+    if (pos > 0 && std::fwrite(buffer.data(), 1, pos, stream) != pos) {
+        failed = true;
+        pos = 0;
+        return false;
+    }
+    streamBytes += pos;
+    pos = 0;
+    return true;
+}
+
+bool OutputBuffer::flush() {
+    return drain() && std::fflush(stream) == 0;
+}
+
+bool OutputBuffer::close() {
+    if (!stream) return !failed;
+    bool ok = flush();
+    if (ownsStream) ok = std::fclose(stream) == 0 && ok;
+    stream = nullptr;
+    ownsStream = false;
+    failed = failed || !ok;
+    return ok;
+}
+
+}  // namespace omm::analytics
@@ -0,0 +1,466 @@
+#include "analytics/snapshotfile.hpp"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace omm::analytics {
+
+using core::models::Market;
+using core::models::Regime;
+
+static_assert(std::is_standard_layout<OptionChainRow>::value &&
+              sizeof(OptionChainRow) == OptionChainColumns::NUM_FIELDS * sizeof(double),
+              "OptionChainRow is stored field by field as doubles");
+
+namespace {
+
+constexpr std::size_t ALIGN = 8;
+constexpr std::size_t WRITE_BUFFER = 1 << 20;
+constexpr std::uint8_t SMILE_SURFACE = 0;
+constexpr std::uint8_t SSVI_SURFACE = 1;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t headerBytes;
+    std::uint32_t rowFields;  // OptionChainRow fields per row
+    char symbol[SnapshotFileFormat::MAX_SYMBOL];
+    std::uint64_t reserved;
+};
+
+struct ChunkHeader {
+    std::uint32_t magic;
+    std::uint32_t numSnapshots;
+    std::uint64_t numExpiries;
+    std::uint64_t numKnots;
+    std::uint64_t numRows;
+    std::uint64_t payloadBytes;
+};
+
+static_assert(sizeof(FileHeader) == SnapshotFileFormat::HEADER_BYTES, "file header layout");
+static_assert(sizeof(ChunkHeader) == SnapshotFileFormat::CHUNK_HEADER_BYTES, "chunk header layout");
+
+std::size_t paddedBytes(std::size_t bytes) {
+    return (bytes + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+// Bytes of the columns of a chunk, in file order
+std::size_t payloadBytes(std::size_t snapshots, std::size_t expiries, std::size_t knots, std::size_t rows) {
+    return paddedBytes(snapshots * sizeof(std::int32_t))        // times
+         + 2 * paddedBytes(snapshots * sizeof(std::uint8_t))    // regimes, surface kinds
+         + 6 * snapshots * sizeof(double)                       // spot, rate, vol, SSVI shape
+         + 2 * paddedBytes(snapshots * sizeof(std::uint32_t))   // expiry and row ends
+         + 2 * expiries * sizeof(double)                        // expiries, ATM total variances
+         + paddedBytes(expiries * sizeof(std::uint32_t))        // knot ends
+         + 2 * knots * sizeof(double)                           // norm strikes, vols
+         + (1 + OptionChainColumns::NUM_FIELDS) * rows * sizeof(double);
+}
+
+// An ends column must never fall and must finish on total, or a view would start past
+// its end or read outside the chunk
+bool validEnds(const std::uint32_t* ends, std::size_t count, std::uint64_t total) {
+    std::uint64_t previous = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (ends[i] < previous || ends[i] > total) return false;
+        previous = ends[i];
+    }
+    return previous == total;
+}
+
+// Walks the columns of a chunk in file order
+class ColumnCursor {
+public:
+    explicit ColumnCursor(const unsigned char* at_) : at(at_) {}
+    
+    template <typename T>
+    const T* take(std::size_t count) {
+        auto* column = reinterpret_cast<const T*>(at);
+        at += paddedBytes(count * sizeof(T));
+        return column;
+    }
+
+private:
+    const unsigned char* at;
+};
+
+}  // namespace
+
+// Writer
+
+SnapshotWriter::SnapshotWriter(std::size_t chunkSnapshots_)
+    : chunkSnapshots(std::max<std::size_t>(chunkSnapshots_, 1)),
+      rowFields(OptionChainColumns::NUM_FIELDS) {}
+
+SnapshotWriter::~SnapshotWriter() {
+    close();
+}
+
+bool SnapshotWriter::open(const std::string& path, const std::string& assetSymbol) {
+    close();
+    std::FILE* stream = std::fopen(path.c_str(), "wb");
+    if (stream) std::setvbuf(stream, nullptr, _IOFBF, WRITE_BUFFER);
+    return start(stream, true, assetSymbol);
+}
+
+bool SnapshotWriter::attach(std::FILE* stream, const std::string& assetSymbol) {
+    close();
+    return start(stream, false, assetSymbol);
+}
+
+bool SnapshotWriter::start(std::FILE* stream, bool owned, const std::string& assetSymbol) {
+    failed = false;
+    snapshotsWritten = 0;
+    fileBytes = 0;
+    file = stream;
+    ownsFile = owned;
+    if (!file) {
+        failed = true;
+        return false;
+    }
+    
+    FileHeader header{};
+    std::memcpy(header.magic, SnapshotFileFormat::MAGIC, sizeof(header.magic));
+    header.version = SnapshotFileFormat::VERSION;
+    header.byteOrder = SnapshotFileFormat::BYTE_ORDER_MARK;
+    header.headerBytes = SnapshotFileFormat::HEADER_BYTES;
+    header.rowFields = OptionChainColumns::NUM_FIELDS;
+    std::memcpy(header.symbol, assetSymbol.data(), std::min(assetSymbol.size(), sizeof(header.symbol)));
+    return writeBytes(&header, sizeof(header));
+}
+
+bool SnapshotWriter::append(const Market& market) {
+    if (!file || failed) return false;
+    if (times.size() == chunkSnapshots && !flush()) return false;
+    
+    const auto& surface = *market.volSurface;
+    times.push_back(market.time);
+    regimes.push_back(static_cast<std::uint8_t>(market.regime));
+    spots.push_back(market.spot);
+    interestRates.push_back(market.interestRate);
+    atmOneMonthVols.push_back(surface.atmOneMonthVolEst);
+    
+    if (surface.ssvi) {
+        const auto& model = *surface.ssvi;
+        surfaceKinds.push_back(SSVI_SURFACE);
+        ssviRhos.push_back(model.params().rho);
+        ssviEtas.push_back(model.params().eta);
+        ssviGammas.push_back(model.params().gamma);
+        expiries.insert(expiries.end(), model.expiries().begin(), model.expiries().end());
+        atmTotalVariances.insert(atmTotalVariances.end(), model.atmTotalVariances().begin(),
+                                 model.atmTotalVariances().end());
+        knotEnds.insert(knotEnds.end(), model.expiries().size(), static_cast<std::uint32_t>(normStrikes.size()));
+    } else {
+        surfaceKinds.push_back(SMILE_SURFACE);
+        ssviRhos.push_back(0.0);
+        ssviEtas.push_back(0.0);
+        ssviGammas.push_back(0.0);
+        expiries.insert(expiries.end(), surface.expiries.begin(), surface.expiries.end());
+        atmTotalVariances.insert(atmTotalVariances.end(), surface.expiries.size(), 0.0);
+        for (const auto& smile : surface.smiles) {
+            normStrikes.insert(normStrikes.end(), smile.normStrikes.begin(), smile.normStrikes.end());
+            volPoints.insert(volPoints.end(), smile.volPoints.begin(), smile.volPoints.end());
+            knotEnds.push_back(static_cast<std::uint32_t>(normStrikes.size()));
+        }
+    }
+    expiryEnds.push_back(static_cast<std::uint32_t>(expiries.size()));
+    rowEnds.push_back(static_cast<std::uint32_t>(rowExpiries.size()));
+    return true;
+}
+
+bool SnapshotWriter::appendChain(double expiry, const std::vector<OptionChainRow>& rows) {
+    if (!file || failed || times.empty()) return false;
+    
+    double fields[OptionChainColumns::NUM_FIELDS];
+    for (const OptionChainRow& row : rows) {
+        std::memcpy(fields, &row, sizeof(row));
+        rowExpiries.push_back(expiry);
+        for (std::size_t f = 0; f < OptionChainColumns::NUM_FIELDS; ++f) rowFields[f].push_back(fields[f]);
+    }
+    rowEnds.back() = static_cast<std::uint32_t>(rowExpiries.size());
+    return true;
+}
+
+bool SnapshotWriter::writeBytes(const void* bytes, std::size_t count) {
+    if (failed) return false;
+    if (count == 0) return true;  // empty columns have no data pointer
+    if (std::fwrite(bytes, 1, count, file) != count) {
+        failed = true;
+        return false;
+    }
+    fileBytes += count;
+    return true;
+}
+
+template <typename T>
+bool SnapshotWriter::writeColumn(const std::vector<T>& column) {
+    static const unsigned char zeros[ALIGN] = {};
+    std::size_t bytes = column.size() * sizeof(T);
+    return writeBytes(column.data(), bytes) && writeBytes(zeros, paddedBytes(bytes) - bytes);
+}
+
+bool SnapshotWriter::flush() {
+    if (!file || failed) return false;
+    if (times.empty()) return true;
+    
+    ChunkHeader header{
+        SnapshotFileFormat::CHUNK_MAGIC,
+        static_cast<std::uint32_t>(times.size()),
+        expiries.size(),
+        normStrikes.size(),
+        rowExpiries.size(),
+        payloadBytes(times.size(), expiries.size(), normStrikes.size(), rowExpiries.size())
+    };
+    bool ok = writeBytes(&header, sizeof(header))
+        && writeColumn(times) && writeColumn(regimes) && writeColumn(spots) && writeColumn(interestRates)
+        && writeColumn(atmOneMonthVols) && writeColumn(surfaceKinds) && writeColumn(ssviRhos)
+        && writeColumn(ssviEtas) && writeColumn(ssviGammas) && writeColumn(expiryEnds) && writeColumn(rowEnds)
+        && writeColumn(expiries) && writeColumn(atmTotalVariances) && writeColumn(knotEnds)
+        && writeColumn(normStrikes) && writeColumn(volPoints) && writeColumn(rowExpiries);
+    for (const auto& column : rowFields) ok = ok && writeColumn(column);
+    if (!ok || std::fflush(file) != 0) {
+        failed = true;
+        return false;
+    }
+    
+    snapshotsWritten += times.size();
+    for (auto* column : {&spots, &interestRates, &atmOneMonthVols, &ssviRhos, &ssviEtas, &ssviGammas,
+                         &expiries, &atmTotalVariances, &normStrikes, &volPoints, &rowExpiries}) {
+        column->clear();
+    }
+    for (auto& column : rowFields) column.clear();
+    times.clear();
+    regimes.clear();
+    surfaceKinds.clear();
+    expiryEnds.clear();
+    rowEnds.clear();
+    knotEnds.clear();
+    return true;
+}
+
+bool SnapshotWriter::close() {
+    if (!file) return !failed;
+    bool ok = flush();
+    ok = (ownsFile ? std::fclose(file) : std::fflush(file)) == 0 && ok;
+    file = nullptr;
+    ownsFile = false;
+    failed = failed || !ok;
+    return ok;
+}
+
+// Reader
+
+OptionChainRow OptionChainColumns::row(std::size_t i) const {
+    double values[NUM_FIELDS];
+    for (std::size_t f = 0; f < NUM_FIELDS; ++f) values[f] = fields[f][i];
+    OptionChainRow result;
+    std::memcpy(&result, values, sizeof(result));
+    return result;
+}
+
+SmileView SnapshotView::smile(std::size_t expiryIdx) const {
+    std::size_t begin = expiryIdx == 0 ? firstKnot : knotEnds[expiryIdx - 1];
+    return SmileView{knotEnds[expiryIdx] - begin, normStrikes + begin, volPoints + begin};
+}
+
+SnapshotReader::~SnapshotReader() {
+    close();
+}
+
+void SnapshotReader::close() {
+#if !defined(_WIN32)
+    if (mapped) munmap(const_cast<unsigned char*>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+    mapped = false;
+    buffer.clear();
+    buffer.shrink_to_fit();
+    fileVersion = 0;
+    symbol.clear();
+    chunks.clear();
+    snapshotCount = 0;
+}
+
+bool SnapshotReader::open(const std::string& path) {
+    close();
+
+#if defined(_WIN32)
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    buffer.resize(static_cast<std::size_t>(in.tellg()));
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()))) return false;
+    data = buffer.data();
+    size = buffer.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(SnapshotFileFormat::HEADER_BYTES)) {
+        ::close(fd);
+        return false;
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        size = 0;
+        return false;
+    }
+    data = static_cast<const unsigned char*>(mapping);
+    mapped = true;
+    madvise(mapping, size, MADV_SEQUENTIAL);
+#endif
+    
+    FileHeader header;
+    if (size < sizeof(header)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, SnapshotFileFormat::MAGIC, sizeof(header.magic)) != 0
+        || header.version != SnapshotFileFormat::VERSION
+        || header.byteOrder != SnapshotFileFormat::BYTE_ORDER_MARK
+        || header.headerBytes != SnapshotFileFormat::HEADER_BYTES
+        || header.rowFields != OptionChainColumns::NUM_FIELDS) {
+        close();
+        return false;
+    }
+    fileVersion = header.version;
+    symbol.assign(header.symbol, std::find(header.symbol, header.symbol + sizeof(header.symbol), '\0'));
+    
+    // Whole chunks up to the end of the file, or up to the first one cut short
+    std::size_t offset = SnapshotFileFormat::HEADER_BYTES;
+    while (size - offset >= sizeof(ChunkHeader)) {
+        ChunkHeader chunkHeader;
+        std::memcpy(&chunkHeader, data + offset, sizeof(chunkHeader));
+        std::size_t payloadOffset = offset + sizeof(chunkHeader);
+        // Each entry of every count takes at least 8 bytes of the rest of the file;
+        // bounding the counts first keeps payloadBytes from overflowing into a match
+        std::uint64_t maxCount = (size - payloadOffset) / sizeof(double);
+        if (chunkHeader.magic != SnapshotFileFormat::CHUNK_MAGIC || chunkHeader.numSnapshots == 0
+            || chunkHeader.numSnapshots > maxCount || chunkHeader.numExpiries > maxCount
+            || chunkHeader.numKnots > maxCount || chunkHeader.numRows > maxCount) {
+            break;
+        }
+        std::uint64_t expected = payloadBytes(chunkHeader.numSnapshots, chunkHeader.numExpiries,
+                                              chunkHeader.numKnots, chunkHeader.numRows);
+        if (chunkHeader.payloadBytes != expected || expected > size - payloadOffset) {
+            break;
+        }
+        
+        Chunk chunk;
+        ColumnCursor cursor(data + payloadOffset);
+        std::size_t n = chunkHeader.numSnapshots;
+        chunk.firstSnapshot = snapshotCount;
+        chunk.numSnapshots = n;
+        chunk.times = cursor.take<std::int32_t>(n);
+        chunk.regimes = cursor.take<std::uint8_t>(n);
+        chunk.spots = cursor.take<double>(n);
+        chunk.interestRates = cursor.take<double>(n);
+        chunk.atmOneMonthVols = cursor.take<double>(n);
+        chunk.surfaceKinds = cursor.take<std::uint8_t>(n);
+        chunk.ssviRhos = cursor.take<double>(n);
+        chunk.ssviEtas = cursor.take<double>(n);
+        chunk.ssviGammas = cursor.take<double>(n);
+        chunk.expiryEnds = cursor.take<std::uint32_t>(n);
+        chunk.rowEnds = cursor.take<std::uint32_t>(n);
+        chunk.expiries = cursor.take<double>(chunkHeader.numExpiries);
+        chunk.atmTotalVariances = cursor.take<double>(chunkHeader.numExpiries);
+        chunk.knotEnds = cursor.take<std::uint32_t>(chunkHeader.numExpiries);
+        chunk.normStrikes = cursor.take<double>(chunkHeader.numKnots);
+        chunk.volPoints = cursor.take<double>(chunkHeader.numKnots);
+        chunk.rowExpiries = cursor.take<double>(chunkHeader.numRows);
+        for (auto& column : chunk.rowFields) column = cursor.take<double>(chunkHeader.numRows);
+        
+        // Ends must rise to the chunk's counts, or the views would read past it
+        bool consistent = validEnds(chunk.expiryEnds, n, chunkHeader.numExpiries)
+            && validEnds(chunk.rowEnds, n, chunkHeader.numRows)
+            && validEnds(chunk.knotEnds, chunkHeader.numExpiries, chunkHeader.numKnots);
+        if (!consistent) break;
+        
+        chunks.push_back(chunk);
+        snapshotCount += n;
+        offset = payloadOffset + expected;
+    }
+    return true;
+}
+
+SnapshotView SnapshotReader::snapshot(std::size_t idx) const {
+    auto it = std::upper_bound(chunks.begin(), chunks.end(), idx,
+                               [](std::size_t i, const Chunk& chunk) { return i < chunk.firstSnapshot; });
+    const Chunk& chunk = *(it - 1);
+    std::size_t i = idx - chunk.firstSnapshot;
+    std::size_t firstExpiry = i == 0 ? 0 : chunk.expiryEnds[i - 1];
+    std::size_t firstRow = i == 0 ? 0 : chunk.rowEnds[i - 1];
+    
+    SnapshotView view;
+    view.time = chunk.times[i];
+    view.spot = chunk.spots[i];
+    view.regime = static_cast<Regime>(chunk.regimes[i]);
+    view.interestRate = chunk.interestRates[i];
+    view.atmOneMonthVol = chunk.atmOneMonthVols[i];
+    view.isSsvi = chunk.surfaceKinds[i] == SSVI_SURFACE;
+    view.ssviParams = core::models::SsviParams{chunk.ssviRhos[i], chunk.ssviEtas[i], chunk.ssviGammas[i]};
+    view.numExpiries = chunk.expiryEnds[i] - firstExpiry;
+    view.expiries = chunk.expiries + firstExpiry;
+    view.atmTotalVariances = chunk.atmTotalVariances + firstExpiry;
+    view.chain.size = chunk.rowEnds[i] - firstRow;
+    view.chain.expiries = chunk.rowExpiries + firstRow;
+    for (std::size_t f = 0; f < OptionChainColumns::NUM_FIELDS; ++f) view.chain.fields[f] = chunk.rowFields[f] + firstRow;
+    view.knotEnds = chunk.knotEnds + firstExpiry;
+    view.firstKnot = firstExpiry == 0 ? 0 : chunk.knotEnds[firstExpiry - 1];
+    view.normStrikes = chunk.normStrikes;
+    view.volPoints = chunk.volPoints;
+    return view;
+}
+
+void SnapshotReader::restore(std::size_t idx, Market& market) const {
+    SnapshotView view = snapshot(idx);
+    if (market.asset.symbol != symbol) market.asset = core::models::Asset(symbol);
+    market.time = view.time;
+    market.spot = view.spot;
+    market.interestRate = view.interestRate;
+    market.regime = view.regime;
+    if (!market.volSurface) market.volSurface = std::make_shared<core::models::VolSurface>();
+    
+    auto& surface = *market.volSurface;
+    surface.expiries.assign(view.expiries, view.expiries + view.numExpiries);
+    surface.atmOneMonthVolEst = view.atmOneMonthVol;
+    surface.arbitrageReport = core::models::ArbitrageReport();
+    surface.arbitrageChecked = false;
+    if (view.isSsvi) {
+        surface.smiles.clear();
+        surface.ssvi = core::models::SsviSurface(
+            surface.expiries,
+            std::vector<double>(view.atmTotalVariances, view.atmTotalVariances + view.numExpiries),
+            view.ssviParams
+        );
+        return;
+    }
+    surface.ssvi.reset();
+    surface.smiles.resize(view.numExpiries);
+    for (std::size_t j = 0; j < view.numExpiries; ++j) {
+        SmileView smile = view.smile(j);
+        surface.smiles[j].normStrikes.assign(smile.normStrikes, smile.normStrikes + smile.size);
+        surface.smiles[j].volPoints.assign(smile.volPoints, smile.volPoints + smile.size);
+    }
+}
+
+std::shared_ptr<Market> SnapshotReader::market(std::size_t idx) const {
+    auto result = std::make_shared<Market>();
+    restore(idx, *result);
+    return result;
+}
+
+}  // namespace omm::analytics
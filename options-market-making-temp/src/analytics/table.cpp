@@ -2,9 +2,9 @@
 #include "core/utils.hpp"
 #include "core/workers/calculator.hpp"
 #include <iostream>
-#include <iomanip>
 #include <vector>
 #include <algorithm>
+#include <cmath>
 
 namespace omm::analytics {
 
@@ -13,109 +13,114 @@ std::vector<OptionChainRow> Table::getOptionChainTable(
     double expiry
 ) {
     std::vector<OptionChainRow> rows;
+    OptionChainWorkspace workspace;
+    getOptionChainTable(*market, expiry, workspace, rows);
+    return rows;
+}
+
+void Table::getOptionChainTable(
+    const omm::core::models::Market& market,
+    double expiry,
+    OptionChainWorkspace& workspace,
+    std::vector<OptionChainRow>& rows
+) {
+    rows.clear();
     
-    double forward = omm::core::Utils::getForwardPrice(market->spot, market->interestRate, expiry);
-    std::vector<double> normStrikes = omm::core::Utils::getNormStrikes(
-        market->spot,
-        market->interestRate,
+    double forward = omm::core::Utils::getForwardPrice(market.spot, market.interestRate, expiry);
+    std::vector<double>& normStrikes = workspace.normStrikes;
+    omm::core::Utils::getNormStrikes(
+        market.spot,
+        market.interestRate,
         expiry,
-        market->volSurface->getAtmVol(expiry)
+        market.volSurface->getAtmVol(expiry),
+        normStrikes
     );
     
-    using namespace omm::core::models;
     using namespace omm::core::workers;
     
-    for (double ns : normStrikes) {
-        double strike = market->volSurface->getStrike(ns, forward, expiry);
-        
-        auto optionCall = std::make_shared<Option>(
-            market->asset,
-            strike,
-            expiry,
-            OptionType::CALL,
-            1
-        );
-        
-        auto optionPut = std::make_shared<Option>(
-            market->asset,
-            strike,
-            expiry,
-            OptionType::PUT,
-            1
-        );
-        
-        double callPrice = Calculator::priceOption(*optionCall, *market);
-        Risk callRisk = Calculator::calculateRisk(*optionCall, *market);
-        double putPrice = Calculator::priceOption(*optionPut, *market);
-        Risk putRisk = Calculator::calculateRisk(*optionPut, *market);
-        
-        double forwardStrike = strike * std::exp(market->interestRate * expiry / 365.0);
-        double impliedVol = market->volSurface->getVolNormStrike(ns, expiry);
+    size_t numStrikes = normStrikes.size();
+    std::vector<double>& strikes = workspace.strikes;
+    std::vector<double>& expiries = workspace.expiries;
+    strikes.resize(numStrikes);
+    expiries.assign(numStrikes, expiry);
+    for (size_t i = 0; i < numStrikes; ++i) {
+        strikes[i] = market.volSurface->getStrike(normStrikes[i], forward, expiry);
+    }
+    
+    // One batch pass prices the calls and puts of every strike
+    workspace.results.resize(10 * numStrikes);
+    double* out = workspace.results.data();
+    OptionBatchResult calls{out, out + numStrikes, out + 2 * numStrikes, out + 3 * numStrikes, out + 4 * numStrikes};
+    out += 5 * numStrikes;
+    OptionBatchResult puts{out, out + numStrikes, out + 2 * numStrikes, out + 3 * numStrikes, out + 4 * numStrikes};
+    Calculator::priceOptionChain(OptionChainBatch{strikes.data(), expiries.data(), numStrikes}, market, calls, puts);
+    
+    rows.reserve(numStrikes);
+    for (size_t i = 0; i < numStrikes; ++i) {
+        double ns = normStrikes[i];
+        double strike = strikes[i];
+        double forwardStrike = strike * std::exp(market.interestRate * expiry / 365.0);
+        double impliedVol = market.volSurface->getVolNormStrike(ns, expiry);
         
         OptionChainRow row{
-            callRisk.theta / 365.0,           // callTheta per day
-            callRisk.vega / 100.0,            // callVega per 1% vol move
-            callRisk.gamma,                   // callGamma
-            callRisk.delta,                   // callDelta
-            callPrice,                        // callPrice
+            calls.thetas[i] / 365.0,          // callTheta per day
+            calls.vegas[i] / 100.0,           // callVega per 1% vol move
+            calls.gammas[i],                  // callGamma
+            calls.deltas[i],                  // callDelta
+            calls.prices[i],                  // callPrice
             ns,                               // normStrike
             strike,                           // strike
             forwardStrike,                    // forwardStrike
             impliedVol,                       // impliedVol
-            putPrice,                         // putPrice
-            putRisk.delta,                    // putDelta
-            putRisk.gamma,                    // putGamma
-            putRisk.vega / 100.0,             // putVega per 1% vol move
-            putRisk.theta / 365.0             // putTheta per day
+            puts.prices[i],                   // putPrice
+            puts.deltas[i],                   // putDelta
+            puts.gammas[i],                   // putGamma
+            puts.vegas[i] / 100.0,            // putVega per 1% vol move
+            puts.thetas[i] / 365.0            // putTheta per day
         };
         
         rows.push_back(row);
     }
-    
-    return rows;
 }
 
 void Table::printOptionChainTable(const std::vector<OptionChainRow>& chain) {
+    // Anything already in std::cout goes out first
+    std::cout.flush();
+    OutputBuffer out(1 << 16);
+    out.attach(stdout);
+    writeOptionChainTable(out, chain);
+    out.close();
+}
+
+void Table::writeOptionChainTable(OutputBuffer& out, const std::vector<OptionChainRow>& chain) {
     if (chain.empty()) {
-        std::cout << "Empty option chain table\n";
+        out.put("Empty option chain table\n");
         return;
     }
     
-    std::cout << std::fixed << std::setprecision(4);
-    std::cout << std::string(200, '=') << "\n";
-    std::cout << std::setw(12) << "Call Theta"
-              << std::setw(12) << "Call Vega"
-              << std::setw(12) << "Call Gamma"
-              << std::setw(12) << "Call Delta"
-              << std::setw(12) << "Call Price"
-              << std::setw(12) << "Norm Strike"
-              << std::setw(12) << "Strike"
-              << std::setw(12) << "Fwd Strike"
-              << std::setw(12) << "Impl Vol"
-              << std::setw(12) << "Put Price"
-              << std::setw(12) << "Put Delta"
-              << std::setw(12) << "Put Gamma"
-              << std::setw(12) << "Put Vega"
-              << std::setw(12) << "Put Theta\n";
-    std::cout << std::string(200, '-') << "\n";
+    constexpr int WIDTH = 12;
+    constexpr int PRECISION = 4;
+    static const char* const HEADERS[] = {
+        "Call Theta", "Call Vega", "Call Gamma", "Call Delta", "Call Price", "Norm Strike", "Strike",
+        "Fwd Strike", "Impl Vol", "Put Price", "Put Delta", "Put Gamma", "Put Vega", "Put Theta\n"
+    };
+    
+    out.put('=', 200);
+    out.put('\n');
+    for (const char* header : HEADERS) out.putPadded(header, WIDTH);
+    out.put('-', 200);
+    out.put('\n');
     
     for (const auto& row : chain) {
-        std::cout << std::setw(12) << row.callTheta
-                  << std::setw(12) << row.callVega
-                  << std::setw(12) << row.callGamma
-                  << std::setw(12) << row.callDelta
-                  << std::setw(12) << row.callPrice
-                  << std::setw(12) << row.normStrike
-                  << std::setw(12) << row.strike
-                  << std::setw(12) << row.forwardStrike
-                  << std::setw(12) << row.impliedVol
-                  << std::setw(12) << row.putPrice
-                  << std::setw(12) << row.putDelta
-                  << std::setw(12) << row.putGamma
-                  << std::setw(12) << row.putVega
-                  << std::setw(12) << row.putTheta << "\n";
+        for (double value : {row.callTheta, row.callVega, row.callGamma, row.callDelta, row.callPrice,
+                             row.normStrike, row.strike, row.forwardStrike, row.impliedVol, row.putPrice,
+                             row.putDelta, row.putGamma, row.putVega, row.putTheta}) {
+            out.putPadded(value, WIDTH, PRECISION);
+        }
+        out.put('\n');
     }
-    std::cout << std::string(200, '=') << "\n";
+    out.put('=', 200);
+    out.put('\n');
 }
 
 }  // namespace omm::analytics
@@ -0,0 +1,157 @@
+#include "core/models/arbitrage.hpp"
+#include "core/models/volsurface.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace omm::core::models {
+
+std::atomic<ArbitrageCheckMode> ArbitrageChecker::currentMode{ArbitrageCheckMode::FULL};
+std::atomic<std::size_t> ArbitrageChecker::sampleInterval{100};
+std::atomic<std::size_t> ArbitrageChecker::constructed{0};
+
+namespace {
+
+// Norm strike rounded to 2 decimals, kept in hundredths so that equal strikes compare
+// exactly. Same as std::round(ns * 100) without the libm call: trunc is one instruction
+// and y - trunc(y) is exact, so ties still round away from zero.
+inline double roundedHundredths(double ns) {
+    double y = ns * 100.0;
+    double t = std::trunc(y);
+    return t + ((std::abs(y - t) >= 0.5) ? std::copysign(1.0, y) : 0.0);
+}
+
+// Smile::getVol at increasing norm strikes: the bracket is found by moving a cursor
+// forward instead of a binary search
+class SmileCursor {
+public:
+    explicit SmileCursor(const Smile& smile_) : smile(smile_) {}
+    
+    double getVol(double normStrike) {
+        const auto& ns = smile.normStrikes;
+        const auto& vols = smile.volPoints;
+        if (normStrike > ns.back()) {
+            return vols.back();
+        }
+        if (normStrike <= ns.front()) {
+            return vols.front();
+        }
+        // First knot at or above normStrike, as std::lower_bound
+        while (ns[idx] < normStrike) {
+            ++idx;
+        }
+        double nsUp = ns[idx];
+        double nsDown = ns[idx - 1];
+        double weight = (nsUp != nsDown) ? (normStrike - nsDown) / (nsUp - nsDown) : 0.0;
+        return vols[idx - 1] + weight * (vols[idx] - vols[idx - 1]);
+    }
+
+private:
+    const Smile& smile;
+    std::size_t idx = 1;
+};
+
+}  // namespace
+
+ArbitrageReport ArbitrageChecker::check(const VolSurface& surface) {
+    ArbitrageReport report;
+    checkCalendar(surface, report);
+    checkButterfly(surface, report);
+    return report;
+}
+
+void ArbitrageChecker::checkCalendar(const VolSurface& surface, ArbitrageReport& report) {
+    std::size_t numPairs = std::min(surface.expiries.size(), surface.smiles.size());
+    for (std::size_t i = 0; i + 1 < numPairs; ++i) {
+        double expiryEarlier = surface.expiries[i];
+        double expiryLater = surface.expiries[i + 1];
+        const Smile& smileEarlier = surface.smiles[i];
+        const Smile& smileLater = surface.smiles[i + 1];
+        if (smileEarlier.normStrikes.empty() || smileLater.normStrikes.empty()) {
+            continue;
+        }
+        
+        // Both smiles are sorted, so their rounded strikes merge in one pass
+        const auto& later = smileLater.normStrikes;
+        std::size_t j = 0;
+        SmileCursor laterVols(smileLater);
+        for (std::size_t k = 0; k < smileEarlier.normStrikes.size(); ++k) {
+            double ns = smileEarlier.normStrikes[k];
+            double nsRounded = roundedHundredths(ns);
+            while (j < later.size() && roundedHundredths(later[j]) < nsRounded) {
+                ++j;
+            }
+            if (j == later.size()) {
+                break;
+            }
+            if (roundedHundredths(later[j]) != nsRounded) {
+                continue;
+            }
+            
+            double volEarlier = smileEarlier.volPoints[k];
+            double volLater = laterVols.getVol(ns);
+            double varEarlier = volEarlier * volEarlier * expiryEarlier / 365.0;
+            double varLater = volLater * volLater * expiryLater / 365.0;
+            if (varLater < varEarlier - TOLERANCE) {
+                report.violations.push_back(ArbitrageViolation{
+                    ArbitrageType::CALENDAR, i, expiryEarlier, expiryLater, ns, varEarlier - varLater});
+                ++report.calendarCount;
+            }
+        }
+    }
+}
+
+void ArbitrageChecker::checkButterfly(const VolSurface& surface, ArbitrageReport& report) {
+    std::size_t numSmiles = std::min(surface.expiries.size(), surface.smiles.size());
+    for (std::size_t idx = 0; idx < numSmiles; ++idx) {
+        const Smile& smile = surface.smiles[idx];
+        const double* vols = smile.volPoints.data();
+        std::size_t n = std::min(smile.volPoints.size(), smile.normStrikes.size());
+        if (n < 3) continue;
+        double T = surface.expiries[idx] / 365.0;
+        
+        // Second difference of total variance; branch-free so the loop vectorizes
+        std::size_t concave = 0;
+        for (std::size_t i = 1; i + 1 < n; ++i) {
+            double varDown = vols[i - 1] * vols[i - 1] * T;
+            double varMid = vols[i] * vols[i] * T;
+            double varUp = vols[i + 1] * vols[i + 1] * T;
+            concave += (varUp - 2.0 * varMid + varDown) < -TOLERANCE;
+        }
+        if (concave == 0) continue;
+        
+        for (std::size_t i = 1; i + 1 < n; ++i) {
+            double varDown = vols[i - 1] * vols[i - 1] * T;
+            double varMid = vols[i] * vols[i] * T;
+            double varUp = vols[i + 1] * vols[i + 1] * T;
+            double varDiff = varUp - 2.0 * varMid + varDown;
+            if (varDiff < -TOLERANCE) {
+                report.violations.push_back(ArbitrageViolation{
+                    ArbitrageType::BUTTERFLY, idx, surface.expiries[idx], surface.expiries[idx],
+                    smile.normStrikes[i], -varDiff});
+                ++report.butterflyCount;
+            }
+        }
+    }
+}
+
+void ArbitrageChecker::setMode(ArbitrageCheckMode mode, std::size_t sampleInterval_) {
+    sampleInterval.store(std::max<std::size_t>(1, sampleInterval_));
+    currentMode.store(mode);
+}
+
+ArbitrageCheckMode ArbitrageChecker::mode() {
+    return currentMode.load();
+}
+
+bool ArbitrageChecker::shouldCheckOnConstruction() {
+    switch (currentMode.load()) {
+        case ArbitrageCheckMode::FULL:
+            return true;
+        case ArbitrageCheckMode::SAMPLED:
+            return constructed.fetch_add(1) % sampleInterval.load() == 0;
+        default:
+            return false;
+    }
+}
+
+}  // namespace omm::core::models
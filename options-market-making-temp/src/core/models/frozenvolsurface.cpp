@@ -0,0 +1,233 @@
+#include "core/models/frozenvolsurface.hpp"
+#include "core/models/volsurface.hpp"
+#include "core/utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace omm::core::models {
+
+namespace {
+
+// Bucket tables are capped so that clustered knots cannot blow up memory; lookups then
+// step over the few extra knots a bucket may hold
+constexpr std::size_t MAX_BUCKETS_PER_VALUE = 8;
+
+}  // namespace
+
+FrozenVolSurface::FrozenVolSurface(const VolSurface& surface) : expiries(surface.expiries) {
+    if (surface.ssvi) {
+        ssvi = surface.ssvi;
+        return;
+    }
+    
+    std::size_t numSmiles = std::min(surface.expiries.size(), surface.smiles.size());
+    expiries.resize(numSmiles);
+    
+    invExpirySpans.resize(numSmiles > 0 ? numSmiles - 1 : 0);
+    for (std::size_t i = 0; i + 1 < numSmiles; ++i) {
+        double span = expiries[i + 1] - expiries[i];
+        invExpirySpans[i] = span != 0.0 ? 1.0 / span : 0.0;
+    }
+    expiryIndex = buildIndex(expiries.data(), numSmiles, buckets);
+    
+    std::size_t totalKnots = 0;
+    for (std::size_t i = 0; i < numSmiles; ++i) {
+        totalKnots += surface.smiles[i].normStrikes.size();
+    }
+    knotNormStrikes.reserve(totalKnots);
+    knotVols.reserve(totalKnots);
+    knotSlopes.reserve(totalKnots);
+    smiles.reserve(numSmiles);
+    atmVols.reserve(numSmiles);
+    
+    for (std::size_t i = 0; i < numSmiles; ++i) {
+        const Smile& smile = surface.smiles[i];
+        std::size_t offset = knotNormStrikes.size();
+        std::size_t count = smile.normStrikes.size();
+        
+        knotNormStrikes.insert(knotNormStrikes.end(), smile.normStrikes.begin(), smile.normStrikes.end());
+        knotVols.insert(knotVols.end(), smile.volPoints.begin(), smile.volPoints.end());
+        for (std::size_t j = 0; j < count; ++j) {
+            double slope = 0.0;
+            if (j + 1 < count && smile.normStrikes[j + 1] != smile.normStrikes[j]) {
+                slope = (smile.volPoints[j + 1] - smile.volPoints[j]) /
+                        (smile.normStrikes[j + 1] - smile.normStrikes[j]);
+            }
+            knotSlopes.push_back(slope);
+        }
+        
+        SmileRange& range = smiles.emplace_back();
+        range.knotOffset = static_cast<std::uint32_t>(offset);
+        range.numKnots = static_cast<std::uint32_t>(count);
+        range.index = buildIndex(knotNormStrikes.data() + offset, count, buckets);
+        
+        atmVols.push_back(count > 0 ? smileVol(i, 0.0) : 0.0);
+    }
+}
+
+FrozenVolSurface::UniformIndex FrozenVolSurface::buildIndex(
+    const double* values,
+    std::size_t count,
+    std::vector<std::uint32_t>& buckets
+) {
+    UniformIndex index;
+    index.bucketOffset = static_cast<std::uint32_t>(buckets.size());
+    if (count < 2) {
+        return index;
+    }
+    
+    double range = values[count - 1] - values[0];
+    double minGap = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i + 1 < count; ++i) {
+        double gap = values[i + 1] - values[i];
+        if (gap > 0.0) minGap = std::min(minGap, gap);
+    }
+    if (!(range > 0.0) || !std::isfinite(minGap)) {
+        return index;
+    }
+    
+    // Buckets no wider than the smallest gap hold at most one knot each
+    double maxBuckets = static_cast<double>(MAX_BUCKETS_PER_VALUE * count);
+    double numBuckets = std::min(std::floor(range / minGap) + 1.0, maxBuckets);
+    double width = range / numBuckets;
+    
+    index.origin = values[0];
+    index.invWidth = 1.0 / width;
+    index.numBuckets = static_cast<std::uint32_t>(numBuckets);
+    
+    // Each bucket stores the last interval starting at or before its left edge
+    std::size_t interval = 0;
+    for (std::uint32_t b = 0; b < index.numBuckets; ++b) {
+        double edge = values[0] + b * width;
+        while (interval + 2 < count && values[interval + 1] <= edge) {
+            ++interval;
+        }
+        buckets.push_back(static_cast<std::uint32_t>(interval));
+    }
+    return index;
+}
+
+std::size_t FrozenVolSurface::findInterval(
+    const UniformIndex& index,
+    const double* values,
+    std::size_t count,
+    double x
+) const {
+    // Callers clamp x into (values[0], values[count - 1]) first, NaN included, so the
+    // cast below is defined
+    double position = (x - index.origin) * index.invWidth;
+    std::size_t bucket = std::min(static_cast<std::size_t>(position), static_cast<std::size_t>(index.numBuckets - 1));
+    std::size_t interval = buckets[index.bucketOffset + bucket];
+    
+    while (interval + 2 < count && x >= values[interval + 1]) {
+        ++interval;
+    }
+    while (interval > 0 && x < values[interval]) {
+        --interval;
+    }
+    return interval;
+}
+
+double FrozenVolSurface::smileVol(std::size_t smileIdx, double normStrike) const {
+    const SmileRange& range = smiles[smileIdx];
+    const double* ns = knotNormStrikes.data() + range.knotOffset;
+    const double* vols = knotVols.data() + range.knotOffset;
+    std::size_t count = range.numKnots;
+    
+    if (count == 0) {
+        return VolSurface::DEFAULT_VOL;
+    }
+    if (normStrike >= ns[count - 1]) {
+        return vols[count - 1];
+    }
+    // Written so NaN takes the flat extrapolation too, never the cast in findInterval
+    if (!(normStrike > ns[0])) {
+        return vols[0];
+    }
+    
+    std::size_t i = findInterval(range.index, ns, count, normStrike);
+    return vols[i] + (normStrike - ns[i]) * knotSlopes[range.knotOffset + i];
+}
+
+FrozenVolSurface::ExpiryBracket FrozenVolSurface::locateExpiry(double expiry) const {
+    std::size_t count = expiries.size();
+    if (expiry >= expiries[count - 1]) {
+        return ExpiryBracket{count - 1, 0.0};
+    }
+    if (!(expiry > expiries[0])) {  // and NaN
+        return ExpiryBracket{0, 0.0};
+    }
+    
+    std::size_t i = findInterval(expiryIndex, expiries.data(), count, expiry);
+    return ExpiryBracket{i, (expiry - expiries[i]) * invExpirySpans[i]};
+}
+
+double FrozenVolSurface::atmVol(const ExpiryBracket& bracket) const {
+    double volDown = atmVols[bracket.idx];
+    if (bracket.weight == 0.0) {
+        return volDown;
+    }
+    return volDown + bracket.weight * (atmVols[bracket.idx + 1] - volDown);
+}
+
+double FrozenVolSurface::volNormStrike(const ExpiryBracket& bracket, double normStrike) const {
+    double volDown = smileVol(bracket.idx, normStrike);
+    if (bracket.weight == 0.0) {
+        return volDown;
+    }
+    return volDown + bracket.weight * (smileVol(bracket.idx + 1, normStrike) - volDown);
+}
+
+double FrozenVolSurface::getNormStrike(double strike, double forward, double expiry) const {
+    return Utils::getNormStrike(strike, forward, expiry, getAtmVol(expiry));
+}
+
+double FrozenVolSurface::getVolNormStrike(double normStrike, double expiry) const {
+    if (ssvi) {
+        return ssvi->getVolNormStrike(normStrike, expiry);
+    }
+    if (expiries.empty()) {
+        return VolSurface::DEFAULT_VOL;
+    }
+    return volNormStrike(locateExpiry(expiry), normStrike);
+}
+
+void FrozenVolSurface::getVolsNormStrike(const double* normStrikes, double expiry, double* vols, std::size_t n) const {
+    if (ssvi) {
+        for (std::size_t i = 0; i < n; ++i) vols[i] = ssvi->getVolNormStrike(normStrikes[i], expiry);
+        return;
+    }
+    if (expiries.empty()) {
+        std::fill(vols, vols + n, VolSurface::DEFAULT_VOL);
+        return;
+    }
+    ExpiryBracket bracket = locateExpiry(expiry);
+    for (std::size_t i = 0; i < n; ++i) {
+        vols[i] = volNormStrike(bracket, normStrikes[i]);
+    }
+}
+
+double FrozenVolSurface::getVol(double strike, double forward, double expiry) const {
+    if (ssvi) {
+        return ssvi->getVol(std::log(strike / forward), expiry);
+    }
+    if (expiries.empty()) {
+        return VolSurface::DEFAULT_VOL;
+    }
+    ExpiryBracket bracket = locateExpiry(expiry);
+    double normStrike = Utils::getNormStrike(strike, forward, expiry, atmVol(bracket));
+    return volNormStrike(bracket, normStrike);
+}
+
+double FrozenVolSurface::getAtmVol(double expiry) const {
+    if (ssvi) {
+        return ssvi->getAtmVol(expiry);
+    }
+    if (expiries.empty()) {
+        return VolSurface::DEFAULT_VOL;
+    }
+    return atmVol(locateExpiry(expiry));
+}
+
+}  // namespace omm::core::models
@@ -0,0 +1,50 @@
+#include "core/models/portfolio.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace omm::core::models {
+
+void Portfolio::addOption(const Option& option, int quantity) {
+    auto it = std::lower_bound(optionBuckets.begin(), optionBuckets.end(), option.expiry,
+                               [](const OptionBucket& bucket, double expiry) { return bucket.expiry < expiry; });
+    if (it == optionBuckets.end() || it->expiry != option.expiry) {
+        it = optionBuckets.insert(it, OptionBucket());
+        it->expiry = option.expiry;
+    }
+    
+    it->strikes.push_back(option.strike);
+    it->expiries.push_back(option.expiry);
+    it->optionTypes.push_back(option.optionType);
+    it->weights.push_back(static_cast<double>(quantity) * option.lotSize);
+    it->logStrikes.push_back(std::log(option.strike));
+}
+
+void Portfolio::addFuture(const Future& future, int quantity) {
+    futureWeights.push_back(static_cast<double>(quantity) * future.lotSize);
+}
+
+void Portfolio::addPosition(const Position& position) {
+    if (!position.security) return;
+    
+    if (auto* option = dynamic_cast<const Option*>(position.security.get())) {
+        addOption(*option, position.quantity);
+    } else if (auto* future = dynamic_cast<const Future*>(position.security.get())) {
+        addFuture(*future, position.quantity);
+    }
+}
+
+std::size_t Portfolio::numOptions() const {
+    std::size_t count = 0;
+    for (const auto& bucket : optionBuckets) count += bucket.size();
+    return count;
+}
+
+Portfolio Portfolio::fromPositions(const std::vector<Position>& positions) {
+    Portfolio portfolio;
+    for (const auto& position : positions) {
+        portfolio.addPosition(position);
+    }
+    return portfolio;
+}
+
+}  // namespace omm::core::models
@@ -0,0 +1,3 @@
+#include "core/models/posarchive.hpp"
+
+// Empty implementation file (struct is header-only)
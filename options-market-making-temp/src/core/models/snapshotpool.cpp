@@ -0,0 +1,117 @@
+#include "core/models/snapshotpool.hpp"
+#include <algorithm>
+#include <cstddef>
+
+namespace omm::core::models {
+
+struct SnapshotPool::Slot {
+    static constexpr std::size_t BLOCK_SIZE = 64;  // one shared_ptr control block
+    
+    Market market;
+    VolSurface surface;
+    alignas(std::max_align_t) unsigned char marketBlock[BLOCK_SIZE];
+    alignas(std::max_align_t) unsigned char surfaceBlock[BLOCK_SIZE];
+    int handles = 0;  // control blocks not yet given back
+};
+
+// Places a control block in its slot buffer and gives the slot back when the block is
+// deallocated, which shared_ptr does after the deleter ran and the last weak_ptr is gone
+template <typename T>
+class SnapshotPool::SlotAllocator {
+public:
+    using value_type = T;
+    
+    SlotAllocator(SnapshotPool* pool_, Slot* slot_, unsigned char* block_)
+        : pool(pool_), slot(slot_), block(block_) {}
+    
+    template <typename U>
+    SlotAllocator(const SlotAllocator<U>& other) : pool(other.pool), slot(other.slot), block(other.block) {}
+    
+    T* allocate(std::size_t) {
+        static_assert(sizeof(T) <= Slot::BLOCK_SIZE, "control block does not fit the slot buffer");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "control block over-aligned");
+        return reinterpret_cast<T*>(block);
+    }
+    
+    void deallocate(T*, std::size_t) {
+        pool->releaseSlot(slot);
+    }
+    
+    template <typename U>
+    bool operator==(const SlotAllocator<U>& other) const { return block == other.block; }
+    template <typename U>
+    bool operator!=(const SlotAllocator<U>& other) const { return block != other.block; }
+    
+    SnapshotPool* pool;
+    Slot* slot;
+    unsigned char* block;
+};
+
+// The market's own handle on the surface would keep the slot alive otherwise
+struct SnapshotPool::MarketDeleter {
+    void operator()(Market* market) const {
+        market->volSurface.reset();
+    }
+};
+
+namespace {
+
+struct SurfaceDeleter {
+    void operator()(VolSurface*) const {}
+};
+
+}  // namespace
+
+SnapshotPool::SnapshotPool(std::size_t initialSlots) {
+    slots.reserve(initialSlots);
+    freeSlots.reserve(initialSlots);
+    for (std::size_t i = 0; i < initialSlots; ++i) {
+        slots.push_back(std::make_unique<Slot>());
+        freeSlots.push_back(slots.back().get());
+    }
+    counters.slots = initialSlots;
+}
+
+SnapshotPool::~SnapshotPool() = default;
+
+std::shared_ptr<Market> SnapshotPool::acquire() {
+    Slot* slot = popSlot();
+    
+    slot->market.volSurface = std::shared_ptr<VolSurface>(
+        &slot->surface, SurfaceDeleter{}, SlotAllocator<VolSurface>(this, slot, slot->surfaceBlock));
+    return std::shared_ptr<Market>(
+        &slot->market, MarketDeleter{}, SlotAllocator<Market>(this, slot, slot->marketBlock));
+}
+
+SnapshotPool::Stats SnapshotPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+SnapshotPool::Slot* SnapshotPool::popSlot() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (freeSlots.empty()) {
+        slots.push_back(std::make_unique<Slot>());
+        freeSlots.reserve(slots.size());
+        freeSlots.push_back(slots.back().get());
+        ++counters.slots;
+    }
+    Slot* slot = freeSlots.back();
+    freeSlots.pop_back();
+    slot->handles = 2;
+    
+    ++counters.acquired;
+    ++counters.inUse;
+    counters.peakInUse = std::max(counters.peakInUse, counters.inUse);
+    return slot;
+}
+
+void SnapshotPool::releaseSlot(Slot* slot) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--slot->handles == 0) {
+        freeSlots.push_back(slot);
+        --counters.inUse;
+    }
+}
+
+}  // namespace omm::core::models
@@ -0,0 +1,126 @@
+#include "core/models/ssvi.hpp"
+#include "core/models/volsurface.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace omm::core::models {
+
+namespace {
+
+constexpr double MIN_THETA = 1e-12;
+// Days; keeps theta / T finite for expiries of 0 days
+constexpr double MIN_EXPIRY = 1e-6;
+constexpr double DEFAULT_VOL = VolSurface::DEFAULT_VOL;
+
+}  // namespace
+
+SsviSurface::SsviSurface(
+    const std::vector<double>& expiries_,
+    const std::vector<double>& atmTotalVariances_,
+    const SsviParams& params_
+) : knotExpiries(expiries_), shape(params_) {
+    shape.rho = std::clamp(shape.rho, -MAX_ABS_RHO, MAX_ABS_RHO);
+    shape.gamma = std::clamp(shape.gamma, 0.0, 0.5);
+    shape.eta = std::clamp(shape.eta, 0.0, 2.0 / (1.0 + std::abs(shape.rho)));
+    
+    std::size_t count = std::min(expiries_.size(), atmTotalVariances_.size());
+    knotExpiries.resize(count);
+    for (double& expiry : knotExpiries) expiry = std::max(MIN_EXPIRY, expiry);
+    thetas.reserve(count);
+    phis.reserve(count);
+    double floor = MIN_THETA;
+    for (std::size_t i = 0; i < count; ++i) {
+        floor = std::max(floor, atmTotalVariances_[i]);
+        thetas.push_back(floor);
+        phis.push_back(phi(floor));
+    }
+}
+
+double SsviSurface::phi(double theta) const {
+    if (shape.gamma == 0.5) {
+        return shape.eta / std::sqrt(theta * (1.0 + theta));
+    }
+    return shape.eta / (std::pow(theta, shape.gamma) * std::pow(1.0 + theta, 1.0 - shape.gamma));
+}
+
+SsviSurface::Slice SsviSurface::slice(double expiry) const {
+    expiry = std::max(MIN_EXPIRY, expiry);
+    double tte = expiry / 365.0;
+    if (expiry <= knotExpiries.front()) {
+        if (expiry == knotExpiries.front()) return Slice{thetas.front(), phis.front(), tte};
+        double theta = std::max(thetas.front() * expiry / knotExpiries.front(), MIN_THETA);
+        return Slice{theta, phi(theta), tte};
+    }
+    if (expiry >= knotExpiries.back()) {
+        if (expiry == knotExpiries.back()) return Slice{thetas.back(), phis.back(), tte};
+        double theta = thetas.back() * expiry / knotExpiries.back();
+        return Slice{theta, phi(theta), tte};
+    }
+    
+    // First knot after expiry: knotExpiries[idx - 1] <= expiry < knotExpiries[idx]
+    auto it = std::upper_bound(knotExpiries.begin(), knotExpiries.end(), expiry);
+    std::size_t idx = static_cast<std::size_t>(it - knotExpiries.begin());
+    double expiryDown = knotExpiries[idx - 1];
+    if (expiry == expiryDown) return Slice{thetas[idx - 1], phis[idx - 1], tte};
+    double weight = (expiry - expiryDown) / (knotExpiries[idx] - expiryDown);
+    double theta = thetas[idx - 1] + weight * (thetas[idx] - thetas[idx - 1]);
+    return Slice{theta, phi(theta), tte};
+}
+
+double SsviSurface::totalVariance(const Slice& s, double logMoneyness) const {
+    double pk = s.phi * logMoneyness;
+    double root = std::sqrt((pk + shape.rho) * (pk + shape.rho) + 1.0 - shape.rho * shape.rho);
+    return 0.5 * s.theta * (1.0 + shape.rho * pk + root);
+}
+
+double SsviSurface::atmTotalVariance(double expiry) const {
+    if (knotExpiries.empty()) return DEFAULT_VOL * DEFAULT_VOL * expiry / 365.0;
+    return slice(expiry).theta;
+}
+
+double SsviSurface::totalVariance(double logMoneyness, double expiry) const {
+    if (knotExpiries.empty()) return DEFAULT_VOL * DEFAULT_VOL * expiry / 365.0;
+    return totalVariance(slice(expiry), logMoneyness);
+}
+
+double SsviSurface::getVol(double logMoneyness, double expiry) const {
+    if (knotExpiries.empty()) return DEFAULT_VOL;
+    Slice s = slice(expiry);
+    return std::sqrt(totalVariance(s, logMoneyness) / s.tte);
+}
+
+double SsviSurface::getAtmVol(double expiry) const {
+    if (knotExpiries.empty()) return DEFAULT_VOL;
+    Slice s = slice(expiry);
+    return std::sqrt(s.theta / s.tte);
+}
+
+double SsviSurface::getVolNormStrike(double normStrike, double expiry) const {
+    if (knotExpiries.empty()) return DEFAULT_VOL;
+    Slice s = slice(expiry);
+    return std::sqrt(totalVariance(s, normStrike * std::sqrt(s.theta)) / s.tte);
+}
+
+SmileDerivatives SsviSurface::getVolDerivatives(double logMoneyness, double expiry) const {
+    if (knotExpiries.empty()) return SmileDerivatives{DEFAULT_VOL, 0.0, 0.0};
+    Slice s = slice(expiry);
+    double rho = shape.rho;
+    double pk = s.phi * logMoneyness;
+    double root = std::sqrt((pk + rho) * (pk + rho) + 1.0 - rho * rho);
+    
+    // w, w' and w'' in k; then vol^2 T = w gives vol' = w' / (2 vol T) and
+    // vol'' = (w'' / (2T) - vol'^2) / vol
+    double w = 0.5 * s.theta * (1.0 + rho * pk + root);
+    double dw = 0.5 * s.theta * s.phi * (rho + (pk + rho) / root);
+    double d2w = 0.5 * s.theta * s.phi * s.phi * (1.0 - rho * rho) / (root * root * root);
+    double vol = std::sqrt(w / s.tte);
+    double dVol = dw / (2.0 * vol * s.tte);
+    double d2Vol = (d2w / (2.0 * s.tte) - dVol * dVol) / vol;
+    return SmileDerivatives{vol, dVol, d2Vol};
+}
+
+std::size_t SsviSurface::memoryBytes() const {
+    return sizeof(*this) + (knotExpiries.capacity() + thetas.capacity() + phis.capacity()) * sizeof(double);
+}
+
+}  // namespace omm::core::models
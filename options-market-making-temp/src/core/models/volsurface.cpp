@@ -7,6 +7,22 @@
 
 namespace omm::core::models {
 
+namespace {
+
+constexpr int GRID_STEP_DIST = VolSurface::GRID_STEP_DIST;
+constexpr double GRID_STRIKE_STEP = VolSurface::GRID_STRIKE_STEP;
+constexpr size_t GRID_SIZE = VolSurface::GRID_SIZE;
+
+// log(K / F) = log(K / S) - r T: the first term is shared by every expiry
+void fillGridLogMoneyness(double spot, double* logMoneyness) {
+    for (int z = -GRID_STEP_DIST; z <= GRID_STEP_DIST; ++z) {
+        double strike = spot + z * GRID_STRIKE_STEP;
+        logMoneyness[z + GRID_STEP_DIST] = std::log(strike / spot);
+    }
+}
+
+}  // namespace
+
 double Smile::getVol(double normStrike) const {
     if (normStrike > normStrikes.back()) {
         return volPoints.back();
@@ -62,11 +78,85 @@ VolSurface::VolSurface(
     }
     
     // Verify no arbitrage (warnings only, don't fail)
-    if (hasButterflyArbitrage()) {
-        std::cerr << "Warning: Butterfly arbitrage detected in vol surface\n";
+    if (ArbitrageChecker::shouldCheckOnConstruction()) {
+        recordArbitrage();
     }
-    if (hasCalendarArbitrage()) {
-        std::cerr << "Warning: Calendar arbitrage detected in vol surface\n";
+}
+
+VolSurface::VolSurface(const SsviSurface& model)
+    : expiries(model.expiries()), atmOneMonthVolEst(model.getAtmVol(30.0)), ssvi(model) {
+    arbitrageChecked = true;
+}
+
+void VolSurface::rebuild(
+    const std::vector<double>& expiries_,
+    double atmOneMonthVolEst_,
+    double skew,
+    double convexity,
+    double volMean,
+    double spot,
+    double interestRate
+) {
+    atmOneMonthVolEst = atmOneMonthVolEst_;
+    resetForRebuild(expiries_);
+    
+    double logMoneyness[GRID_SIZE];
+    fillGridLogMoneyness(spot, logMoneyness);
+    
+    for (size_t idx = 0; idx < expiries.size(); ++idx) {
+        double expiry = expiries[idx];
+        
+        // Same ATM term structure as the constructor
+        double weight = std::exp(-std::abs(expiry - 30.0) / 365.0);
+        double atmVol = std::sqrt(
+            volMean * volMean +
+            weight * (atmOneMonthVolEst_ * atmOneMonthVolEst_ - volMean * volMean)
+        );
+        fillSmile(idx, logMoneyness, interestRate * (expiry / 365.0), SmileParams{atmVol, skew, convexity});
+    }
+}
+
+void VolSurface::rebuild(
+    const std::vector<double>& expiries_,
+    const SmileParams* params,
+    double spot,
+    double interestRate
+) {
+    resetForRebuild(expiries_);
+    
+    double logMoneyness[GRID_SIZE];
+    fillGridLogMoneyness(spot, logMoneyness);
+    
+    for (size_t idx = 0; idx < expiries.size(); ++idx) {
+        fillSmile(idx, logMoneyness, interestRate * (expiries[idx] / 365.0), params[idx]);
+    }
+    atmOneMonthVolEst = getAtmVol(30.0);
+}
+
+void VolSurface::resetForRebuild(const std::vector<double>& expiries_) {
+    ssvi.reset();
+    arbitrageReport.violations.clear();
+    arbitrageReport.calendarCount = 0;
+    arbitrageReport.butterflyCount = 0;
+    arbitrageChecked = false;
+    if (&expiries_ != &expiries) {
+        expiries.assign(expiries_.begin(), expiries_.end());
+    }
+    smiles.resize(expiries.size());
+}
+
+void VolSurface::fillSmile(std::size_t idx, const double* logMoneyness, double carry, const SmileParams& params) {
+    double tte = expiries[idx] / 365.0;
+    double invScale = 1.0 / (params.atmVol * std::sqrt(tte));
+    
+    // Overwrite in place: after the first rebuild no smile reallocates
+    Smile& smile = smiles[idx];
+    smile.normStrikes.resize(GRID_SIZE);
+    smile.volPoints.resize(GRID_SIZE);
+    for (size_t j = 0; j < GRID_SIZE; ++j) {
+        double ns = (logMoneyness[j] - carry) * invScale;
+        smile.normStrikes[j] = ns;
+        smile.volPoints[j] = params.atmVol + params.skew * ns + params.convexity * ns * ns;
     }
 }
 
@@ -90,8 +180,11 @@ double VolSurface::getStrike(double normStrike, double forward, double expiry) c
 }
 
 double VolSurface::getVolNormStrike(double normStrike, double expiry) const {
+    if (ssvi) {
+        return ssvi->getVolNormStrike(normStrike, expiry);
+    }
     if (expiries.empty() || smiles.empty()) {
-        return 0.15;  // Default fallback
+        return DEFAULT_VOL;
     }
     
     if (expiry > expiries.back()) {
@@ -123,6 +216,9 @@ double VolSurface::getVolNormStrike(double normStrike, double expiry) const {
 }
 
 double VolSurface::getVol(double strike, double forward, double expiry) const {
+    if (ssvi) {
+        return ssvi->getVol(std::log(strike / forward), expiry);
+    }
     double normStrike = getNormStrike(strike, forward, expiry);
     return getVolNormStrike(normStrike, expiry);
 }
@@ -131,61 +227,42 @@ double VolSurface::getAtmVol(double expiry) const {
     return getVolNormStrike(0.0, expiry);
 }
 
-bool VolSurface::hasButterflyArbitrage() const {
-    for (size_t idx = 0; idx < expiries.size(); ++idx) {
-        const Smile& smile = smiles[idx];
-        double T = expiries[idx] / 365.0;
-        
-        if (smile.normStrikes.size() < 3) continue;
-        
-        // Check variance convexity (not IV convexity)
-        for (size_t i = 1; i + 1 < smile.volPoints.size(); ++i) {
-            double var_down = smile.volPoints[i - 1] * smile.volPoints[i - 1] * T;
-            double var_mid = smile.volPoints[i] * smile.volPoints[i] * T;
-            double var_up = smile.volPoints[i + 1] * smile.volPoints[i + 1] * T;
-            
-            double var_diff = var_up - 2.0 * var_mid + var_down;
-            if (var_diff < -1e-8) {
-                return true;
-            }
-        }
+FrozenVolSurface VolSurface::freeze() const {
+    return FrozenVolSurface(*this);
+}
+
+ArbitrageReport VolSurface::checkArbitrage() const {
+    return ArbitrageChecker::check(*this);
+}
+
+const ArbitrageReport& VolSurface::ensureArbitrageChecked() {
+    if (!arbitrageChecked && ArbitrageChecker::mode() != ArbitrageCheckMode::OFF) {
+        recordArbitrage();
     }
-    return false;
+    return arbitrageReport;
 }
 
-bool VolSurface::hasCalendarArbitrage() const {
-    for (size_t i = 0; i + 1 < expiries.size(); ++i) {
-        double expiryEarlier = expiries[i];
-        double expiryLater = expiries[i + 1];
-        const Smile& smileEarlier = smiles[i];
-        const Smile& smileLater = smiles[i + 1];
-        
-        // Find common normalized strikes (rounded to 2 decimals)
-        std::vector<double> commonStrikes;
-        for (double ns : smileEarlier.normStrikes) {
-            double nsRounded = std::round(ns * 100.0) / 100.0;
-            for (double nsLater : smileLater.normStrikes) {
-                double nsLaterRounded = std::round(nsLater * 100.0) / 100.0;
-                if (std::abs(nsRounded - nsLaterRounded) < 1e-6) {
-                    commonStrikes.push_back(ns);
-                    break;
-                }
-            }
-        }
-        
-        for (double ns : commonStrikes) {
-            double volEarlier = smileEarlier.getVol(ns);
-            double volLater = smileLater.getVol(ns);
-            
-            double varEarlier = volEarlier * volEarlier * expiryEarlier / 365.0;
-            double varLater = volLater * volLater * expiryLater / 365.0;
-            
-            if (varLater < varEarlier - 1e-8) {
-                return true;
-            }
-        }
+void VolSurface::recordArbitrage() {
+    arbitrageReport = checkArbitrage();
+    arbitrageChecked = true;
+    if (arbitrageReport.butterflyCount > 0) {
+        std::cerr << "Warning: Butterfly arbitrage detected in vol surface\n";
     }
-    return false;
+    if (arbitrageReport.calendarCount > 0) {
+        std::cerr << "Warning: Calendar arbitrage detected in vol surface\n";
+    }
+}
+
+bool VolSurface::hasButterflyArbitrage() const {
+    ArbitrageReport report;
+    ArbitrageChecker::checkButterfly(*this, report);
+    return report.butterflyCount > 0;
+}
+
+bool VolSurface::hasCalendarArbitrage() const {
+    ArbitrageReport report;
+    ArbitrageChecker::checkCalendar(*this, report);
+    return report.calendarCount > 0;
 }
 
 }  // namespace omm::core::models
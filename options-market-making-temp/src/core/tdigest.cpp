@@ -0,0 +1,139 @@
+#include "core/tdigest.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace omm::core {
+
+namespace {
+
+constexpr double BUFFER_FACTOR = 5.0;  // values buffered per unit of compression
+
+}  // namespace
+
+TDigest::TDigest(double compression_)
+    : compression(std::max(compression_, 10.0)),
+      bufferCapacity(static_cast<std::size_t>(BUFFER_FACTOR * std::max(compression_, 10.0))),
+      minValue(std::numeric_limits<double>::infinity()),
+      maxValue(-std::numeric_limits<double>::infinity()) {
+    centroids.reserve(static_cast<std::size_t>(compression));
+    buffer.reserve(bufferCapacity);
+    scratch.reserve(bufferCapacity + static_cast<std::size_t>(compression));
+}
+
+void TDigest::add(double x, double weight) {
+    if (!(weight > 0.0) || std::isnan(x)) return;
+    buffer.push_back(Centroid{x, weight});
+    bufferWeight += weight;
+    sum += x * weight;
+    minValue = std::min(minValue, x);
+    maxValue = std::max(maxValue, x);
+    if (buffer.size() >= bufferCapacity) flush();
+}
+
+void TDigest::merge(const TDigest& other) {
+    other.flush();
+    for (const Centroid& c : other.centroids) add(c.mean, c.weight);
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+}
+
+void TDigest::flush() const {
+    if (buffer.empty()) return;
+    scratch.assign(centroids.begin(), centroids.end());
+    scratch.insert(scratch.end(), buffer.begin(), buffer.end());
+    std::sort(scratch.begin(), scratch.end(), [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+    
+    double total = totalWeight + bufferWeight;
+    double normalizer = compression / (4.0 * std::log(std::max(total / compression, 1.0)) + 24.0);
+    auto kOfQ = [&](double q) { return normalizer * std::log(q / (1.0 - q)); };
+    auto qOfK = [&](double k) { return 1.0 / (1.0 + std::exp(-k / normalizer)); };
+    
+    // Greedy merge left to right: a centroid may grow while it spans at most one unit of k
+    centroids.clear();
+    Centroid current = scratch.front();
+    double before = 0.0;
+    double qLimit = 0.0;  // k(0) = -inf: the smallest value stays a singleton
+    for (std::size_t i = 1; i < scratch.size(); ++i) {
+        const Centroid& next = scratch[i];
+        if ((before + current.weight + next.weight) / total <= qLimit) {
+            current.weight += next.weight;
+            current.mean += (next.mean - current.mean) * next.weight / current.weight;
+        } else {
+            before += current.weight;
+            centroids.push_back(current);
+            current = next;
+            qLimit = qOfK(kOfQ(before / total) + 1.0);
+        }
+    }
+    centroids.push_back(current);
+    
+    totalWeight = total;
+    bufferWeight = 0.0;
+    buffer.clear();
+}
+
+double TDigest::valueAtRank(double t) const {
+    // Knots (0, min), (centre of each centroid, mean), (total, max)
+    double prevRank = 0.0;
+    double prevValue = minValue;
+    double cumulative = 0.0;
+    for (const Centroid& c : centroids) {
+        double rank = cumulative + 0.5 * c.weight;
+        if (t <= rank) {
+            double span = rank - prevRank;
+            return span > 0.0 ? prevValue + (c.mean - prevValue) * (t - prevRank) / span : c.mean;
+        }
+        prevRank = rank;
+        prevValue = c.mean;
+        cumulative += c.weight;
+    }
+    double span = totalWeight - prevRank;
+    return span > 0.0 ? prevValue + (maxValue - prevValue) * (t - prevRank) / span : maxValue;
+}
+
+double TDigest::integralToRank(double t) const {
+    // Whole centroids contribute exactly weight * mean; the one holding rank t the
+    // integral of the quantile curve over its part below t
+    double cumulative = 0.0;
+    double area = 0.0;
+    for (const Centroid& c : centroids) {
+        if (t <= cumulative + c.weight) {
+            double start = valueAtRank(cumulative);
+            return area + 0.5 * (start + valueAtRank(t)) * (t - cumulative);
+        }
+        area += c.weight * c.mean;
+        cumulative += c.weight;
+    }
+    return area;
+}
+
+double TDigest::quantile(double q) const {
+    flush();
+    if (centroids.empty()) return std::numeric_limits<double>::quiet_NaN();
+    return valueAtRank(std::clamp(q, 0.0, 1.0) * totalWeight);
+}
+
+double TDigest::tailMean(double q) const {
+    flush();
+    if (centroids.empty()) return std::numeric_limits<double>::quiet_NaN();
+    double t = std::clamp(q, 0.0, 1.0) * totalWeight;
+    if (t <= 0.0) return minValue;
+    return integralToRank(t) / t;
+}
+
+double TDigest::mean() const {
+    double n = count();
+    return n > 0.0 ? sum / n : std::numeric_limits<double>::quiet_NaN();
+}
+
+std::size_t TDigest::numCentroids() const {
+    flush();
+    return centroids.size();
+}
+
+std::size_t TDigest::memoryBytes() const {
+    return sizeof(*this) + (centroids.capacity() + buffer.capacity() + scratch.capacity()) * sizeof(Centroid);
+}
+
+}  // namespace omm::core
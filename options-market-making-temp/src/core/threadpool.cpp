@@ -0,0 +1,135 @@
+#include "core/threadpool.hpp"
+#include <algorithm>
+
+namespace omm::core {
+
+ThreadPool::ThreadPool(std::size_t numThreads) {
+    if (numThreads == 0) {
+        numThreads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+    for (std::size_t i = 0; i < numThreads; ++i) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (std::size_t i = 1; i < numThreads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+    if (queues.size() == 1) {
+        for (std::size_t i = 0; i < count; ++i) task(i);
+        return;
+    }
+    
+    // Contiguous runs keep neighbouring indices on one thread until stealing starts
+    std::size_t numQueues = queues.size();
+    for (std::size_t q = 0; q < numQueues; ++q) {
+        std::size_t begin = count * q / numQueues;
+        std::size_t end = count * (q + 1) / numQueues;
+        std::lock_guard<std::mutex> lock(queues[q]->mutex);
+        for (std::size_t i = begin; i < end; ++i) {
+            queues[q]->indices.push_back(i);
+        }
+    }
+    
+    remaining.store(count);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        error = nullptr;
+        ++generation;
+    }
+    wake.notify_all();
+    
+    runTasks(0, task);
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return remaining.load() == 0 && activeWorkers == 0; });
+    currentTask = nullptr;
+    if (error) {
+        std::exception_ptr failure = error;
+        error = nullptr;
+        std::rethrow_exception(failure);
+    }
+}
+
+void ThreadPool::workerLoop(std::size_t self) {
+    std::size_t seen = 0;
+    while (true) {
+        const std::function<void(std::size_t)>* task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || (generation != seen && currentTask); });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            task = currentTask;
+            ++activeWorkers;
+        }
+        
+        runTasks(self, *task);
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --activeWorkers;
+        }
+        done.notify_all();
+    }
+}
+
+void ThreadPool::runTasks(std::size_t self, const std::function<void(std::size_t)>& task) {
+    std::size_t index;
+    while (popTask(self, index)) {
+        try {
+            task(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) error = std::current_exception();
+        }
+        if (remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::popTask(std::size_t self, std::size_t& index) {
+    {
+        WorkQueue& own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.indices.empty()) {
+            index = own.indices.back();
+            own.indices.pop_back();
+            return true;
+        }
+    }
+    
+    // Steal the oldest index of the next non-empty queue
+    for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+        WorkQueue& victim = *queues[(self + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.indices.empty()) {
+            index = victim.indices.front();
+            victim.indices.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace omm::core
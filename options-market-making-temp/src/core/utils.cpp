@@ -20,16 +20,28 @@ std::vector<double> Utils::getNormStrikes(
     int maxStrikeStepDist,
     double strikeStep
 ) {
-    double forward = getForwardPrice(spot, interestRate, expiry);
     std::vector<double> normStrikes;
+    getNormStrikes(spot, interestRate, expiry, atmVol, normStrikes, maxStrikeStepDist, strikeStep);
+    return normStrikes;
+}
+
+void Utils::getNormStrikes(
+    double spot,
+    double interestRate,
+    double expiry,
+    double atmVol,
+    std::vector<double>& normStrikes,
+    int maxStrikeStepDist,
+    double strikeStep
+) {
+    double forward = getForwardPrice(spot, interestRate, expiry);
+    normStrikes.clear();
     
     for (int z = -maxStrikeStepDist; z <= maxStrikeStepDist; ++z) {
         double strike = spot + z * strikeStep;
         double ns = getNormStrike(strike, forward, expiry, atmVol);
         normStrikes.push_back(ns);
     }
-    
-    return normStrikes;
 }
 
 double Utils::getForwardPrice(double spot, double interestRate, double expiry) {
@@ -0,0 +1,164 @@
+#include "core/vecmath.hpp"
+#include "vecmath_kernels.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace omm::core {
+
+namespace {
+
+// Portable one-lane pack: the fallback path and the reference for the SIMD packs
+struct ScalarPack {
+    using reg = double;
+    using mask = bool;
+    static constexpr std::size_t width = 1;
+    
+    static reg load(const double* p) { return *p; }
+    static void store(double* p, reg x) { *p = x; }
+    static reg set1(double x) { return x; }
+    static reg add(reg a, reg b) { return a + b; }
+    static reg sub(reg a, reg b) { return a - b; }
+    static reg mul(reg a, reg b) { return a * b; }
+    static reg div(reg a, reg b) { return a / b; }
+    static reg fma(reg a, reg b, reg c) { return std::fma(a, b, c); }
+    static reg sqrt(reg x) { return std::sqrt(x); }
+    static reg abs(reg x) { return std::fabs(x); }
+    // Same operand order as minpd/maxpd: the second operand is returned for NaN
+    static reg min(reg a, reg b) { return a < b ? a : b; }
+    static reg max(reg a, reg b) { return a > b ? a : b; }
+    static reg round(reg x) { return std::nearbyint(x); }
+    static mask lt(reg a, reg b) { return a < b; }
+    static mask le(reg a, reg b) { return a <= b; }
+    static mask gt(reg a, reg b) { return a > b; }
+    static mask eq(reg a, reg b) { return a == b; }
+    static mask orMask(mask a, mask b) { return a || b; }
+    static reg select(mask m, reg a, reg b) { return m ? a : b; }
+    
+    static reg pow2i(reg n) {
+        std::uint64_t bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(n) + 1023) << 52;
+        double result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+    
+    static reg frexp1(reg x, reg& e) {
+        int exponent = 0;
+        double m = std::frexp(x, &exponent);  // m in [0.5, 1)
+        e = static_cast<double>(exponent - 1);
+        return m * 2.0;
+    }
+};
+
+bool cpuSupports(SimdLevel level) {
+#if defined(OMM_VECMATH_X86) && (defined(__GNUC__) || defined(__clang__))
+    switch (level) {
+        case SimdLevel::AVX512:
+            return __builtin_cpu_supports("avx512f");
+        case SimdLevel::AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case SimdLevel::SCALAR:
+            return true;
+    }
+    return false;
+#else
+    return level == SimdLevel::SCALAR;
+#endif
+}
+
+detail::VecMathKernels kernelsFor(SimdLevel level) {
+    switch (level) {
+#if defined(OMM_VECMATH_X86)
+        case SimdLevel::AVX512:
+            return detail::avx512Kernels();
+        case SimdLevel::AVX2:
+            return detail::avx2Kernels();
+#endif
+        default:
+            return detail::scalarKernels();
+    }
+}
+
+SimdLevel bestLevel() {
+    if (cpuSupports(SimdLevel::AVX512)) return SimdLevel::AVX512;
+    if (cpuSupports(SimdLevel::AVX2)) return SimdLevel::AVX2;
+    return SimdLevel::SCALAR;
+}
+
+struct Dispatch {
+    SimdLevel level;
+    detail::VecMathKernels kernels;
+    
+    Dispatch() : level(bestLevel()), kernels(kernelsFor(level)) {}
+};
+
+Dispatch& dispatch() {
+    static Dispatch instance;
+    return instance;
+}
+
+}  // namespace
+
+namespace detail {
+
+VecMathKernels scalarKernels() {
+    return vecmath::makeKernels<ScalarPack>();
+}
+
+}  // namespace detail
+
+SimdLevel VecMath::simdLevel() {
+    return dispatch().level;
+}
+
+SimdLevel VecMath::setSimdLevel(SimdLevel level) {
+    while (!cpuSupports(level)) {
+        level = static_cast<SimdLevel>(static_cast<int>(level) - 1);
+    }
+    Dispatch& d = dispatch();
+    d.level = level;
+    d.kernels = kernelsFor(level);
+    return level;
+}
+
+const char* VecMath::simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX512: return "avx512";
+        case SimdLevel::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+void VecMath::exp(const double* x, double* out, std::size_t n) {
+    dispatch().kernels.exp(x, out, n);
+}
+
+void VecMath::log(const double* x, double* out, std::size_t n) {
+    dispatch().kernels.log(x, out, n);
+}
+
+void VecMath::sqrt(const double* x, double* out, std::size_t n) {
+    dispatch().kernels.sqrt(x, out, n);
+}
+
+void VecMath::erf(const double* x, double* out, std::size_t n) {
+    dispatch().kernels.erf(x, out, n);
+}
+
+void VecMath::normCdf(const double* x, double* out, std::size_t n) {
+    dispatch().kernels.normCdf(x, out, n);
+}
+
+void VecMath::normPdf(const double* x, double* out, std::size_t n) {
+    dispatch().kernels.normPdf(x, out, n);
+}
+
+void VecMath::sinPi(const double* x, double* out, std::size_t n) {
+    dispatch().kernels.sinPi(x, out, n);
+}
+
+void VecMath::cosPi(const double* x, double* out, std::size_t n) {
+    dispatch().kernels.cosPi(x, out, n);
+}
+
+}  // namespace omm::core
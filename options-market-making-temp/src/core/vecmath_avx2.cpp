@@ -0,0 +1,73 @@
+// Built with -mavx2 -mfma; only called after a runtime CPU check (see vecmath.cpp)
+#include "vecmath_kernels.hpp"
+#include <immintrin.h>
+
+namespace omm::core {
+
+namespace {
+
+struct Avx2Pack {
+    using reg = __m256d;
+    using mask = __m256d;
+    static constexpr std::size_t width = 4;
+    
+    static reg load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, reg x) { _mm256_storeu_pd(p, x); }
+    static reg set1(double x) { return _mm256_set1_pd(x); }
+    static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+    static reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+    static reg sqrt(reg x) { return _mm256_sqrt_pd(x); }
+    static reg abs(reg x) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x); }
+    static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+    static reg round(reg x) { return _mm256_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static mask lt(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static mask le(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static mask gt(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static mask eq(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static mask orMask(mask a, mask b) { return _mm256_or_pd(a, b); }
+    static reg select(mask m, reg a, reg b) { return _mm256_blendv_pd(b, a, m); }
+    
+    // Biased exponent n + 1023 placed in bits 52..62 through the 2^52 + 2^51 magic number
+    static reg pow2i(reg n) {
+        __m256d magic = _mm256_set1_pd(6755399441055744.0 + 1023.0);
+        __m256i bits = _mm256_castpd_si256(_mm256_add_pd(n, magic));
+        return _mm256_castsi256_pd(_mm256_slli_epi64(bits, 52));
+    }
+    
+    static reg frexp1(reg x, reg& e) {
+        // Scale subnormals into the normal range first
+        mask tiny = lt(x, set1(2.2250738585072014e-308));
+        reg xs = select(tiny, mul(x, set1(18014398509481984.0)), x);  // 2^54
+        
+        __m256i bits = _mm256_castpd_si256(xs);
+        __m256i exponentBits = _mm256_and_si256(_mm256_srli_epi64(bits, 52), _mm256_set1_epi64x(0x7ff));
+        // Exponent as a double: or into the mantissa of 2^52 and subtract 2^52
+        reg biased = _mm256_sub_pd(
+            _mm256_castsi256_pd(_mm256_or_si256(exponentBits, _mm256_set1_epi64x(0x4330000000000000LL))),
+            set1(4503599627370496.0)
+        );
+        e = sub(biased, select(tiny, set1(1023.0 + 54.0), set1(1023.0)));
+        
+        __m256i mantissa = _mm256_or_si256(
+            _mm256_and_si256(bits, _mm256_set1_epi64x(0x000fffffffffffffLL)),
+            _mm256_set1_epi64x(0x3ff0000000000000LL)
+        );
+        return _mm256_castsi256_pd(mantissa);
+    }
+};
+
+}  // namespace
+
+namespace detail {
+
+VecMathKernels avx2Kernels() {
+    return vecmath::makeKernels<Avx2Pack>();
+}
+
+}  // namespace detail
+
+}  // namespace omm::core
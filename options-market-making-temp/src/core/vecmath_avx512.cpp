@@ -0,0 +1,56 @@
+// Built with -mavx512f -mfma; only called after a runtime CPU check (see vecmath.cpp)
+#include "vecmath_kernels.hpp"
+#include <immintrin.h>
+
+namespace omm::core {
+
+namespace {
+
+struct Avx512Pack {
+    using reg = __m512d;
+    using mask = __mmask8;
+    static constexpr std::size_t width = 8;
+    // The unmasked forms of sqrt, min, max, roundscale, scalef, getexp and getmant merge
+    // into _mm512_undefined_pd(), which GCC 12 reports as maybe-uninitialized; the
+    // zero-masked forms with every lane set are the same instructions
+    static constexpr mask ALL = 0xFF;
+    
+    static reg load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, reg x) { _mm512_storeu_pd(p, x); }
+    static reg set1(double x) { return _mm512_set1_pd(x); }
+    static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+    static reg div(reg a, reg b) { return _mm512_div_pd(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+    static reg sqrt(reg x) { return _mm512_maskz_sqrt_pd(ALL, x); }
+    static reg abs(reg x) { return _mm512_abs_pd(x); }
+    static reg min(reg a, reg b) { return _mm512_maskz_min_pd(ALL, a, b); }
+    static reg max(reg a, reg b) { return _mm512_maskz_max_pd(ALL, a, b); }
+    static reg round(reg x) { return _mm512_maskz_roundscale_pd(ALL, x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static mask lt(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static mask le(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+    static mask gt(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static mask eq(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+    static mask orMask(mask a, mask b) { return static_cast<mask>(a | b); }
+    static reg select(mask m, reg a, reg b) { return _mm512_mask_blend_pd(m, b, a); }
+    
+    static reg pow2i(reg n) { return _mm512_maskz_scalef_pd(ALL, set1(1.0), n); }
+    
+    static reg frexp1(reg x, reg& e) {
+        e = _mm512_maskz_getexp_pd(ALL, x);
+        return _mm512_maskz_getmant_pd(ALL, x, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_src);
+    }
+};
+
+}  // namespace
+
+namespace detail {
+
+VecMathKernels avx512Kernels() {
+    return vecmath::makeKernels<Avx512Pack>();
+}
+
+}  // namespace detail
+
+}  // namespace omm::core
@@ -0,0 +1,333 @@
+#pragma once
+
+// Generic VecMath algorithms, written once against a "pack" type V and instantiated by
+// each ISA translation unit (vecmath.cpp, vecmath_avx2.cpp, vecmath_avx512.cpp).
+//
+// A pack provides:
+//   using reg / mask; static constexpr std::size_t width;
+//   load, store, set1, add, sub, mul, div, fma (a * b + c), sqrt, abs, min, max,
+//   round (to nearest even), lt, le, gt, eq, orMask, select (m ? a : b),
+//   pow2i (2^n for integral n in [-1022, 1023]),
+//   frexp1 (x = m * 2^e with m in [1, 2) for finite x > 0, subnormals included).
+//
+// Packs must be declared in an anonymous namespace so that every instantiation has
+// internal linkage and code built for one ISA can never be picked for another.
+
+#include <cstddef>
+
+namespace omm::core::detail {
+
+using ArrayKernel = void (*)(const double*, double*, std::size_t);
+
+struct VecMathKernels {
+    ArrayKernel exp;
+    ArrayKernel log;
+    ArrayKernel sqrt;
+    ArrayKernel erf;
+    ArrayKernel normCdf;
+    ArrayKernel normPdf;
+    ArrayKernel sinPi;
+    ArrayKernel cosPi;
+};
+
+VecMathKernels scalarKernels();
+VecMathKernels avx2Kernels();
+VecMathKernels avx512Kernels();
+
+namespace vecmath {
+
+constexpr double LN2_HI = 6.93147180369123816490e-01;
+constexpr double LN2_LO = 1.90821492927058770002e-10;
+constexpr double LOG2E = 1.44269504088896338700e+00;
+constexpr double SQRT2 = 1.41421356237309504880e+00;
+constexpr double SQRT1_2 = 7.07106781186547524401e-01;
+constexpr double INV_SQRT_2PI = 3.98942280401432677940e-01;
+constexpr double EXP_OVERFLOW = 7.09782712893383973096e+02;
+constexpr double EXP_UNDERFLOW = -7.45133219101941108420e+02;
+constexpr double INF = __builtin_huge_val();
+constexpr double PI_HI = 3.14159265358979311600e+00;
+constexpr double PI_LO = 1.22464679914735317723e-16;
+
+// Taylor coefficients of erf(x) / x in x^2 (|x| < 1)
+constexpr double ERF_TAYLOR[] = {
+    1.1283791670955126,
+    -0.37612638903183754,
+    0.11283791670955126,
+    -0.026866170645131252,
+    0.005223977625442188,
+    -0.0008548327023450853,
+    0.00012055332981789664,
+    -1.492565035840625e-05,
+    1.6462114365889248e-06,
+    -1.6365844691234924e-07,
+    1.4807192815879218e-08,
+    -1.2290555301717928e-09,
+    9.422759064650411e-11,
+    -6.7113668551641105e-12,
+    4.4632242632864775e-13,
+    -2.7835162072109215e-14,
+    1.6342614095367152e-15,
+    -9.063970842808673e-17,
+    4.763348040515068e-18,
+    -2.3784598852774293e-19,
+};
+
+// Chebyshev coefficients of x * erfc(x) * exp(x^2) in u = 1/x over [1/6, 1]
+constexpr double ERFC_CHEB_LO = 1.0 / 6.0;
+constexpr double ERFC_CHEB_HI = 1.0;
+constexpr double ERFC_CHEB[] = {
+    0.49471361578208073,
+    -0.06627963187965226,
+    -0.0022764645742360114,
+    0.001717245128146866,
+    -0.00032014496358247316,
+    2.6743225983670515e-05,
+    3.968695744344053e-06,
+    -2.2059099609177132e-06,
+    5.18822760986672e-07,
+    -6.999918836906682e-08,
+    -9.071270087834272e-10,
+    3.81951552192842e-09,
+    -1.3416438565181666e-09,
+    2.947892218032652e-10,
+    -3.786760799975439e-11,
+    -2.167147256147601e-12,
+    3.1122292821541805e-12,
+    -1.1363842124992377e-12,
+    2.77398552779693e-13,
+    -4.459066763759465e-14,
+    1.0733133055338635e-15,
+    2.4789530204177567e-15,
+    -1.1596680074225182e-15,
+    3.456896074763195e-16,
+    -7.485758919039714e-17,
+    9.669856187678423e-18,
+    9.014205604008193e-19,
+};
+
+template <typename V, std::size_t N>
+inline typename V::reg horner(typename V::reg x, const double (&coeffs)[N]) {
+    typename V::reg acc = V::set1(coeffs[N - 1]);
+    for (std::size_t i = N - 1; i-- > 0;) {
+        acc = V::fma(acc, x, V::set1(coeffs[i]));
+    }
+    return acc;
+}
+
+// exp(x) = 2^n * p(r), x = n ln2 + r, |r| <= ln2 / 2, p = Taylor polynomial of degree 13.
+// 2^n is applied in two halves so that results near overflow and in the subnormal
+// range stay representable.
+template <typename V>
+inline typename V::reg exp(typename V::reg x) {
+    using reg = typename V::reg;
+    reg xc = V::min(V::max(x, V::set1(EXP_UNDERFLOW)), V::set1(EXP_OVERFLOW));
+    reg n = V::round(V::mul(xc, V::set1(LOG2E)));
+    reg r = V::fma(n, V::set1(-LN2_HI), xc);
+    r = V::fma(n, V::set1(-LN2_LO), r);
+
+    reg p = V::set1(1.0 / 6227020800.0);
+    p = V::fma(p, r, V::set1(1.0 / 479001600.0));
+    p = V::fma(p, r, V::set1(1.0 / 39916800.0));
+    p = V::fma(p, r, V::set1(1.0 / 3628800.0));
+    p = V::fma(p, r, V::set1(1.0 / 362880.0));
+    p = V::fma(p, r, V::set1(1.0 / 40320.0));
+    p = V::fma(p, r, V::set1(1.0 / 5040.0));
+    p = V::fma(p, r, V::set1(1.0 / 720.0));
+    p = V::fma(p, r, V::set1(1.0 / 120.0));
+    p = V::fma(p, r, V::set1(1.0 / 24.0));
+    p = V::fma(p, r, V::set1(1.0 / 6.0));
+    p = V::fma(p, r, V::set1(0.5));
+    p = V::fma(p, r, V::set1(1.0));
+    p = V::fma(p, r, V::set1(1.0));
+
+    reg n1 = V::round(V::mul(n, V::set1(0.5)));
+    reg result = V::mul(V::mul(p, V::pow2i(n1)), V::pow2i(V::sub(n, n1)));
+
+    result = V::select(V::lt(x, V::set1(EXP_UNDERFLOW)), V::set1(0.0), result);
+    result = V::select(V::gt(x, V::set1(EXP_OVERFLOW)), V::set1(INF), result);
+    return V::select(V::eq(x, x), result, x);  // NaN passes through
+}
+
+// log(x) = e ln2 + log(1 + f), 1 + f in [sqrt(1/2), sqrt(2)), with
+// log(1 + f) = f - s (f - R), s = f / (2 + f), R = 2 (s^2/3 + s^4/5 + ...)
+template <typename V>
+inline typename V::reg log(typename V::reg x) {
+    using reg = typename V::reg;
+    reg e;
+    reg m = V::frexp1(x, e);
+
+    auto big = V::gt(m, V::set1(SQRT2));
+    m = V::select(big, V::mul(m, V::set1(0.5)), m);
+    e = V::select(big, V::add(e, V::set1(1.0)), e);
+
+    reg f = V::sub(m, V::set1(1.0));
+    reg s = V::div(f, V::add(f, V::set1(2.0)));
+    reg z = V::mul(s, s);
+
+    reg R = V::set1(2.0 / 23.0);
+    R = V::fma(R, z, V::set1(2.0 / 21.0));
+    R = V::fma(R, z, V::set1(2.0 / 19.0));
+    R = V::fma(R, z, V::set1(2.0 / 17.0));
+    R = V::fma(R, z, V::set1(2.0 / 15.0));
+    R = V::fma(R, z, V::set1(2.0 / 13.0));
+    R = V::fma(R, z, V::set1(2.0 / 11.0));
+    R = V::fma(R, z, V::set1(2.0 / 9.0));
+    R = V::fma(R, z, V::set1(2.0 / 7.0));
+    R = V::fma(R, z, V::set1(2.0 / 5.0));
+    R = V::fma(R, z, V::set1(2.0 / 3.0));
+    R = V::mul(R, z);
+
+    reg log1pf = V::sub(f, V::mul(s, V::sub(f, R)));
+    reg result = V::fma(e, V::set1(LN2_HI), V::fma(e, V::set1(LN2_LO), log1pf));
+
+    result = V::select(V::eq(x, V::set1(INF)), x, result);
+    result = V::select(V::eq(x, V::set1(0.0)), V::set1(-INF), result);
+    return V::select(V::lt(x, V::set1(0.0)), V::set1(__builtin_nan("")),
+                     V::select(V::eq(x, x), result, x));
+}
+
+// erf(x): Taylor series for |x| < 1, 1 - exp(-x^2) Chebyshev(1/x) / x for 1 <= |x| < 6,
+// +-1 beyond (erfc(6) is below half an ULP of 1)
+template <typename V>
+inline typename V::reg erf(typename V::reg x) {
+    using reg = typename V::reg;
+    reg a = V::abs(x);
+
+    reg small = V::mul(x, horner<V>(V::mul(x, x), ERF_TAYLOR));
+
+    reg ac = V::min(V::max(a, V::set1(1.0)), V::set1(6.0));
+    reg u = V::div(V::set1(1.0), ac);
+
+    // Clenshaw recurrence on t = u mapped to [-1, 1]
+    constexpr double scale = 2.0 / (ERFC_CHEB_HI - ERFC_CHEB_LO);
+    constexpr double shift = -(ERFC_CHEB_HI + ERFC_CHEB_LO) / (ERFC_CHEB_HI - ERFC_CHEB_LO);
+    reg t = V::fma(u, V::set1(scale), V::set1(shift));
+    reg t2 = V::add(t, t);
+    constexpr std::size_t N = sizeof(ERFC_CHEB) / sizeof(ERFC_CHEB[0]);
+    reg b1 = V::set1(0.0);
+    reg b2 = V::set1(0.0);
+    for (std::size_t k = N - 1; k > 0; --k) {
+        reg b0 = V::fma(t2, b1, V::sub(V::set1(ERFC_CHEB[k]), b2));
+        b2 = b1;
+        b1 = b0;
+    }
+    reg cheb = V::fma(t, b1, V::sub(V::set1(ERFC_CHEB[0]), b2));
+
+    reg erfc = V::mul(V::mul(exp<V>(V::mul(ac, V::sub(V::set1(0.0), ac))), u), cheb);
+    reg mid = V::sub(V::set1(1.0), erfc);
+    mid = V::select(V::lt(a, V::set1(6.0)), mid, V::set1(1.0));
+    mid = V::select(V::lt(x, V::set1(0.0)), V::sub(V::set1(0.0), mid), mid);
+
+    reg result = V::select(V::lt(a, V::set1(1.0)), small, mid);
+    return V::select(V::eq(x, x), result, x);
+}
+
+template <typename V>
+inline typename V::reg normCdf(typename V::reg x) {
+    typename V::reg e = erf<V>(V::mul(x, V::set1(SQRT1_2)));
+    return V::mul(V::set1(0.5), V::add(V::set1(1.0), e));
+}
+
+template <typename V>
+inline typename V::reg normPdf(typename V::reg x) {
+    typename V::reg arg = V::mul(V::set1(-0.5), V::mul(x, x));
+    return V::mul(exp<V>(arg), V::set1(INV_SQRT_2PI));
+}
+
+// sin(t) and cos(t) for |t| <= pi/4 (fdlibm __kernel_sin / __kernel_cos coefficients)
+template <typename V>
+inline typename V::reg sinKernel(typename V::reg t, typename V::reg z) {
+    typename V::reg p = V::set1(1.58969099521155010221e-10);
+    p = V::fma(p, z, V::set1(-2.50507602534068634195e-08));
+    p = V::fma(p, z, V::set1(2.75573137070700676789e-06));
+    p = V::fma(p, z, V::set1(-1.98412698298579493134e-04));
+    p = V::fma(p, z, V::set1(8.33333333332248946124e-03));
+    p = V::fma(p, z, V::set1(-1.66666666666666324348e-01));
+    return V::fma(V::mul(t, z), p, t);
+}
+
+template <typename V>
+inline typename V::reg cosKernel(typename V::reg z) {
+    using reg = typename V::reg;
+    reg p = V::set1(-1.13596475577881948265e-11);
+    p = V::fma(p, z, V::set1(2.08757232129817482790e-09));
+    p = V::fma(p, z, V::set1(-2.75573143513906633035e-07));
+    p = V::fma(p, z, V::set1(2.48015872894767294178e-05));
+    p = V::fma(p, z, V::set1(-1.38888888888741095749e-03));
+    p = V::fma(p, z, V::set1(4.16666666666666019037e-02));
+    reg hz = V::mul(V::set1(0.5), z);
+    reg w = V::sub(V::set1(1.0), hz);
+    // w + ((1 - w) - hz) recovers the bits of 1 - z/2 lost in w
+    reg tail = V::fma(V::mul(z, z), p, V::sub(V::sub(V::set1(1.0), w), hz));
+    return V::add(w, tail);
+}
+
+// x = q / 2 + r with |r| <= 1/4; the reduction is exact, so sinPi(n) is exactly 0 and
+// large arguments keep full accuracy. Returns t = pi r and q mod 4 in {-2, ..., 2}.
+template <typename V>
+inline typename V::reg reducePi(typename V::reg x, typename V::reg& t, typename V::reg& quadrant) {
+    using reg = typename V::reg;
+    reg q = V::round(V::add(x, x));
+    reg r = V::fma(q, V::set1(-0.5), x);
+    t = V::fma(r, V::set1(PI_HI), V::mul(r, V::set1(PI_LO)));
+    quadrant = V::fma(V::round(V::mul(q, V::set1(0.25))), V::set1(-4.0), q);
+    return V::mul(t, t);
+}
+
+template <typename V>
+inline typename V::reg sinPi(typename V::reg x) {
+    using reg = typename V::reg;
+    reg t, m;
+    reg z = reducePi<V>(x, t, m);
+    reg odd = V::select(V::eq(V::abs(m), V::set1(1.0)), cosKernel<V>(z), sinKernel<V>(t, z));
+    auto negate = V::orMask(V::lt(m, V::set1(0.0)), V::eq(m, V::set1(2.0)));
+    return V::select(negate, V::sub(V::set1(0.0), odd), odd);
+}
+
+template <typename V>
+inline typename V::reg cosPi(typename V::reg x) {
+    using reg = typename V::reg;
+    reg t, m;
+    reg z = reducePi<V>(x, t, m);
+    reg odd = V::select(V::eq(V::abs(m), V::set1(1.0)), sinKernel<V>(t, z), cosKernel<V>(z));
+    auto negate = V::orMask(V::gt(m, V::set1(0.0)), V::eq(m, V::set1(-2.0)));
+    return V::select(negate, V::sub(V::set1(0.0), odd), odd);
+}
+
+// Apply a pack function over an array; the tail goes through one padded pack
+template <typename V, typename V::reg (*F)(typename V::reg)>
+void apply(const double* x, double* out, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + V::width <= n; i += V::width) {
+        V::store(out + i, F(V::load(x + i)));
+    }
+    if (i < n) {
+        double buffer[V::width] = {};
+        for (std::size_t j = 0; i + j < n; ++j) buffer[j] = x[i + j];
+        V::store(buffer, F(V::load(buffer)));
+        for (std::size_t j = 0; i + j < n; ++j) out[i + j] = buffer[j];
+    }
+}
+
+template <typename V>
+typename V::reg sqrt(typename V::reg x) {
+    return V::sqrt(x);
+}
+
+template <typename V>
+VecMathKernels makeKernels() {
+    return VecMathKernels{
+        &apply<V, &exp<V>>,
+        &apply<V, &log<V>>,
+        &apply<V, &sqrt<V>>,
+        &apply<V, &erf<V>>,
+        &apply<V, &normCdf<V>>,
+        &apply<V, &normPdf<V>>,
+        &apply<V, &sinPi<V>>,
+        &apply<V, &cosPi<V>>,
+    };
+}
+
+}  // namespace vecmath
+
+}  // namespace omm::core::detail
@@ -0,0 +1,352 @@
+#include "core/workers/aadrisk.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace omm::core::workers {
+
+using aad::Real;
+using omm::core::models::SmileParams;
+
+namespace {
+
+// Every result of a call with the wrong number of smiles
+constexpr double NOT_A_VALUE = std::numeric_limits<double>::quiet_NaN();
+
+// The knots are rebuilt on VolSurface's own strike grid
+constexpr int GRID_STEP_DIST = omm::core::models::VolSurface::GRID_STEP_DIST;
+constexpr double GRID_STRIKE_STEP = omm::core::models::VolSurface::GRID_STRIKE_STEP;
+constexpr std::size_t GRID_SIZE = omm::core::models::VolSurface::GRID_SIZE;
+constexpr double DEFAULT_VOL = omm::core::models::VolSurface::DEFAULT_VOL;
+constexpr double INV_SQRT_2 = 0.70710678118654752440;
+constexpr double INV_SQRT_2PI = 0.39894228040143267794;
+
+double normCdf(double x) {
+    return 0.5 * (1.0 + std::erf(x * INV_SQRT_2));
+}
+
+// One expiry's smile parameters in the valuation's number type
+template <typename T>
+struct SmileInputs {
+    T atmVol;
+    T skew;
+    T convexity;
+};
+
+// Black price of one leg; with Real, one node whose parents are forward, vol and df
+double blackPrice(double forward, double strike, double vol, double tte, double df, bool call) {
+    double stdDev = vol * std::sqrt(tte);
+    double d1 = (std::log(forward / strike) + 0.5 * vol * vol * tte) / stdDev;
+    double d2 = d1 - stdDev;
+    return call ? df * (forward * normCdf(d1) - strike * normCdf(d2))
+                : df * (strike * normCdf(-d2) - forward * normCdf(-d1));
+}
+
+Real blackPrice(const Real& forward, double strike, const Real& vol, double tte, const Real& df, bool call) {
+    double f = forward.value;
+    double sqrtTte = std::sqrt(tte);
+    double stdDev = vol.value * sqrtTte;
+    double d1 = (std::log(f / strike) + 0.5 * vol.value * vol.value * tte) / stdDev;
+    double d2 = d1 - stdDev;
+    double nd1 = normCdf(call ? d1 : -d1);
+    double nd2 = normCdf(call ? d2 : -d2);
+    double undiscounted = call ? f * nd1 - strike * nd2 : strike * nd2 - f * nd1;
+    double dForward = df.value * (call ? nd1 : -nd1);
+    double dVol = df.value * f * INV_SQRT_2PI * std::exp(-0.5 * d1 * d1) * sqrtTte;
+    return Real::record(df.value * undiscounted, {forward, vol, df}, {dForward, dVol, undiscounted});
+}
+
+// Knot vol atmVol + skew ns + convexity ns^2 as one node
+double knotVol(const SmileInputs<double>& smile, double ns) {
+    return smile.atmVol + smile.skew * ns + smile.convexity * ns * ns;
+}
+
+Real knotVol(const SmileInputs<Real>& smile, const Real& ns) {
+    double n = ns.value;
+    double value = smile.atmVol.value + smile.skew.value * n + smile.convexity.value * n * n;
+    double dNs = smile.skew.value + 2.0 * smile.convexity.value * n;
+    return Real::record(value, {smile.atmVol, smile.skew, smile.convexity, ns}, {1.0, n, n * n, dNs});
+}
+
+// Linear interpolation between knots (xDown, yDown) and (xUp, yUp) at x; with Real,
+// one node over the five inputs
+double interpolate(double x, double xDown, double xUp, double yDown, double yUp) {
+    double weight = (x - xDown) / (xUp - xDown);
+    return yDown + weight * (yUp - yDown);
+}
+
+Real interpolate(const Real& x, const Real& xDown, const Real& xUp, const Real& yDown, const Real& yUp) {
+    double span = xUp.value - xDown.value;
+    double weight = (x.value - xDown.value) / span;
+    double slope = (yUp.value - yDown.value) / span;
+    return Real::record(
+        yDown.value + weight * (yUp.value - yDown.value),
+        {x, xDown, xUp, yDown, yUp},
+        {slope, -slope * (1.0 - weight), -slope * weight, 1.0 - weight, weight});
+}
+
+// (1 - weight) * down + weight * up
+double blend(double down, double up, double weight) {
+    return down + weight * (up - down);
+}
+
+Real blend(const Real& down, const Real& up, double weight) {
+    return Real::record(down.value + weight * (up.value - down.value), {down, up}, {1.0 - weight, weight});
+}
+
+// sum of weights[i] * terms[i] (+ constant); with Real, one node over all terms
+double weightedSum(const std::vector<double>& terms, const std::vector<double>& weights) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < terms.size(); ++i) sum += weights[i] * terms[i];
+    return sum;
+}
+
+Real weightedSum(const std::vector<Real>& terms, const std::vector<double>& weights) {
+    double sum = 0.0;
+    aad::Tape* tape = nullptr;
+    std::vector<aad::NodeIndex> nodes(terms.size());
+    for (std::size_t i = 0; i < terms.size(); ++i) {
+        sum += weights[i] * terms[i].value;
+        nodes[i] = terms[i].node;
+        if (!tape) tape = terms[i].tape;
+    }
+    if (!tape) return Real(sum);
+    return Real(sum, tape->record(nodes.data(), weights.data(), nodes.size()), tape);
+}
+
+// The valuation, generic in the number type: double to price, Real to record
+template <typename T>
+class BookValuation {
+public:
+    BookValuation(const omm::core::models::Market& market_, const std::vector<SmileInputs<T>>& smiles_)
+        : market(market_), expiries(market_.volSurface->expiries), smiles(smiles_) {
+        buildKnots();
+    }
+    
+    T value(const omm::core::models::Portfolio& portfolio, const T& spot, const T& rate) const {
+        using std::exp;
+        using std::log;
+        std::vector<T> terms;
+        std::vector<double> weights;
+        terms.reserve(portfolio.numOptions() + 1);
+        weights.reserve(portfolio.numOptions() + 1);
+        
+        for (const auto& bucket : portfolio.optionBuckets) {
+            double tte = bucket.expiry / 365.0;
+            double sqrtTte = std::sqrt(tte);
+            T carry = rate * tte;
+            T forward = spot * exp(carry);
+            T df = exp(-carry);
+            T logForward = log(forward);
+            Bracket bracket = locate(bucket.expiry);
+            
+            // VolSurface::getVol: norm strike against getAtmVol, then the smile lookup
+            T scale = volNormStrike(bracket, T(0.0)) * sqrtTte;
+            for (std::size_t i = 0; i < bucket.size(); ++i) {
+                T ns = (bucket.logStrikes[i] - logForward) / scale;
+                T vol = volNormStrike(bracket, ns);
+                bool call = bucket.optionTypes[i] == omm::core::models::OptionType::CALL;
+                terms.push_back(blackPrice(forward, bucket.strikes[i], vol, tte, df, call));
+                weights.push_back(bucket.weights[i]);
+            }
+        }
+        
+        double futureWeight = 0.0;
+        for (double weight : portfolio.futureWeights) futureWeight += weight;
+        terms.push_back(spot);
+        weights.push_back(futureWeight);
+        return weightedSum(terms, weights);
+    }
+
+private:
+    // Smiles either side of an expiry and the weight of the later one
+    struct Bracket {
+        std::size_t down;
+        std::size_t up;
+        double weight;
+    };
+    
+    // Knots as VolSurface::rebuild lays them
+    void buildKnots() {
+        double logMoneyness[GRID_SIZE];
+        for (int z = -GRID_STEP_DIST; z <= GRID_STEP_DIST; ++z) {
+            logMoneyness[z + GRID_STEP_DIST] = std::log((market.spot + z * GRID_STRIKE_STEP) / market.spot);
+        }
+        knotNs.reserve(smiles.size() * GRID_SIZE);
+        knotNsValues.reserve(smiles.size() * GRID_SIZE);
+        knotVols.reserve(smiles.size() * GRID_SIZE);
+        for (std::size_t idx = 0; idx < smiles.size(); ++idx) {
+            double tte = expiries[idx] / 365.0;
+            double carry = market.interestRate * tte;
+            T invScale = T(1.0) / (smiles[idx].atmVol * std::sqrt(tte));
+            for (std::size_t j = 0; j < GRID_SIZE; ++j) {
+                T ns = invScale * (logMoneyness[j] - carry);
+                knotNs.push_back(ns);
+                knotNsValues.push_back(aad::valueOf(ns));
+                knotVols.push_back(knotVol(smiles[idx], ns));
+            }
+        }
+    }
+    
+    // Smile::getVol
+    T smileVol(std::size_t idx, const T& ns) const {
+        std::size_t offset = idx * GRID_SIZE;
+        const double* values = knotNsValues.data() + offset;
+        double n = aad::valueOf(ns);
+        if (n > values[GRID_SIZE - 1]) return knotVols[offset + GRID_SIZE - 1];
+        if (n < values[0]) return knotVols[offset];
+        
+        std::size_t up = static_cast<std::size_t>(std::lower_bound(values, values + GRID_SIZE, n) - values);
+        up = std::max<std::size_t>(up, 1);
+        if (values[up] == values[up - 1]) return knotVols[offset + up - 1];
+        return interpolate(
+            ns, knotNs[offset + up - 1], knotNs[offset + up], knotVols[offset + up - 1], knotVols[offset + up]);
+    }
+    
+    // VolSurface::getVolNormStrike's choice of smiles
+    Bracket locate(double expiry) const {
+        if (expiries.size() < 2) return Bracket{0, 0, 0.0};
+        if (expiry > expiries.back()) return Bracket{expiries.size() - 1, expiries.size() - 1, 0.0};
+        if (expiry < expiries.front()) return Bracket{0, 0, 0.0};
+        auto idx = static_cast<std::size_t>(std::lower_bound(expiries.begin(), expiries.end(), expiry) - expiries.begin());
+        idx = std::clamp<std::size_t>(idx, 1, expiries.size() - 1);
+        double span = expiries[idx] - expiries[idx - 1];
+        return Bracket{idx - 1, idx, span != 0.0 ? (expiry - expiries[idx - 1]) / span : 0.0};
+    }
+    
+    T volNormStrike(const Bracket& bracket, const T& ns) const {
+        if (smiles.empty()) return T(DEFAULT_VOL);
+        T volDown = smileVol(bracket.down, ns);
+        if (bracket.weight == 0.0) return volDown;
+        return blend(volDown, smileVol(bracket.up, ns), bracket.weight);
+    }
+    
+    const omm::core::models::Market& market;
+    const std::vector<double>& expiries;
+    const std::vector<SmileInputs<T>>& smiles;
+    std::vector<T> knotNs;
+    std::vector<double> knotNsValues;
+    std::vector<T> knotVols;
+};
+
+// ATM term structure of VolSurface's parametric constructor
+template <typename T>
+T termStructureAtmVol(double expiry, const T& atmOneMonthVol, const T& volMean) {
+    using std::sqrt;
+    double weight = std::exp(-std::abs(expiry - 30.0) / 365.0);
+    return sqrt(volMean * volMean + weight * (atmOneMonthVol * atmOneMonthVol - volMean * volMean));
+}
+
+// Real smile inputs as tape variables, and the per-expiry adjoints after the sweep
+std::vector<SmileParams> smileAdjoints(const std::vector<SmileInputs<Real>>& smiles, const aad::Tape& tape) {
+    std::vector<SmileParams> adjoints;
+    adjoints.reserve(smiles.size());
+    for (const auto& smile : smiles) {
+        adjoints.push_back(SmileParams{
+            tape.adjoint(smile.atmVol.node), tape.adjoint(smile.skew.node), tape.adjoint(smile.convexity.node)});
+    }
+    return adjoints;
+}
+
+SurfaceSensitivities sweep(
+    const omm::core::models::Portfolio& portfolio,
+    const omm::core::models::Market& market,
+    const std::vector<SmileInputs<Real>>& smiles,
+    const Real& spot,
+    const Real& rate,
+    aad::Tape& tape
+) {
+    BookValuation<Real> valuation(market, smiles);
+    Real value = valuation.value(portfolio, spot, rate);
+    tape.propagate(value.node);
+    
+    SurfaceSensitivities result;
+    result.value = value.value;
+    result.spot = tape.adjoint(spot.node);
+    result.interestRate = tape.adjoint(rate.node);
+    result.smiles = smileAdjoints(smiles, tape);
+    return result;
+}
+
+}  // namespace
+
+SurfaceSensitivities AadRisk::portfolioSensitivities(
+    const omm::core::models::Portfolio& portfolio,
+    const omm::core::models::Market& market,
+    const SurfaceParams& params,
+    aad::Tape& tape
+) {
+    tape.clear();
+    Real spot = Real::variable(market.spot, tape);
+    Real rate = Real::variable(market.interestRate, tape);
+    Real atmOneMonthVol = Real::variable(params.atmOneMonthVolEst, tape);
+    Real skew = Real::variable(params.skew, tape);
+    Real convexity = Real::variable(params.convexity, tape);
+    Real volMean = Real::variable(params.volMean, tape);
+    
+    // Per-expiry nodes (identities for skew and convexity) so that the smile
+    // adjoints come out of the same sweep
+    std::vector<SmileInputs<Real>> smiles;
+    for (double expiry : market.volSurface->expiries) {
+        smiles.push_back(SmileInputs<Real>{
+            termStructureAtmVol(expiry, atmOneMonthVol, volMean), skew * 1.0, convexity * 1.0});
+    }
+    
+    SurfaceSensitivities result = sweep(portfolio, market, smiles, spot, rate, tape);
+    result.surface = SurfaceParams{
+        tape.adjoint(atmOneMonthVol.node), tape.adjoint(skew.node), tape.adjoint(convexity.node),
+        tape.adjoint(volMean.node)};
+    return result;
+}
+
+SurfaceSensitivities AadRisk::portfolioSensitivities(
+    const omm::core::models::Portfolio& portfolio,
+    const omm::core::models::Market& market,
+    const std::vector<SmileParams>& smileParams,
+    aad::Tape& tape
+) {
+    tape.clear();
+    if (smileParams.size() != market.volSurface->expiries.size()) {
+        SurfaceSensitivities invalid;
+        invalid.value = invalid.spot = invalid.interestRate = NOT_A_VALUE;
+        invalid.surface = SurfaceParams{NOT_A_VALUE, NOT_A_VALUE, NOT_A_VALUE, NOT_A_VALUE};
+        return invalid;
+    }
+    Real spot = Real::variable(market.spot, tape);
+    Real rate = Real::variable(market.interestRate, tape);
+    std::vector<SmileInputs<Real>> smiles;
+    for (const SmileParams& smile : smileParams) {
+        smiles.push_back(SmileInputs<Real>{
+            Real::variable(smile.atmVol, tape), Real::variable(smile.skew, tape),
+            Real::variable(smile.convexity, tape)});
+    }
+    return sweep(portfolio, market, smiles, spot, rate, tape);
+}
+
+double AadRisk::portfolioValue(
+    const omm::core::models::Portfolio& portfolio,
+    const omm::core::models::Market& market,
+    const SurfaceParams& params
+) {
+    std::vector<SmileInputs<double>> smiles;
+    for (double expiry : market.volSurface->expiries) {
+        smiles.push_back(SmileInputs<double>{
+            termStructureAtmVol(expiry, params.atmOneMonthVolEst, params.volMean), params.skew, params.convexity});
+    }
+    return BookValuation<double>(market, smiles).value(portfolio, market.spot, market.interestRate);
+}
+
+double AadRisk::portfolioValue(
+    const omm::core::models::Portfolio& portfolio,
+    const omm::core::models::Market& market,
+    const std::vector<SmileParams>& smileParams
+) {
+    if (smileParams.size() != market.volSurface->expiries.size()) return NOT_A_VALUE;
+    std::vector<SmileInputs<double>> smiles;
+    for (const SmileParams& smile : smileParams) {
+        smiles.push_back(SmileInputs<double>{smile.atmVol, smile.skew, smile.convexity});
+    }
+    return BookValuation<double>(market, smiles).value(portfolio, market.spot, market.interestRate);
+}
+
+}  // namespace omm::core::workers
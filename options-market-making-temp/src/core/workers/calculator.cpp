@@ -1,6 +1,9 @@
 #include "core/workers/calculator.hpp"
 #include "core/utils.hpp"
+#include "core/vecmath.hpp"
 #include <cmath>
+#include <algorithm>
+#include <utility>
 
 namespace omm::core::workers {
 
@@ -17,8 +20,160 @@ static double normPdf(double x) {
     return std::exp(-0.5 * x * x) / SQRT_2PI;
 }
 
+namespace {
+
+// Batch pricers work in fixed-size blocks so per-strike scratch lives on the stack
+constexpr std::size_t BATCH_BLOCK = 64;
+
+// Quantities shared by every strike of one expiry
+struct ExpiryInputs {
+    double expiry = -1.0;
+    double tte = 0.0;
+    double forward = 0.0;
+    double sqrtTte = 0.0;
+    double df = 0.0;
+    double atmVol = 0.0;
+};
+
+// Black-Scholes inputs for one block of a batch
+struct BlockInputs {
+    double strike[BATCH_BLOCK];
+    double forward[BATCH_BLOCK];
+    double sigma[BATCH_BLOCK];
+    double sqrtTte[BATCH_BLOCK];
+    double df[BATCH_BLOCK];
+    double d1[BATCH_BLOCK];
+    double d2[BATCH_BLOCK];
+    double pdfD1[BATCH_BLOCK];
+};
+
+// Prices and Greeks for one block of a batch
+struct BlockOutputs {
+    double price[BATCH_BLOCK];
+    double delta[BATCH_BLOCK];
+    double gamma[BATCH_BLOCK];
+    double vega[BATCH_BLOCK];
+    double theta[BATCH_BLOCK];
+};
+
+// Same model as Calculator::getOptionPricerInputs. The per-expiry terms (forward,
+// discount factor, ATM vol) are computed once per run of equal expiries; the vol
+// lookup stays scalar and log / normPdf run through VecMath over the whole block.
+// Surface is VolSurface or FrozenVolSurface.
+template <typename Surface>
+void fillBlockInputs(
+    const double* strikes,
+    const double* expiries,
+    std::size_t count,
+    const omm::core::models::Market& market,
+    const Surface& volSurface,
+    ExpiryInputs& cache,
+    BlockInputs& inputs
+) {
+    // VecMath inputs are value-initialized: the compiler cannot see that the kernels
+    // read only the count entries written
+    double moneyness[BATCH_BLOCK] = {};
+    double halfVarTte[BATCH_BLOCK];
+    
+    for (std::size_t i = 0; i < count; ++i) {
+        double expiry = expiries[i];
+        if (expiry != cache.expiry) {
+            cache.expiry = expiry;
+            cache.tte = expiry / 365.0;
+            cache.forward = market.spot * std::exp(market.interestRate * cache.tte);
+            cache.sqrtTte = std::sqrt(cache.tte);
+            cache.df = std::exp(-market.interestRate * cache.tte);
+            cache.atmVol = volSurface.getAtmVol(expiry);
+        }
+        
+        double strike = strikes[i];
+        double normStrike = Utils::getNormStrike(strike, cache.forward, expiry, cache.atmVol);
+        double sigma = volSurface.getVolNormStrike(normStrike, expiry);
+        
+        inputs.strike[i] = strike;
+        inputs.forward[i] = cache.forward;
+        inputs.sigma[i] = sigma;
+        inputs.sqrtTte[i] = cache.sqrtTte;
+        inputs.df[i] = cache.df;
+        moneyness[i] = cache.forward / strike;
+        halfVarTte[i] = 0.5 * sigma * sigma * cache.tte;
+    }
+    
+    double logMoneyness[BATCH_BLOCK];
+    VecMath::log(moneyness, logMoneyness, count);
+    
+    for (std::size_t i = 0; i < count; ++i) {
+        double sigmaSqrtTte = inputs.sigma[i] * inputs.sqrtTte[i];
+        inputs.d1[i] = (logMoneyness[i] + halfVarTte[i]) / sigmaSqrtTte;
+        inputs.d2[i] = inputs.d1[i] - sigmaSqrtTte;
+    }
+    
+    VecMath::normPdf(inputs.d1, inputs.pdfD1, count);
+}
+
+// Gamma, vega and the time part of theta (shared by calls and puts)
+void fillCommonGreeks(const BlockInputs& inputs, std::size_t count, BlockOutputs& outputs) {
+    for (std::size_t i = 0; i < count; ++i) {
+        double df = inputs.df[i];
+        double forward = inputs.forward[i];
+        double pdf = inputs.pdfD1[i];
+        outputs.gamma[i] = df * pdf / (forward * inputs.sigma[i] * inputs.sqrtTte[i]);
+        outputs.vega[i] = df * forward * pdf * inputs.sqrtTte[i];
+        outputs.theta[i] = -df * forward * pdf * inputs.sigma[i] / (2.0 * inputs.sqrtTte[i]);
+    }
+}
+
+// Price, delta and theta carry given sign = +1 (call) or -1 (put):
+// N(sign d1), N(sign d2) turn both payoffs into sign * df * (F N1 - K N2)
+void fillSignedGreeks(
+    const BlockInputs& inputs,
+    const double* sign,
+    std::size_t count,
+    double rate,
+    BlockOutputs& outputs
+) {
+    double x1[BATCH_BLOCK] = {};
+    double x2[BATCH_BLOCK] = {};
+    for (std::size_t i = 0; i < count; ++i) {
+        x1[i] = sign[i] * inputs.d1[i];
+        x2[i] = sign[i] * inputs.d2[i];
+    }
+    
+    double cdf1[BATCH_BLOCK];
+    double cdf2[BATCH_BLOCK];
+    VecMath::normCdf(x1, cdf1, count);
+    VecMath::normCdf(x2, cdf2, count);
+    
+    for (std::size_t i = 0; i < count; ++i) {
+        double signedDf = sign[i] * inputs.df[i];
+        outputs.price[i] = signedDf * (inputs.forward[i] * cdf1[i] - inputs.strike[i] * cdf2[i]);
+        outputs.delta[i] = signedDf * cdf1[i];
+        outputs.theta[i] -= rate * signedDf * inputs.forward[i] * cdf1[i];
+    }
+}
+
+void copyOut(const double* src, double* dst, std::size_t count) {
+    if (dst) std::copy(src, src + count, dst);
+}
+
+void storeBlock(
+    const BlockInputs& inputs,
+    const BlockOutputs& outputs,
+    std::size_t count,
+    const OptionBatchResult& result,
+    std::size_t offset
+) {
+    copyOut(inputs.sigma, result.vols ? result.vols + offset : nullptr, count);
+    copyOut(outputs.price, result.prices ? result.prices + offset : nullptr, count);
+    copyOut(outputs.delta, result.deltas ? result.deltas + offset : nullptr, count);
+    copyOut(outputs.gamma, result.gammas ? result.gammas + offset : nullptr, count);
+    copyOut(outputs.vega, result.vegas ? result.vegas + offset : nullptr, count);
+    copyOut(outputs.theta, result.thetas ? result.thetas + offset : nullptr, count);
+}
+
+}  // namespace
+
 double Calculator::priceFuture(const omm::core::models::Future& future, const omm::core::models::Market& market) {
-    double tte = std::stod(future.expiry) / 365.0;
     return Utils::getForwardPrice(market.spot, market.interestRate, std::stod(future.expiry));
 }
 
@@ -75,6 +230,295 @@ omm::core::models::Risk Calculator::calculateRisk(
     return omm::core::models::Risk(delta, gamma, vega, theta);
 }
 
+namespace {
+
+template <typename Surface>
+void priceOptionBatchImpl(
+    const OptionBatch& batch,
+    const omm::core::models::Market& market,
+    const Surface& volSurface,
+    const OptionBatchResult& result
+) {
+    ExpiryInputs cache;
+    BlockInputs inputs;
+    BlockOutputs outputs;
+    double sign[BATCH_BLOCK];
+    
+    for (std::size_t begin = 0; begin < batch.size; begin += BATCH_BLOCK) {
+        std::size_t count = std::min(BATCH_BLOCK, batch.size - begin);
+        fillBlockInputs(batch.strikes + begin, batch.expiries + begin, count, market, volSurface, cache, inputs);
+        
+        for (std::size_t i = 0; i < count; ++i) {
+            sign[i] = batch.optionTypes[begin + i] == omm::core::models::OptionType::CALL ? 1.0 : -1.0;
+        }
+        fillCommonGreeks(inputs, count, outputs);
+        fillSignedGreeks(inputs, sign, count, market.interestRate, outputs);
+        storeBlock(inputs, outputs, count, result, begin);
+    }
+}
+
+template <typename Surface>
+void priceOptionChainImpl(
+    const OptionChainBatch& chain,
+    const omm::core::models::Market& market,
+    const Surface& volSurface,
+    const OptionBatchResult& calls,
+    const OptionBatchResult& puts
+) {
+    ExpiryInputs cache;
+    BlockInputs inputs;
+    BlockOutputs common;
+    BlockOutputs outputs;
+    double callSign[BATCH_BLOCK];
+    double putSign[BATCH_BLOCK];
+    std::fill(callSign, callSign + BATCH_BLOCK, 1.0);
+    std::fill(putSign, putSign + BATCH_BLOCK, -1.0);
+    
+    for (std::size_t begin = 0; begin < chain.size; begin += BATCH_BLOCK) {
+        std::size_t count = std::min(BATCH_BLOCK, chain.size - begin);
+        fillBlockInputs(chain.strikes + begin, chain.expiries + begin, count, market, volSurface, cache, inputs);
+        
+        // Gamma, vega and the time part of theta are shared by the call and the put
+        fillCommonGreeks(inputs, count, common);
+        
+        outputs = common;
+        fillSignedGreeks(inputs, callSign, count, market.interestRate, outputs);
+        storeBlock(inputs, outputs, count, calls, begin);
+        
+        outputs = common;
+        fillSignedGreeks(inputs, putSign, count, market.interestRate, outputs);
+        storeBlock(inputs, outputs, count, puts, begin);
+    }
+}
+
+// Terms of one Portfolio bucket computed once per call. With log(K) stored per leg,
+// a leg's norm strike and d1 need no log, so the per-leg work is one vol lookup, one
+// exp (pdf) and one erf (cdf); prices are not needed for risk.
+struct BucketInputs {
+    double tte;
+    double sqrtTte;
+    double forward;
+    double logForward;
+    double df;
+    double invNormScale;  // 1 / (atmVol * sqrt(tte))
+};
+
+// Weighted Greeks of one block of a bucket, with the legs' norm strikes
+struct BlockRisk {
+    double normStrike[BATCH_BLOCK];
+    double delta[BATCH_BLOCK];
+    double gamma[BATCH_BLOCK];
+    double vega[BATCH_BLOCK];
+    double theta[BATCH_BLOCK];
+};
+
+template <typename Surface>
+BucketInputs getBucketInputs(double expiry, const omm::core::models::Market& market, const Surface& volSurface) {
+    BucketInputs inputs;
+    inputs.tte = expiry / 365.0;
+    inputs.sqrtTte = std::sqrt(inputs.tte);
+    inputs.forward = market.spot * std::exp(market.interestRate * inputs.tte);
+    inputs.logForward = std::log(inputs.forward);
+    inputs.df = std::exp(-market.interestRate * inputs.tte);
+    inputs.invNormScale = 1.0 / (volSurface.getAtmVol(expiry) * inputs.sqrtTte);
+    return inputs;
+}
+
+// Vols of n norm strikes of one expiry; the frozen surface locates the expiry once
+void lookupVols(const omm::core::models::VolSurface& volSurface, const double* normStrikes,
+                double expiry, double* vols, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) vols[i] = volSurface.getVolNormStrike(normStrikes[i], expiry);
+}
+
+void lookupVols(const omm::core::models::FrozenVolSurface& volSurface, const double* normStrikes,
+                double expiry, double* vols, std::size_t n) {
+    volSurface.getVolsNormStrike(normStrikes, expiry, vols, n);
+}
+
+template <typename Surface>
+void fillBlockRisk(
+    const omm::core::models::OptionBucket& bucket,
+    std::size_t begin,
+    std::size_t count,
+    const BucketInputs& in,
+    double rate,
+    const Surface& volSurface,
+    BlockRisk& out
+) {
+    // Norm strike log(K / F) / (atmVol sqrt(tte)) from the stored log(K)
+    for (std::size_t i = 0; i < count; ++i) {
+        out.normStrike[i] = (bucket.logStrikes[begin + i] - in.logForward) * in.invNormScale;
+    }
+    double sigma[BATCH_BLOCK];
+    lookupVols(volSurface, out.normStrike, bucket.expiry, sigma, count);
+    
+    double d1[BATCH_BLOCK] = {};
+    double signedD1[BATCH_BLOCK] = {};
+    double sign[BATCH_BLOCK];
+    for (std::size_t i = 0; i < count; ++i) {
+        double logMoneyness = bucket.logStrikes[begin + i] - in.logForward;  // log(K / F)
+        double sigmaSqrtTte = sigma[i] * in.sqrtTte;
+        d1[i] = (-logMoneyness + 0.5 * sigma[i] * sigma[i] * in.tte) / sigmaSqrtTte;
+        sign[i] = bucket.optionTypes[begin + i] == omm::core::models::OptionType::CALL ? 1.0 : -1.0;
+        signedD1[i] = sign[i] * d1[i];
+    }
+    
+    double pdf[BATCH_BLOCK];
+    double cdf[BATCH_BLOCK];
+    VecMath::normPdf(d1, pdf, count);
+    VecMath::normCdf(signedD1, cdf, count);
+    
+    const double* weights = bucket.weights.data() + begin;
+    for (std::size_t i = 0; i < count; ++i) {
+        double w = weights[i];
+        double signedDf = sign[i] * in.df;
+        double dfForwardPdf = in.df * in.forward * pdf[i];
+        out.delta[i] = w * signedDf * cdf[i];
+        out.gamma[i] = w * in.df * pdf[i] / (in.forward * sigma[i] * in.sqrtTte);
+        out.vega[i] = w * dfForwardPdf * in.sqrtTte;
+        out.theta[i] = w * (-dfForwardPdf * sigma[i] / (2.0 * in.sqrtTte) - rate * signedDf * in.forward * cdf[i]);
+    }
+}
+
+// Per-expiry and total Greeks; with ladder rows given (numBuckets per expiry), vega
+// and gamma are also summed by norm-strike bucket
+template <typename Surface>
+void accumulateRisk(
+    const omm::core::models::Portfolio& portfolio,
+    const omm::core::models::Market& market,
+    const Surface& volSurface,
+    std::vector<omm::core::models::ExpiryRisk>& byExpiry,
+    omm::core::models::Risk& total,
+    const omm::core::models::RiskLadderSpec* spec = nullptr,
+    double* vegaLadder = nullptr,
+    double* gammaLadder = nullptr
+) {
+    BlockRisk block;
+    byExpiry.clear();
+    byExpiry.reserve(portfolio.optionBuckets.size());
+    
+    for (std::size_t b = 0; b < portfolio.optionBuckets.size(); ++b) {
+        const auto& bucket = portfolio.optionBuckets[b];
+        BucketInputs inputs = getBucketInputs(bucket.expiry, market, volSurface);
+        double delta = 0.0, gamma = 0.0, vega = 0.0, theta = 0.0;
+        
+        for (std::size_t begin = 0; begin < bucket.size(); begin += BATCH_BLOCK) {
+            std::size_t count = std::min(BATCH_BLOCK, bucket.size() - begin);
+            fillBlockRisk(bucket, begin, count, inputs, market.interestRate, volSurface, block);
+            for (std::size_t i = 0; i < count; ++i) {
+                delta += block.delta[i];
+                gamma += block.gamma[i];
+                vega += block.vega[i];
+                theta += block.theta[i];
+            }
+            
+            if (spec) {
+                double invWidth = spec->numBuckets / (spec->maxNormStrike - spec->minNormStrike);
+                double lastBucket = static_cast<double>(spec->numBuckets - 1);
+                double* vegaRow = vegaLadder + b * spec->numBuckets;
+                double* gammaRow = gammaLadder + b * spec->numBuckets;
+                for (std::size_t i = 0; i < count; ++i) {
+                    // NaN (a leg without a norm strike) lands in the first bucket
+                    double pos = (block.normStrike[i] - spec->minNormStrike) * invWidth;
+                    std::size_t k = pos > 0.0 ? static_cast<std::size_t>(std::min(pos, lastBucket)) : 0;
+                    vegaRow[k] += block.vega[i];
+                    gammaRow[k] += block.gamma[i];
+                }
+            }
+        }
+        
+        byExpiry.push_back({bucket.expiry, omm::core::models::Risk(delta, gamma, vega, theta)});
+        total.delta += delta;
+        total.gamma += gamma;
+        total.vega += vega;
+        total.theta += theta;
+    }
+    
+    // Futures carry delta only
+    for (double weight : portfolio.futureWeights) {
+        total.delta += weight;
+    }
+}
+
+template <typename Surface>
+omm::core::models::PortfolioRisk portfolioRiskImpl(
+    const omm::core::models::Portfolio& portfolio,
+    const omm::core::models::Market& market,
+    const Surface& volSurface
+) {
+    omm::core::models::PortfolioRisk result;
+    accumulateRisk(portfolio, market, volSurface, result.byExpiry, result.total);
+    return result;
+}
+
+template <typename Surface>
+omm::core::models::RiskLadder riskLadderImpl(
+    const omm::core::models::Portfolio& portfolio,
+    const omm::core::models::Market& market,
+    const Surface& volSurface,
+    const omm::core::models::RiskLadderSpec& spec
+) {
+    omm::core::models::RiskLadder ladder;
+    ladder.spec = spec;
+    ladder.spec.numBuckets = std::max<std::size_t>(1, spec.numBuckets);
+    
+    // A reversed range is swapped and an empty one widened to one unit, so bucket
+    // widths are finite and positive; non-finite bounds fall back to the defaults
+    omm::core::models::RiskLadderSpec& used = ladder.spec;
+    if (!std::isfinite(used.minNormStrike) || !std::isfinite(used.maxNormStrike)) {
+        used.minNormStrike = omm::core::models::RiskLadderSpec().minNormStrike;
+        used.maxNormStrike = omm::core::models::RiskLadderSpec().maxNormStrike;
+    }
+    if (used.minNormStrike > used.maxNormStrike) std::swap(used.minNormStrike, used.maxNormStrike);
+    if (used.minNormStrike == used.maxNormStrike) {
+        used.minNormStrike -= 0.5;
+        used.maxNormStrike += 0.5;
+    }
+    ladder.vega.assign(portfolio.optionBuckets.size() * ladder.spec.numBuckets, 0.0);
+    ladder.gamma.assign(portfolio.optionBuckets.size() * ladder.spec.numBuckets, 0.0);
+    accumulateRisk(portfolio, market, volSurface, ladder.byExpiry, ladder.total,
+                   &ladder.spec, ladder.vega.data(), ladder.gamma.data());
+    return ladder;
+}
+
+}  // namespace
+
+void Calculator::priceOptionBatch(
+    const OptionBatch& batch,
+    const omm::core::models::Market& market,
+    const OptionBatchResult& result
+) {
+    priceOptionBatchImpl(batch, market, *market.volSurface, result);
+}
+
+void Calculator::priceOptionBatch(
+    const OptionBatch& batch,
+    const omm::core::models::Market& market,
+    const omm::core::models::FrozenVolSurface& volSurface,
+    const OptionBatchResult& result
+) {
+    priceOptionBatchImpl(batch, market, volSurface, result);
+}
+
+void Calculator::priceOptionChain(
+    const OptionChainBatch& chain,
+    const omm::core::models::Market& market,
+    const OptionBatchResult& calls,
+    const OptionBatchResult& puts
+) {
+    priceOptionChainImpl(chain, market, *market.volSurface, calls, puts);
+}
+
+void Calculator::priceOptionChain(
+    const OptionChainBatch& chain,
+    const omm::core::models::Market& market,
+    const omm::core::models::FrozenVolSurface& volSurface,
+    const OptionBatchResult& calls,
+    const OptionBatchResult& puts
+) {
+    priceOptionChainImpl(chain, market, volSurface, calls, puts);
+}
+
 omm::core::models::Risk Calculator::calculatePortfolioRisk(
     const std::vector<std::shared_ptr<omm::core::models::Security>>& positions,
     const omm::core::models::Market& market
@@ -106,6 +550,45 @@ omm::core::models::Risk Calculator::calculatePortfolioRisk(
     return omm::core::models::Risk(totalDelta, totalGamma, totalVega, totalTheta);
 }
 
+omm::core::models::Risk Calculator::calculatePortfolioRisk(
+    const std::vector<omm::core::models::Position>& positions,
+    const omm::core::models::Market& market
+) {
+    return calculatePortfolioRisk(omm::core::models::Portfolio::fromPositions(positions), market).total;
+}
+
+omm::core::models::PortfolioRisk Calculator::calculatePortfolioRisk(
+    const omm::core::models::Portfolio& portfolio,
+    const omm::core::models::Market& market
+) {
+    return portfolioRiskImpl(portfolio, market, *market.volSurface);
+}
+
+omm::core::models::PortfolioRisk Calculator::calculatePortfolioRisk(
+    const omm::core::models::Portfolio& portfolio,
+    const omm::core::models::Market& market,
+    const omm::core::models::FrozenVolSurface& volSurface
+) {
+    return portfolioRiskImpl(portfolio, market, volSurface);
+}
+
+omm::core::models::RiskLadder Calculator::calculateRiskLadder(
+    const omm::core::models::Portfolio& portfolio,
+    const omm::core::models::Market& market,
+    const omm::core::models::RiskLadderSpec& spec
+) {
+    return riskLadderImpl(portfolio, market, *market.volSurface, spec);
+}
+
+omm::core::models::RiskLadder Calculator::calculateRiskLadder(
+    const omm::core::models::Portfolio& portfolio,
+    const omm::core::models::Market& market,
+    const omm::core::models::FrozenVolSurface& volSurface,
+    const omm::core::models::RiskLadderSpec& spec
+) {
+    return riskLadderImpl(portfolio, market, volSurface, spec);
+}
+
 double Calculator::getForwardStrike(const omm::core::models::Market& market, double strike, double expiry) {
     double tte = expiry / 365.0;
     return strike * std::exp(market.interestRate * tte);
@@ -0,0 +1,283 @@
+#include "core/workers/impliedvol.hpp"
+#include "core/vecmath.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace omm::core::workers {
+
+namespace {
+
+constexpr std::size_t SOLVER_BLOCK = 64;
+constexpr double INV_SQRT_2PI = 0.39894228040143267794;
+constexpr double SQRT_2PI = 2.50662827463100050241;
+constexpr double PRICE_TOLERANCE = 1e-12;  // normalized time value under zero still taken as zero
+constexpr double STEP_TOLERANCE = 1e-13;   // relative step in s that ends the iteration
+constexpr double CDF_NOISE = 1e-15;        // VecMath::normCdf is only accurate to 2.3e-16 absolute in the left tail
+constexpr double NO_UPPER_BOUND = std::numeric_limits<double>::infinity();
+constexpr double NOT_A_VOL = std::numeric_limits<double>::quiet_NaN();
+
+// Forward terms shared by every quote of one expiry
+struct ExpiryTerms {
+    double expiry = -1.0;
+    double sqrtTte = 0.0;
+    double forward = 0.0;
+    double df = 0.0;
+};
+
+// Normalized problems of the quotes still iterating, packed to the front
+struct SolverState {
+    std::uint32_t index[SOLVER_BLOCK];  // position in the block
+    double x[SOLVER_BLOCK];             // -|log(F / K)|
+    double expHalfX[SOLVER_BLOCK];
+    double expMinusHalfX[SOLVER_BLOCK];
+    double target[SOLVER_BLOCK];        // log b (lower branch) or log(b_max - b) (upper)
+    double s[SOLVER_BLOCK];
+    double lo[SOLVER_BLOCK];
+    double hi[SOLVER_BLOCK];
+    double sqrtTte[SOLVER_BLOCK];
+    bool lower[SOLVER_BLOCK];
+    std::size_t size = 0;
+};
+
+void setResult(const ImpliedVolResult& result, std::size_t i, double vol, ImpliedVolStatus status) {
+    result.vols[i] = vol;
+    if (result.statuses) result.statuses[i] = status;
+}
+
+// Reduce quotes [begin, begin + count) to normalized problems; settle those with no
+// vol to find (invalid, out of bounds or zero time value)
+void prepareBlock(
+    const ImpliedVolBatch& batch,
+    std::size_t begin,
+    std::size_t count,
+    const omm::core::models::Market& market,
+    ExpiryTerms& cache,
+    const ImpliedVolResult& result,
+    SolverState& state
+) {
+    double moneyness[SOLVER_BLOCK];
+    double timeValue[SOLVER_BLOCK];
+    double sqrtTte[SOLVER_BLOCK];
+    double sqrtFK[SOLVER_BLOCK];
+    bool valid[SOLVER_BLOCK];
+    
+    for (std::size_t i = 0; i < count; ++i) {
+        std::size_t q = begin + i;
+        double price = batch.prices[q];
+        double strike = batch.strikes[q];
+        double expiry = batch.expiries[q];
+        valid[i] = std::isfinite(price) && strike > 0.0 && expiry > 0.0;
+        if (!valid[i]) {
+            moneyness[i] = 1.0;
+            continue;
+        }
+        if (expiry != cache.expiry) {
+            double tte = expiry / 365.0;
+            cache.expiry = expiry;
+            cache.sqrtTte = std::sqrt(tte);
+            cache.forward = market.spot * std::exp(market.interestRate * tte);
+            cache.df = std::exp(-market.interestRate * tte);
+        }
+        double forward = cache.forward;
+        double intrinsic = batch.optionTypes[q] == omm::core::models::OptionType::CALL
+                               ? std::max(forward - strike, 0.0)
+                               : std::max(strike - forward, 0.0);
+        moneyness[i] = forward / strike;
+        timeValue[i] = price / cache.df - intrinsic;
+        sqrtTte[i] = cache.sqrtTte;
+        sqrtFK[i] = std::sqrt(forward * strike);
+    }
+    
+    double logMoneyness[SOLVER_BLOCK];
+    double halfX[SOLVER_BLOCK];
+    double expHalfX[SOLVER_BLOCK];
+    VecMath::log(moneyness, logMoneyness, count);
+    for (std::size_t i = 0; i < count; ++i) {
+        halfX[i] = -0.5 * std::abs(logMoneyness[i]);
+    }
+    VecMath::exp(halfX, expHalfX, count);
+    
+    // Survivors, with the normalized price at the inflection point s_c: there
+    // d1 = 0 and d2 = -s_c, so b(x, s_c) = e^(x/2) / 2 - e^(-x/2) N(-s_c)
+    double beta[SOLVER_BLOCK];
+    double minusSc[SOLVER_BLOCK];
+    state.size = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!valid[i]) {
+            setResult(result, begin + i, NOT_A_VOL, ImpliedVolStatus::INVALID_INPUT);
+            continue;
+        }
+        double b = timeValue[i] / sqrtFK[i];
+        double bMax = expHalfX[i];
+        if (b < -PRICE_TOLERANCE) {
+            setResult(result, begin + i, NOT_A_VOL, ImpliedVolStatus::BELOW_INTRINSIC);
+        } else if (b <= 0.0) {
+            setResult(result, begin + i, 0.0, ImpliedVolStatus::OK);
+        } else if (b >= bMax) {
+            setResult(result, begin + i, NOT_A_VOL, ImpliedVolStatus::ABOVE_MAXIMUM);
+        } else {
+            std::size_t k = state.size++;
+            state.index[k] = static_cast<std::uint32_t>(i);
+            state.x[k] = 2.0 * halfX[i];
+            state.expHalfX[k] = bMax;
+            state.expMinusHalfX[k] = 1.0 / bMax;
+            state.sqrtTte[k] = sqrtTte[i];
+            beta[k] = b;
+            minusSc[k] = -std::sqrt(-state.x[k] * 2.0);
+        }
+    }
+    
+    std::size_t n = state.size;
+    double cdfMinusSc[SOLVER_BLOCK];
+    VecMath::normCdf(minusSc, cdfMinusSc, n);
+    
+    double targetArg[SOLVER_BLOCK];
+    for (std::size_t k = 0; k < n; ++k) {
+        double sc = -minusSc[k];
+        double bc = 0.5 * state.expHalfX[k] - state.expMinusHalfX[k] * cdfMinusSc[k];
+        state.lower[k] = beta[k] < bc;
+        targetArg[k] = state.lower[k] ? beta[k] : state.expHalfX[k] - beta[k];
+        state.lo[k] = state.lower[k] ? 0.0 : sc;
+        state.hi[k] = state.lower[k] ? sc : NO_UPPER_BOUND;
+    }
+    VecMath::log(targetArg, state.target, n);
+    
+    // Lower branch: log b ~ -x^2 / (2 s^2) for small s; upper: the ATM slope
+    for (std::size_t k = 0; k < n; ++k) {
+        if (state.lower[k]) {
+            double guess = -state.x[k] / std::sqrt(-2.0 * state.target[k]);
+            state.s[k] = std::min(guess, state.hi[k]);
+        } else {
+            state.s[k] = std::max(state.lo[k], SQRT_2PI * beta[k]);
+        }
+    }
+}
+
+// Householder iterations over the packed problems until each has converged
+void iterate(std::size_t begin, const ImpliedVolResult& result, SolverState& state) {
+    double y1[SOLVER_BLOCK];
+    double d2[SOLVER_BLOCK];
+    double halfExponent[SOLVER_BLOCK];
+    double cdf1[SOLVER_BLOCK];
+    double cdf2[SOLVER_BLOCK];
+    double gaussian[SOLVER_BLOCK];
+    double value[SOLVER_BLOCK];
+    double logValue[SOLVER_BLOCK];
+    
+    for (int iteration = 1; state.size > 0; ++iteration) {
+        std::size_t n = state.size;
+        for (std::size_t k = 0; k < n; ++k) {
+            double s = state.s[k];
+            double xOverS = state.x[k] / s;
+            double d1 = xOverS + 0.5 * s;
+            y1[k] = state.lower[k] ? d1 : -d1;
+            d2[k] = xOverS - 0.5 * s;
+            halfExponent[k] = -0.5 * (xOverS * xOverS + 0.25 * s * s);
+        }
+        VecMath::normCdf(y1, cdf1, n);
+        VecMath::normCdf(d2, cdf2, n);
+        VecMath::exp(halfExponent, gaussian, n);
+        
+        // b = e^(x/2) N(d1) - e^(-x/2) N(d2); b_max - b = e^(x/2) N(-d1) + e^(-x/2) N(d2)
+        for (std::size_t k = 0; k < n; ++k) {
+            double sign = state.lower[k] ? -1.0 : 1.0;
+            value[k] = state.expHalfX[k] * cdf1[k] + sign * state.expMinusHalfX[k] * cdf2[k];
+        }
+        VecMath::log(value, logValue, n);
+        
+        std::size_t kept = 0;
+        for (std::size_t k = 0; k < n; ++k) {
+            double s = state.s[k];
+            double x = state.x[k];
+            bool lower = state.lower[k];
+            double g = logValue[k] - state.target[k];
+            
+            // Deep in the wings the cdf terms are small and their absolute error shows in
+            // g; once g is down to that noise the iterate is as good as it gets
+            double noise = CDF_NOISE * (state.expHalfX[k] + state.expMinusHalfX[k]) / value[k];
+            
+            double next;
+            bool done = std::abs(g) <= noise;
+            if (!done) {
+                // log b rises with s, log(b_max - b) falls
+                bool tooHigh = lower ? g > 0.0 : g < 0.0;
+                if (tooHigh) {
+                    state.hi[k] = s;
+                } else {
+                    state.lo[k] = s;
+                }
+                
+                // Derivatives of b in s: b' = vega, b'' / b' = h2, b''' / b' = h3
+                double vega = INV_SQRT_2PI * gaussian[k];
+                double xx = x * x;
+                double h2 = xx / (s * s * s) - 0.25 * s;
+                double h3 = h2 * h2 - 3.0 * xx / (s * s * s * s) - 0.25;
+                double r = (lower ? vega : -vega) / value[k];
+                double nu = -g / r;
+                double g2 = h2 - r;
+                double g3 = h3 - 3.0 * r * h2 + 2.0 * r * r;
+                next = s + nu * (1.0 + 0.5 * g2 * nu) / (1.0 + nu * (g2 + g3 * nu / 6.0));
+                
+                if (!(next >= state.lo[k] && next <= state.hi[k])) {
+                    next = state.hi[k] < NO_UPPER_BOUND ? 0.5 * (state.lo[k] + state.hi[k]) : 2.0 * s;
+                }
+                done = std::abs(next - s) <= STEP_TOLERANCE * s;
+            } else {
+                next = s;
+            }
+            
+            if (done || iteration == ImpliedVolSolver::MAX_ITERATIONS) {
+                setResult(result, begin + state.index[k], next / state.sqrtTte[k],
+                          done ? ImpliedVolStatus::OK : ImpliedVolStatus::NOT_CONVERGED);
+                continue;
+            }
+            
+            state.index[kept] = state.index[k];
+            state.x[kept] = x;
+            state.expHalfX[kept] = state.expHalfX[k];
+            state.expMinusHalfX[kept] = state.expMinusHalfX[k];
+            state.target[kept] = state.target[k];
+            state.s[kept] = next;
+            state.lo[kept] = state.lo[k];
+            state.hi[kept] = state.hi[k];
+            state.sqrtTte[kept] = state.sqrtTte[k];
+            state.lower[kept] = lower;
+            ++kept;
+        }
+        state.size = kept;
+    }
+}
+
+}  // namespace
+
+double ImpliedVolSolver::impliedVol(
+    double price,
+    double strike,
+    double expiry,
+    omm::core::models::OptionType optionType,
+    const omm::core::models::Market& market,
+    ImpliedVolStatus* status
+) {
+    double vol;
+    ImpliedVolStatus solved;
+    impliedVolBatch(ImpliedVolBatch{&price, &strike, &expiry, &optionType, 1}, market, ImpliedVolResult{&vol, &solved});
+    if (status) *status = solved;
+    return vol;
+}
+
+void ImpliedVolSolver::impliedVolBatch(
+    const ImpliedVolBatch& batch,
+    const omm::core::models::Market& market,
+    const ImpliedVolResult& result
+) {
+    ExpiryTerms cache;
+    SolverState state;
+    for (std::size_t begin = 0; begin < batch.size; begin += SOLVER_BLOCK) {
+        std::size_t count = std::min(SOLVER_BLOCK, batch.size - begin);
+        prepareBlock(batch, begin, count, market, cache, result, state);
+        iterate(begin, result, state);
+    }
+}
+
+}  // namespace omm::core::workers
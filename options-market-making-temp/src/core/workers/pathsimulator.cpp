@@ -0,0 +1,265 @@
+#include "core/workers/pathsimulator.hpp"
+#include "core/config.hpp"
+#include "core/random.hpp"
+#include "core/threadpool.hpp"
+#include "core/vecmath.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace omm::core::workers {
+
+namespace {
+
+// Paths evolved together; the per-block scratch arrays stay in L1
+constexpr std::size_t PATH_BLOCK = 256;
+
+// Philox counter of one draw: (step, draw, path). A step takes two blocks of four
+// words: regime draw and u1 from the first, u2 from the second.
+inline Philox4x32::Counter drawCounter(std::size_t path, std::size_t step, std::uint32_t draw) {
+    std::uint64_t p = static_cast<std::uint64_t>(path);
+    return Philox4x32::Counter{{
+        static_cast<std::uint32_t>(step),
+        draw,
+        static_cast<std::uint32_t>(p),
+        static_cast<std::uint32_t>(p >> 32),
+    }};
+}
+
+// Per-regime step coefficients, in the operation order of Simulator::simulateNextState
+struct RegimeCoefficients {
+    double drift[3];         // -0.5 spotVol^2 dt
+    double diffusion[3];     // spotVol sqrt(dt)
+    double volKappa[3];
+    double volMean[3];
+    double volDiffusion[3];  // volOfVol sqrt(dt)
+    double rho[3];
+    double rhoPerp[3];       // sqrt(1 - rho^2)
+    double cumProb0[3];      // transition CDF of each regime
+    double cumProb1[3];
+    
+    RegimeCoefficients() {
+        double dt = static_cast<double>(Config::TIME_STEP) / 365.0;
+        for (int k = 0; k < 3; ++k) {
+            const auto& params = Simulator::getRegimeParams(static_cast<omm::core::models::Regime>(k));
+            drift[k] = -0.5 * params.spotVol * params.spotVol * dt;
+            diffusion[k] = params.spotVol * std::sqrt(dt);
+            volKappa[k] = params.volKappa;
+            volMean[k] = params.volMean;
+            volDiffusion[k] = params.volOfVol * std::sqrt(dt);
+            rho[k] = params.rho;
+            rhoPerp[k] = std::sqrt(1.0 - params.rho * params.rho);
+            cumProb0[k] = Config::REGIME_TRANSITION[k][0];
+            cumProb1[k] = Config::REGIME_TRANSITION[k][0] + Config::REGIME_TRANSITION[k][1];
+        }
+    }
+};
+
+// v[k] for a regime index k, written as selects so that per-path loops vectorize
+// without gathers
+inline double byRegime(const double (&v)[3], int k) {
+    return k == 0 ? v[0] : (k == 1 ? v[1] : v[2]);
+}
+
+// Scratch arrays of one block step
+struct BlockBuffers {
+    std::uint32_t words[2][4][PATH_BLOCK];  // Philox counters, then outputs
+    double regimeDraw[PATH_BLOCK];
+    double u1[PATH_BLOCK];
+    double u2[PATH_BLOCK];
+    double radius[PATH_BLOCK];
+    double cosine[PATH_BLOCK];
+    double sine[PATH_BLOCK];
+    double growth[PATH_BLOCK];
+    int regime[PATH_BLOCK];  // carried from step to step
+};
+
+// Draws of one step for a block: regime uniform, then the Box-Muller pair
+// z1 = r cos(2 pi u2), z2 = r sin(2 pi u2), r = sqrt(-2 log u1), u1 in (0, 1]
+void drawShocks(Philox4x32::Key key, std::size_t firstPath, std::size_t step, BlockBuffers& buf, std::size_t count) {
+    for (std::uint32_t draw = 0; draw < 2; ++draw) {
+        for (std::size_t i = 0; i < count; ++i) {
+            Philox4x32::Counter ctr = drawCounter(firstPath + i, step, draw);
+            buf.words[draw][0][i] = ctr.words[0];
+            buf.words[draw][1][i] = ctr.words[1];
+            buf.words[draw][2][i] = ctr.words[2];
+            buf.words[draw][3][i] = ctr.words[3];
+        }
+        Philox4x32::generate(buf.words[draw][0], buf.words[draw][1], buf.words[draw][2], buf.words[draw][3],
+                             count, key);
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        buf.regimeDraw[i] = Philox4x32::toUniform(buf.words[0][0][i], buf.words[0][1][i]);
+        buf.u1[i] = 1.0 - Philox4x32::toUniform(buf.words[0][2][i], buf.words[0][3][i]);
+        buf.u2[i] = 2.0 * Philox4x32::toUniform(buf.words[1][0][i], buf.words[1][1][i]);
+    }
+    
+    VecMath::log(buf.u1, buf.radius, count);
+    for (std::size_t i = 0; i < count; ++i) buf.radius[i] *= -2.0;
+    VecMath::sqrt(buf.radius, buf.radius, count);
+    VecMath::cosPi(buf.u2, buf.cosine, count);
+    VecMath::sinPi(buf.u2, buf.sine, count);
+}
+
+// Paths [first, first + count) over all steps; blocks write disjoint columns
+void simulateBlock(omm::core::models::MarketPaths& paths, omm::core::models::Regime initialRegime,
+                   std::size_t first, std::size_t count) {
+    static const RegimeCoefficients coeffs;
+    Philox4x32::Key key = Philox4x32::makeKey(paths.seed);
+    BlockBuffers buf;
+    std::fill(buf.regime, buf.regime + count, static_cast<int>(initialRegime));
+    
+    for (std::size_t t = 1; t <= paths.numSteps; ++t) {
+        std::size_t prev = paths.index(t - 1, first);
+        std::size_t cur = paths.index(t, first);
+        drawShocks(key, paths.firstPath + first, t, buf, count);
+        
+        // Regime transitions, as in Simulator::getNextRegime
+        for (std::size_t i = 0; i < count; ++i) {
+            int from = buf.regime[i];
+            double u = buf.regimeDraw[i];
+            buf.regime[i] = (u >= byRegime(coeffs.cumProb0, from)) + (u >= byRegime(coeffs.cumProb1, from));
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            paths.regimes[cur + i] = static_cast<omm::core::models::Regime>(buf.regime[i]);
+        }
+        
+        // Spot GBM exponent and vol OU step
+        double dt = static_cast<double>(Config::TIME_STEP) / 365.0;
+        const double* volPrev = paths.atmOneMonthVols.data() + prev;
+        double* volCur = paths.atmOneMonthVols.data() + cur;
+        for (std::size_t i = 0; i < count; ++i) {
+            int k = buf.regime[i];
+            double z1 = buf.radius[i] * buf.cosine[i];
+            double z2 = buf.radius[i] * buf.sine[i];
+            double zVol = byRegime(coeffs.rho, k) * z1 + byRegime(coeffs.rhoPerp, k) * z2;
+            buf.growth[i] = byRegime(coeffs.drift, k) + byRegime(coeffs.diffusion, k) * z1;
+            volCur[i] = volPrev[i] +
+                byRegime(coeffs.volKappa, k) * (byRegime(coeffs.volMean, k) - volPrev[i]) * dt +
+                byRegime(coeffs.volDiffusion, k) * zVol;
+        }
+        
+        VecMath::exp(buf.growth, buf.growth, count);
+        const double* spotPrev = paths.spots.data() + prev;
+        double* spotCur = paths.spots.data() + cur;
+        for (std::size_t i = 0; i < count; ++i) {
+            spotCur[i] = spotPrev[i] * buf.growth[i];
+        }
+    }
+}
+
+// Shared set-up: step 0 and the expiry schedule
+omm::core::models::MarketPaths initializePaths(
+    const omm::core::models::Market& market,
+    std::size_t numPaths,
+    std::size_t numSteps,
+    std::uint64_t seed,
+    std::size_t firstPath
+) {
+    omm::core::models::MarketPaths paths(numPaths, numSteps, seed);
+    paths.firstPath = firstPath;
+    paths.asset = market.asset;
+    paths.startTime = market.time;
+    paths.interestRate = market.interestRate;
+    paths.initialVolSurface = market.volSurface;
+    
+    // Expiries roll the same way on every path
+    paths.expiries.reserve(numSteps + 1);
+    paths.expiries.push_back(market.volSurface->expiries);
+    for (std::size_t t = 1; t <= numSteps; ++t) {
+        paths.expiries.push_back(Simulator::rollExpiries(paths.expiries.back()));
+    }
+    
+    std::fill(paths.regimes.begin(), paths.regimes.begin() + numPaths, market.regime);
+    std::fill(paths.spots.begin(), paths.spots.begin() + numPaths, market.spot);
+    std::fill(paths.atmOneMonthVols.begin(), paths.atmOneMonthVols.begin() + numPaths,
+              market.volSurface->atmOneMonthVolEst);
+    return paths;
+}
+
+}  // namespace
+
+omm::core::models::MarketPaths PathSimulator::simulatePaths(
+    const omm::core::models::Market& market,
+    std::size_t numPaths,
+    std::size_t numSteps,
+    std::uint64_t seed,
+    std::size_t firstPath
+) {
+    auto paths = initializePaths(market, numPaths, numSteps, seed, firstPath);
+    for (std::size_t first = 0; first < numPaths; first += PATH_BLOCK) {
+        simulateBlock(paths, market.regime, first, std::min(PATH_BLOCK, numPaths - first));
+    }
+    return paths;
+}
+
+omm::core::models::MarketPaths PathSimulator::simulatePaths(
+    const omm::core::models::Market& market,
+    std::size_t numPaths,
+    std::size_t numSteps,
+    std::uint64_t seed,
+    ThreadPool& pool,
+    std::size_t firstPath
+) {
+    auto paths = initializePaths(market, numPaths, numSteps, seed, firstPath);
+    std::size_t numBlocks = (numPaths + PATH_BLOCK - 1) / PATH_BLOCK;
+    pool.parallelFor(numBlocks, [&](std::size_t block) {
+        std::size_t first = block * PATH_BLOCK;
+        simulateBlock(paths, market.regime, first, std::min(PATH_BLOCK, numPaths - first));
+    });
+    return paths;
+}
+
+std::vector<MarketShock> PathSimulator::generateShocks(std::uint64_t seed, std::size_t path, std::size_t numSteps) {
+    constexpr double TWO_PI = 6.28318530717958647692;
+    Philox4x32::Key key = Philox4x32::makeKey(seed);
+    std::vector<MarketShock> shocks;
+    shocks.reserve(numSteps);
+    for (std::size_t t = 1; t <= numSteps; ++t) {
+        Philox4x32::Counter first = Philox4x32::generate(drawCounter(path, t, 0), key);
+        Philox4x32::Counter second = Philox4x32::generate(drawCounter(path, t, 1), key);
+        double regimeDraw = Philox4x32::toUniform(first.words[0], first.words[1]);
+        double u1 = 1.0 - Philox4x32::toUniform(first.words[2], first.words[3]);
+        double u2 = Philox4x32::toUniform(second.words[0], second.words[1]);
+        double radius = std::sqrt(-2.0 * std::log(u1));
+        shocks.push_back(MarketShock{regimeDraw, radius * std::cos(TWO_PI * u2), radius * std::sin(TWO_PI * u2)});
+    }
+    return shocks;
+}
+
+std::shared_ptr<omm::core::models::Market> PathSimulator::materializeMarket(
+    const omm::core::models::MarketPaths& paths,
+    std::size_t step,
+    std::size_t path
+) {
+    std::size_t idx = paths.index(step, path);
+    auto regime = paths.regimes[idx];
+    double spot = paths.spots[idx];
+    int time = paths.startTime + static_cast<int>(step) * Config::TIME_STEP;
+    
+    std::shared_ptr<omm::core::models::VolSurface> volSurface = paths.initialVolSurface;
+    if (step > 0) {
+        const auto& regimeParams = Simulator::getRegimeParams(regime);
+        volSurface = std::make_shared<omm::core::models::VolSurface>(
+            paths.expiries[step],
+            paths.atmOneMonthVols[idx],
+            regimeParams.skew,
+            regimeParams.convexity,
+            regimeParams.volMean,
+            spot,
+            paths.interestRate
+        );
+        // Under ArbitrageCheckMode::DEFERRED only surfaces that are actually used get checked
+        volSurface->ensureArbitrageChecked();
+    }
+    
+    return std::make_shared<omm::core::models::Market>(
+        paths.asset,
+        time,
+        spot,
+        volSurface,
+        paths.interestRate,
+        regime
+    );
+}
+
+}  // namespace omm::core::workers
@@ -0,0 +1,182 @@
+#include "core/workers/scenarioengine.hpp"
+#include "core/models/frozenvolsurface.hpp"
+#include "core/workers/calculator.hpp"
+#include "core/workers/simulator.hpp"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+
+namespace omm::core::workers {
+
+using omm::core::models::FrozenVolSurface;
+using omm::core::models::Market;
+using omm::core::models::Portfolio;
+using omm::core::models::Regime;
+
+namespace {
+
+constexpr std::size_t PRICE_CHUNK = 256;  // legs priced per batch call, on the stack
+constexpr double MIN_ATM_VOL = 0.01;      // floor of a shocked one-month ATM vol
+constexpr Regime REGIMES[] = {Regime::CALM, Regime::STRESS, Regime::EVENT};
+
+using ParallelFor = std::function<void(std::size_t, const std::function<void(std::size_t)>&)>;
+
+// Options through priceBatch(batch, result), futures at spot
+template <typename PriceBatch>
+double bookValue(const Portfolio& portfolio, double spot, const PriceBatch& priceBatch) {
+    double prices[PRICE_CHUNK];
+    double value = 0.0;
+    for (const auto& bucket : portfolio.optionBuckets) {
+        for (std::size_t first = 0; first < bucket.size(); first += PRICE_CHUNK) {
+            std::size_t count = std::min(PRICE_CHUNK, bucket.size() - first);
+            OptionBatch batch{bucket.strikes.data() + first, bucket.expiries.data() + first,
+                              bucket.optionTypes.data() + first, count};
+            priceBatch(batch, OptionBatchResult{prices, nullptr, nullptr, nullptr, nullptr});
+            for (std::size_t i = 0; i < count; ++i) value += bucket.weights[first + i] * prices[i];
+        }
+    }
+    for (double weight : portfolio.futureWeights) value += weight * spot;
+    return value;
+}
+
+// Surface of a regime around the shocked one-month ATM vol, as Simulator builds it
+FrozenVolSurface buildSurface(const Market& market, Regime regime, double volShock) {
+    const auto& regimeParams = Simulator::getRegimeParams(regime);
+    omm::core::models::VolSurface surface;
+    surface.rebuild(
+        market.volSurface->expiries,
+        std::max(market.volSurface->atmOneMonthVolEst + volShock, MIN_ATM_VOL),
+        regimeParams.skew,
+        regimeParams.convexity,
+        regimeParams.volMean,
+        market.spot,
+        market.interestRate
+    );
+    return surface.freeze();
+}
+
+void fillWorst(ScenarioResult& result, const ScenarioGridSpec& spec) {
+    std::vector<std::size_t> cells(result.pnl.size());
+    std::iota(cells.begin(), cells.end(), 0);
+    std::size_t count = std::min(spec.numWorst, cells.size());
+    std::partial_sort(cells.begin(), cells.begin() + count, cells.end(), [&](std::size_t a, std::size_t b) {
+        return result.pnl[a] < result.pnl[b];
+    });
+    result.worst.clear();
+    for (std::size_t k = 0; k < count; ++k) {
+        std::size_t spotIdx = cells[k] % result.numSpotShocks;
+        std::size_t volIdx = cells[k] / result.numSpotShocks;
+        result.worst.push_back(ScenarioCell{
+            spotIdx, volIdx, spec.spotShocks[spotIdx], spec.volShocks[volIdx], result.pnl[cells[k]]});
+    }
+}
+
+// Grids of several regimes: all surfaces in one parallel pass, then all cells in another
+std::vector<ScenarioResult> runScenarios(
+    const Portfolio& portfolio,
+    const Market& market,
+    const ScenarioGridSpec& spec,
+    const Regime* regimes,
+    std::size_t numRegimes,
+    const ParallelFor& parallelFor
+) {
+    std::size_t numSpot = spec.spotShocks.size();
+    std::size_t numVol = spec.volShocks.size();
+    std::size_t numCells = numSpot * numVol;
+    
+    std::vector<FrozenVolSurface> surfaces(numRegimes * numVol);
+    parallelFor(surfaces.size(), [&](std::size_t s) {
+        surfaces[s] = buildSurface(market, regimes[s / numVol], spec.volShocks[s % numVol]);
+    });
+    
+    std::vector<Market> spotMarkets(numSpot, market);
+    for (std::size_t i = 0; i < numSpot; ++i) spotMarkets[i].spot = market.spot * (1.0 + spec.spotShocks[i]);
+    
+    double baseValue = bookValue(portfolio, market.spot, [&](const OptionBatch& batch, const OptionBatchResult& out) {
+        Calculator::priceOptionBatch(batch, market, out);
+    });
+    
+    std::vector<ScenarioResult> results(numRegimes);
+    for (std::size_t r = 0; r < numRegimes; ++r) {
+        results[r].regime = regimes[r];
+        results[r].baseValue = baseValue;
+        results[r].numSpotShocks = numSpot;
+        results[r].numVolShocks = numVol;
+        results[r].pnl.resize(numCells);
+    }
+    
+    parallelFor(numRegimes * numCells, [&](std::size_t task) {
+        std::size_t r = task / numCells;
+        std::size_t cell = task % numCells;
+        const Market& cellMarket = spotMarkets[cell % numSpot];
+        const FrozenVolSurface& surface = surfaces[r * numVol + cell / numSpot];
+        double value = bookValue(portfolio, cellMarket.spot, [&](const OptionBatch& batch, const OptionBatchResult& out) {
+            Calculator::priceOptionBatch(batch, cellMarket, surface, out);
+        });
+        results[r].pnl[cell] = value - baseValue;
+    });
+    
+    for (auto& result : results) fillWorst(result, spec);
+    return results;
+}
+
+void serialFor(std::size_t count, const std::function<void(std::size_t)>& task) {
+    for (std::size_t i = 0; i < count; ++i) task(i);
+}
+
+}  // namespace
+
+ScenarioGridSpec ScenarioGridSpec::uniform(double maxSpotShock, std::size_t numSpot, double maxVolShock, std::size_t numVol) {
+    auto spaced = [](double maxShock, std::size_t n) {
+        std::vector<double> shocks(n, 0.0);
+        for (std::size_t i = 0; i < n && n > 1; ++i) {
+            shocks[i] = -maxShock + 2.0 * maxShock * static_cast<double>(i) / static_cast<double>(n - 1);
+        }
+        return shocks;
+    };
+    ScenarioGridSpec spec;
+    spec.spotShocks = spaced(maxSpotShock, numSpot);
+    spec.volShocks = spaced(maxVolShock, numVol);
+    return spec;
+}
+
+ScenarioResult ScenarioEngine::runGrid(const Portfolio& portfolio, const Market& market, const ScenarioGridSpec& spec) {
+    return runGrid(portfolio, market, spec, market.regime);
+}
+
+ScenarioResult ScenarioEngine::runGrid(
+    const Portfolio& portfolio,
+    const Market& market,
+    const ScenarioGridSpec& spec,
+    Regime regime
+) {
+    return runScenarios(portfolio, market, spec, &regime, 1, serialFor).front();
+}
+
+ScenarioResult ScenarioEngine::runGrid(
+    const Portfolio& portfolio,
+    const Market& market,
+    const ScenarioGridSpec& spec,
+    Regime regime,
+    ThreadPool& pool
+) {
+    ParallelFor parallelFor = [&](std::size_t count, const std::function<void(std::size_t)>& task) {
+        pool.parallelFor(count, task);
+    };
+    return runScenarios(portfolio, market, spec, &regime, 1, parallelFor).front();
+}
+
+std::vector<ScenarioResult> ScenarioEngine::runRegimes(
+    const Portfolio& portfolio,
+    const Market& market,
+    const ScenarioGridSpec& spec,
+    ThreadPool& pool
+) {
+    ParallelFor parallelFor = [&](std::size_t count, const std::function<void(std::size_t)>& task) {
+        pool.parallelFor(count, task);
+    };
+    return runScenarios(portfolio, market, spec, REGIMES, std::size(REGIMES), parallelFor);
+}
+
+}  // namespace omm::core::workers
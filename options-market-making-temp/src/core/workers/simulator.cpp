@@ -7,13 +7,27 @@
 
 namespace omm::core::workers {
 
-static std::mt19937 rng(std::random_device{}());
-static std::normal_distribution<double> normal(0.0, 1.0);
+namespace {
 
-std::map<omm::core::models::Regime, omm::core::models::RegimeParams> getRegimeParams() {
-    std::map<omm::core::models::Regime, omm::core::models::RegimeParams> params;
-    
-    params[omm::core::models::Regime::CALM] = omm::core::models::RegimeParams(
+// Engine behind the overloads that draw their own shocks; one per thread so that
+// simulations on different threads do not race on it
+std::mt19937& threadRng() {
+    thread_local std::mt19937 rng(std::random_device{}());
+    return rng;
+}
+
+double uniformDraw() {
+    return std::uniform_real_distribution<double>(0.0, 1.0)(threadRng());
+}
+
+double normalDraw() {
+    thread_local std::normal_distribution<double> normal(0.0, 1.0);
+    return normal(threadRng());
+}
+
+// Indexed by Regime, built once
+const omm::core::models::RegimeParams REGIME_PARAMS[3] = {
+    omm::core::models::RegimeParams(  // CALM
         0.12,    // spotVol
         0.18,    // volMean
         4.0,     // volKappa
@@ -21,9 +35,8 @@ std::map<omm::core::models::Regime, omm::core::models::RegimeParams> getRegimePa
         -0.3,    // rho
         -0.02,   // skew
         0.01     // convexity
-    );
-    
-    params[omm::core::models::Regime::STRESS] = omm::core::models::RegimeParams(
+    ),
+    omm::core::models::RegimeParams(  // STRESS
         0.25,    // spotVol
         0.28,    // volMean
         1.5,     // volKappa
@@ -31,9 +44,8 @@ std::map<omm::core::models::Regime, omm::core::models::RegimeParams> getRegimePa
         -0.6,    // rho
         -0.05,   // skew
         0.02     // convexity
-    );
-    
-    params[omm::core::models::Regime::EVENT] = omm::core::models::RegimeParams(
+    ),
+    omm::core::models::RegimeParams(  // EVENT
         0.40,    // spotVol
         0.35,    // volMean
         0.5,     // volKappa
@@ -41,10 +53,10 @@ std::map<omm::core::models::Regime, omm::core::models::RegimeParams> getRegimePa
         -0.75,   // rho
         -0.08,   // skew
         0.03     // convexity
-    );
-    
-    return params;
-}
+    ),
+};
+
+}  // namespace
 
 std::shared_ptr<omm::core::models::Market> Simulator::initializeMarket() {
     omm::core::models::Asset asset(".NDX");
@@ -84,15 +96,22 @@ std::shared_ptr<omm::core::models::Market> Simulator::initializeMarket() {
     return simulateNextMarket(market, Config::VIX, expiriesForSimulationDouble);
 }
 
+const omm::core::models::RegimeParams& Simulator::getRegimeParams(omm::core::models::Regime regime) {
+    return REGIME_PARAMS[static_cast<int>(regime)];
+}
+
 omm::core::models::Regime Simulator::getNextRegime(omm::core::models::Regime regime) {
+    return getNextRegime(regime, uniformDraw());
+}
+
+omm::core::models::Regime Simulator::getNextRegime(omm::core::models::Regime regime, double u) {
     const double* probs = Config::REGIME_TRANSITION[static_cast<int>(regime)];
     
     // Sample from multinomial distribution
-    double r = static_cast<double>(rand()) / RAND_MAX;
     double cumProb = 0.0;
     for (int i = 0; i < 3; ++i) {
         cumProb += probs[i];
-        if (r < cumProb) {
+        if (u < cumProb) {
             return static_cast<omm::core::models::Regime>(i);
         }
     }
@@ -100,80 +119,190 @@ omm::core::models::Regime Simulator::getNextRegime(omm::core::models::Regime reg
     return static_cast<omm::core::models::Regime>(2);
 }
 
-std::shared_ptr<omm::core::models::Market> Simulator::simulateNextMarket(
-    const std::shared_ptr<omm::core::models::Market>& market,
-    double atmOneMonthVol,
-    const std::vector<double>& expiries
-) {
-    int currentTime = market->time;
+MarketState Simulator::simulateNextState(const MarketState& state, const MarketShock& shock) {
     double dt = static_cast<double>(Config::TIME_STEP) / 365.0;
     
-    // New expiries
-    std::vector<double> newExpiries;
-    if (expiries.empty()) {
-        newExpiries = market->volSurface->expiries;
-    } else {
-        newExpiries = expiries;
-    }
-    
-    // Remove negative expiries
-    std::vector<double> filteredExpiries;
-    for (double e : newExpiries) {
-        if (e - Config::TIME_STEP > 0) {
-            filteredExpiries.push_back(e - Config::TIME_STEP);
-        }
-    }
-    
-    int numExpiriesRemoved = newExpiries.size() - filteredExpiries.size();
-    
-    // Add new expiries at the end with 7-day steps
-    for (int i = 0; i < numExpiriesRemoved; ++i) {
-        double newExpiry = filteredExpiries.back() + 7.0 * (i + 1);
-        filteredExpiries.push_back(newExpiry);
-    }
-    
-    // Get next regime and its parameters
-    auto nextRegime = getNextRegime(market->regime);
-    auto regimeParamsMap = getRegimeParams();
-    auto regimeParams = regimeParamsMap[nextRegime];
+    // Get next regime, then move spot and vol under its parameters
+    auto nextRegime = getNextRegime(state.regime, shock.regimeDraw);
+    return diffuseState(MarketState{nextRegime, state.spot, state.atmOneMonthVol}, dt, shock.z1, shock.z2);
+}
+
+MarketState Simulator::diffuseState(const MarketState& state, double dt, double z1, double z2) {
+    const auto& regimeParams = getRegimeParams(state.regime);
     
-    // Generate correlated shocks
-    double z1 = normal(rng);
-    double z2 = normal(rng);
+    // Correlate shocks
     double zSpot = z1;
     double zVol = regimeParams.rho * z1 + std::sqrt(1.0 - regimeParams.rho * regimeParams.rho) * z2;
     
     // Spot GBM
-    double spotNext = market->spot * std::exp(
+    double spotNext = state.spot * std::exp(
         -0.5 * regimeParams.spotVol * regimeParams.spotVol * dt +
         regimeParams.spotVol * std::sqrt(dt) * zSpot
     );
     
     // Vol Ornstein-Uhlenbeck process
-    double currentAtmOneMonthVol = (atmOneMonthVol > 0) ? atmOneMonthVol : market->volSurface->atmOneMonthVolEst;
-    double atmOneMonthVolNext = currentAtmOneMonthVol +
-        regimeParams.volKappa * (regimeParams.volMean - currentAtmOneMonthVol) * dt +
+    double atmOneMonthVolNext = state.atmOneMonthVol +
+        regimeParams.volKappa * (regimeParams.volMean - state.atmOneMonthVol) * dt +
         regimeParams.volOfVol * std::sqrt(dt) * zVol;
     
+    return MarketState{state.regime, spotNext, atmOneMonthVolNext};
+}
+
+std::vector<double> Simulator::rollExpiries(const std::vector<double>& expiries) {
+    std::vector<double> rolled(expiries);
+    rollExpiriesInPlace(rolled);
+    return rolled;
+}
+
+void Simulator::rollExpiriesInPlace(std::vector<double>& expiries) {
+    // Remove negative expiries
+    std::size_t kept = 0;
+    for (double e : expiries) {
+        if (e - Config::TIME_STEP > 0) {
+            expiries[kept++] = e - Config::TIME_STEP;
+        }
+    }
+    if (kept == 0) {
+        expiries.clear();
+        return;
+    }
+    
+    // Add new expiries at the end with 7-day steps
+    double last = expiries[kept - 1];
+    for (std::size_t i = kept; i < expiries.size(); ++i) {
+        expiries[i] = last + 7.0 * (i - kept + 1);
+    }
+}
+
+std::shared_ptr<omm::core::models::Market> Simulator::simulateNextMarket(
+    const std::shared_ptr<omm::core::models::Market>& market,
+    double atmOneMonthVol,
+    const std::vector<double>& expiries
+) {
+    MarketShock shock;
+    shock.regimeDraw = uniformDraw();
+    shock.z1 = normalDraw();
+    shock.z2 = normalDraw();
+    return simulateNextMarket(market, shock, atmOneMonthVol, expiries);
+}
+
+std::shared_ptr<omm::core::models::Market> Simulator::simulateNextMarket(
+    const std::shared_ptr<omm::core::models::Market>& market,
+    const MarketShock& shock,
+    double atmOneMonthVol,
+    const std::vector<double>& expiries
+) {
+    int currentTime = market->time;
+    
+    // New expiries
+    auto filteredExpiries = rollExpiries(expiries.empty() ? market->volSurface->expiries : expiries);
+    
+    double currentAtmOneMonthVol = (atmOneMonthVol > 0) ? atmOneMonthVol : market->volSurface->atmOneMonthVolEst;
+    MarketState next = simulateNextState(
+        MarketState{market->regime, market->spot, currentAtmOneMonthVol},
+        shock
+    );
+    const auto& regimeParams = getRegimeParams(next.regime);
+    
     // Create new vol surface
     auto vsNext = std::make_shared<omm::core::models::VolSurface>(
         filteredExpiries,
-        atmOneMonthVolNext,
+        next.atmOneMonthVol,
         regimeParams.skew,
         regimeParams.convexity,
         regimeParams.volMean,
-        spotNext,
+        next.spot,
         market->interestRate
     );
     
     return std::make_shared<omm::core::models::Market>(
         market->asset,
         currentTime + Config::TIME_STEP,
-        spotNext,
+        next.spot,
         vsNext,
         market->interestRate,
-        nextRegime
+        next.regime
+    );
+}
+
+void Simulator::advanceMarket(omm::core::models::Market& market) {
+    MarketShock shock;
+    shock.regimeDraw = uniformDraw();
+    shock.z1 = normalDraw();
+    shock.z2 = normalDraw();
+    advanceMarket(market, shock);
+}
+
+void Simulator::advanceMarket(omm::core::models::Market& market, const MarketShock& shock) {
+    MarketState next = simulateNextState(
+        MarketState{market.regime, market.spot, market.volSurface->atmOneMonthVolEst},
+        shock
     );
+    const auto& regimeParams = getRegimeParams(next.regime);
+    
+    // Earlier snapshots may still point at the surface
+    if (market.volSurface.use_count() != 1) {
+        market.volSurface = std::make_shared<omm::core::models::VolSurface>(*market.volSurface);
+    }
+    rollExpiriesInPlace(market.volSurface->expiries);
+    market.volSurface->rebuild(
+        market.volSurface->expiries,
+        next.atmOneMonthVol,
+        regimeParams.skew,
+        regimeParams.convexity,
+        regimeParams.volMean,
+        next.spot,
+        market.interestRate
+    );
+    
+    market.time += Config::TIME_STEP;
+    market.spot = next.spot;
+    market.regime = next.regime;
+}
+
+std::shared_ptr<omm::core::models::Market> Simulator::simulateNextMarket(
+    const std::shared_ptr<omm::core::models::Market>& market,
+    omm::core::models::SnapshotPool& pool
+) {
+    MarketShock shock;
+    shock.regimeDraw = uniformDraw();
+    shock.z1 = normalDraw();
+    shock.z2 = normalDraw();
+    return simulateNextMarket(market, shock, pool);
+}
+
+std::shared_ptr<omm::core::models::Market> Simulator::simulateNextMarket(
+    const std::shared_ptr<omm::core::models::Market>& market,
+    const MarketShock& shock,
+    omm::core::models::SnapshotPool& pool
+) {
+    MarketState next = simulateNextState(
+        MarketState{market->regime, market->spot, market->volSurface->atmOneMonthVolEst},
+        shock
+    );
+    const auto& regimeParams = getRegimeParams(next.regime);
+    
+    // Refill a recycled slot: every vector keeps its capacity
+    auto nextMarket = pool.acquire();
+    omm::core::models::VolSurface& vsNext = *nextMarket->volSurface;
+    vsNext.expiries.assign(market->volSurface->expiries.begin(), market->volSurface->expiries.end());
+    rollExpiriesInPlace(vsNext.expiries);
+    vsNext.rebuild(
+        vsNext.expiries,
+        next.atmOneMonthVol,
+        regimeParams.skew,
+        regimeParams.convexity,
+        regimeParams.volMean,
+        next.spot,
+        market->interestRate
+    );
+    
+    nextMarket->asset = market->asset;
+    nextMarket->time = market->time + Config::TIME_STEP;
+    nextMarket->spot = next.spot;
+    nextMarket->interestRate = market->interestRate;
+    nextMarket->regime = next.regime;
+    return nextMarket;
 }
 
 }  // namespace omm::core::workers
@@ -0,0 +1,214 @@
+#include "core/workers/varengine.hpp"
+#include "core/config.hpp"
+#include "core/models/marketpaths.hpp"
+#include "core/workers/calculator.hpp"
+#include "core/workers/pathsimulator.hpp"
+#include "core/workers/simulator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <memory>
+
+namespace omm::core::workers {
+
+using omm::core::models::Market;
+using omm::core::models::MarketPaths;
+using omm::core::models::OptionType;
+using omm::core::models::Portfolio;
+using omm::core::models::Regime;
+
+namespace {
+
+constexpr std::size_t BATCH_PATHS = 2048;  // paths simulated and held at a time
+constexpr std::size_t TASK_PATHS = 32;     // paths revalued per thread-pool task
+constexpr std::size_t PRICE_CHUNK = 256;   // legs priced per batch call, on the stack
+constexpr double MIN_ATM_VOL = 0.01;       // floor of a path's one-month ATM vol
+constexpr Regime REGIMES[] = {Regime::CALM, Regime::STRESS, Regime::EVENT};
+
+using ParallelFor = std::function<void(std::size_t, const std::function<void(std::size_t)>&)>;
+
+// The book as seen a horizon later
+struct Horizon {
+    std::size_t step;
+    Portfolio book;  // expiries shortened by the horizon; expired buckets have expiry <= 0
+    std::vector<std::size_t> settleSteps;  // per option bucket: step it expires at, if expired
+};
+
+Portfolio agePortfolio(const Portfolio& portfolio, double days) {
+    Portfolio aged = portfolio;
+    for (auto& bucket : aged.optionBuckets) {
+        bucket.expiry -= days;
+        for (double& expiry : bucket.expiries) expiry -= days;
+    }
+    return aged;
+}
+
+// Options through Calculator's batch pricer, futures at spot. Expired buckets are
+// paid intrinsic at settleSpots[bucket] (the spot of their expiry step), or at the
+// market's spot without it.
+double bookValue(const Portfolio& portfolio, const Market& market, const double* settleSpots = nullptr) {
+    double prices[PRICE_CHUNK];
+    double value = 0.0;
+    for (std::size_t b = 0; b < portfolio.optionBuckets.size(); ++b) {
+        const auto& bucket = portfolio.optionBuckets[b];
+        if (bucket.expiry <= 0.0) {
+            double spot = settleSpots ? settleSpots[b] : market.spot;
+            for (std::size_t i = 0; i < bucket.size(); ++i) {
+                double payoff = bucket.optionTypes[i] == OptionType::CALL ? spot - bucket.strikes[i]
+                                                                          : bucket.strikes[i] - spot;
+                value += bucket.weights[i] * std::max(payoff, 0.0);
+            }
+            continue;
+        }
+        for (std::size_t first = 0; first < bucket.size(); first += PRICE_CHUNK) {
+            std::size_t count = std::min(PRICE_CHUNK, bucket.size() - first);
+            OptionBatch batch{bucket.strikes.data() + first, bucket.expiries.data() + first,
+                              bucket.optionTypes.data() + first, count};
+            Calculator::priceOptionBatch(batch, market, OptionBatchResult{prices, nullptr, nullptr, nullptr, nullptr});
+            for (std::size_t i = 0; i < count; ++i) value += bucket.weights[first + i] * prices[i];
+        }
+    }
+    for (double weight : portfolio.futureWeights) value += weight * market.spot;
+    return value;
+}
+
+// P&L of paths [first, first + count) at every horizon into pnl[h * BATCH_PATHS + path].
+// One market and surface per task, rebuilt in place for each path.
+void revaluePaths(
+    const MarketPaths& paths,
+    const std::vector<Horizon>& horizons,
+    const Market& market,
+    double baseValue,
+    std::size_t first,
+    std::size_t count,
+    double* pnl
+) {
+    Market scenario = market;
+    scenario.volSurface = std::make_shared<omm::core::models::VolSurface>();
+    std::vector<double> settleSpots;
+    for (std::size_t h = 0; h < horizons.size(); ++h) {
+        const Horizon& horizon = horizons[h];
+        std::size_t step = horizon.step;
+        settleSpots.assign(horizon.settleSteps.size(), 0.0);
+        for (std::size_t path = first; path < first + count; ++path) {
+            for (std::size_t b = 0; b < horizon.settleSteps.size(); ++b) {
+                settleSpots[b] = paths.spots[paths.index(horizon.settleSteps[b], path)];
+            }
+            std::size_t idx = paths.index(step, path);
+            const auto& regimeParams = Simulator::getRegimeParams(paths.regimes[idx]);
+            scenario.spot = paths.spots[idx];
+            scenario.volSurface->rebuild(
+                paths.expiries[step],
+                std::max(paths.atmOneMonthVols[idx], MIN_ATM_VOL),
+                regimeParams.skew,
+                regimeParams.convexity,
+                regimeParams.volMean,
+                scenario.spot,
+                market.interestRate
+            );
+            pnl[h * BATCH_PATHS + path] = bookValue(horizon.book, scenario, settleSpots.data()) - baseValue;
+        }
+    }
+}
+
+std::vector<VarResult> runVar(
+    const Portfolio& portfolio,
+    const Market& market,
+    const VarSpec& spec,
+    const Regime* regimes,
+    std::size_t numRegimes,
+    const ParallelFor& parallelFor
+) {
+    std::vector<Horizon> horizons;
+    std::size_t numSteps = 0;
+    for (int days : spec.horizons) {
+        std::size_t step = static_cast<std::size_t>(std::max(days / Config::TIME_STEP, 1));
+        Horizon horizon{step, agePortfolio(portfolio, static_cast<double>(step * Config::TIME_STEP)), {}};
+        
+        // A leg expires at the first step on or after its expiry, as in the simulator's
+        // market time; those already expired today settle at step 0
+        for (const auto& bucket : portfolio.optionBuckets) {
+            double expirySteps = std::ceil(bucket.expiry / Config::TIME_STEP);
+            horizon.settleSteps.push_back(
+                static_cast<std::size_t>(std::clamp(expirySteps, 0.0, static_cast<double>(step))));
+        }
+        horizons.push_back(std::move(horizon));
+        numSteps = std::max(numSteps, step);
+    }
+    double baseValue = bookValue(portfolio, market);
+    std::vector<double> pnl(horizons.size() * BATCH_PATHS);
+    
+    std::vector<VarResult> results;
+    for (std::size_t r = 0; r < numRegimes; ++r) {
+        Market start = market;
+        start.regime = regimes[r];
+        std::vector<TDigest> digests(horizons.size(), TDigest(spec.compression));
+        std::vector<double> sums(horizons.size(), 0.0);
+        
+        for (std::size_t done = 0; done < spec.numPaths; done += BATCH_PATHS) {
+            std::size_t numPaths = std::min(BATCH_PATHS, spec.numPaths - done);
+            MarketPaths paths = PathSimulator::simulatePaths(start, numPaths, numSteps, spec.seed, done);
+            std::size_t numTasks = (numPaths + TASK_PATHS - 1) / TASK_PATHS;
+            parallelFor(numTasks, [&](std::size_t task) {
+                std::size_t first = task * TASK_PATHS;
+                revaluePaths(paths, horizons, market, baseValue, first, std::min(TASK_PATHS, numPaths - first), pnl.data());
+            });
+            
+            // In path order, so the digests do not depend on the thread count
+            for (std::size_t h = 0; h < horizons.size(); ++h) {
+                for (std::size_t path = 0; path < numPaths; ++path) {
+                    double value = pnl[h * BATCH_PATHS + path];
+                    digests[h].add(value);
+                    sums[h] += value;
+                }
+            }
+        }
+        
+        VarResult result;
+        result.regime = regimes[r];
+        result.baseValue = baseValue;
+        result.numPaths = spec.numPaths;
+        for (std::size_t h = 0; h < horizons.size(); ++h) {
+            HorizonRisk risk{spec.horizons[h], spec.numPaths > 0 ? sums[h] / spec.numPaths : 0.0, {}, digests[h]};
+            for (double confidence : spec.confidences) {
+                double tail = 1.0 - confidence;
+                risk.measures.push_back(RiskMeasure{confidence, -risk.pnl.quantile(tail), -risk.pnl.tailMean(tail)});
+            }
+            result.horizons.push_back(std::move(risk));
+        }
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+void serialFor(std::size_t count, const std::function<void(std::size_t)>& task) {
+    for (std::size_t i = 0; i < count; ++i) task(i);
+}
+
+}  // namespace
+
+VarResult VarEngine::run(const Portfolio& portfolio, const Market& market, const VarSpec& spec) {
+    return runVar(portfolio, market, spec, &market.regime, 1, serialFor).front();
+}
+
+VarResult VarEngine::run(const Portfolio& portfolio, const Market& market, const VarSpec& spec, ThreadPool& pool) {
+    ParallelFor parallelFor = [&](std::size_t count, const std::function<void(std::size_t)>& task) {
+        pool.parallelFor(count, task);
+    };
+    return runVar(portfolio, market, spec, &market.regime, 1, parallelFor).front();
+}
+
+std::vector<VarResult> VarEngine::runRegimes(
+    const Portfolio& portfolio,
+    const Market& market,
+    const VarSpec& spec,
+    ThreadPool& pool
+) {
+    ParallelFor parallelFor = [&](std::size_t count, const std::function<void(std::size_t)>& task) {
+        pool.parallelFor(count, task);
+    };
+    return runVar(portfolio, market, spec, REGIMES, std::size(REGIMES), parallelFor);
+}
+
+}  // namespace omm::core::workers
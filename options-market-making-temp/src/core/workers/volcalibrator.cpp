@@ -0,0 +1,300 @@
+#include "core/workers/volcalibrator.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace omm::core::workers {
+
+using omm::core::models::SmileParams;
+
+namespace {
+
+constexpr int NUM_CHECKS = 33;                // check strikes, evenly spaced in ns
+constexpr double MAX_DAMPING = 1e10;
+constexpr double MIN_STEP = 1e-12;
+constexpr double STEP_TOLERANCE = 1e-6;       // relative step that ends a fit
+constexpr double DIAGONAL_FLOOR = 1e-12;      // keeps a parameter no quote moves from a singular system
+
+// Least squares quadratic in ns through (normStrikes, vols); false below 3 points
+bool fitQuadratic(const double* normStrikes, const double* vols, std::size_t count, SmileParams& smile) {
+    if (count < 3) return false;
+    Eigen::Matrix3d normal = Eigen::Matrix3d::Zero();
+    Eigen::Vector3d rhs = Eigen::Vector3d::Zero();
+    for (std::size_t k = 0; k < count; ++k) {
+        double ns = normStrikes[k];
+        Eigen::Vector3d basis(1.0, ns, ns * ns);
+        normal.noalias() += basis * basis.transpose();
+        rhs.noalias() += vols[k] * basis;
+    }
+    Eigen::Vector3d coefficients = normal.ldlt().solve(rhs);
+    smile = SmileParams{coefficients(0), coefficients(1), coefficients(2)};
+    return true;
+}
+
+// One expiry's quotes and constraints
+struct SmileProblem {
+    const double* logMoneyness;  // log(K / F) per quote
+    const double* vols;
+    const double* weights;       // null: all 1
+    std::size_t size;
+    double invTotalWeight;
+    double sqrtTte;
+    
+    double checkStrikes[NUM_CHECKS];
+    double floorVariance[NUM_CHECKS];  // earlier expiry's total variance / T here, 0 for the first
+    double minVol;
+    double constraintWeight;
+};
+
+struct SmileFit {
+    SmileParams smile;
+    int iterations = 0;
+    bool constrained = false;
+};
+
+void project(SmileParams& smile, double minVol) {
+    smile.atmVol = std::max(smile.atmVol, minVol);
+    smile.convexity = std::max(smile.convexity, 0.0);
+}
+
+// Cost at smile and, when wanted, the normal equations J^T J and J^T r
+double evaluate(const SmileProblem& problem, const SmileParams& smile, Eigen::Matrix3d* jtj, Eigen::Vector3d* jtr,
+                bool* constrained = nullptr) {
+    double a = smile.atmVol;
+    double b = smile.skew;
+    double c = smile.convexity;
+    double invScale = 1.0 / (a * problem.sqrtTte);
+    
+    Eigen::Matrix3d quoteJtj = Eigen::Matrix3d::Zero();
+    Eigen::Vector3d quoteJtr = Eigen::Vector3d::Zero();
+    double quoteCost = 0.0;
+    for (std::size_t i = 0; i < problem.size; ++i) {
+        double ns = problem.logMoneyness[i] * invScale;
+        double residual = a + b * ns + c * ns * ns - problem.vols[i];
+        double weight = problem.weights ? problem.weights[i] : 1.0;
+        quoteCost += weight * residual * residual;
+        if (jtj) {
+            // ns moves with atmVol at a fixed strike: d ns / d a = -ns / a
+            Eigen::Vector3d grad(1.0 - (b + 2.0 * c * ns) * ns / a, ns, ns * ns);
+            quoteJtj.noalias() += weight * grad * grad.transpose();
+            quoteJtr.noalias() += weight * residual * grad;
+        }
+    }
+    
+    // Penalties at fixed ns: v^2 under the calendar floor, v under minVol
+    Eigen::Matrix3d penaltyJtj = Eigen::Matrix3d::Zero();
+    Eigen::Vector3d penaltyJtr = Eigen::Vector3d::Zero();
+    double penaltyCost = 0.0;
+    bool active = false;
+    for (int j = 0; j < NUM_CHECKS; ++j) {
+        double ns = problem.checkStrikes[j];
+        double vol = a + b * ns + c * ns * ns;
+        Eigen::Vector3d grad(1.0, ns, ns * ns);
+        double calendarGap = problem.floorVariance[j] - vol * vol;
+        if (calendarGap > 0.0) {
+            active = true;
+            penaltyCost += calendarGap * calendarGap;
+            if (jtj) {
+                Eigen::Vector3d residualGrad = -2.0 * vol * grad;
+                penaltyJtj.noalias() += residualGrad * residualGrad.transpose();
+                penaltyJtr.noalias() += calendarGap * residualGrad;
+            }
+        }
+        double floorGap = problem.minVol - vol;
+        if (floorGap > 0.0) {
+            active = true;
+            penaltyCost += floorGap * floorGap;
+            if (jtj) {
+                penaltyJtj.noalias() += grad * grad.transpose();
+                penaltyJtr.noalias() -= floorGap * grad;
+            }
+        }
+    }
+    
+    if (jtj) {
+        *jtj = problem.invTotalWeight * quoteJtj + problem.constraintWeight * penaltyJtj;
+        *jtr = problem.invTotalWeight * quoteJtr + problem.constraintWeight * penaltyJtr;
+    }
+    if (constrained) *constrained = active;
+    return problem.invTotalWeight * quoteCost + problem.constraintWeight * penaltyCost;
+}
+
+// Levenberg-Marquardt with Marquardt's diagonal scaling, projected onto the bounds
+SmileFit fitSmile(const SmileProblem& problem, SmileParams start, const CalibrationParams& params) {
+    SmileFit fit;
+    project(start, params.minVol);
+    fit.smile = start;
+    
+    Eigen::Matrix3d jtj;
+    Eigen::Vector3d jtr;
+    double cost = evaluate(problem, fit.smile, &jtj, &jtr);
+    double damping = params.initialDamping;
+    
+    while (fit.iterations < params.maxIterations && damping < MAX_DAMPING) {
+        ++fit.iterations;
+        Eigen::Matrix3d system = jtj;
+        system.diagonal() = system.diagonal() * (1.0 + damping) + Eigen::Vector3d::Constant(DIAGONAL_FLOOR);
+        Eigen::Vector3d step = system.ldlt().solve(-jtr);
+        if (step.norm() < MIN_STEP) break;
+        
+        SmileParams trial{fit.smile.atmVol + step(0), fit.smile.skew + step(1), fit.smile.convexity + step(2)};
+        project(trial, params.minVol);
+        Eigen::Matrix3d trialJtj;
+        Eigen::Vector3d trialJtr;
+        double trialCost = evaluate(problem, trial, &trialJtj, &trialJtr);
+        if (!(trialCost < cost)) {
+            damping *= 10.0;
+            continue;
+        }
+        
+        double decrease = cost - trialCost;
+        fit.smile = trial;
+        cost = trialCost;
+        jtj = trialJtj;
+        jtr = trialJtr;
+        damping *= 0.3;
+        double size = std::abs(trial.atmVol) + std::abs(trial.skew) + std::abs(trial.convexity);
+        if (decrease <= params.tolerance * cost || step.norm() <= STEP_TOLERANCE * size) break;
+    }
+    evaluate(problem, fit.smile, nullptr, nullptr, &fit.constrained);
+    
+    // The penalties leave violations of the order of 1 / constraintWeight: lift the
+    // smile by the largest gap left so that calendar and floor hold exactly
+    if (fit.constrained && problem.constraintWeight > 0.0) {
+        double lift = 0.0;
+        for (int j = 0; j < NUM_CHECKS; ++j) {
+            double ns = problem.checkStrikes[j];
+            double vol = fit.smile.atmVol + fit.smile.skew * ns + fit.smile.convexity * ns * ns;
+            lift = std::max({lift, std::sqrt(problem.floorVariance[j]) - vol, problem.minVol - vol});
+        }
+        fit.smile.atmVol += lift;
+    }
+    return fit;
+}
+
+}  // namespace
+
+VolCalibrator::VolCalibrator(const CalibrationParams& params_) : params(params_) {}
+
+CalibrationStats VolCalibrator::calibrate(const VolQuoteBatch& quotes, const omm::core::models::Market& market) {
+    CalibrationStats stats;
+    std::swap(previousExpiries, fittedExpiries);
+    std::swap(previousSmiles, fittedSmiles);
+    fittedExpiries.clear();
+    fittedSmiles.clear();
+    logMoneyness.resize(quotes.size);
+    
+    double totalWeight = 0.0;
+    double totalSquaredError = 0.0;
+    std::size_t previous = 0;  // cursor into the previous fit, both in expiry order
+    std::size_t end = 0;
+    for (std::size_t begin = 0; begin < quotes.size; begin = end) {
+        double expiry = quotes.expiries[begin];
+        double tte = expiry / 365.0;
+        double forward = market.spot * std::exp(market.interestRate * tte);
+        end = begin;
+        while (end < quotes.size && quotes.expiries[end] == expiry) {
+            logMoneyness[end] = std::log(quotes.strikes[end] / forward);
+            ++end;
+        }
+        
+        SmileProblem problem;
+        problem.logMoneyness = logMoneyness.data() + begin;
+        problem.vols = quotes.vols + begin;
+        problem.weights = quotes.weights ? quotes.weights + begin : nullptr;
+        problem.size = end - begin;
+        double weight = 0.0;
+        for (std::size_t i = 0; i < problem.size; ++i) weight += problem.weights ? problem.weights[i] : 1.0;
+        problem.invTotalWeight = weight > 0.0 ? 1.0 / weight : 0.0;
+        problem.sqrtTte = std::sqrt(tte);
+        problem.minVol = params.minVol;
+        problem.constraintWeight = params.constraintWeight;
+        
+        // Calendar floor: the earlier expiry's total variance at the same ns, per unit of T here
+        const SmileParams* earlier = fittedSmiles.empty() ? nullptr : &fittedSmiles.back();
+        double varianceRatio = earlier ? fittedExpiries.back() / expiry : 0.0;
+        for (int j = 0; j < NUM_CHECKS; ++j) {
+            double ns = params.checkRange * (2.0 * j / (NUM_CHECKS - 1) - 1.0);
+            problem.checkStrikes[j] = ns;
+            double earlierVol = earlier ? earlier->atmVol + earlier->skew * ns + earlier->convexity * ns * ns : 0.0;
+            problem.floorVariance[j] = varianceRatio * earlierVol * earlierVol;
+        }
+        
+        // Warm start from this expiry's last fit, else from the quote nearest the forward
+        while (previous < previousExpiries.size() && previousExpiries[previous] < expiry) ++previous;
+        SmileParams start;
+        if (previous < previousExpiries.size() && previousExpiries[previous] == expiry) {
+            start = previousSmiles[previous];
+            ++stats.warmStarts;
+        } else {
+            std::size_t atm = 0;
+            for (std::size_t i = 1; i < problem.size; ++i) {
+                if (std::abs(problem.logMoneyness[i]) < std::abs(problem.logMoneyness[atm])) atm = i;
+            }
+            start = SmileParams{problem.vols[atm], 0.0, 0.0};
+        }
+        
+        SmileFit fit = fitSmile(problem, start, params);
+        fittedExpiries.push_back(expiry);
+        fittedSmiles.push_back(fit.smile);
+        ++stats.smiles;
+        stats.iterations += static_cast<std::uint64_t>(fit.iterations);
+        if (fit.constrained) ++stats.constrained;
+        
+        double invScale = 1.0 / (fit.smile.atmVol * problem.sqrtTte);
+        for (std::size_t i = 0; i < problem.size; ++i) {
+            double ns = problem.logMoneyness[i] * invScale;
+            double error = fit.smile.atmVol + fit.smile.skew * ns + fit.smile.convexity * ns * ns - problem.vols[i];
+            double w = problem.weights ? problem.weights[i] : 1.0;
+            totalWeight += w;
+            totalSquaredError += w * error * error;
+            stats.maxError = std::max(stats.maxError, std::abs(error));
+        }
+    }
+    stats.rmse = totalWeight > 0.0 ? std::sqrt(totalSquaredError / totalWeight) : 0.0;
+    return stats;
+}
+
+std::size_t VolCalibrator::warmStart(const omm::core::models::VolSurface& surface) {
+    fittedExpiries.clear();
+    fittedSmiles.clear();
+    SmileParams fit;
+    
+    if (surface.ssvi) {
+        // No knots: sample each SSVI slice at the check strikes
+        double normStrikes[NUM_CHECKS];
+        double vols[NUM_CHECKS];
+        for (int j = 0; j < NUM_CHECKS; ++j) {
+            normStrikes[j] = params.checkRange * (2.0 * j / (NUM_CHECKS - 1) - 1.0);
+        }
+        for (double expiry : surface.ssvi->expiries()) {
+            for (int j = 0; j < NUM_CHECKS; ++j) vols[j] = surface.ssvi->getVolNormStrike(normStrikes[j], expiry);
+            if (!fitQuadratic(normStrikes, vols, NUM_CHECKS, fit)) continue;
+            fittedExpiries.push_back(expiry);
+            fittedSmiles.push_back(fit);
+        }
+        return fittedSmiles.size();
+    }
+    
+    // Least squares quadratic through each smile's knots (exact for a parametric surface)
+    std::size_t count = std::min(surface.expiries.size(), surface.smiles.size());
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        const auto& smile = surface.smiles[idx];
+        if (!fitQuadratic(smile.normStrikes.data(), smile.volPoints.data(), smile.normStrikes.size(), fit)) continue;
+        fittedExpiries.push_back(surface.expiries[idx]);
+        fittedSmiles.push_back(fit);
+    }
+    return fittedSmiles.size();
+}
+
+void VolCalibrator::toSurface(omm::core::models::VolSurface& surface, double spot, double interestRate) const {
+    surface.rebuild(fittedExpiries, fittedSmiles.data(), spot, interestRate);
+}
+
+void VolCalibrator::reset() {
+    fittedExpiries.clear();
+    fittedSmiles.clear();
+}
+
+}  // namespace omm::core::workers
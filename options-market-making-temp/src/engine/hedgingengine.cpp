@@ -0,0 +1,112 @@
+#include "engine/hedgingengine.hpp"
+#include "core/utils.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace omm::engine {
+
+HedgingEngine::HedgingEngine(
+    lob::BookManager& books_,
+    lob::InstrumentId future_,
+    double futureExpiry_,
+    double spot_,
+    double interestRate_,
+    const HedgeParams& params_
+) : books(books_),
+    future(future_),
+    futureTte(futureExpiry_),
+    interestRate(interestRate_),
+    params(params_),
+    currentSpot(spot_),
+    nextOrderId(HEDGE_ID_TAG) {}
+
+void HedgingEngine::onOptionFill(const core::models::Risk& unitRisk, double quantity, int lotSize) {
+    double weight = quantity * lotSize;
+    runningRisk.delta += weight * unitRisk.delta;
+    runningRisk.gamma += weight * unitRisk.gamma;
+    runningRisk.vega += weight * unitRisk.vega;
+    runningRisk.theta += weight * unitRisk.theta;
+}
+
+void HedgingEngine::onFutureFill(double lots) {
+    futureLots += lots;
+    runningRisk.delta += lots * params.futureLotSize;
+}
+
+void HedgingEngine::onSpot(double spot) {
+    runningRisk.delta += runningRisk.gamma * (spot - currentSpot);
+    currentSpot = spot;
+}
+
+void HedgingEngine::resync(const core::models::Risk& risk) {
+    runningRisk = risk;
+}
+
+double HedgingEngine::bandWidth() const {
+    return params.deltaBand + params.gammaBandScale * std::abs(runningRisk.gamma) * currentSpot;
+}
+
+double HedgingEngine::futureFair() const {
+    return core::Utils::getForwardPrice(currentSpot, interestRate, futureTte);
+}
+
+lob::Price HedgingEngine::futureFairTicks() const {
+    return static_cast<lob::Price>(std::lround(futureFair() / params.tickSize));
+}
+
+lob::Quantity HedgingEngine::requiredLots() const {
+    double delta = runningRisk.delta;
+    double band = bandWidth();
+    if (std::abs(delta) <= band) {
+        return 0;
+    }
+    double target = (delta > 0.0 ? band : -band) * params.rehedgeTo;
+    auto lots = static_cast<lob::Quantity>(std::lround((target - delta) / params.futureLotSize));
+    return std::clamp(lots, -params.maxLots, params.maxLots);
+}
+
+lob::Quantity HedgingEngine::hedge() {
+    ++hedgeStats.checks;
+    lob::Quantity lots = requiredLots();
+    if (lots == 0) {
+        return 0;
+    }
+    
+    const lob::OrderBook& book = books.book(future);
+    lob::Side side = lots > 0 ? lob::Side::BUY : lob::Side::SELL;
+    lob::Price fairTicks = futureFairTicks();
+    lob::Price limit = side == lob::Side::BUY ? fairTicks + params.maxSlippage : fairTicks - params.maxSlippage;
+    limit = std::clamp(limit, book.minPrice(), book.maxPrice());
+    
+    double fair = futureFair();
+    fills.clear();
+    books.add(future, lob::OrderRequest{nextOrderId++, side, lob::OrderType::LIMIT, lob::TimeInForce::IOC, limit, std::abs(lots)}, fills);
+    ++hedgeStats.hedges;
+    
+    lob::Quantity filled = 0;
+    double sign = side == lob::Side::BUY ? 1.0 : -1.0;
+    for (const lob::Fill& fill : fills) {
+        auto quantity = static_cast<double>(fill.quantity);
+        futureLots += sign * quantity;
+        runningRisk.delta += sign * quantity * params.futureLotSize;
+        hedgeStats.slippage += (static_cast<double>(fill.price) * params.tickSize - fair) * sign * quantity * params.futureLotSize;
+        filled += fill.quantity;
+        if (counterpartyFillHandler) counterpartyFillHandler(future, fill);
+    }
+    hedgeStats.lotsTraded += static_cast<std::uint64_t>(filled);
+    hedgeStats.lotsMissed += static_cast<std::uint64_t>(std::abs(lots) - filled);
+    hedgeStats.fees += params.feePerLot * static_cast<double>(filled);
+    return side == lob::Side::BUY ? filled : -filled;
+}
+
+void HedgingEngine::executed(lob::Quantity lots, double price) {
+    auto signedLots = static_cast<double>(lots);
+    futureLots += signedLots;
+    runningRisk.delta += signedLots * params.futureLotSize;
+    hedgeStats.slippage += (price - futureFair()) * signedLots * params.futureLotSize;
+    hedgeStats.fees += params.feePerLot * std::abs(signedLots);
+    hedgeStats.lotsTraded += static_cast<std::uint64_t>(std::abs(lots));
+    ++hedgeStats.hedges;
+}
+
+}  // namespace omm::engine
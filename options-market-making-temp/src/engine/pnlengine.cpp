@@ -0,0 +1,270 @@
+#include "engine/pnlengine.hpp"
+#include "core/config.hpp"
+#include "core/workers/calculator.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace omm::engine {
+
+using core::models::Market;
+using core::models::OptionType;
+using core::workers::Calculator;
+using core::workers::OptionBatch;
+using core::workers::OptionBatchResult;
+using core::workers::Simulator;
+
+namespace {
+
+double intrinsicValue(OptionType type, double strike, double spot) {
+    return std::max(type == OptionType::CALL ? spot - strike : strike - spot, 0.0);
+}
+
+template <typename T>
+void eraseFrontOf(std::vector<T>& column, std::size_t count) {
+    column.erase(column.begin(), column.begin() + static_cast<std::ptrdiff_t>(count));
+}
+
+}  // namespace
+
+void PnlEngine::Legs::insert(
+    std::size_t at,
+    std::uint32_t row,
+    double expiryTime,
+    double strike,
+    OptionType optionType
+) {
+    auto pos = static_cast<std::ptrdiff_t>(at);
+    rows.insert(rows.begin() + pos, row);
+    expiryTimes.insert(expiryTimes.begin() + pos, expiryTime);
+    strikes.insert(strikes.begin() + pos, strike);
+    optionTypes.insert(optionTypes.begin() + pos, optionType);
+    for (auto* column : {&weights, &expiries, &prices, &deltas, &gammas, &vegas, &thetas, &vols}) {
+        column->insert(column->begin() + pos, 0.0);
+    }
+}
+
+void PnlEngine::Legs::erase(std::size_t at) {
+    auto pos = static_cast<std::ptrdiff_t>(at);
+    rows.erase(rows.begin() + pos);
+    expiryTimes.erase(expiryTimes.begin() + pos);
+    strikes.erase(strikes.begin() + pos);
+    optionTypes.erase(optionTypes.begin() + pos);
+    for (auto* column : {&weights, &expiries, &prices, &deltas, &gammas, &vegas, &thetas, &vols}) {
+        column->erase(column->begin() + pos);
+    }
+}
+
+void PnlEngine::Legs::eraseFront(std::size_t count) {
+    if (count == 0) return;
+    eraseFrontOf(rows, count);
+    eraseFrontOf(expiryTimes, count);
+    eraseFrontOf(strikes, count);
+    eraseFrontOf(optionTypes, count);
+    for (auto* column : {&weights, &expiries, &prices, &deltas, &gammas, &vegas, &thetas, &vols}) {
+        eraseFrontOf(*column, count);
+    }
+}
+
+void PnlEngine::Marks::resize(std::size_t size) {
+    for (auto* column : {&prices, &deltas, &gammas, &vegas, &thetas, &vols}) {
+        column->resize(size);
+    }
+}
+
+PnlEngine::PnlEngine(std::shared_ptr<Market> market_)
+    : pool(2),
+      currentMarket(std::move(market_)) {}
+
+std::uint32_t PnlEngine::instrumentRow(const InstrumentKey& key) {
+    auto it = instrumentRows.find(key);
+    if (it != instrumentRows.end()) return it->second;
+    
+    auto row = static_cast<std::uint32_t>(table.size());
+    table.isFuture.push_back(std::get<0>(key));
+    table.strikes.push_back(std::get<1>(key));
+    table.expiryTimes.push_back(std::get<2>(key));
+    table.optionTypes.push_back(static_cast<OptionType>(std::get<3>(key)));
+    table.lotSizes.push_back(std::get<4>(key));
+    table.quantities.push_back(0);
+    instrumentRows.emplace(key, row);
+    return row;
+}
+
+std::uint32_t PnlEngine::trade(const core::models::Option& option, int quantity, double price) {
+    const Market& market = *currentMarket;
+    double expiryTime = market.time + option.expiry;
+    std::uint32_t row = instrumentRow(
+        InstrumentKey{0, option.strike, expiryTime, static_cast<int>(option.optionType), option.lotSize});
+    table.quantities[row] += quantity;
+    
+    // The leg if held, else a new one marked at the current market
+    auto first = std::lower_bound(legs.expiryTimes.begin(), legs.expiryTimes.end(), expiryTime);
+    auto at = static_cast<std::size_t>(first - legs.expiryTimes.begin());
+    while (at < legs.size() && legs.expiryTimes[at] == expiryTime && legs.rows[at] != row) ++at;
+    if (at == legs.size() || legs.rows[at] != row) {
+        legs.insert(at, row, expiryTime, option.strike, option.optionType);
+        legs.expiries[at] = option.expiry;
+        if (option.expiry > 0.0) {
+            Calculator::priceOptionBatch(
+                OptionBatch{&legs.strikes[at], &legs.expiries[at], &legs.optionTypes[at], 1},
+                market,
+                OptionBatchResult{&legs.prices[at], &legs.deltas[at], &legs.gammas[at],
+                                  &legs.vegas[at], &legs.thetas[at], &legs.vols[at]}
+            );
+        } else {
+            legs.prices[at] = intrinsicValue(option.optionType, option.strike, market.spot);
+        }
+    }
+    
+    double weight = static_cast<double>(quantity) * option.lotSize;
+    double mark = legs.prices[at];
+    if (price < 0.0) price = mark;
+    legs.weights[at] += weight;
+    cash -= weight * price;
+    pendingTrading += weight * (mark - price);
+    trades.append(row, quantity, price, market.time);
+    
+    if (table.quantities[row] == 0) legs.erase(at);
+    return row;
+}
+
+std::uint32_t PnlEngine::trade(const core::models::Future& future, int quantity, double price) {
+    const Market& market = *currentMarket;
+    std::uint32_t row = instrumentRow(InstrumentKey{1, 0.0, 0.0, 0, future.lotSize});
+    table.quantities[row] += quantity;
+    
+    double weight = static_cast<double>(quantity) * future.lotSize;
+    if (price < 0.0) price = market.spot;
+    futureWeight += weight;
+    cash -= weight * price;
+    pendingTrading += weight * (market.spot - price);
+    trades.append(row, quantity, price, market.time);
+    return row;
+}
+
+void PnlEngine::trade(const core::models::Position& position, double price) {
+    if (!position.security) return;
+    
+    if (auto* option = dynamic_cast<const core::models::Option*>(position.security.get())) {
+        trade(*option, position.quantity, price);
+    } else if (auto* future = dynamic_cast<const core::models::Future*>(position.security.get())) {
+        trade(*future, position.quantity, price);
+    }
+}
+
+const DailyPnl& PnlEngine::step() {
+    return bookStep(Simulator::simulateNextMarket(currentMarket, pool));
+}
+
+const DailyPnl& PnlEngine::step(const core::workers::MarketShock& shock) {
+    return bookStep(Simulator::simulateNextMarket(currentMarket, shock, pool));
+}
+
+const DailyPnl& PnlEngine::bookStep(std::shared_ptr<Market> nextMarket) {
+    const Market& market = *nextMarket;
+    double dS = market.spot - currentMarket->spot;
+    double dt = core::Config::TIME_STEP / 365.0;
+    DailyPnl day{market.time, market.spot, market.regime, 0.0, risk(), PnlAttribution{}};
+    
+    // Legs expired by the new market come first and are marked at intrinsic; their
+    // vol is left as it was, so they book no vega
+    std::size_t n = legs.size();
+    nextMarks.resize(n);
+    std::size_t expired = 0;
+    for (; expired < n && legs.expiryTimes[expired] <= market.time; ++expired) {
+        legs.expiries[expired] = 0.0;
+        nextMarks.prices[expired] = intrinsicValue(legs.optionTypes[expired], legs.strikes[expired], market.spot);
+        nextMarks.deltas[expired] = 0.0;
+        nextMarks.gammas[expired] = 0.0;
+        nextMarks.vegas[expired] = 0.0;
+        nextMarks.thetas[expired] = 0.0;
+        nextMarks.vols[expired] = legs.vols[expired];
+    }
+    for (std::size_t i = expired; i < n; ++i) {
+        legs.expiries[i] = legs.expiryTimes[i] - market.time;
+    }
+    if (expired < n) {
+        Calculator::priceOptionBatch(
+            OptionBatch{legs.strikes.data() + expired, legs.expiries.data() + expired,
+                        legs.optionTypes.data() + expired, n - expired},
+            market,
+            OptionBatchResult{nextMarks.prices.data() + expired, nextMarks.deltas.data() + expired,
+                              nextMarks.gammas.data() + expired, nextMarks.vegas.data() + expired,
+                              nextMarks.thetas.data() + expired, nextMarks.vols.data() + expired}
+        );
+    }
+    
+    // Greeks held over the day against the moves of spot, each leg's vol and time
+    PnlAttribution& pnl = day.pnl;
+    for (std::size_t i = 0; i < n; ++i) {
+        double weight = legs.weights[i];
+        pnl.total += weight * (nextMarks.prices[i] - legs.prices[i]);
+        pnl.delta += weight * legs.deltas[i] * dS;
+        pnl.gamma += 0.5 * weight * legs.gammas[i] * dS * dS;
+        pnl.vega += weight * legs.vegas[i] * (nextMarks.vols[i] - legs.vols[i]);
+        pnl.theta += weight * legs.thetas[i] * dt;
+    }
+    pnl.total += futureWeight * dS;
+    pnl.delta += futureWeight * dS;
+    pnl.trading = pendingTrading;
+    pnl.total += pendingTrading;
+    pnl.unexplained = pnl.total - pnl.delta - pnl.gamma - pnl.vega - pnl.theta - pnl.trading;
+    pendingTrading = 0.0;
+    
+    std::swap(legs.prices, nextMarks.prices);
+    std::swap(legs.deltas, nextMarks.deltas);
+    std::swap(legs.gammas, nextMarks.gammas);
+    std::swap(legs.vegas, nextMarks.vegas);
+    std::swap(legs.thetas, nextMarks.thetas);
+    std::swap(legs.vols, nextMarks.vols);
+    currentMarket = std::move(nextMarket);
+    
+    // Expired legs into cash, closed in the archive at intrinsic
+    for (std::size_t i = 0; i < expired; ++i) {
+        std::uint32_t row = legs.rows[i];
+        cash += legs.weights[i] * legs.prices[i];
+        trades.append(row, -table.quantities[row], legs.prices[i], currentMarket->time);
+        table.quantities[row] = 0;
+    }
+    legs.eraseFront(expired);
+    
+    day.value = value();
+    days.push_back(day);
+    return days.back();
+}
+
+core::models::Risk PnlEngine::risk() const {
+    core::models::Risk total(futureWeight);
+    for (std::size_t i = 0; i < legs.size(); ++i) {
+        double weight = legs.weights[i];
+        total.delta += weight * legs.deltas[i];
+        total.gamma += weight * legs.gammas[i];
+        total.vega += weight * legs.vegas[i];
+        total.theta += weight * legs.thetas[i];
+    }
+    return total;
+}
+
+double PnlEngine::value() const {
+    double total = cash + futureWeight * currentMarket->spot;
+    for (std::size_t i = 0; i < legs.size(); ++i) {
+        total += legs.weights[i] * legs.prices[i];
+    }
+    return total;
+}
+
+PnlAttribution PnlEngine::cumulative() const {
+    PnlAttribution sum;
+    for (const DailyPnl& day : days) {
+        sum.total += day.pnl.total;
+        sum.delta += day.pnl.delta;
+        sum.gamma += day.pnl.gamma;
+        sum.vega += day.pnl.vega;
+        sum.theta += day.pnl.theta;
+        sum.trading += day.pnl.trading;
+        sum.unexplained += day.pnl.unexplained;
+    }
+    return sum;
+}
+
+}  // namespace omm::engine
@@ -0,0 +1,284 @@
+#include "engine/quotingengine.hpp"
+#include "core/workers/calculator.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace omm::engine {
+
+using omm::core::models::OptionType;
+using omm::core::workers::Calculator;
+using omm::core::workers::OptionBatch;
+using omm::core::workers::OptionBatchResult;
+
+namespace {
+
+lob::Price toTicks(double price, double tickSize) {
+    return static_cast<lob::Price>(std::lround(price / tickSize));
+}
+
+}  // namespace
+
+QuotingEngine::QuotingEngine(
+    const lob::InstrumentRegistry& registry,
+    lob::BookManager& books_,
+    const core::models::Market& market_,
+    const core::models::FrozenVolSurface& surface_,
+    const QuotingParams& params_
+) : books(books_),
+    market(market_),
+    surface(surface_),
+    params(params_),
+    numStrikes(registry.strikesPerExpiry()) {
+    std::size_t numExpiries = registry.numExpiries();
+    for (std::size_t e = 0; e < numExpiries; ++e) {
+        double expiry = registry.expiryAt(e);
+        expiries.push_back(expiry);
+        ttes.push_back(expiry / 365.0);
+        sqrtTtes.push_back(std::sqrt(expiry / 365.0));
+        for (std::size_t k = 0; k < numStrikes; ++k) {
+            strikes.push_back(registry.strikeAt(k));
+            logStrikes.push_back(std::log(registry.strikeAt(k)));
+        }
+    }
+    vols.assign(strikes.size(), 0.0);
+    normStrikes.assign(numStrikes, 0.0);
+    
+    std::size_t numSeries = registry.numOptions();
+    theo.assign(numSeries, 0.0);
+    deltas.assign(numSeries, 0.0);
+    gammas.assign(numSeries, 0.0);
+    vegas.assign(numSeries, 0.0);
+    thetas.assign(numSeries, 0.0);
+    refSpots.assign(numSeries, market.spot);
+    refVols.assign(numSeries, 0.0);
+    bids.assign(numSeries, lob::NO_PRICE);
+    asks.assign(numSeries, lob::NO_PRICE);
+    positions.assign(numSeries, 0);
+    
+    moved.reserve(numSeries);
+    batchStrikes.resize(numSeries);
+    batchExpiries.resize(numSeries);
+    batchTypes.resize(numSeries);
+    batchPrices.resize(numSeries);
+    batchDeltas.resize(numSeries);
+    batchGammas.resize(numSeries);
+    batchVegas.resize(numSeries);
+    batchThetas.resize(numSeries);
+}
+
+std::vector<lob::BookSpec> QuotingEngine::bookSpecs(
+    const lob::InstrumentRegistry& registry,
+    const core::models::Market& market,
+    const core::models::FrozenVolSurface& surface,
+    const QuotingParams& params,
+    lob::Price bandTicks,
+    const lob::BookSpec& futureSpec
+) {
+    std::size_t numOptions = registry.numOptions();
+    std::vector<double> strikes(numOptions);
+    std::vector<double> expiries(numOptions);
+    std::vector<OptionType> types(numOptions);
+    for (lob::InstrumentId id = 0; id < numOptions; ++id) {
+        lob::InstrumentInfo info = registry.describe(id);
+        strikes[id] = info.strike;
+        expiries[id] = info.expiry;
+        types[id] = info.optionType;
+    }
+    std::vector<double> prices(numOptions);
+    Calculator::priceOptionBatch(OptionBatch{strikes.data(), expiries.data(), types.data(), numOptions},
+                                 market, surface, OptionBatchResult{prices.data(), nullptr, nullptr, nullptr, nullptr});
+    
+    std::vector<lob::BookSpec> specs(registry.size(), futureSpec);
+    for (std::size_t id = 0; id < numOptions; ++id) {
+        lob::Price center = toTicks(prices[id], params.tickSize);
+        specs[id] = lob::BookSpec{std::max<lob::Price>(0, center - bandTicks), center + bandTicks, lob::BookSpec().maxOrders};
+    }
+    return specs;
+}
+
+QuotingStats QuotingEngine::start() {
+    collectMoved(true);
+    reprice();
+    return finish();
+}
+
+QuotingStats QuotingEngine::onSpot(double spot) {
+    market.spot = spot;
+    collectMoved(false);
+    reprice();
+    return finish();
+}
+
+QuotingStats QuotingEngine::onVolSurface(const core::models::FrozenVolSurface& surface_) {
+    surface = surface_;
+    collectMoved(false);
+    reprice();
+    return finish();
+}
+
+QuotingStats QuotingEngine::applyFill(lob::InstrumentId instrument, const lob::Fill& fill) {
+    if (instrument >= numSeries() || !isQuote(fill.makerId)) {
+        return QuotingStats();
+    }
+    // The resting quote traded against the taker
+    bookFill(instrument, fill.takerSide == lob::Side::BUY ? lob::Side::SELL : lob::Side::BUY, fill.quantity);
+    for (std::size_t series = 0; series < numSeries(); ++series) {
+        requote(series);
+    }
+    return finish();
+}
+
+core::models::Risk QuotingEngine::risk(lob::InstrumentId series) const {
+    return core::models::Risk(deltas[series], gammas[series], vegas[series], thetas[series]);
+}
+
+void QuotingEngine::collectMoved(bool all) {
+    // Vols at the current market: log(K / F) moves by log(F) alone, so the norm
+    // strikes of an expiry need no log per strike
+    double logSpot = std::log(market.spot);
+    for (std::size_t e = 0; e < expiries.size(); ++e) {
+        double logForward = logSpot + market.interestRate * ttes[e];
+        double scale = 1.0 / (surface.getAtmVol(expiries[e]) * sqrtTtes[e]);
+        const double* logK = logStrikes.data() + e * numStrikes;
+        for (std::size_t k = 0; k < numStrikes; ++k) {
+            normStrikes[k] = (logK[k] - logForward) * scale;
+        }
+        surface.getVolsNormStrike(normStrikes.data(), expiries[e], vols.data() + e * numStrikes, numStrikes);
+    }
+    
+    moved.clear();
+    double threshold = params.requoteTicks * params.tickSize;
+    for (std::size_t series = 0; series < theo.size(); ++series) {
+        double dS = market.spot - refSpots[series];
+        double dVol = vols[series >> 1] - refVols[series];
+        double estimate = deltas[series] * dS + 0.5 * gammas[series] * dS * dS + vegas[series] * dVol;
+        if (all || std::abs(estimate) >= threshold) {
+            moved.push_back(static_cast<std::uint32_t>(series));
+        }
+    }
+    updateStats.seriesChecked += theo.size();
+}
+
+void QuotingEngine::reprice() {
+    std::size_t count = moved.size();
+    if (count == 0) return;
+    
+    for (std::size_t j = 0; j < count; ++j) {
+        std::size_t series = moved[j];
+        std::size_t node = series >> 1;
+        batchStrikes[j] = strikes[node];
+        batchExpiries[j] = expiries[node / numStrikes];
+        batchTypes[j] = (series & 1) ? OptionType::PUT : OptionType::CALL;
+    }
+    Calculator::priceOptionBatch(
+        OptionBatch{batchStrikes.data(), batchExpiries.data(), batchTypes.data(), count},
+        market, surface,
+        OptionBatchResult{batchPrices.data(), batchDeltas.data(), batchGammas.data(), batchVegas.data(), batchThetas.data()}
+    );
+    
+    for (std::size_t j = 0; j < count; ++j) {
+        std::size_t series = moved[j];
+        if (auto position = static_cast<double>(positions[series]); position != 0.0) {
+            inventoryRisk.delta += position * (batchDeltas[j] - deltas[series]);
+            inventoryRisk.gamma += position * (batchGammas[j] - gammas[series]);
+            inventoryRisk.vega += position * (batchVegas[j] - vegas[series]);
+            inventoryRisk.theta += position * (batchThetas[j] - thetas[series]);
+        }
+        theo[series] = batchPrices[j];
+        deltas[series] = batchDeltas[j];
+        gammas[series] = batchGammas[j];
+        vegas[series] = batchVegas[j];
+        thetas[series] = batchThetas[j];
+        refSpots[series] = market.spot;
+        refVols[series] = vols[series >> 1];
+    }
+    updateStats.seriesRepriced += count;
+    
+    for (std::size_t j = 0; j < count; ++j) {
+        requote(moved[j]);
+    }
+}
+
+void QuotingEngine::requote(std::size_t series) {
+    double skew = -(params.deltaSkew * inventoryRisk.delta * deltas[series] +
+                    params.vegaSkew * inventoryRisk.vega * vegas[series]);
+    double center = (theo[series] + skew) / params.tickSize;
+    lob::Price bid = static_cast<lob::Price>(std::floor(center)) - params.halfSpread;
+    lob::Price ask = static_cast<lob::Price>(std::ceil(center)) + params.halfSpread;
+    
+    const lob::OrderBook& book = books.book(static_cast<lob::InstrumentId>(series));
+    if (bid < std::max<lob::Price>(1, book.minPrice()) || bid > book.maxPrice()) bid = lob::NO_PRICE;
+    if (ask < std::max<lob::Price>(1, book.minPrice()) || ask > book.maxPrice()) ask = lob::NO_PRICE;
+    
+    // Move the side leading the way first so the quotes never cross each other
+    if (bid != lob::NO_PRICE && bids[series] != lob::NO_PRICE && bid > bids[series]) {
+        sendQuote(series, lob::Side::SELL, ask);
+        sendQuote(series, lob::Side::BUY, bid);
+    } else {
+        sendQuote(series, lob::Side::BUY, bid);
+        sendQuote(series, lob::Side::SELL, ask);
+    }
+}
+
+void QuotingEngine::sendQuote(std::size_t series, lob::Side side, lob::Price price) {
+    auto instrument = static_cast<lob::InstrumentId>(series);
+    lob::Price& current = side == lob::Side::BUY ? bids[series] : asks[series];
+    lob::OrderId id = quoteId(series, side);
+    bool resting = current != lob::NO_PRICE && books.book(instrument).contains(id);
+    if (price == current && (resting || price == lob::NO_PRICE)) {
+        return;
+    }
+    
+    current = price;
+    if (price == lob::NO_PRICE) {
+        if (resting) {
+            books.cancel(instrument, id);
+            ++updateStats.quotesSent;
+        }
+        return;
+    }
+    ++updateStats.quotesSent;
+    fills.clear();
+    if (resting) {
+        books.replace(instrument, id, price, params.quoteSize, fills);
+    } else {
+        books.add(instrument, lob::OrderRequest{id, side, lob::OrderType::LIMIT, lob::TimeInForce::GTC, price, params.quoteSize}, fills);
+    }
+    handleFills(instrument);
+    // Filled in full on arrival: the side is unquoted until the next requote
+    if (!fills.empty() && !books.book(instrument).contains(id)) {
+        current = lob::NO_PRICE;
+    }
+}
+
+void QuotingEngine::handleFills(lob::InstrumentId instrument) {
+    for (const lob::Fill& fill : fills) {
+        if (isQuote(fill.takerId)) {
+            bookFill(instrument, fill.takerSide, fill.quantity);
+            if (counterpartyFillHandler) counterpartyFillHandler(instrument, fill);
+        }
+    }
+}
+
+void QuotingEngine::bookFill(std::size_t series, lob::Side side, lob::Quantity quantity) {
+    lob::Quantity signedQuantity = side == lob::Side::BUY ? quantity : -quantity;
+    positions[series] += signedQuantity;
+    auto q = static_cast<double>(signedQuantity);
+    inventoryRisk.delta += q * deltas[series];
+    inventoryRisk.gamma += q * gammas[series];
+    inventoryRisk.vega += q * vegas[series];
+    inventoryRisk.theta += q * thetas[series];
+    ++updateStats.fills;
+}
+
+QuotingStats QuotingEngine::finish() {
+    QuotingStats update = updateStats;
+    totalStats.seriesChecked += update.seriesChecked;
+    totalStats.seriesRepriced += update.seriesRepriced;
+    totalStats.quotesSent += update.quotesSent;
+    totalStats.fills += update.fills;
+    updateStats = QuotingStats();
+    return update;
+}
+
+}  // namespace omm::engine
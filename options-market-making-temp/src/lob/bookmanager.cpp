@@ -0,0 +1,81 @@
+#include "lob/bookmanager.hpp"
+
+namespace omm::lob {
+
+BookManager::BookManager(const InstrumentRegistry& registry, const BookSpec& spec) {
+    books.reserve(registry.size());
+    for (std::size_t i = 0; i < registry.size(); ++i) {
+        books.emplace_back(spec.minPrice, spec.maxPrice, spec.maxOrders);
+    }
+}
+
+BookManager::BookManager(const InstrumentRegistry& registry, const std::vector<BookSpec>& specs) {
+    books.reserve(registry.size());
+    for (std::size_t i = 0; i < registry.size(); ++i) {
+        const BookSpec& spec = i < specs.size() ? specs[i] : BookSpec();
+        books.emplace_back(spec.minPrice, spec.maxPrice, spec.maxOrders);
+    }
+}
+
+OrderResult BookManager::route(const OrderEvent& event, std::vector<Fill>& fills) {
+    switch (event.action) {
+        case OrderAction::ADD:
+            return add(event.instrument, event.order, fills);
+        case OrderAction::CANCEL:
+            return cancel(event.instrument, event.order.id);
+        case OrderAction::REPLACE:
+            return replace(event.instrument, event.order.id, event.order.price, event.order.quantity, fills);
+    }
+    return OrderResult{OrderStatus::REJECTED, RejectReason::UNKNOWN_ORDER};
+}
+
+OrderResult BookManager::add(InstrumentId instrument, const OrderRequest& order, std::vector<Fill>& fills) {
+    if (instrument >= books.size()) {
+        return OrderResult{OrderStatus::REJECTED, RejectReason::UNKNOWN_INSTRUMENT};
+    }
+    return books[instrument].add(order, fills);
+}
+
+OrderResult BookManager::cancel(InstrumentId instrument, OrderId id) {
+    if (instrument >= books.size()) {
+        return OrderResult{OrderStatus::REJECTED, RejectReason::UNKNOWN_INSTRUMENT};
+    }
+    return books[instrument].cancel(id);
+}
+
+OrderResult BookManager::replace(
+    InstrumentId instrument,
+    OrderId id,
+    Price price,
+    Quantity quantity,
+    std::vector<Fill>& fills
+) {
+    if (instrument >= books.size()) {
+        return OrderResult{OrderStatus::REJECTED, RejectReason::UNKNOWN_INSTRUMENT};
+    }
+    return books[instrument].replace(id, price, quantity, fills);
+}
+
+std::size_t BookManager::numOrders() const {
+    std::size_t total = 0;
+    for (const OrderBook& book : books) {
+        total += book.numOrders();
+    }
+    return total;
+}
+
+std::size_t BookManager::memoryBytes() const {
+    std::size_t bytes = sizeof(*this) + (books.capacity() - books.size()) * sizeof(OrderBook);
+    for (const OrderBook& book : books) {
+        bytes += book.memoryBytes();
+    }
+    return bytes;
+}
+
+void BookManager::clear() {
+    for (OrderBook& book : books) {
+        book.clear();
+    }
+}
+
+}  // namespace omm::lob
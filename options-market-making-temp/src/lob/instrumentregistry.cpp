@@ -0,0 +1,111 @@
+#include "lob/instrumentregistry.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace omm::lob {
+
+using namespace omm::core::models;
+
+namespace {
+
+constexpr std::uint32_t NO_EXPIRY = UINT32_MAX;
+
+}  // namespace
+
+InstrumentRegistry::InstrumentRegistry(
+    const std::vector<double>& expiries_,
+    double minStrike_,
+    double strikeStep_,
+    std::size_t numStrikes_,
+    const std::vector<std::string>& futureExpiries_
+) : expiries(expiries_),
+    minStrike(minStrike_),
+    strikeStep(strikeStep_),
+    invStrikeStep(1.0 / strikeStep_),
+    numStrikes(numStrikes_),
+    futureExpiries(futureExpiries_) {
+    
+    // Expiries are whole days, so a day-indexed table replaces the search
+    std::size_t maxDay = 0;
+    for (double expiry : expiries) {
+        if (expiry >= 0.0 && expiry == std::floor(expiry)) {
+            maxDay = std::max(maxDay, static_cast<std::size_t>(expiry));
+        }
+    }
+    expiryByDay.assign(expiries.empty() ? 0 : maxDay + 1, NO_EXPIRY);
+    for (std::size_t i = 0; i < expiries.size(); ++i) {
+        if (expiries[i] >= 0.0 && expiries[i] == std::floor(expiries[i])) {
+            expiryByDay[static_cast<std::size_t>(expiries[i])] = static_cast<std::uint32_t>(i);
+        }
+    }
+}
+
+InstrumentRegistry InstrumentRegistry::fromVolSurface(
+    const VolSurface& surface,
+    double spot,
+    const std::vector<std::string>& futureExpiries,
+    int maxStrikeStepDist,
+    double strikeStep
+) {
+    return InstrumentRegistry(
+        surface.expiries,
+        spot - maxStrikeStepDist * strikeStep,
+        strikeStep,
+        static_cast<std::size_t>(2 * maxStrikeStepDist + 1),
+        futureExpiries
+    );
+}
+
+InstrumentId InstrumentRegistry::lookup(const Option& option) const {
+    return lookup(option.expiry, option.strike, option.optionType);
+}
+
+InstrumentId InstrumentRegistry::lookup(double expiry, double strike, OptionType optionType) const {
+    if (!(expiry >= 0.0) || expiry >= static_cast<double>(expiryByDay.size())) {
+        return NO_INSTRUMENT;
+    }
+    auto day = static_cast<std::size_t>(expiry);
+    std::uint32_t expiryIdx = expiryByDay[day];
+    if (expiryIdx == NO_EXPIRY || expiries[expiryIdx] != expiry) {
+        return NO_INSTRUMENT;
+    }
+    
+    // Nearest grid strike, accepted only if it is the strike (up to rounding)
+    double z = (strike - minStrike) * invStrikeStep + 0.5;
+    if (!(z >= 0.0) || z >= static_cast<double>(numStrikes)) {
+        return NO_INSTRUMENT;
+    }
+    auto strikeIdx = static_cast<std::size_t>(z);
+    if (std::abs(strike - strikeAt(strikeIdx)) > 1e-9 * strikeStep) {
+        return NO_INSTRUMENT;
+    }
+    return optionId(expiryIdx, strikeIdx, optionType);
+}
+
+InstrumentId InstrumentRegistry::lookup(const Future& future) const {
+    for (std::size_t i = 0; i < futureExpiries.size(); ++i) {
+        if (futureExpiries[i] == future.expiry) {
+            return futureId(i);
+        }
+    }
+    return NO_INSTRUMENT;
+}
+
+InstrumentInfo InstrumentRegistry::describe(InstrumentId id) const {
+    if (id >= numOptions()) {
+        return InstrumentInfo{InstrumentKind::FUTURE, id - numOptions(), 0, 0.0, 0.0, OptionType::CALL};
+    }
+    std::size_t series = id / 2;
+    std::size_t expiryIdx = series / numStrikes;
+    std::size_t strikeIdx = series % numStrikes;
+    return InstrumentInfo{
+        InstrumentKind::OPTION,
+        expiryIdx,
+        strikeIdx,
+        expiries[expiryIdx],
+        strikeAt(strikeIdx),
+        (id & 1) ? OptionType::PUT : OptionType::CALL
+    };
+}
+
+}  // namespace omm::lob
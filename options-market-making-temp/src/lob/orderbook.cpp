@@ -0,0 +1,381 @@
+#include "lob/orderbook.hpp"
+#include <algorithm>
+
+namespace omm::lob {
+
+namespace {
+
+unsigned countTrailingZeros(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    unsigned n = 0;
+    while (!(x & 1)) { x >>= 1; ++n; }
+    return n;
+#endif
+}
+
+unsigned countLeadingZeros(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_clzll(x));
+#else
+    unsigned n = 0;
+    while (!(x & (1ULL << 63))) { x <<= 1; ++n; }
+    return n;
+#endif
+}
+
+}  // namespace
+
+OrderBook::OrderBook(Price minPrice, Price maxPrice, std::size_t maxOrders)
+    : lowPrice(minPrice),
+      numLevels(static_cast<std::size_t>(std::max<Price>(maxPrice - minPrice, 0)) + 1) {
+    for (BookSide* book : {&bids, &asks}) {
+        book->levels.resize(numLevels);
+        book->occupied.assign((numLevels + 63) / 64, 0);
+    }
+    
+    nodes.resize(std::max<std::size_t>(maxOrders, 1));
+    
+    // At most half full keeps probe sequences short
+    std::size_t indexSize = 16;
+    indexShift = 60;
+    while (indexSize < 2 * nodes.size()) {
+        indexSize *= 2;
+        --indexShift;
+    }
+    index.resize(indexSize);
+    indexMask = indexSize - 1;
+    
+    clear();
+}
+
+void OrderBook::clear() {
+    for (BookSide* book : {&bids, &asks}) {
+        std::fill(book->levels.begin(), book->levels.end(), PriceLevel());
+        std::fill(book->occupied.begin(), book->occupied.end(), 0);
+        book->best = NIL;
+    }
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].next = (i + 1 < nodes.size()) ? static_cast<std::uint32_t>(i + 1) : NIL;
+    }
+    freeList = 0;
+    liveOrders = 0;
+    std::fill(index.begin(), index.end(), IndexEntry());
+}
+
+OrderResult OrderBook::add(const OrderRequest& order, std::vector<Fill>& fills) {
+    if (order.quantity <= 0) {
+        return OrderResult{OrderStatus::REJECTED, RejectReason::INVALID_QUANTITY};
+    }
+    bool limit = order.type == OrderType::LIMIT;
+    if (limit && (order.price < minPrice() || order.price > maxPrice())) {
+        return OrderResult{OrderStatus::REJECTED, RejectReason::INVALID_PRICE};
+    }
+    if (findOrder(order.id) != NIL) {
+        return OrderResult{OrderStatus::REJECTED, RejectReason::DUPLICATE_ID};
+    }
+    bool mayRest = limit && order.timeInForce == TimeInForce::GTC;
+    if (mayRest && freeList == NIL) {
+        return OrderResult{OrderStatus::REJECTED, RejectReason::BOOK_FULL};
+    }
+    if (order.timeInForce == TimeInForce::FOK && !canFill(order)) {
+        return OrderResult{OrderStatus::REJECTED, RejectReason::FOK_NOT_FILLABLE};
+    }
+    
+    Quantity filled = order.quantity - match(order, order.quantity, fills);
+    Quantity remaining = order.quantity - filled;
+    if (remaining == 0) {
+        return OrderResult{OrderStatus::FILLED, RejectReason::NONE, filled, 0};
+    }
+    if (!mayRest) {
+        return OrderResult{OrderStatus::CANCELLED, RejectReason::NONE, filled, 0};
+    }
+    rest(order, remaining);
+    return OrderResult{OrderStatus::RESTING, RejectReason::NONE, filled, remaining};
+}
+
+OrderResult OrderBook::cancel(OrderId id) {
+    std::uint32_t node = findOrder(id);
+    if (node == NIL) {
+        return OrderResult{OrderStatus::REJECTED, RejectReason::UNKNOWN_ORDER};
+    }
+    remove(node);
+    return OrderResult{OrderStatus::CANCELLED};
+}
+
+OrderResult OrderBook::replace(OrderId id, Price price, Quantity quantity, std::vector<Fill>& fills) {
+    std::uint32_t node = findOrder(id);
+    if (node == NIL) {
+        return OrderResult{OrderStatus::REJECTED, RejectReason::UNKNOWN_ORDER};
+    }
+    if (quantity <= 0) {
+        return OrderResult{OrderStatus::REJECTED, RejectReason::INVALID_QUANTITY};
+    }
+    if (price < minPrice() || price > maxPrice()) {
+        return OrderResult{OrderStatus::REJECTED, RejectReason::INVALID_PRICE};
+    }
+    
+    OrderNode& n = nodes[node];
+    std::size_t level = static_cast<std::size_t>(price - lowPrice);
+    if (level == n.level && quantity <= n.remaining) {
+        // Size down in place, keeping the queue position
+        PriceLevel& priceLevel = sideOf(n.side).levels[level];
+        (n.hidden ? priceLevel.hiddenQuantity : priceLevel.visibleQuantity) -= n.remaining - quantity;
+        n.remaining = quantity;
+        return OrderResult{OrderStatus::RESTING, RejectReason::NONE, 0, quantity};
+    }
+    
+    OrderRequest requeued{id, n.side, OrderType::LIMIT, TimeInForce::GTC, price, quantity, n.hidden};
+    remove(node);
+    return add(requeued, fills);
+}
+
+Price OrderBook::bestBid() const {
+    return bids.best == NIL ? NO_PRICE : lowPrice + static_cast<Price>(bids.best);
+}
+
+Price OrderBook::bestAsk() const {
+    return asks.best == NIL ? NO_PRICE : lowPrice + static_cast<Price>(asks.best);
+}
+
+Quantity OrderBook::visibleQuantity(Side side, Price price) const {
+    if (price < minPrice() || price > maxPrice()) return 0;
+    return sideOf(side).levels[static_cast<std::size_t>(price - lowPrice)].visibleQuantity;
+}
+
+Quantity OrderBook::totalQuantity(Side side, Price price) const {
+    if (price < minPrice() || price > maxPrice()) return 0;
+    const PriceLevel& level = sideOf(side).levels[static_cast<std::size_t>(price - lowPrice)];
+    return level.visibleQuantity + level.hiddenQuantity;
+}
+
+bool OrderBook::contains(OrderId id) const {
+    return findOrder(id) != NIL;
+}
+
+std::size_t OrderBook::memoryBytes() const {
+    std::size_t bytes = sizeof(*this);
+    for (const BookSide* book : {&bids, &asks}) {
+        bytes += book->levels.capacity() * sizeof(PriceLevel);
+        bytes += book->occupied.capacity() * sizeof(std::uint64_t);
+    }
+    bytes += nodes.capacity() * sizeof(OrderNode);
+    bytes += index.capacity() * sizeof(IndexEntry);
+    return bytes;
+}
+
+bool OrderBook::crosses(const OrderRequest& order, std::size_t level) const {
+    if (order.type == OrderType::MARKET) {
+        return true;
+    }
+    Price price = lowPrice + static_cast<Price>(level);
+    return order.side == Side::BUY ? price <= order.price : price >= order.price;
+}
+
+Quantity OrderBook::match(const OrderRequest& order, Quantity quantity, std::vector<Fill>& fills) {
+    BookSide& book = order.side == Side::BUY ? asks : bids;
+    while (quantity > 0 && book.best != NIL && crosses(order, book.best)) {
+        PriceLevel& level = book.levels[book.best];
+        Price price = lowPrice + static_cast<Price>(book.best);
+        
+        // Displayed orders first; the last removal clears the level and moves best
+        quantity = matchQueue(level.displayed, order, quantity, price, fills);
+        if (quantity > 0) {
+            quantity = matchQueue(level.hiddenQueue, order, quantity, price, fills);
+        }
+    }
+    return quantity;
+}
+
+Quantity OrderBook::matchQueue(
+    Queue& queue,
+    const OrderRequest& order,
+    Quantity quantity,
+    Price price,
+    std::vector<Fill>& fills
+) {
+    std::uint32_t node = queue.head;
+    while (node != NIL && quantity > 0) {
+        OrderNode& maker = nodes[node];
+        Quantity traded = std::min(quantity, maker.remaining);
+        fills.push_back(Fill{maker.id, order.id, price, traded, order.side});
+        quantity -= traded;
+        
+        std::uint32_t next = maker.next;
+        if (traded == maker.remaining) {
+            remove(node);
+        } else {
+            PriceLevel& level = sideOf(maker.side).levels[maker.level];
+            (maker.hidden ? level.hiddenQuantity : level.visibleQuantity) -= traded;
+            maker.remaining -= traded;
+        }
+        node = next;
+    }
+    return quantity;
+}
+
+bool OrderBook::canFill(const OrderRequest& order) const {
+    const BookSide& book = order.side == Side::BUY ? asks : bids;
+    Quantity available = 0;
+    std::size_t level = book.best;
+    while (level != NIL && crosses(order, level)) {
+        const PriceLevel& priceLevel = book.levels[level];
+        available += priceLevel.visibleQuantity + priceLevel.hiddenQuantity;
+        if (available >= order.quantity) {
+            return true;
+        }
+        if (order.side == Side::BUY) {
+            level = nextOccupied(book, level + 1);
+        } else {
+            level = level == 0 ? NIL : prevOccupied(book, level - 1);
+        }
+    }
+    return false;
+}
+
+void OrderBook::rest(const OrderRequest& order, Quantity quantity) {
+    std::uint32_t node = freeList;
+    freeList = nodes[node].next;
+    ++liveOrders;
+    
+    std::size_t level = static_cast<std::size_t>(order.price - lowPrice);
+    PriceLevel& priceLevel = sideOf(order.side).levels[level];
+    Queue& queue = order.hidden ? priceLevel.hiddenQueue : priceLevel.displayed;
+    
+    OrderNode& n = nodes[node];
+    n.id = order.id;
+    n.remaining = quantity;
+    n.level = static_cast<std::uint32_t>(level);
+    n.prev = queue.tail;
+    n.next = NIL;
+    n.side = order.side;
+    n.hidden = order.hidden;
+    
+    if (queue.tail != NIL) {
+        nodes[queue.tail].next = node;
+    } else {
+        queue.head = node;
+    }
+    queue.tail = node;
+    (order.hidden ? priceLevel.hiddenQuantity : priceLevel.visibleQuantity) += quantity;
+    
+    markLevel(order.side, level);
+    insertOrder(order.id, node);
+}
+
+void OrderBook::remove(std::uint32_t node) {
+    OrderNode& n = nodes[node];
+    PriceLevel& level = sideOf(n.side).levels[n.level];
+    Queue& queue = n.hidden ? level.hiddenQueue : level.displayed;
+    
+    if (n.prev != NIL) {
+        nodes[n.prev].next = n.next;
+    } else {
+        queue.head = n.next;
+    }
+    if (n.next != NIL) {
+        nodes[n.next].prev = n.prev;
+    } else {
+        queue.tail = n.prev;
+    }
+    (n.hidden ? level.hiddenQuantity : level.visibleQuantity) -= n.remaining;
+    
+    if (level.displayed.head == NIL && level.hiddenQueue.head == NIL) {
+        clearLevel(n.side, n.level);
+    }
+    eraseOrder(n.id);
+    
+    n.next = freeList;
+    freeList = node;
+    --liveOrders;
+}
+
+void OrderBook::markLevel(Side side, std::size_t level) {
+    BookSide& book = sideOf(side);
+    book.occupied[level >> 6] |= 1ULL << (level & 63);
+    if (book.best == NIL || (side == Side::BUY ? level > book.best : level < book.best)) {
+        book.best = level;
+    }
+}
+
+void OrderBook::clearLevel(Side side, std::size_t level) {
+    BookSide& book = sideOf(side);
+    book.occupied[level >> 6] &= ~(1ULL << (level & 63));
+    if (book.best == level) {
+        if (side == Side::BUY) {
+            book.best = level == 0 ? NIL : prevOccupied(book, level - 1);
+        } else {
+            book.best = nextOccupied(book, level + 1);
+        }
+    }
+}
+
+std::size_t OrderBook::nextOccupied(const BookSide& book, std::size_t from) const {
+    if (from >= numLevels) {
+        return NIL;
+    }
+    std::size_t word = from >> 6;
+    std::uint64_t bits = book.occupied[word] & (~0ULL << (from & 63));
+    while (bits == 0) {
+        if (++word == book.occupied.size()) {
+            return NIL;
+        }
+        bits = book.occupied[word];
+    }
+    return (word << 6) + countTrailingZeros(bits);
+}
+
+std::size_t OrderBook::prevOccupied(const BookSide& book, std::size_t from) const {
+    std::size_t word = from >> 6;
+    unsigned bit = static_cast<unsigned>(from & 63);
+    std::uint64_t bits = book.occupied[word] & (bit == 63 ? ~0ULL : ((1ULL << (bit + 1)) - 1));
+    while (bits == 0) {
+        if (word == 0) {
+            return NIL;
+        }
+        bits = book.occupied[--word];
+    }
+    return (word << 6) + 63 - countLeadingZeros(bits);
+}
+
+std::size_t OrderBook::slotOf(OrderId id) const {
+    return static_cast<std::size_t>((id * 0x9E3779B97F4A7C15ULL) >> indexShift);
+}
+
+std::uint32_t OrderBook::findOrder(OrderId id) const {
+    for (std::size_t slot = slotOf(id);; slot = (slot + 1) & indexMask) {
+        const IndexEntry& entry = index[slot];
+        if (entry.node == NIL) return NIL;
+        if (entry.id == id) return entry.node;
+    }
+}
+
+void OrderBook::insertOrder(OrderId id, std::uint32_t node) {
+    std::size_t slot = slotOf(id);
+    while (index[slot].node != NIL) {
+        slot = (slot + 1) & indexMask;
+    }
+    index[slot] = IndexEntry{id, node};
+}
+
+void OrderBook::eraseOrder(OrderId id) {
+    std::size_t hole = slotOf(id);
+    while (index[hole].id != id || index[hole].node == NIL) {
+        hole = (hole + 1) & indexMask;
+    }
+    
+    // Backward-shift deletion: pull later entries of the probe run into the hole
+    // unless their home slot lies cyclically in (hole, slot]
+    for (std::size_t slot = (hole + 1) & indexMask; index[slot].node != NIL; slot = (slot + 1) & indexMask) {
+        std::size_t home = slotOf(index[slot].id);
+        bool stays = hole <= slot ? (hole < home && home <= slot) : (hole < home || home <= slot);
+        if (!stays) {
+            index[hole] = index[slot];
+            hole = slot;
+        }
+    }
+    index[hole].node = NIL;
+}
+
+}  // namespace omm::lob
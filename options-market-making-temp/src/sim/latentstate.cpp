@@ -0,0 +1,89 @@
+#include "sim/latentstate.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace omm::sim {
+
+using omm::core::Philox4x32;
+using omm::core::workers::MarketState;
+using omm::core::workers::Simulator;
+
+namespace {
+
+constexpr double TWO_PI = 6.28318530717958647692;
+constexpr double YEARS_PER_NS = 1.0 / (365.0 * static_cast<double>(NS_PER_DAY));
+
+// Counter streams: word 3 tells diffusion draws from regime draws
+constexpr std::uint32_t DIFFUSION_STREAM = 0;
+constexpr std::uint32_t REGIME_STREAM = 1;
+
+Timestamp dayBoundaryAfter(Timestamp time) {
+    Timestamp day = time / NS_PER_DAY;
+    if (time < 0 && day * NS_PER_DAY != time) --day;
+    return (day + 1) * NS_PER_DAY;
+}
+
+}  // namespace
+
+LatentState::LatentState(const MarketState& initial, std::uint64_t seed, Timestamp start)
+    : current(initial),
+      lastTime(start),
+      nextDayBoundary(dayBoundaryAfter(start)),
+      key(Philox4x32::makeKey(seed)) {}
+
+const MarketState& LatentState::sampleAt(Timestamp time) {
+    if (time <= lastTime) {
+        return current;
+    }
+    
+    // Day by day: the regime switches as the day starts, then the day diffuses under it
+    while (lastTime < time) {
+        if (!dayStarted) {
+            switchRegime(nextDayBoundary / NS_PER_DAY - 1);
+            dayStarted = true;
+        }
+        Timestamp end = std::min(time, nextDayBoundary);
+        diffuse(end - lastTime);
+        lastTime = end;
+        if (lastTime == nextDayBoundary) {
+            nextDayBoundary += NS_PER_DAY;
+            dayStarted = false;
+        }
+    }
+    return current;
+}
+
+void LatentState::diffuse(Timestamp elapsed) {
+    if (elapsed <= 0) {
+        return;
+    }
+    std::uint64_t n = numDiffusions++;
+    Philox4x32::Counter out = Philox4x32::generate(Philox4x32::Counter{{
+        static_cast<std::uint32_t>(n),
+        static_cast<std::uint32_t>(n >> 32),
+        0,
+        DIFFUSION_STREAM,
+    }}, key);
+    
+    // Box-Muller, as PathSimulator::generateShocks
+    double u1 = 1.0 - Philox4x32::toUniform(out.words[0], out.words[1]);
+    double u2 = Philox4x32::toUniform(out.words[2], out.words[3]);
+    double radius = std::sqrt(-2.0 * std::log(u1));
+    double z1 = radius * std::cos(TWO_PI * u2);
+    double z2 = radius * std::sin(TWO_PI * u2);
+    
+    current = Simulator::diffuseState(current, static_cast<double>(elapsed) * YEARS_PER_NS, z1, z2);
+}
+
+void LatentState::switchRegime(std::int64_t day) {
+    auto d = static_cast<std::uint64_t>(day);
+    Philox4x32::Counter out = Philox4x32::generate(Philox4x32::Counter{{
+        static_cast<std::uint32_t>(d),
+        static_cast<std::uint32_t>(d >> 32),
+        0,
+        REGIME_STREAM,
+    }}, key);
+    current.regime = Simulator::getNextRegime(current.regime, Philox4x32::toUniform(out.words[0], out.words[1]));
+}
+
+}  // namespace omm::sim
@@ -0,0 +1,58 @@
+#include "sim/scheduler.hpp"
+
+namespace omm::sim {
+
+using omm::core::Philox4x32;
+
+namespace {
+
+const LatencyModel ZERO_LATENCY;
+
+}  // namespace
+
+Scheduler::Scheduler(std::uint64_t seed) : key(Philox4x32::makeKey(seed)) {}
+
+void Scheduler::setLatency(ParticipantId participant, const LatencyModel& model) {
+    if (participant >= participants.size()) {
+        participants.resize(participant + 1);
+    }
+    participants[participant].model = model;
+}
+
+const LatencyModel& Scheduler::latency(ParticipantId participant) const {
+    return participant < participants.size() ? participants[participant].model : ZERO_LATENCY;
+}
+
+Timestamp Scheduler::drawLatency(ParticipantId participant) {
+    if (participant >= participants.size()) {
+        return 0;
+    }
+    Participant& p = participants[participant];
+    if (p.model.kind == LatencyKind::CONSTANT) {
+        return p.model.base;
+    }
+    
+    // One block per draw: (draw number, participant)
+    std::uint64_t n = p.draws++;
+    Philox4x32::Counter out = Philox4x32::generate(Philox4x32::Counter{{
+        static_cast<std::uint32_t>(n),
+        static_cast<std::uint32_t>(n >> 32),
+        participant,
+        0,
+    }}, key);
+    return p.model.sample(Philox4x32::toUniform(out.words[0], out.words[1]));
+}
+
+void Scheduler::reset() {
+    queue.clear();
+    currentTime = 0;
+    nextSeq = 0;
+    processedCount = 0;
+    stopRequested = false;
+    topVacant = false;
+    for (Participant& p : participants) {
+        p.draws = 0;
+    }
+}
+
+}  // namespace omm::sim